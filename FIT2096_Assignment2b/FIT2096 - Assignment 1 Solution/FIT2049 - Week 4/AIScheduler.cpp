@@ -0,0 +1,119 @@
+/*	FIT2096 - Assignment 2b
+*	AIScheduler.cpp
+*	Implementation of AIScheduler.h
+*/
+
+#include "AIScheduler.h"
+#include <algorithm>
+
+AIScheduler::AIScheduler()
+{
+	m_budget = AI_DEFAULT_BUDGET;
+	m_timeBudget = AI_DEFAULT_TIME_BUDGET;
+	m_tick = 0;
+
+	m_updateCount = 0;
+	m_deferredCount = 0;
+	m_overrunCount = 0;
+	m_slowestTick = 0.0f;
+
+	QueryPerformanceFrequency(&m_counterFrequency);
+}
+
+float AIScheduler::GetMilliseconds(LARGE_INTEGER start)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	return (now.QuadPart - start.QuadPart) * 1000.0f / (float)m_counterFrequency.QuadPart;
+}
+
+void AIScheduler::Update(std::vector<Enemy*>* enemies, Vector3 playerPosition, float timestep)
+{
+	LARGE_INTEGER start;
+	QueryPerformanceCounter(&start);
+
+	int count = (int)enemies->size();
+
+	// Someone has been added since last time, they start fresh
+	if ((int)m_pendingTime.size() != count)
+	{
+		m_pendingTime.resize(count, 0.0f);
+		m_deferred.resize(count, 0);
+	}
+
+	m_tick++;
+	m_near.clear();
+	m_due.clear();
+
+	for (int i = 0; i < count; i++)
+	{
+		m_pendingTime[i] += timestep;
+
+		float distanceSquared = Vector3::DistanceSquared((*enemies)[i]->GetPosition(), playerPosition);
+		int interval = AI_NEAR_INTERVAL;
+
+		if (distanceSquared >= AI_FAR_DISTANCE * AI_FAR_DISTANCE)
+		{
+			interval = AI_FAR_INTERVAL;
+		}
+		else if (distanceSquared >= AI_NEAR_DISTANCE * AI_NEAR_DISTANCE)
+		{
+			interval = AI_MID_INTERVAL;
+		}
+
+		if (interval == AI_NEAR_INTERVAL)
+		{
+			// Anyone close enough to matter always gets their turn
+			m_near.push_back(i);
+		}
+		else if (m_deferred[i] || (m_tick + i) % interval == 0)
+		{
+			// Offsetting by index means a different share of them is due each tick
+			m_due.push_back(i);
+		}
+	}
+
+	RunBatch(enemies, m_near.data(), (int)m_near.size(), playerPosition);
+
+	// Whoever missed out last tick goes first
+	std::stable_partition(m_due.begin(), m_due.end(), [this](int i) { return m_deferred[i] != 0; });
+
+	// Anyone past the budget keeps their time owed and waits for next tick
+	int allowed = (int)m_due.size() < m_budget ? (int)m_due.size() : m_budget;
+
+	for (unsigned int rest = allowed; rest < m_due.size(); rest++)
+	{
+		m_deferred[m_due[rest]] = 1;
+	}
+
+	m_deferredCount += (int)m_due.size() - allowed;
+
+	for (int d = 0; d < allowed; d += AI_BATCH_SIZE)
+	{
+		int batch = allowed - d < AI_BATCH_SIZE ? allowed - d : AI_BATCH_SIZE;
+		RunBatch(enemies, &m_due[d], batch, playerPosition);
+	}
+
+	// Only reported, deciding anything on it would make the game depend on how fast the machine is
+	float elapsed = GetMilliseconds(start);
+
+	if (elapsed > m_timeBudget)
+		m_overrunCount++;
+
+	if (elapsed > m_slowestTick)
+		m_slowestTick = elapsed;
+}
+
+void AIScheduler::RunBatch(std::vector<Enemy*>* enemies, const int* indices, int count, Vector3 playerPosition)
+{
+	m_behaviours.Update(enemies, indices, count, m_pendingTime.data(), playerPosition);
+
+	for (int n = 0; n < count; n++)
+	{
+		m_pendingTime[indices[n]] = 0.0f;
+		m_deferred[indices[n]] = 0;
+	}
+
+	m_updateCount += count;
+}
@@ -0,0 +1,86 @@
+/*	FIT2096 - Assignment 2b
+*	AIScheduler.h
+*	Decides which enemies think each tick. Enemies close to the player update every tick,
+*	further away every second tick and far away every fourth, with the time they skipped
+*	handed to them in one go so they still move and shoot at the same rate.
+*	Updates are spread out so each tick does a similar share of the far away enemies, and
+*	after the near ones are done we stop once the tick's budget of updates is spent. Anyone
+*	who missed out goes first next tick. The budget is a count rather than a time so a tick
+*	plays out the same whatever the machine or thread count, the time is only watched so we
+*	can tell when the count is set too high.
+*	Enemies are handed to EnemyBehaviours in batches rather than one at a time.
+*/
+
+#ifndef AI_SCHEDULER_H
+#define AI_SCHEDULER_H
+
+#include "Enemy.h"
+#include "EnemyBehaviours.h"
+#include <Windows.h>
+#include <vector>
+
+// How far from the player an enemy has to be to drop to the slower rates
+#define AI_NEAR_DISTANCE 15.0f
+#define AI_FAR_DISTANCE 40.0f
+
+// Ticks between updates for each level of detail
+#define AI_NEAR_INTERVAL 1
+#define AI_MID_INTERVAL 2
+#define AI_FAR_INTERVAL 4
+
+// Updates per tick we're happy to spend on enemies further away than AI_NEAR_DISTANCE,
+// about what one core gets through in AI_DEFAULT_TIME_BUDGET
+#define AI_DEFAULT_BUDGET 2048
+
+// Milliseconds a tick of enemy updates should take, going over is counted but changes nothing
+#define AI_DEFAULT_TIME_BUDGET 2.0f
+
+// Enemies further away are updated this many at a time.
+// Big enough that a batch is worth splitting between threads.
+#define AI_BATCH_SIZE 256
+
+class AIScheduler
+{
+private:
+	// One entry per enemy, in the same order as the GameBoard's list
+	std::vector<float> m_pendingTime;		// Time that has passed since the enemy last updated
+	std::vector<unsigned char> m_deferred;	// Was due but the budget ran out
+
+	EnemyBehaviours m_behaviours;
+
+	std::vector<int> m_near;	// Scratch, enemies close enough to update every tick
+	std::vector<int> m_due;		// Scratch, enemies to update this tick after the near ones
+
+	int m_budget;			// Updates
+	float m_timeBudget;		// Milliseconds
+	unsigned int m_tick;
+
+	LARGE_INTEGER m_counterFrequency;
+
+	// For checking the budget is doing its job
+	int m_updateCount;
+	int m_deferredCount;
+	int m_overrunCount;
+	float m_slowestTick;
+
+	float GetMilliseconds(LARGE_INTEGER start);
+	void RunBatch(std::vector<Enemy*>* enemies, const int* indices, int count, Vector3 playerPosition);
+
+public:
+	AIScheduler();
+
+	// Runs this tick's share of enemy updates
+	void Update(std::vector<Enemy*>* enemies, Vector3 playerPosition, float timestep);
+
+	void SetBudget(int updates) { m_budget = updates; }
+	void SetTimeBudget(float milliseconds) { m_timeBudget = milliseconds; }
+	void SetNeighbours(SpatialHash* neighbours) { m_behaviours.SetNeighbours(neighbours); }  // So enemies can keep apart
+	void SetJobSystem(JobSystem* jobs) { m_behaviours.SetJobSystem(jobs); }  // Batches are split between threads
+
+	int GetUpdateCount() { return m_updateCount; }		// Enemy updates actually run
+	int GetDeferredCount() { return m_deferredCount; }	// Updates pushed to a later tick by the budget
+	int GetOverrunCount() { return m_overrunCount; }	// Ticks that took longer than the time budget
+	float GetSlowestTick() { return m_slowestTick; }	// Milliseconds
+};
+
+#endif
@@ -0,0 +1,203 @@
+/*	FIT2096 - Assignment 2b
+*	AssetLoader.cpp
+*	Implementation of AssetLoader.h
+*/
+
+#include "AssetLoader.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+AssetLoader::AssetLoader(JobSystem* jobs)
+{
+	m_jobs = jobs;
+	m_pendingCount = 0;
+	m_startTime = chrono::steady_clock::now();
+}
+
+AssetLoader::~AssetLoader()
+{
+	// Decodes still running would be writing into requests we're about to delete
+	Finish();
+
+	for (unsigned int i = 0; i < m_requests.size(); i++)
+	{
+		delete m_requests[i];
+		m_requests[i] = NULL;
+	}
+}
+
+double AssetLoader::GetTime()
+{
+	return chrono::duration<double>(chrono::steady_clock::now() - m_startTime).count();
+}
+
+AssetFuture AssetLoader::Load(const char* name, function<bool()> decode, function<bool(bool decoded)> create)
+{
+	Request* request = new Request();
+	request->name = name;
+	request->decode = decode;
+	request->create = create;
+	request->decoded = false;
+	request->created = false;
+	request->queuedTime = GetTime();
+	request->decodeStartTime = 0.0;
+	request->decodeEndTime = 0.0;
+	request->createStartTime = 0.0;
+	request->createEndTime = 0.0;
+
+	m_requests.push_back(request);
+	m_pendingCount++;
+
+	AssetFuture future = request->result.get_future().share();
+
+	m_jobs->Submit(m_jobs->CreateJob([this, request]() { Decode(request); }, &m_decoding));
+
+	return future;
+}
+
+AssetFuture AssetLoader::Ready(bool result)
+{
+	promise<bool> done;
+	done.set_value(result);
+	return done.get_future().share();
+}
+
+void AssetLoader::Decode(Request* request)
+{
+	request->decodeStartTime = GetTime();
+	request->decoded = request->decode();
+	request->decodeEndTime = GetTime();
+
+	lock_guard<mutex> guard(m_decodedLock);
+	m_decoded.push_back(request);
+}
+
+void AssetLoader::Update()
+{
+	// With no other threads the decodes only run when we run them. A few at a time keeps the menu
+	// responding while they load, waiting on the lot would hold it up until everything was in.
+	if (m_jobs->GetThreadCount() == 1)
+	{
+		for (int i = 0; i < ASSET_LOADER_DECODES_PER_UPDATE; i++)
+		{
+			if (!m_jobs->TryRunOne())
+				break;
+		}
+	}
+
+	{
+		lock_guard<mutex> guard(m_decodedLock);
+		m_creating.swap(m_decoded);
+	}
+
+	for (unsigned int i = 0; i < m_creating.size(); i++)
+	{
+		Request* request = m_creating[i];
+
+		request->createStartTime = GetTime();
+		request->created = request->create(request->decoded);
+		request->createEndTime = GetTime();
+
+		// Whatever the steps were holding on to can go now
+		request->decode = nullptr;
+		request->create = nullptr;
+
+		m_pendingCount--;
+		request->result.set_value(request->created);
+	}
+
+	m_creating.clear();
+}
+
+void AssetLoader::Finish()
+{
+	while (m_pendingCount > 0)
+	{
+		m_jobs->Wait(&m_decoding);
+		Update();
+	}
+}
+
+void AssetLoader::AddMark(const char* name)
+{
+	Mark mark;
+	mark.name = name;
+	mark.time = GetTime();
+	m_marks.push_back(mark);
+}
+
+double AssetLoader::GetMarkTime(const char* name)
+{
+	for (unsigned int i = 0; i < m_marks.size(); i++)
+	{
+		if (m_marks[i].name == name)
+			return m_marks[i].time;
+	}
+
+	return -1.0;
+}
+
+AssetLoaderStats AssetLoader::GetStats()
+{
+	AssetLoaderStats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	for (unsigned int i = 0; i < m_requests.size(); i++)
+	{
+		Request* request = m_requests[i];
+
+		// Still loading, so nothing to count yet
+		if (request->createEndTime == 0.0)
+			continue;
+
+		stats.assetCount++;
+		if (!request->created)
+			stats.failedCount++;
+
+		stats.readyTime = max(stats.readyTime, request->createEndTime);
+		stats.decodeTime += request->decodeEndTime - request->decodeStartTime;
+		stats.createTime += request->createEndTime - request->createStartTime;
+	}
+
+	return stats;
+}
+
+string AssetLoader::GetTimeline()
+{
+	// Everything in milliseconds since the loader was made, which is near enough the start of the game
+	string timeline = "Startup timeline (ms)            queued     decode             create\n";
+	char line[256];
+
+	for (unsigned int i = 0; i < m_requests.size(); i++)
+	{
+		Request* request = m_requests[i];
+
+		// Only the file's name, the folders make the lines too long to read
+		const char* name = request->name.c_str();
+		const char* slash = strrchr(name, '/');
+		if (slash)
+			name = slash + 1;
+
+		snprintf(line, sizeof(line), "  %-28s %8.2f %8.2f - %8.2f %8.2f - %8.2f%s\n", name, request->queuedTime * 1000.0,
+			request->decodeStartTime * 1000.0, request->decodeEndTime * 1000.0,
+			request->createStartTime * 1000.0, request->createEndTime * 1000.0, request->created ? "" : "  FAILED");
+		timeline += line;
+	}
+
+	for (unsigned int i = 0; i < m_marks.size(); i++)
+	{
+		snprintf(line, sizeof(line), "  %-28s %8.2f\n", m_marks[i].name.c_str(), m_marks[i].time * 1000.0);
+		timeline += line;
+	}
+
+	AssetLoaderStats stats = GetStats();
+	snprintf(line, sizeof(line), "  %d assets ready at %.2f ms, %.2f ms of decoding over %d threads, %.2f ms of creating\n",
+		stats.assetCount, stats.readyTime * 1000.0, stats.decodeTime * 1000.0, m_jobs->GetThreadCount(), stats.createTime * 1000.0);
+	timeline += line;
+
+	return timeline;
+}
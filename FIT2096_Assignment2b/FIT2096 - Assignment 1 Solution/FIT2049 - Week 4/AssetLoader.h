@@ -0,0 +1,112 @@
+/*	FIT2096 - Assignment 2b
+*	AssetLoader.h
+*	Loads assets in the background so the menu can go up before they're all in. Each asset is
+*	loaded in two steps. Decode runs as a job on the JobSystem's threads and does the slow part,
+*	reading the file and parsing or decoding it. Create runs later on the thread that owns the
+*	device, inside Update, and does whatever can only happen there, like making buffers and handing
+*	the asset to its manager. Everything that has finished decoding is created in one batch.
+*	Every asset gets a future that becomes ready once it's in its manager (true) or has failed (false).
+*	The loader also remembers when each step started and finished, for the startup timeline.
+*/
+
+#ifndef ASSET_LOADER_H
+#define ASSET_LOADER_H
+
+#include "JobSystem.h"
+
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef std::shared_future<bool> AssetFuture;
+
+// With no other threads to decode on, Update runs this many decodes itself each time it's called
+#define ASSET_LOADER_DECODES_PER_UPDATE 2
+
+// Totals across everything the loader has been asked for, times are in seconds since it was made
+struct AssetLoaderStats
+{
+	int assetCount;
+	int failedCount;
+	double readyTime;		// When the last asset was created
+	double decodeTime;		// Add up every decode, compare with readyTime to see what the threads bought us
+	double createTime;
+};
+
+class AssetLoader
+{
+private:
+	struct Request
+	{
+		std::string name;
+		std::function<bool()> decode;				// Runs on any thread
+		std::function<bool(bool decoded)> create;	// Runs in Update, told whether decode worked
+		std::promise<bool> result;
+		bool decoded;
+		bool created;
+
+		double queuedTime;
+		double decodeStartTime;
+		double decodeEndTime;
+		double createStartTime;
+		double createEndTime;
+	};
+
+	struct Mark
+	{
+		std::string name;
+		double time;
+	};
+
+	JobSystem* m_jobs;
+	JobCounter m_decoding;
+	std::chrono::steady_clock::time_point m_startTime;
+
+	std::vector<Request*> m_requests;	// Everything we've been asked for, in order, kept for the timeline
+	std::vector<Mark> m_marks;
+	int m_pendingCount;					// Not created yet
+
+	// Decodes finish on other threads and wait in here for Update
+	std::mutex m_decodedLock;
+	std::vector<Request*> m_decoded;
+	std::vector<Request*> m_creating;	// Swapped with m_decoded so the creates run without holding the lock
+
+	double GetTime();
+	void Decode(Request* request);
+
+public:
+	// Decodes go on these threads. Only use the loader from the thread that made the JobSystem.
+	AssetLoader(JobSystem* jobs);
+	~AssetLoader();		// Finishes anything still loading first
+
+	// Starts decoding straight away, create happens in a later Update. name has to stay around until then.
+	AssetFuture Load(const char* name, std::function<bool()> decode, std::function<bool(bool decoded)> create);
+
+	// A future that's already done, for assets that were loaded before
+	static AssetFuture Ready(bool result);
+
+	// Creates everything that has finished decoding. Call this regularly from the device's thread.
+	// On a JobSystem with one thread it also does a couple of the decodes, rather than all of them at once.
+	void Update();
+
+	// Waits for every decode (helping out with them) and creates the lot
+	void Finish();
+
+	bool IsFinished() { return m_pendingCount == 0; }
+	int GetAssetCount() { return (int)m_requests.size(); }
+	int GetPendingCount() { return m_pendingCount; }
+
+	// Notes that something happened now (like the menu going up), it shows up in the timeline
+	void AddMark(const char* name);
+	double GetMarkTime(const char* name);	// -1 if there's no mark by that name
+
+	AssetLoaderStats GetStats();
+
+	// One line per asset saying when it was queued, decoded and created, then the marks and totals
+	std::string GetTimeline();
+};
+
+#endif
@@ -0,0 +1,398 @@
+/*	FIT2096 - Assignment 2b
+*	AssetPack.cpp
+*	Implementation of AssetPack.h
+*/
+
+#include "AssetPack.h"
+#include "Lz4.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+// A compressed file has to come out at most this fraction of its size or it's stored instead.
+// Decompressing isn't free, it needs to save a good few reads to pay for itself.
+#define ASSET_PACK_MAX_RATIO 0.875
+
+AssetData::AssetData()
+{
+	m_data = NULL;
+	m_size = 0;
+}
+
+bool AssetData::OpenFile(const char* filename)
+{
+	Clear();
+
+	if (!m_file.Open(filename))
+		return false;
+
+	m_data = m_file.GetData();
+	m_size = m_file.GetSize();
+	return true;
+}
+
+void AssetData::SetData(const char* data, size_t size)
+{
+	Clear();
+
+	m_data = data;
+	m_size = size;
+}
+
+char* AssetData::Allocate(size_t size)
+{
+	Clear();
+
+	// One extra so an empty file still has somewhere to point
+	m_buffer.resize(size + 1);
+	m_data = &m_buffer[0];
+	m_size = size;
+
+	return &m_buffer[0];
+}
+
+void AssetData::Clear()
+{
+	m_file.Close();
+	m_buffer.clear();
+	m_data = NULL;
+	m_size = 0;
+}
+
+AssetPack::AssetPack()
+{
+	m_header = NULL;
+	m_entries = NULL;
+	m_paths = NULL;
+	m_jobs = NULL;
+}
+
+AssetPack::~AssetPack()
+{
+	Close();
+}
+
+bool AssetPack::Open(const char* filename)
+{
+	Close();
+
+	if (!m_file.Open(filename))
+		return false;
+
+	if (!Validate())
+	{
+		Close();
+		return false;
+	}
+
+	return true;
+}
+
+void AssetPack::Close()
+{
+	m_header = NULL;
+	m_entries = NULL;
+	m_paths = NULL;
+	m_file.Close();
+}
+
+bool AssetPack::Validate()
+{
+	const char* data = m_file.GetData();
+	unsigned long long size = m_file.GetSize();
+
+	if (!data || size < sizeof(AssetPackHeader))
+		return false;
+
+	const AssetPackHeader* header = (const AssetPackHeader*)data;
+
+	if (header->magic != ASSET_PACK_MAGIC || header->version != ASSET_PACK_VERSION || header->blockSize == 0)
+		return false;
+
+	// Offsets are checked against the size before anything is added to them, so a corrupt one can't wrap around and look like it fits
+	if (header->entryOffset % 8 != 0 || header->entryOffset < sizeof(AssetPackHeader) || header->entryOffset > size)
+		return false;
+
+	unsigned long long entryEnd = header->entryOffset + (unsigned long long)header->entryCount * sizeof(AssetPackEntry);
+
+	if (entryEnd > size)
+		return false;
+
+	// The paths have to end with a null so none of them can run off the end
+	if (header->pathOffset < entryEnd || header->pathOffset > size || header->pathSize > size - header->pathOffset ||
+		(header->pathSize > 0 && data[header->pathOffset + header->pathSize - 1] != '\0'))
+		return false;
+
+	const AssetPackEntry* entries = (const AssetPackEntry*)(data + header->entryOffset);
+
+	for (unsigned int i = 0; i < header->entryCount; i++)
+	{
+		const AssetPackEntry& entry = entries[i];
+
+		// Sorted with no two the same, or the binary search won't work
+		if (i > 0 && entries[i - 1].pathHash >= entry.pathHash)
+			return false;
+
+		if (entry.pathOffset >= header->pathSize)
+			return false;
+
+		if (entry.offset % ASSET_PACK_ALIGNMENT != 0 || entry.offset > size || entry.storedSize > size - entry.offset)
+			return false;
+
+		if (entry.compression == ASSET_PACK_STORED)
+		{
+			if (entry.storedSize != entry.size)
+				return false;
+		}
+		else if (entry.compression == ASSET_PACK_LZ4)
+		{
+			unsigned long long blockCount = (entry.size + header->blockSize - 1) / header->blockSize;
+
+			if (entry.blockCount != blockCount || (unsigned long long)entry.blockCount * sizeof(unsigned int) > entry.storedSize)
+				return false;
+		}
+		else
+		{
+			return false;
+		}
+	}
+
+	m_header = header;
+	m_entries = entries;
+	m_paths = data + header->pathOffset;
+	return true;
+}
+
+const AssetPackEntry* AssetPack::Find(const char* path)
+{
+	if (!m_header)
+		return NULL;
+
+	unsigned int pathHash = HashPath(path);
+
+	const AssetPackEntry* end = m_entries + m_header->entryCount;
+	const AssetPackEntry* entry = lower_bound(m_entries, end, pathHash,
+		[](const AssetPackEntry& entry, unsigned int hash) { return entry.pathHash < hash; });
+
+	// Only one file can have each hash (Save makes sure), but it might be a different file to the one we want
+	if (entry == end || entry->pathHash != pathHash || strcmp(GetPath(entry), path) != 0)
+		return NULL;
+
+	return entry;
+}
+
+bool AssetPack::Read(const char* path, AssetData* data)
+{
+	const AssetPackEntry* entry = Find(path);
+	if (!entry)
+		return false;
+
+	if (entry->compression == ASSET_PACK_STORED)
+	{
+		data->SetData(m_file.GetData() + entry->offset, (size_t)entry->size);
+		return true;
+	}
+
+	return Decompress(entry, data);
+}
+
+bool AssetPack::Decompress(const AssetPackEntry* entry, AssetData* data)
+{
+	const char* stored = m_file.GetData() + entry->offset;
+	unsigned int blockSize = m_header->blockSize;
+	int blockCount = (int)entry->blockCount;
+
+	// Each block's compressed size is at the start, add them up to find where each one begins
+	const unsigned int* blockSizes = (const unsigned int*)stored;
+	vector<unsigned long long> blockOffsets(blockCount + 1);
+	blockOffsets[0] = (unsigned long long)blockCount * sizeof(unsigned int);
+
+	for (int i = 0; i < blockCount; i++)
+	{
+		blockOffsets[i + 1] = blockOffsets[i] + (blockSizes[i] & ~ASSET_PACK_BLOCK_STORED);
+	}
+
+	if (blockOffsets[blockCount] != entry->storedSize)
+		return false;
+
+	char* destination = data->Allocate((size_t)entry->size);
+	atomic<int> failedCount(0);
+
+	// Every block is on its own so they can all go at once. Each is tens of microseconds of work, enough to be worth a job.
+	ParallelFor(m_jobs, blockCount, 1, [&](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			const char* source = stored + blockOffsets[i];
+			size_t sourceSize = (size_t)(blockOffsets[i + 1] - blockOffsets[i]);
+			size_t offset = (size_t)i * blockSize;
+			size_t size = (size_t)min<unsigned long long>(blockSize, entry->size - offset);
+
+			if (blockSizes[i] & ASSET_PACK_BLOCK_STORED)
+			{
+				if (sourceSize != size)
+					failedCount++;
+				else
+					memcpy(destination + offset, source, size);
+			}
+			else if (!Lz4::Decompress(source, sourceSize, destination + offset, size))
+			{
+				failedCount++;
+			}
+		}
+	});
+
+	if (failedCount > 0)
+	{
+		data->Clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool AssetPack::ReadAsset(AssetPack* pack, const char* path, AssetData* data)
+{
+	if (pack && pack->IsOpen() && pack->Read(path, data))
+		return true;
+
+	return data->OpenFile(path);
+}
+
+// Compresses one source the way Decompress reads it back. False if it isn't worth it.
+static bool CompressSource(const AssetPackSource& source, vector<char>* stored)
+{
+	size_t blockCount = (source.size + ASSET_PACK_BLOCK_SIZE - 1) / ASSET_PACK_BLOCK_SIZE;
+
+	stored->assign(blockCount * sizeof(unsigned int), 0);
+	vector<char> block(Lz4::GetMaxCompressedSize(ASSET_PACK_BLOCK_SIZE));
+
+	for (size_t i = 0; i < blockCount; i++)
+	{
+		const char* data = source.data + i * ASSET_PACK_BLOCK_SIZE;
+		size_t size = min<size_t>(ASSET_PACK_BLOCK_SIZE, source.size - i * ASSET_PACK_BLOCK_SIZE);
+
+		size_t compressedSize = Lz4::Compress(data, size, &block[0], block.size());
+		unsigned int blockSize;
+
+		if (compressedSize == 0 || compressedSize >= size)
+		{
+			blockSize = (unsigned int)size | ASSET_PACK_BLOCK_STORED;
+			stored->insert(stored->end(), data, data + size);
+		}
+		else
+		{
+			blockSize = (unsigned int)compressedSize;
+			stored->insert(stored->end(), block.begin(), block.begin() + compressedSize);
+		}
+
+		memcpy(&(*stored)[i * sizeof(unsigned int)], &blockSize, sizeof(blockSize));
+	}
+
+	return stored->size() <= source.size * ASSET_PACK_MAX_RATIO;
+}
+
+static unsigned long long Align(unsigned long long offset)
+{
+	return (offset + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+}
+
+bool AssetPack::Save(const char* filename, const vector<AssetPackSource>& sources)
+{
+	// The table goes out sorted by hash, so work out that order first
+	vector<unsigned int> order(sources.size());
+	for (unsigned int i = 0; i < sources.size(); i++)
+	{
+		order[i] = i;
+	}
+
+	sort(order.begin(), order.end(), [&sources](unsigned int a, unsigned int b)
+		{ return HashPath(sources[a].path.c_str()) < HashPath(sources[b].path.c_str()); });
+
+	AssetPackHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = ASSET_PACK_MAGIC;
+	header.version = ASSET_PACK_VERSION;
+	header.entryCount = (unsigned int)sources.size();
+	header.blockSize = ASSET_PACK_BLOCK_SIZE;
+	header.entryOffset = sizeof(AssetPackHeader);
+
+	vector<AssetPackEntry> entries(sources.size());
+	vector<vector<char> > compressed(sources.size());
+	string paths;
+
+	for (unsigned int i = 0; i < order.size(); i++)
+	{
+		const AssetPackSource& source = sources[order[i]];
+		AssetPackEntry& entry = entries[i];
+
+		memset(&entry, 0, sizeof(entry));
+		entry.pathHash = HashPath(source.path.c_str());
+		entry.pathOffset = (unsigned int)paths.size();
+		entry.size = source.size;
+
+		if (i > 0 && entries[i - 1].pathHash == entry.pathHash)
+			return false;
+
+		paths += source.path;
+		paths += '\0';
+
+		if (source.compress && source.size > 0 && CompressSource(source, &compressed[i]))
+		{
+			entry.compression = ASSET_PACK_LZ4;
+			entry.blockCount = (unsigned int)((source.size + ASSET_PACK_BLOCK_SIZE - 1) / ASSET_PACK_BLOCK_SIZE);
+			entry.storedSize = compressed[i].size();
+		}
+		else
+		{
+			compressed[i].clear();
+			entry.compression = ASSET_PACK_STORED;
+			entry.storedSize = source.size;
+		}
+	}
+
+	header.pathOffset = header.entryOffset + entries.size() * sizeof(AssetPackEntry);
+	header.pathSize = paths.size();
+
+	// Now everything's size is known the data can be laid out after the paths
+	unsigned long long offset = header.pathOffset + header.pathSize;
+	for (unsigned int i = 0; i < entries.size(); i++)
+	{
+		entries[i].offset = Align(offset);
+		offset = entries[i].offset + entries[i].storedSize;
+	}
+
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		(entries.empty() || fwrite(&entries[0], sizeof(AssetPackEntry), entries.size(), file) == entries.size()) &&
+		fwrite(paths.data(), 1, paths.size(), file) == paths.size();
+
+	const char padding[ASSET_PACK_ALIGNMENT] = { 0 };
+	offset = header.pathOffset + header.pathSize;
+
+	for (unsigned int i = 0; i < entries.size() && written; i++)
+	{
+		const AssetPackSource& source = sources[order[i]];
+		const char* data = entries[i].compression == ASSET_PACK_STORED ? source.data : &compressed[i][0];
+		size_t size = (size_t)entries[i].storedSize;
+
+		size_t paddingSize = (size_t)(entries[i].offset - offset);
+		written = fwrite(padding, 1, paddingSize, file) == paddingSize && fwrite(data, 1, size, file) == size;
+		offset = entries[i].offset + entries[i].storedSize;
+	}
+
+	if (fclose(file) != 0 || !written)
+	{
+		remove(filename);
+		return false;
+	}
+
+	return true;
+}
@@ -0,0 +1,147 @@
+/*	FIT2096 - Assignment 2b
+*	AssetPack.h
+*	Every file under Assets in one .pak, so starting the game is one open and one mapping instead of
+*	an open, a few seeks and a close for every mesh, texture, font and sound. assetpack makes it.
+*
+*	The file is an AssetPackHeader, then the table of contents (one AssetPackEntry per file, sorted by
+*	the HashPath of its path so finding one is a binary search), then the paths themselves, then the
+*	data for each file starting on a 64 byte boundary. Everything is little endian.
+*
+*	Files are stored as they are, or as LZ4 when that makes them a good bit smaller. A compressed
+*	file is cut into blocks of blockSize before it's compressed, and each block is compressed on its
+*	own, so the blocks can be decompressed on every thread at once. The data starts with one
+*	unsigned int per block giving its compressed size, then the blocks back to back. A block that
+*	didn't get any smaller is stored as it was, with ASSET_PACK_BLOCK_STORED set on its size.
+*
+*	Reading a stored file copies nothing, it's handed back as a pointer into the mapping.
+*/
+
+#ifndef ASSET_PACK_H
+#define ASSET_PACK_H
+
+#include "JobSystem.h"
+#include "MappedFile.h"
+#include "ResourceHandle.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#define ASSET_PACK_MAGIC 0x4b415041		// "APAK"
+#define ASSET_PACK_VERSION 1
+#define ASSET_PACK_FILENAME "Assets.pak"	// Where the game looks for one, next to the Assets folder
+#define ASSET_PACK_ALIGNMENT 64				// A cache line, so nothing read in place straddles one it doesn't need to
+#define ASSET_PACK_BLOCK_SIZE (64 * 1024)
+#define ASSET_PACK_BLOCK_STORED 0x80000000
+
+enum AssetPackCompression
+{
+	ASSET_PACK_STORED = 0,
+	ASSET_PACK_LZ4
+};
+
+struct AssetPackHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int entryCount;
+	unsigned int blockSize;				// What compressed files were cut into
+	unsigned long long entryOffset;		// From the start of the file
+	unsigned long long pathOffset;
+	unsigned long long pathSize;		// Every path, each with its null on the end
+	unsigned int reserved[6];			// Keeps the header a whole cache line
+};
+
+struct AssetPackEntry
+{
+	unsigned int pathHash;				// HashPath of the path, the table is sorted by this
+	unsigned int pathOffset;			// Into the paths
+	unsigned long long offset;			// From the start of the file, always a multiple of ASSET_PACK_ALIGNMENT
+	unsigned long long size;			// Of the file itself
+	unsigned long long storedSize;		// What it takes up in the pack
+	unsigned int compression;			// An AssetPackCompression
+	unsigned int blockCount;			// 0 when stored
+};
+
+// A file going into a pack
+struct AssetPackSource
+{
+	std::string path;		// What the game will ask for it by, like "Assets/Meshes/enemy.obj"
+	const char* data;
+	size_t size;
+	bool compress;			// Try LZ4 on it, it's only kept if it saves enough
+};
+
+// The bytes of one asset. They're either straight out of a mapped file (the pack, or the file itself
+// when there's no pack) or, when they were compressed, a copy we own.
+class AssetData
+{
+private:
+	MappedFile m_file;
+	std::vector<char> m_buffer;
+	const char* m_data;
+	size_t m_size;
+
+	AssetData(const AssetData&);
+	AssetData& operator=(const AssetData&);
+
+public:
+	AssetData();
+
+	bool OpenFile(const char* filename);
+	void SetData(const char* data, size_t size);	// Somebody else's memory, it has to outlive this
+	char* Allocate(size_t size);					// Our own buffer to fill in
+	void Clear();
+
+	const char* GetData() { return m_data; }
+	size_t GetSize() { return m_size; }
+
+	// False when the data is our own copy and goes away with us. True when it's someone else's
+	// memory, which for the pack lasts as long as the pack stays open.
+	bool IsMapped() { return m_buffer.empty(); }
+};
+
+class AssetPack
+{
+private:
+	MappedFile m_file;
+	const AssetPackHeader* m_header;	// NULL while closed
+	const AssetPackEntry* m_entries;
+	const char* m_paths;
+	JobSystem* m_jobs;
+
+	bool Validate();
+	bool Decompress(const AssetPackEntry* entry, AssetData* data);
+
+public:
+	AssetPack();
+	~AssetPack();
+
+	// Checks the header and every entry up front, so reads can trust the offsets
+	bool Open(const char* filename);
+	void Close();
+	bool IsOpen() { return m_header != NULL; }
+
+	// Compressed files are decompressed on these threads. Without any it all happens on the caller's.
+	void SetJobSystem(JobSystem* jobs) { m_jobs = jobs; }
+
+	// NULL if the pack doesn't have the file
+	const AssetPackEntry* Find(const char* path);
+	bool Contains(const char* path) { return Find(path) != NULL; }
+
+	// Safe from any number of threads at once
+	bool Read(const char* path, AssetData* data);
+
+	int GetEntryCount() { return m_header ? (int)m_header->entryCount : 0; }
+	const AssetPackEntry* GetEntry(int index) { return &m_entries[index]; }
+	const char* GetPath(const AssetPackEntry* entry) { return m_paths + entry->pathOffset; }
+	size_t GetSize() { return m_file.GetSize(); }
+
+	// Out of the pack when it's open and has the file, otherwise the file itself. pack can be NULL.
+	static bool ReadAsset(AssetPack* pack, const char* path, AssetData* data);
+
+	// Writes a pack holding sources. Fails if two paths have the same hash.
+	static bool Save(const char* filename, const std::vector<AssetPackSource>& sources);
+};
+
+#endif
@@ -5,12 +5,25 @@ cbuffer MatrixBuffer
 	matrix projection;
 };
 
+// The engine compiles this once per vertex format (see VertexFormat.cpp) with macros saying
+// which attributes are packed. Packed ones are unpacked in GetNormal and GetColour below.
+// InstancedShader also defines INSTANCED, and then each copy of the mesh is moved on by its
+// instance offset and passes its texture array layer through to the pixel shader.
 struct VertexInput
 {
 	float4 position : POSITION;
+#ifndef VERTEX_NO_COLOUR
 	float4 colour : COLOR;
+#endif
+#ifdef VERTEX_NORMAL_OCTAHEDRAL
+	float2 normal : NORMAL;
+#else
 	float3 normal : NORMAL;
+#endif
 	float2 uv : TEXCOORD;
+#ifdef INSTANCED
+	float4 instance : INSTANCE;
+#endif
 };
 
 struct PixelInput
@@ -19,8 +32,36 @@ struct PixelInput
 	float4 colour : COLOR;
 	float3 normal : NORMAL;
 	float2 uv : TEXCOORD;
+#ifdef INSTANCED
+	nointerpolation float layer : LAYER;
+#endif
 };
 
+float3 GetNormal(VertexInput input)
+{
+#if defined(VERTEX_NORMAL_OCTAHEDRAL)
+	// Unfold the square back onto the octahedron, the bottom half was folded out over the corners
+	float3 normal = float3(input.normal.xy, 1.0f - abs(input.normal.x) - abs(input.normal.y));
+	float fold = saturate(-normal.z);
+	normal.xy += normal.xy >= 0.0f ? -fold : fold;
+	return normalize(normal);
+#elif defined(VERTEX_NORMAL_UNORM)
+	// Stored in 0..1, so stretch it back out to -1..1
+	return input.normal * 2.0f - 1.0f;
+#else
+	return input.normal;
+#endif
+}
+
+float4 GetColour(VertexInput input)
+{
+#ifdef VERTEX_NO_COLOUR
+	return float4(1.0f, 1.0f, 1.0f, 1.0f);
+#else
+	return input.colour;
+#endif
+}
+
 PixelInput main(VertexInput input)
 {
 	PixelInput output;
@@ -29,6 +70,12 @@ PixelInput main(VertexInput input)
 	// Model to world space
 	float4 position = mul(input.position, world);
 
+#ifdef INSTANCED
+	// Instances only move, so the offset goes on after the world matrix
+	position.xyz += input.instance.xyz;
+	output.layer = input.instance.w;
+#endif
+
 	// World space to view space
 	position = mul(position, view);
 
@@ -40,10 +87,10 @@ PixelInput main(VertexInput input)
 
 	// Transform normal from model to world space
 	// Lighting calculations need world space normals otherwise lighting won't change when the object rotates
-	output.normal = mul(input.normal, (float3x3)world);
+	output.normal = mul(GetNormal(input), (float3x3)world);
 
 	// Pass through colour and texture coordinates unchanged
-	output.colour = input.colour;
+	output.colour = GetColour(input);
 	output.uv = input.uv;
 	
 	return output;
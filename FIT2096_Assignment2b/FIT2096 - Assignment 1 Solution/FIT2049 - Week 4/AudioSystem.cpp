@@ -1,9 +1,11 @@
 #include "AudioSystem.h"
+#include <cstring>
 #include <iostream>
 
 AudioSystem::AudioSystem()
 {
 	m_audioEngine = NULL;
+	m_assetPack = NULL;
 }
 
 bool AudioSystem::Initialise()
@@ -33,11 +35,11 @@ bool AudioSystem::Load(const char* filepath)
 {
 	FMOD::Sound* sound;
 
-	if (!DidSucceed(m_audioEngine->createSound(filepath, FMOD_DEFAULT, NULL, &sound)))
+	if (!OpenSound(filepath, false, &sound))
 		return false;
 
 	// Add the sound to our audio map so we can easily retrieve it when we are told to play it
-	m_audioMap[filepath] = sound;
+	AddSound(filepath, sound);
 
 	return true;
 }
@@ -50,15 +52,47 @@ bool AudioSystem::LoadStream(const char* filepath)
 
 	FMOD::Sound* sound;
 
-	if (!DidSucceed(m_audioEngine->createStream(filepath, FMOD_DEFAULT, NULL, &sound)))
+	if (!OpenSound(filepath, true, &sound))
 		return false;
 
 	// Add sound to our audio map so we can easily retrieve it when we are told to play it
-	m_audioMap[filepath] = sound;
+	AddSound(filepath, sound);
 
 	return true;
 }
 
+bool AudioSystem::OpenSound(const char* filepath, bool stream, FMOD::Sound** sound)
+{
+	AssetData data;
+
+	if (m_assetPack && m_assetPack->IsOpen() && m_assetPack->Read(filepath, &data))
+	{
+		// FMOD reads the sound out of memory instead of opening the file
+		FMOD_CREATESOUNDEXINFO info;
+		memset(&info, 0, sizeof(info));
+		info.cbsize = sizeof(info);
+		info.length = (unsigned int)data.GetSize();
+
+		// A stream keeps reading from the memory for as long as it plays. That's fine when it's the pack's mapping,
+		// but a decompressed copy goes away when we return, so those are decoded into a sound up front instead.
+		if (stream && data.IsMapped())
+			return DidSucceed(m_audioEngine->createStream(data.GetData(), FMOD_DEFAULT | FMOD_OPENMEMORY, &info, sound));
+
+		return DidSucceed(m_audioEngine->createSound(data.GetData(), FMOD_DEFAULT | FMOD_OPENMEMORY, &info, sound));
+	}
+
+	// FMOD's own calls are safe from any thread unless it was told otherwise in init
+	if (stream)
+		return DidSucceed(m_audioEngine->createStream(filepath, FMOD_DEFAULT, NULL, sound));
+
+	return DidSucceed(m_audioEngine->createSound(filepath, FMOD_DEFAULT, NULL, sound));
+}
+
+void AudioSystem::AddSound(const char* filepath, FMOD::Sound* sound)
+{
+	m_audioMap[filepath] = sound;
+}
+
 AudioClip* AudioSystem::Play(const char* filepath, bool startPaused)
 {
 	// Pull the sound we want to play out of the map
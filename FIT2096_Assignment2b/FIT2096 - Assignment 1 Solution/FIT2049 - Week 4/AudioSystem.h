@@ -11,11 +11,13 @@
 
 #include <d3d11.h>
 #include <map>
+#include <string>
 
 #include "DirectXTK/SimpleMath.h"
 #include "fmod.hpp"
 #include "fmod_errors.h"
 #include "AudioClip.h"
+#include "AssetPack.h"
 
 using namespace DirectX::SimpleMath;
 
@@ -25,6 +27,9 @@ private:
 	// This object is how we talk to FMOD
 	FMOD::System* m_audioEngine;
 
+	// Sounds it has are played straight out of its mapping, so it has to stay open until Shutdown
+	AssetPack* m_assetPack;
+
 	// Map actual sounds to a string just like we do in the mesh and texture managers
 	typedef std::map<std::string, FMOD::Sound*> AudioMap;
 	AudioMap m_audioMap;
@@ -43,8 +48,15 @@ public:
 	void Shutdown();
 	void Update();
 
+	void SetAssetPack(AssetPack* pack) { m_assetPack = pack; }
+
 	bool Load(const char* filepath);
 	bool LoadStream(const char* filepath);
+
+	// Load split in two so the slow part can go on another thread. OpenSound is safe on any thread
+	// (it doesn't touch the map), AddSound makes the sound playable and belongs on the game's thread.
+	bool OpenSound(const char* filepath, bool stream, FMOD::Sound** sound);
+	void AddSound(const char* filepath, FMOD::Sound* sound);
 	bool ReleaseSound(const char* filepath);
 
 	AudioClip* Play(const char* filepath, bool startPaused);
@@ -0,0 +1,644 @@
+/*	FIT2096 - Assignment 2b
+*	BlockCompression.cpp
+*	Implementation of BlockCompression.h
+*/
+
+#include "BlockCompression.h"
+
+#include <cmath>
+#include <cstring>
+
+// How far along the line each of BC7's 16 steps is, out of 64
+static const int BC7_WEIGHTS[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static int Clamp(int value, int minimum, int maximum)
+{
+	return value < minimum ? minimum : (value > maximum ? maximum : value);
+}
+
+// The mean of the points and the direction they're most spread out along, found by power iteration on their covariance.
+// Only the first channels channels are used.
+static void FindAxis(const float points[16][4], int count, int channels, float* mean, float* axis)
+{
+	for (int c = 0; c < channels; c++)
+	{
+		mean[c] = 0.0f;
+		for (int i = 0; i < count; i++)
+			mean[c] += points[i][c];
+		mean[c] /= count;
+	}
+
+	float covariance[4][4];
+	memset(covariance, 0, sizeof(covariance));
+
+	for (int i = 0; i < count; i++)
+	{
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = 0; b < channels; b++)
+				covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+		}
+	}
+
+	for (int c = 0; c < channels; c++)
+		axis[c] = 1.0f;
+
+	for (int iteration = 0; iteration < 8; iteration++)
+	{
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float length = 0.0f;
+
+		for (int a = 0; a < channels; a++)
+		{
+			for (int b = 0; b < channels; b++)
+				next[a] += covariance[a][b] * axis[b];
+			length += next[a] * next[a];
+		}
+
+		// Every point is the same, any direction will do
+		if (length < 1e-8f)
+			return;
+
+		length = sqrtf(length);
+		for (int c = 0; c < channels; c++)
+			axis[c] = next[c] / length;
+	}
+}
+
+// The two ends of the line through the points, as far along the axis as the points go
+static void FindEndpoints(const float points[16][4], int count, int channels, float* start, float* end)
+{
+	float mean[4];
+	float axis[4];
+	FindAxis(points, count, channels, mean, axis);
+
+	float minimum = 0.0f;
+	float maximum = 0.0f;
+
+	for (int i = 0; i < count; i++)
+	{
+		float along = 0.0f;
+		for (int c = 0; c < channels; c++)
+			along += (points[i][c] - mean[c]) * axis[c];
+
+		minimum = along < minimum ? along : minimum;
+		maximum = along > maximum ? along : maximum;
+	}
+
+	for (int c = 0; c < channels; c++)
+	{
+		start[c] = fminf(fmaxf(mean[c] + axis[c] * minimum, 0.0f), 255.0f);
+		end[c] = fminf(fmaxf(mean[c] + axis[c] * maximum, 0.0f), 255.0f);
+	}
+}
+
+static unsigned short To565(const float* colour)
+{
+	int r = Clamp((int)(colour[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+	int g = Clamp((int)(colour[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+	int b = Clamp((int)(colour[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+	return (unsigned short)((r << 11) | (g << 5) | b);
+}
+
+static void From565(unsigned short colour, int* rgb)
+{
+	int r = colour >> 11;
+	int g = (colour >> 5) & 63;
+	int b = colour & 31;
+
+	rgb[0] = (r << 3) | (r >> 2);
+	rgb[1] = (g << 2) | (g >> 4);
+	rgb[2] = (b << 3) | (b >> 2);
+}
+
+// Four colours, or with threeColours the third is halfway and the fourth is transparent black
+static void BuildColourPalette(unsigned short colour0, unsigned short colour1, bool threeColours, int palette[4][4])
+{
+	From565(colour0, palette[0]);
+	From565(colour1, palette[1]);
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+
+	for (int c = 0; c < 3; c++)
+	{
+		if (threeColours)
+		{
+			palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+			palette[3][c] = 0;
+		}
+		else
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+		}
+	}
+
+	palette[2][3] = 255;
+	palette[3][3] = threeColours ? 0 : 255;
+}
+
+// Picks the nearest colour for each pixel. Transparent pixels get index 3, which has to be the transparent one.
+// Returns the total squared error.
+static int FitColours(const unsigned char* pixels, const bool* transparent, int palette[4][4], int usable, unsigned int* indices)
+{
+	int error = 0;
+	*indices = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 3;
+		int bestError = 0;
+
+		if (!transparent[i])
+		{
+			bestError = 0x7fffffff;
+			for (int p = 0; p < usable; p++)
+			{
+				int dr = pixels[i * 4 + 0] - palette[p][0];
+				int dg = pixels[i * 4 + 1] - palette[p][1];
+				int db = pixels[i * 4 + 2] - palette[p][2];
+				int distance = dr * dr + dg * dg + db * db;
+
+				if (distance < bestError)
+				{
+					best = p;
+					bestError = distance;
+				}
+			}
+		}
+
+		error += bestError;
+		*indices |= (unsigned int)best << (i * 2);
+	}
+
+	return error;
+}
+
+static void WriteColourBlock(unsigned short colour0, unsigned short colour1, unsigned int indices, unsigned char* block)
+{
+	block[0] = (unsigned char)(colour0 & 0xff);
+	block[1] = (unsigned char)(colour0 >> 8);
+	block[2] = (unsigned char)(colour1 & 0xff);
+	block[3] = (unsigned char)(colour1 >> 8);
+	block[4] = (unsigned char)(indices & 0xff);
+	block[5] = (unsigned char)((indices >> 8) & 0xff);
+	block[6] = (unsigned char)((indices >> 16) & 0xff);
+	block[7] = (unsigned char)(indices >> 24);
+}
+
+// The colour half of BC1 and BC3. BC1 has a second mode with three colours and a transparent one, which it's told
+// to use by putting the smaller colour first. BC3 always has four colours whichever way round they are.
+static void EncodeColours(const unsigned char* pixels, bool allowTransparent, unsigned char* block)
+{
+	bool transparent[16];
+	bool anyTransparent = false;
+
+	float points[16][4];
+	int count = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		transparent[i] = allowTransparent && pixels[i * 4 + 3] < 128;
+		anyTransparent = anyTransparent || transparent[i];
+
+		if (!transparent[i])
+		{
+			for (int c = 0; c < 3; c++)
+				points[count][c] = pixels[i * 4 + c];
+			count++;
+		}
+	}
+
+	if (count == 0)
+	{
+		// Nothing but transparent, equal colours pick the three colour mode and index 3 everywhere
+		WriteColourBlock(0, 0, 0xffffffff, block);
+		return;
+	}
+
+	// Try the principal axis and the bounding box, keep whichever fits better
+	float starts[2][4];
+	float ends[2][4];
+	FindEndpoints(points, count, 3, starts[0], ends[0]);
+
+	for (int c = 0; c < 3; c++)
+	{
+		starts[1][c] = 255.0f;
+		ends[1][c] = 0.0f;
+
+		for (int i = 0; i < count; i++)
+		{
+			starts[1][c] = fminf(starts[1][c], points[i][c]);
+			ends[1][c] = fmaxf(ends[1][c], points[i][c]);
+		}
+	}
+
+	int bestError = 0x7fffffff;
+
+	for (int candidate = 0; candidate < 2; candidate++)
+	{
+		unsigned short colour0 = To565(ends[candidate]);
+		unsigned short colour1 = To565(starts[candidate]);
+
+		// BC1 picks its mode from the order, bigger first means four colours
+		bool threeColours = false;
+
+		if (allowTransparent)
+		{
+			threeColours = anyTransparent || colour0 == colour1;
+
+			if ((threeColours && colour0 > colour1) || (!threeColours && colour0 < colour1))
+			{
+				unsigned short swap = colour0;
+				colour0 = colour1;
+				colour1 = swap;
+			}
+		}
+
+		int palette[4][4];
+		BuildColourPalette(colour0, colour1, threeColours, palette);
+
+		unsigned int indices;
+		int error = FitColours(pixels, transparent, palette, threeColours ? 3 : 4, &indices);
+
+		if (error < bestError)
+		{
+			bestError = error;
+			WriteColourBlock(colour0, colour1, indices, block);
+		}
+	}
+}
+
+bool BlockCompression::IsCompressed(DXGI_FORMAT format)
+{
+	return format == DXGI_FORMAT_BC1_UNORM || format == DXGI_FORMAT_BC3_UNORM || format == DXGI_FORMAT_BC7_UNORM;
+}
+
+unsigned int BlockCompression::GetBlockSize(DXGI_FORMAT format)
+{
+	return format == DXGI_FORMAT_BC1_UNORM ? 8 : 16;
+}
+
+void BlockCompression::EncodeBC1(const unsigned char* pixels, unsigned char* block)
+{
+	EncodeColours(pixels, true, block);
+}
+
+void BlockCompression::EncodeBC3(const unsigned char* pixels, unsigned char* block)
+{
+	int minimum = 255;
+	int maximum = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		minimum = pixels[i * 4 + 3] < minimum ? pixels[i * 4 + 3] : minimum;
+		maximum = pixels[i * 4 + 3] > maximum ? pixels[i * 4 + 3] : maximum;
+	}
+
+	// Biggest first gives eight alphas, six of them in between. If they're equal it's the other mode, but index 0 is still alpha 0.
+	int palette[8];
+	palette[0] = maximum;
+	palette[1] = minimum;
+	for (int i = 2; i < 8; i++)
+	{
+		palette[i] = ((8 - i) * maximum + (i - 1) * minimum) / 7;
+	}
+
+	unsigned long long indices = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		int best = 0;
+		int bestError = 256;
+
+		for (int p = 0; p < (maximum == minimum ? 1 : 8); p++)
+		{
+			int error = pixels[i * 4 + 3] - palette[p];
+			error = error < 0 ? -error : error;
+
+			if (error < bestError)
+			{
+				best = p;
+				bestError = error;
+			}
+		}
+
+		indices |= (unsigned long long)best << (i * 3);
+	}
+
+	block[0] = (unsigned char)maximum;
+	block[1] = (unsigned char)minimum;
+	for (int i = 0; i < 6; i++)
+	{
+		block[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xff);
+	}
+
+	EncodeColours(pixels, false, block + 8);
+}
+
+// BC7 is a stream of fields of odd sizes, lowest bit first
+static void WriteBits(unsigned char* block, int* position, unsigned int value, int bits)
+{
+	for (int i = 0; i < bits; i++, (*position)++)
+	{
+		if ((value >> i) & 1)
+			block[*position >> 3] |= (unsigned char)(1 << (*position & 7));
+	}
+}
+
+static unsigned int ReadBits(const unsigned char* block, int* position, int bits)
+{
+	unsigned int value = 0;
+
+	for (int i = 0; i < bits; i++, (*position)++)
+	{
+		value |= (unsigned int)((block[*position >> 3] >> (*position & 7)) & 1) << i;
+	}
+
+	return value;
+}
+
+// Mode 6 endpoints are 7 bits a channel plus one low bit shared by all four. Tries both low bits and keeps the closer.
+static void QuantiseBC7Endpoint(const float* endpoint, int* quantised, int* lowBit)
+{
+	int bestError = 0x7fffffff;
+
+	for (int p = 0; p < 2; p++)
+	{
+		int values[4];
+		int error = 0;
+
+		for (int c = 0; c < 4; c++)
+		{
+			values[c] = Clamp((int)floorf((endpoint[c] - p) / 2.0f + 0.5f), 0, 127);
+			int difference = ((values[c] << 1) | p) - (int)(endpoint[c] + 0.5f);
+			error += difference * difference;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+			*lowBit = p;
+			memcpy(quantised, values, sizeof(values));
+		}
+	}
+}
+
+void BlockCompression::EncodeBC7(const unsigned char* pixels, unsigned char* block)
+{
+	float points[16][4];
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 4; c++)
+			points[i][c] = pixels[i * 4 + c];
+	}
+
+	float ends[2][4];
+	FindEndpoints(points, 16, 4, ends[0], ends[1]);
+
+	int quantised[2][4];
+	int lowBits[2];
+	QuantiseBC7Endpoint(ends[0], quantised[0], &lowBits[0]);
+	QuantiseBC7Endpoint(ends[1], quantised[1], &lowBits[1]);
+
+	int palette[16][4];
+	for (int c = 0; c < 4; c++)
+	{
+		int start = (quantised[0][c] << 1) | lowBits[0];
+		int end = (quantised[1][c] << 1) | lowBits[1];
+
+		for (int i = 0; i < 16; i++)
+			palette[i][c] = ((64 - BC7_WEIGHTS[i]) * start + BC7_WEIGHTS[i] * end + 32) >> 6;
+	}
+
+	int indices[16];
+	for (int i = 0; i < 16; i++)
+	{
+		int bestError = 0x7fffffff;
+
+		for (int p = 0; p < 16; p++)
+		{
+			int error = 0;
+			for (int c = 0; c < 4; c++)
+			{
+				int difference = pixels[i * 4 + c] - palette[p][c];
+				error += difference * difference;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+				indices[i] = p;
+			}
+		}
+	}
+
+	// The first index only gets three bits, its top bit is taken to be 0. Swapping the ends round makes it so.
+	if (indices[0] >= 8)
+	{
+		for (int c = 0; c < 4; c++)
+		{
+			int swap = quantised[0][c];
+			quantised[0][c] = quantised[1][c];
+			quantised[1][c] = swap;
+		}
+
+		int swap = lowBits[0];
+		lowBits[0] = lowBits[1];
+		lowBits[1] = swap;
+
+		for (int i = 0; i < 16; i++)
+			indices[i] = 15 - indices[i];
+	}
+
+	memset(block, 0, 16);
+	int position = 0;
+
+	WriteBits(block, &position, 1 << 6, 7);		// Mode 6 is six zeros then a one
+	for (int c = 0; c < 4; c++)
+	{
+		WriteBits(block, &position, quantised[0][c], 7);
+		WriteBits(block, &position, quantised[1][c], 7);
+	}
+
+	WriteBits(block, &position, lowBits[0], 1);
+	WriteBits(block, &position, lowBits[1], 1);
+
+	for (int i = 0; i < 16; i++)
+		WriteBits(block, &position, indices[i], i == 0 ? 3 : 4);
+}
+
+// The colour half of BC1, or of BC3 which always has four colours
+static void DecodeColours(const unsigned char* block, bool allowThreeColours, unsigned char* pixels)
+{
+	unsigned short colour0 = (unsigned short)(block[0] | (block[1] << 8));
+	unsigned short colour1 = (unsigned short)(block[2] | (block[3] << 8));
+	unsigned int indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((unsigned int)block[7] << 24);
+
+	int palette[4][4];
+	BuildColourPalette(colour0, colour1, allowThreeColours && colour0 <= colour1, palette);
+
+	for (int i = 0; i < 16; i++)
+	{
+		int index = (indices >> (i * 2)) & 3;
+		for (int c = 0; c < 4; c++)
+			pixels[i * 4 + c] = (unsigned char)palette[index][c];
+	}
+}
+
+void BlockCompression::DecodeBC1(const unsigned char* block, unsigned char* pixels)
+{
+	DecodeColours(block, true, pixels);
+}
+
+void BlockCompression::DecodeBC3(const unsigned char* block, unsigned char* pixels)
+{
+	DecodeColours(block + 8, false, pixels);
+
+	int alpha0 = block[0];
+	int alpha1 = block[1];
+
+	int palette[8];
+	palette[0] = alpha0;
+	palette[1] = alpha1;
+
+	if (alpha0 > alpha1)
+	{
+		for (int i = 2; i < 8; i++)
+			palette[i] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+	}
+	else
+	{
+		for (int i = 2; i < 6; i++)
+			palette[i] = ((6 - i) * alpha0 + (i - 1) * alpha1) / 5;
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	unsigned long long indices = 0;
+	for (int i = 0; i < 6; i++)
+	{
+		indices |= (unsigned long long)block[2 + i] << (i * 8);
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		pixels[i * 4 + 3] = (unsigned char)palette[(indices >> (i * 3)) & 7];
+	}
+}
+
+bool BlockCompression::DecodeBC7(const unsigned char* block, unsigned char* pixels)
+{
+	// The mode is the number of zeros before the first one
+	if ((block[0] & 0x7f) != 1 << 6)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			pixels[i * 4 + 0] = 255;
+			pixels[i * 4 + 1] = 0;
+			pixels[i * 4 + 2] = 255;
+			pixels[i * 4 + 3] = 255;
+		}
+
+		return false;
+	}
+
+	int position = 7;
+	int endpoints[2][4];
+
+	for (int c = 0; c < 4; c++)
+	{
+		endpoints[0][c] = ReadBits(block, &position, 7);
+		endpoints[1][c] = ReadBits(block, &position, 7);
+	}
+
+	int lowBit0 = ReadBits(block, &position, 1);
+	int lowBit1 = ReadBits(block, &position, 1);
+
+	for (int c = 0; c < 4; c++)
+	{
+		endpoints[0][c] = (endpoints[0][c] << 1) | lowBit0;
+		endpoints[1][c] = (endpoints[1][c] << 1) | lowBit1;
+	}
+
+	for (int i = 0; i < 16; i++)
+	{
+		int index = ReadBits(block, &position, i == 0 ? 3 : 4);
+
+		for (int c = 0; c < 4; c++)
+		{
+			pixels[i * 4 + c] = (unsigned char)(((64 - BC7_WEIGHTS[index]) * endpoints[0][c] + BC7_WEIGHTS[index] * endpoints[1][c] + 32) >> 6);
+		}
+	}
+
+	return true;
+}
+
+bool BlockCompression::Encode(DXGI_FORMAT format, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned char* blocks)
+{
+	if (!IsCompressed(format))
+		return false;
+
+	unsigned int blockSize = GetBlockSize(format);
+	unsigned char blockPixels[16 * 4];
+
+	for (unsigned int blockY = 0; blockY < height; blockY += 4)
+	{
+		for (unsigned int blockX = 0; blockX < width; blockX += 4)
+		{
+			for (unsigned int y = 0; y < 4; y++)
+			{
+				for (unsigned int x = 0; x < 4; x++)
+				{
+					unsigned int sourceX = blockX + x < width ? blockX + x : width - 1;
+					unsigned int sourceY = blockY + y < height ? blockY + y : height - 1;
+					memcpy(&blockPixels[(y * 4 + x) * 4], &pixels[(sourceY * width + sourceX) * 4], 4);
+				}
+			}
+
+			if (format == DXGI_FORMAT_BC1_UNORM)
+				EncodeBC1(blockPixels, blocks);
+			else if (format == DXGI_FORMAT_BC3_UNORM)
+				EncodeBC3(blockPixels, blocks);
+			else
+				EncodeBC7(blockPixels, blocks);
+
+			blocks += blockSize;
+		}
+	}
+
+	return true;
+}
+
+bool BlockCompression::Decode(DXGI_FORMAT format, const unsigned char* blocks, unsigned int width, unsigned int height, unsigned char* pixels)
+{
+	if (!IsCompressed(format))
+		return false;
+
+	unsigned int blockSize = GetBlockSize(format);
+	unsigned char blockPixels[16 * 4];
+	bool decoded = true;
+
+	for (unsigned int blockY = 0; blockY < height; blockY += 4)
+	{
+		for (unsigned int blockX = 0; blockX < width; blockX += 4)
+		{
+			if (format == DXGI_FORMAT_BC1_UNORM)
+				DecodeBC1(blocks, blockPixels);
+			else if (format == DXGI_FORMAT_BC3_UNORM)
+				DecodeBC3(blocks, blockPixels);
+			else
+				decoded = DecodeBC7(blocks, blockPixels) && decoded;
+
+			for (unsigned int y = 0; y < 4 && blockY + y < height; y++)
+			{
+				for (unsigned int x = 0; x < 4 && blockX + x < width; x++)
+					memcpy(&pixels[((blockY + y) * width + blockX + x) * 4], &blockPixels[(y * 4 + x) * 4], 4);
+			}
+
+			blocks += blockSize;
+		}
+	}
+
+	return decoded;
+}
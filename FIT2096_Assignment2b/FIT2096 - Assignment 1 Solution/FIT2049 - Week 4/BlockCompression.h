@@ -0,0 +1,40 @@
+/*	FIT2096 - Assignment 2b
+*	BlockCompression.h
+*	Packs 4x4 blocks of RGBA8 pixels into the block compressed formats the GPU samples directly.
+*	  BC1 - 8 bytes a block. Two 565 colours and three more in between, one bit of alpha.
+*	  BC3 - 16 bytes. BC1's colours plus two alphas and six in between.
+*	  BC7 - 16 bytes. Only mode 6 is written: one line through RGBA with 16 steps along it and
+*	        7 bits (plus a shared low bit) per channel on each end. Much better than BC1 on
+*	        smooth colours, and alpha comes free.
+*	The encoders are the quick kind, the line through each block is its principal axis and every
+*	pixel takes the nearest point on it. Fine for textures this size, cooked once and kept.
+*	Decoding is here so texturecook can say how much each format cost. BC7 only decodes mode 6.
+*/
+
+#ifndef BLOCK_COMPRESSION_H
+#define BLOCK_COMPRESSION_H
+
+#include <dxgi.h>
+
+class BlockCompression
+{
+public:
+	// True for the formats below, the others are stored a pixel at a time
+	static bool IsCompressed(DXGI_FORMAT format);
+	static unsigned int GetBlockSize(DXGI_FORMAT format);	// Bytes in one 4x4 block
+
+	// pixels is 16 RGBA8 pixels, a row of four at a time
+	static void EncodeBC1(const unsigned char* pixels, unsigned char* block);
+	static void EncodeBC3(const unsigned char* pixels, unsigned char* block);
+	static void EncodeBC7(const unsigned char* pixels, unsigned char* block);
+
+	static void DecodeBC1(const unsigned char* block, unsigned char* pixels);
+	static void DecodeBC3(const unsigned char* block, unsigned char* pixels);
+	static bool DecodeBC7(const unsigned char* block, unsigned char* pixels);	// False (and magenta) for modes other than 6
+
+	// A whole image, width and height in pixels. Edge blocks repeat the last row and column.
+	static bool Encode(DXGI_FORMAT format, const unsigned char* pixels, unsigned int width, unsigned int height, unsigned char* blocks);
+	static bool Decode(DXGI_FORMAT format, const unsigned char* blocks, unsigned int width, unsigned int height, unsigned char* pixels);
+};
+
+#endif
@@ -0,0 +1,132 @@
+/*	FIT2096 - Assignment 2b
+*	BroadphaseGrid.cpp
+*	Implementation of BroadphaseGrid.h
+*/
+
+#include "BroadphaseGrid.h"
+#include <cmath>
+
+// Windows.h defines min and max as macros so we do the clamp by hand
+static int ClampCell(int cell, int cellCount)
+{
+	if (cell < 0)
+		return 0;
+	else if (cell >= cellCount)
+		return cellCount - 1;
+	else
+		return cell;
+}
+
+BroadphaseGrid::BroadphaseGrid()
+{
+	m_width = 0;
+	m_height = 0;
+	m_cellSize = 1.0f;
+	m_currentStamp = 0;
+}
+
+void BroadphaseGrid::Resize(int width, int height, float cellSize)
+{
+	m_width = width;
+	m_height = height;
+	m_cellSize = cellSize;
+
+	m_cellHeads.assign(width * height, -1);
+	m_touchedCells.clear();
+	m_entryObjects.clear();
+	m_entryNext.clear();
+}
+
+void BroadphaseGrid::Clear()
+{
+	for (unsigned int i = 0; i < m_touchedCells.size(); i++)
+	{
+		m_cellHeads[m_touchedCells[i]] = -1;
+	}
+
+	m_touchedCells.clear();
+	m_entryObjects.clear();
+	m_entryNext.clear();
+}
+
+CellRect BroadphaseGrid::GetCellRect(const CBoundingBox& bounds)
+{
+	// Tiles are centred on whole numbers so a cell covers from -half a cell to +half a cell around it
+	Vector3 min = bounds.GetMin();
+	Vector3 max = bounds.GetMax();
+
+	CellRect rect;
+	rect.minX = (int)floorf(min.x / m_cellSize + 0.5f);
+	rect.minZ = (int)floorf(min.z / m_cellSize + 0.5f);
+	rect.maxX = (int)floorf(max.x / m_cellSize + 0.5f);
+	rect.maxZ = (int)floorf(max.z / m_cellSize + 0.5f);
+
+	// Things that have been "put away" under or off the board still need a cell, use the closest one
+	rect.minX = ClampCell(rect.minX, m_width);
+	rect.maxX = ClampCell(rect.maxX, m_width);
+	rect.minZ = ClampCell(rect.minZ, m_height);
+	rect.maxZ = ClampCell(rect.maxZ, m_height);
+
+	return rect;
+}
+
+void BroadphaseGrid::InsertIntoCell(int cell, int object)
+{
+	if (m_cellHeads[cell] == -1)
+	{
+		m_touchedCells.push_back(cell);
+	}
+
+	// Push onto the front of the cell's list
+	m_entryObjects.push_back(object);
+	m_entryNext.push_back(m_cellHeads[cell]);
+	m_cellHeads[cell] = (int)m_entryObjects.size() - 1;
+}
+
+void BroadphaseGrid::Insert(int object, const CellRect& cells)
+{
+	if (object >= (int)m_objectStamps.size())
+	{
+		m_objectStamps.resize(object + 1, 0);
+	}
+
+	for (int z = cells.minZ; z <= cells.maxZ; z++)
+	{
+		for (int x = cells.minX; x <= cells.maxX; x++)
+		{
+			InsertIntoCell(z * m_width + x, object);
+		}
+	}
+}
+
+void BroadphaseGrid::BeginQuery()
+{
+	m_currentStamp++;
+
+	// Wrapped around, every old stamp could now look like a match so start them all again
+	if (m_currentStamp == 0)
+	{
+		m_objectStamps.assign(m_objectStamps.size(), 0);
+		m_currentStamp = 1;
+	}
+}
+
+void BroadphaseGrid::Query(const CellRect& cells, std::vector<int>* results)
+{
+	for (int z = cells.minZ; z <= cells.maxZ; z++)
+	{
+		for (int x = cells.minX; x <= cells.maxX; x++)
+		{
+			for (int entry = m_cellHeads[z * m_width + x]; entry != -1; entry = m_entryNext[entry])
+			{
+				int object = m_entryObjects[entry];
+
+				if (m_objectStamps[object] != m_currentStamp)
+				{
+					m_objectStamps[object] = m_currentStamp;
+					results->push_back(object);
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,71 @@
+/*	FIT2096 - Assignment 2b
+*	BroadphaseGrid.h
+*	A uniform grid laid over the board (one grid cell per board cell) which remembers which
+*	objects are touching which cells. Instead of testing every object against every other
+*	object we only test the ones that share a cell.
+*	Each cell keeps a singly linked list of entries stored in flat arrays, so rebuilding the
+*	grid each tick only costs as much as the number of objects in it, not the size of the board.
+*/
+
+#ifndef BROADPHASE_GRID_H
+#define BROADPHASE_GRID_H
+
+#include "Collisions.h"
+#include <vector>
+
+// The block of cells an object overlaps (inclusive). Anything off the board is clamped onto the edge.
+struct CellRect
+{
+	int minX;
+	int minZ;
+	int maxX;
+	int maxZ;
+
+	bool operator==(const CellRect& other) const
+	{
+		return minX == other.minX && minZ == other.minZ && maxX == other.maxX && maxZ == other.maxZ;
+	}
+};
+
+class BroadphaseGrid
+{
+private:
+	int m_width;
+	int m_height;
+	float m_cellSize;
+
+	std::vector<int> m_cellHeads;		// First entry in each cell, -1 when the cell is empty
+	std::vector<int> m_touchedCells;	// Cells we've written to since the last Clear
+
+	// One entry per object per cell it overlaps
+	std::vector<int> m_entryObjects;
+	std::vector<int> m_entryNext;
+
+	// Used to hand back each object only once per query even if it covers several cells
+	std::vector<unsigned int> m_objectStamps;
+	unsigned int m_currentStamp;
+
+	void InsertIntoCell(int cell, int object);
+
+public:
+	BroadphaseGrid();
+
+	void Resize(int width, int height, float cellSize);
+
+	// Empties the grid. Only touches cells that were used so it's cheap on big boards.
+	void Clear();
+
+	CellRect GetCellRect(const CBoundingBox& bounds);
+
+	// Objects are identified by their index in whatever vector the caller is using
+	void Insert(int object, const CellRect& cells);
+
+	// Queries are done in two steps so one query can cover more than one rectangle
+	// without returning the same object twice. Results are appended to the vector.
+	void BeginQuery();
+	void Query(const CellRect& cells, std::vector<int>* results);
+
+	int GetEntryCount() { return (int)m_entryObjects.size(); }
+};
+
+#endif
@@ -1,44 +1,43 @@
 #include "Bullet.h"
+#include "BulletPool.h"
 
-Bullet::Bullet(Mesh* mesh, Shader* shader, Texture* texture, Vector3 position)
-	:PhysicsObject(mesh, shader, texture, position)
+Bullet::Bullet(Mesh* mesh, Shader* shader, Texture* texture)
+	:GameObject(mesh, shader, texture)
 {
-	isBeingUsed = false;
-	m_moveSpeed = 1.0f;
-	m_timeInAir = 0.0f;
-
-	m_boundingBox = CBoundingBox(m_position + m_mesh->GetMin(), m_position + m_mesh->GetMax());
+	m_pool = NULL;
+	m_poolIndex = -1;
+	m_nextFree = -1;
+	m_activeSlot = -1;
+}
 
-	m_flyTowards = Vector3::Zero;
+CBoundingBox Bullet::GetBounds()
+{
+	if (m_activeSlot == -1)
+	{
+		// Not flying, we're nowhere
+		return CBoundingBox();
+	}
 
-	m_master = NULL;
+	return m_pool->GetActiveBounds(m_activeSlot);
 }
 
-void Bullet::Update(float timestep)
+GameObject* Bullet::GetMaster()
 {
-	if (isBeingUsed)
+	if (m_activeSlot == -1)
 	{
-		m_timeInAir += timestep;
-
-		// If the bullet flys for a certain time
-		if (m_timeInAir >= 5.0f)  
-		{
-			isBeingUsed = false;
-			m_position = initialPosition;
-			m_timeInAir = 0.0f;  // Reset time in air
-		}
-		// Still flying
-		else
-		{
-			m_position += m_flyTowards * m_moveSpeed * timestep;
-		}
+		return NULL;
 	}
-	
-	// Keep bounds up to date with position
-	m_boundingBox.SetMin(m_position + m_mesh->GetMin());
-	m_boundingBox.SetMax(m_position + m_mesh->GetMax());
+
+	return m_pool->GetActiveOwner(m_activeSlot);
 }
 
+void Bullet::Deactivate()
+{
+	if (m_pool)
+	{
+		m_pool->Release(this);
+	}
+}
 
 // Collisions
 void Bullet::OnEnemyCollisionEnter(GameObject* other)
@@ -55,9 +54,7 @@ void Bullet::OnEnemyCollisionExit(GameObject* other)
 {
 	OutputDebugString("Bullet-Enemy Collision Exit\n");
 
-	isBeingUsed = false;
-	m_position = initialPosition;
-	m_timeInAir = 0.0f;  // Reset time in air
+	Deactivate();
 }
 
 void Bullet::OnPlayerCollisionEnter(GameObject* other)
@@ -74,8 +71,5 @@ void Bullet::OnPlayerCollisionExit(GameObject* other)
 {
 	OutputDebugString("Bullet-Player Collision Exit\n");
 
-	isBeingUsed = false;
-	m_position = initialPosition;
-	m_timeInAir = 0.0f;  // Reset time in air
+	Deactivate();
 }
-
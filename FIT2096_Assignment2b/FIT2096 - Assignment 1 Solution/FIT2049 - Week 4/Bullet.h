@@ -3,30 +3,32 @@
 #ifndef BULLET_H
 #define BULLET_H
 
-#include "PhysicsObject.h"
+#include "GameObject.h"
 
-class Bullet : public PhysicsObject
-{
-private:
-	const Vector3 initialPosition = Vector3(0.0f, -10.0f, 0.0f);  // Where a bullet should stay when it is not being used
+class BulletPool;
 
-	CBoundingBox m_boundingBox;  // Hitbox of a bullet
+// A bullet's position, velocity, age and bounds all live in the BulletPool, which moves every bullet
+// at once. This is just a handle to one of them so the collision code has something to talk to.
+class Bullet : public GameObject
+{
+	// The pool keeps its bookkeeping inside each bullet so it never has to search for one
+	friend class BulletPool;
 
-	bool isBeingUsed;  // For others to know if a bullet is being used
-	float m_moveSpeed;  // How fast a bullet travel
-	float m_timeInAir;  // How long does a bullet fly
+private:
+	// Pool bookkeeping, only the pool touches these
+	BulletPool* m_pool;
+	int m_poolIndex;   // Where we live in the pool
+	int m_nextFree;    // Next free bullet after us, only meaningful while we're free
+	int m_activeSlot;  // Where our data is in the pool's arrays of bullets in flight, -1 while we're free
 
-	Vector3 m_flyTowards;
+	// Stop flying and hand ourselves back to the pool
+	void Deactivate();
 
-	// Masters
-	GameObject* m_master;
+	Bullet(Mesh* mesh, Shader* shader, Texture* texture);
 
 public:
-
-	Bullet(Mesh* mesh, Shader* shader, Texture* texture, Vector3 position);
-
-	void Update(float timestep);
-
+	// The pool moves us, there's nothing to do here
+	void Update(float timestep) { }
 
 	// Collisions with other objects (Bullet doesn't need to know who it hits, it just need to know it hits something)
 	void OnEnemyCollisionEnter(GameObject* other);
@@ -38,15 +40,9 @@ public:
 	void OnPlayerCollisionExit(GameObject* other);
 	
 	// Accessors
-	CBoundingBox GetBounds() { return m_boundingBox; }
-	bool GetBeingUsed() { return isBeingUsed; }
-	Vector3 GetFlyTowards() { return m_flyTowards; }
-	GameObject* GetMaster() { return m_master; }
-
-	// Mutators
-	void SetBeingUsed(bool value) { isBeingUsed = value; }
-	void SetFlyTowards(Vector3 direction) { m_flyTowards = direction; }
-	void SetMaster(GameObject* master) { m_master = master; }
+	CBoundingBox GetBounds();
+	bool GetBeingUsed() { return m_activeSlot != -1; }
+	GameObject* GetMaster();  // Who fired us, NULL while we're in the pool
 
 };
 
@@ -0,0 +1,292 @@
+/*	FIT2096 - Assignment 2b
+*	BulletPool.cpp
+*	Implementation of BulletPool.h
+*/
+
+#include "BulletPool.h"
+#include "MathsHelper.h"
+
+BulletPool::BulletPool(Mesh* mesh, Shader* shader, Texture* texture, int initialCapacity)
+{
+	m_mesh = mesh;
+	m_shader = shader;
+	m_texture = texture;
+
+	m_boundsMin = mesh ? mesh->GetMin() : Vector3::Zero;
+	m_boundsMax = mesh ? mesh->GetMax() : Vector3::Zero;
+
+	m_firstFree = -1;
+
+	m_overflow = BulletPoolOverflow::FAIL;
+	m_maxCapacity = initialCapacity;
+
+	m_highWaterMark = 0;
+	m_failedAcquires = 0;
+
+	Grow(initialCapacity);
+}
+
+BulletPool::~BulletPool()
+{
+	for (unsigned int i = 0; i < m_bullets.size(); i++)
+	{
+		delete m_bullets[i];
+		m_bullets[i] = NULL;
+	}
+}
+
+void BulletPool::SetOverflowPolicy(BulletPoolOverflow overflow, int maxCapacity)
+{
+	m_overflow = overflow;
+
+	// Can't shrink below what we've already made
+	m_maxCapacity = maxCapacity > GetCapacity() ? maxCapacity : GetCapacity();
+}
+
+void BulletPool::Grow(int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		Bullet* bullet = new Bullet(m_mesh, m_shader, m_texture);
+		bullet->m_pool = this;
+		bullet->m_poolIndex = (int)m_bullets.size();
+		m_bullets.push_back(bullet);
+	}
+
+	// Push the new bullets onto the front of the free list backwards so the lowest index comes out first
+	for (int i = (int)m_bullets.size() - 1; i >= (int)m_bullets.size() - count; i--)
+	{
+		m_bullets[i]->m_nextFree = m_firstFree;
+		m_firstFree = i;
+	}
+
+	// Room for every bullet to be in flight at once, so firing never reallocates
+	int capacity = GetCapacity();
+	m_active.reserve(capacity);
+	m_positionX.resize(capacity);
+	m_positionY.resize(capacity);
+	m_positionZ.resize(capacity);
+	m_previousX.resize(capacity);
+	m_previousY.resize(capacity);
+	m_previousZ.resize(capacity);
+	m_velocityX.resize(capacity);
+	m_velocityY.resize(capacity);
+	m_velocityZ.resize(capacity);
+	m_rotY.resize(capacity);
+	m_timeInAir.resize(capacity);
+	m_owners.resize(capacity);
+	m_minX.resize(capacity);
+	m_minY.resize(capacity);
+	m_minZ.resize(capacity);
+	m_maxX.resize(capacity);
+	m_maxY.resize(capacity);
+	m_maxZ.resize(capacity);
+}
+
+Bullet* BulletPool::Acquire()
+{
+	if (m_firstFree == -1)
+	{
+		int capacity = GetCapacity();
+
+		if (m_overflow == BulletPoolOverflow::GROW && capacity < m_maxCapacity)
+		{
+			int extra = capacity > 0 ? capacity : 1;
+
+			if (capacity + extra > m_maxCapacity)
+				extra = m_maxCapacity - capacity;
+
+			Grow(extra);
+		}
+		else
+		{
+			m_failedAcquires++;
+			return NULL;
+		}
+	}
+
+	// Pop the head of the free list
+	Bullet* bullet = m_bullets[m_firstFree];
+	m_firstFree = bullet->m_nextFree;
+	bullet->m_nextFree = -1;
+
+	bullet->m_activeSlot = (int)m_active.size();
+	m_active.push_back(bullet->m_poolIndex);
+
+	if (GetActiveCount() > m_highWaterMark)
+		m_highWaterMark = GetActiveCount();
+
+	return bullet;
+}
+
+Bullet* BulletPool::Fire(Vector3 position, Vector3 velocity, float rotY, GameObject* owner)
+{
+	Bullet* bullet = Acquire();
+
+	if (bullet)
+	{
+		int slot = bullet->m_activeSlot;
+
+		// Appearing out of nowhere is a teleport, so there's nothing to blend or sweep from
+		m_positionX[slot] = m_previousX[slot] = position.x;
+		m_positionY[slot] = m_previousY[slot] = position.y;
+		m_positionZ[slot] = m_previousZ[slot] = position.z;
+		m_velocityX[slot] = velocity.x;
+		m_velocityY[slot] = velocity.y;
+		m_velocityZ[slot] = velocity.z;
+		m_rotY[slot] = rotY;
+		m_timeInAir[slot] = 0.0f;
+		m_owners[slot] = owner;
+
+		m_minX[slot] = position.x + m_boundsMin.x;
+		m_minY[slot] = position.y + m_boundsMin.y;
+		m_minZ[slot] = position.z + m_boundsMin.z;
+		m_maxX[slot] = position.x + m_boundsMax.x;
+		m_maxY[slot] = position.y + m_boundsMax.y;
+		m_maxZ[slot] = position.z + m_boundsMax.z;
+	}
+
+	return bullet;
+}
+
+void BulletPool::CopySlot(int from, int to)
+{
+	m_positionX[to] = m_positionX[from];
+	m_positionY[to] = m_positionY[from];
+	m_positionZ[to] = m_positionZ[from];
+	m_previousX[to] = m_previousX[from];
+	m_previousY[to] = m_previousY[from];
+	m_previousZ[to] = m_previousZ[from];
+	m_velocityX[to] = m_velocityX[from];
+	m_velocityY[to] = m_velocityY[from];
+	m_velocityZ[to] = m_velocityZ[from];
+	m_rotY[to] = m_rotY[from];
+	m_timeInAir[to] = m_timeInAir[from];
+	m_owners[to] = m_owners[from];
+	m_minX[to] = m_minX[from];
+	m_minY[to] = m_minY[from];
+	m_minZ[to] = m_minZ[from];
+	m_maxX[to] = m_maxX[from];
+	m_maxY[to] = m_maxY[from];
+	m_maxZ[to] = m_maxZ[from];
+}
+
+void BulletPool::Release(Bullet* bullet)
+{
+	// Already back in the pool (or never left)
+	if (bullet->m_activeSlot == -1)
+		return;
+
+	// Fill the gap with the last active bullet so the arrays stay packed
+	int slot = bullet->m_activeSlot;
+	int lastSlot = GetActiveCount() - 1;
+	int last = m_active[lastSlot];
+
+	if (slot != lastSlot)
+	{
+		CopySlot(lastSlot, slot);
+	}
+
+	m_active[slot] = last;
+	m_bullets[last]->m_activeSlot = slot;
+	m_active.pop_back();
+	bullet->m_activeSlot = -1;
+
+	// Push onto the front of the free list
+	bullet->m_nextFree = m_firstFree;
+	m_firstFree = bullet->m_poolIndex;
+}
+
+void BulletPool::Update(float timestep, JobSystem* jobs)
+{
+	int count = GetActiveCount();
+
+	ParallelFor(jobs, count, BULLET_UPDATE_GRAIN, [this, timestep](int begin, int end)
+	{
+		Integrate(begin, end, timestep);
+	});
+
+	// Put away anything that has flown for too long
+	// Backwards, as releasing moves the last bullet into the gap and we've already looked at that one
+	for (int i = count - 1; i >= 0; i--)
+	{
+		if (m_timeInAir[i] >= BULLET_LIFETIME)
+		{
+			Release(m_bullets[m_active[i]]);
+		}
+	}
+}
+
+void BulletPool::Integrate(int begin, int end, float timestep)
+{
+	// Raw pointers so the compiler can see these are plain arrays and vectorise the loops
+	float* x = m_positionX.data();
+	float* y = m_positionY.data();
+	float* z = m_positionZ.data();
+	const float* vx = m_velocityX.data();
+	const float* vy = m_velocityY.data();
+	const float* vz = m_velocityZ.data();
+	float* timeInAir = m_timeInAir.data();
+
+	for (int i = begin; i < end; i++)
+	{
+		timeInAir[i] += timestep;
+		x[i] += vx[i] * timestep;
+		y[i] += vy[i] * timestep;
+		z[i] += vz[i] * timestep;
+	}
+
+	// Keep bounds up to date with position
+	float* minX = m_minX.data();
+	float* minY = m_minY.data();
+	float* minZ = m_minZ.data();
+	float* maxX = m_maxX.data();
+	float* maxY = m_maxY.data();
+	float* maxZ = m_maxZ.data();
+
+	for (int i = begin; i < end; i++)
+	{
+		minX[i] = x[i] + m_boundsMin.x;
+		minY[i] = y[i] + m_boundsMin.y;
+		minZ[i] = z[i] + m_boundsMin.z;
+		maxX[i] = x[i] + m_boundsMax.x;
+		maxY[i] = y[i] + m_boundsMax.y;
+		maxZ[i] = z[i] + m_boundsMax.z;
+	}
+}
+
+void BulletPool::StorePreviousPositions()
+{
+	int count = GetActiveCount();
+
+	for (int i = 0; i < count; i++)
+	{
+		m_previousX[i] = m_positionX[i];
+		m_previousY[i] = m_positionY[i];
+		m_previousZ[i] = m_positionZ[i];
+	}
+}
+
+void BulletPool::Render(RenderSnapshot* snapshot)
+{
+	if (!m_mesh)
+		return;
+
+	for (int i = 0; i < GetActiveCount(); i++)
+	{
+		// Bullets only ever turn around Y (to face the way they were fired), and never while in flight
+		Vector3 rotation(0.0f, m_rotY[i], 0.0f);
+		snapshot->AddMesh(m_mesh, m_shader, m_texture, Vector3(m_previousX[i], m_previousY[i], m_previousZ[i]),
+			Vector3(m_positionX[i], m_positionY[i], m_positionZ[i]), rotation, rotation);
+	}
+}
+
+CBoundingBox BulletPool::GetActiveBounds(int slot)
+{
+	return CBoundingBox(Vector3(m_minX[slot], m_minY[slot], m_minZ[slot]), Vector3(m_maxX[slot], m_maxY[slot], m_maxZ[slot]));
+}
+
+Vector3 BulletPool::GetActiveDisplacement(int slot)
+{
+	return Vector3(m_positionX[slot] - m_previousX[slot], m_positionY[slot] - m_previousY[slot], m_positionZ[slot] - m_previousZ[slot]);
+}
@@ -0,0 +1,110 @@
+/*	FIT2096 - Assignment 2b
+*	BulletPool.h
+*	Owns and simulates every bullet in the game. Whoever wants to shoot asks the pool to Fire
+*	and the bullet is handed back when it's done flying.
+*	Free bullets are chained together through a link stored in the Bullet itself (a free list)
+*	so getting or returning one never has to search.
+*	Everything a flying bullet needs (position, velocity, lifetime, owner, bounds) lives here in
+*	one array per value, packed so the bullets in flight are always slots 0 to GetActiveCount() - 1.
+*	Moving, ageing and bounding every bullet is then a handful of straight loops over floats
+*	that the compiler can vectorise, and bullets that aren't flying cost nothing at all.
+*	The Bullet objects themselves are just handles so the collision code has something to talk to.
+*/
+
+#ifndef BULLET_POOL_H
+#define BULLET_POOL_H
+
+#include "Bullet.h"
+#include "JobSystem.h"
+#include <vector>
+
+// How long a bullet flies before it gives up (seconds)
+#define BULLET_LIFETIME 5.0f
+
+// Bullets per job when they're moved on several threads
+#define BULLET_UPDATE_GRAIN 2048
+
+// What to do when someone wants a bullet and they're all in flight
+enum class BulletPoolOverflow
+{
+	FAIL,	// Nobody gets a bullet until one comes back (how the game has always worked)
+	GROW	// Make more, doubling the pool each time, up to the maximum capacity
+};
+
+class BulletPool
+{
+private:
+	// Every bullet shares these
+	Mesh* m_mesh;
+	Shader* m_shader;
+	Texture* m_texture;
+	Vector3 m_boundsMin;	// Bounding box around a bullet's position, taken from the mesh
+	Vector3 m_boundsMax;
+
+	std::vector<Bullet*> m_bullets;	// Every bullet we've made, a bullet's index in here never changes
+	std::vector<int> m_active;		// Index of the bullet in each active slot
+	int m_firstFree;				// Head of the free list, -1 when there are no free bullets
+
+	// Per bullet state, indexed by active slot
+	std::vector<float> m_positionX, m_positionY, m_positionZ;
+	std::vector<float> m_previousX, m_previousY, m_previousZ;	// Position at the end of the last tick
+	std::vector<float> m_velocityX, m_velocityY, m_velocityZ;
+	std::vector<float> m_rotY;
+	std::vector<float> m_timeInAir;
+	std::vector<GameObject*> m_owners;
+	std::vector<float> m_minX, m_minY, m_minZ;
+	std::vector<float> m_maxX, m_maxY, m_maxZ;
+
+	BulletPoolOverflow m_overflow;
+	int m_maxCapacity;
+
+	// For sizing the pool. How many were in flight at once, and how often we ran out.
+	int m_highWaterMark;
+	int m_failedAcquires;
+
+	void Grow(int count);
+	void CopySlot(int from, int to);
+	Bullet* Acquire();
+	void Integrate(int begin, int end, float timestep);  // Moves and bounds the bullets in these active slots
+
+public:
+	// Mesh can be NULL (nothing is drawn and bullets are points), handy for tools
+	BulletPool(Mesh* mesh, Shader* shader, Texture* texture, int initialCapacity);
+	~BulletPool();
+
+	void SetOverflowPolicy(BulletPoolOverflow overflow, int maxCapacity);
+
+	// Launches a bullet. Returns NULL if we're out of bullets and aren't allowed to make any more.
+	Bullet* Fire(Vector3 position, Vector3 velocity, float rotY, GameObject* owner);
+
+	// Puts a bullet away. Bullets call this themselves when they hit something.
+	void Release(Bullet* bullet);
+
+	// Moves every bullet in flight and puts away any that have been flying too long
+	// Moving is split between threads if there's a job system, putting away is always done here in order
+	void Update(float timestep, JobSystem* jobs = NULL);
+	void StorePreviousPositions();  // Called at the start of each simulation tick so rendering can blend between ticks
+	void Render(RenderSnapshot* snapshot);
+
+	int GetCapacity() { return (int)m_bullets.size(); }
+	int GetActiveCount() { return (int)m_active.size(); }
+	int GetHighWaterMark() { return m_highWaterMark; }
+	int GetFailedAcquires() { return m_failedAcquires; }
+	BulletPoolOverflow GetOverflowPolicy() { return m_overflow; }
+	int GetMaxCapacity() { return m_maxCapacity; }
+
+	// Index into every bullet (0 to GetCapacity() - 1)
+	Bullet* GetBullet(int index) { return m_bullets[index]; }
+
+	// Index into bullets in flight (0 to GetActiveCount() - 1). Releasing a bullet moves the last
+	// active bullet into its place, so walk this backwards if bullets may be released as you go.
+	Bullet* GetActiveBullet(int slot) { return m_bullets[m_active[slot]]; }
+	int GetActiveIndex(int slot) { return m_active[slot]; }
+
+	CBoundingBox GetActiveBounds(int slot);
+	Vector3 GetActivePosition(int slot) { return Vector3(m_positionX[slot], m_positionY[slot], m_positionZ[slot]); }
+	Vector3 GetActiveDisplacement(int slot);  // How far it moved since the last StorePreviousPositions
+	GameObject* GetActiveOwner(int slot) { return m_owners[slot]; }
+};
+
+#endif
@@ -7,7 +7,7 @@
 #include "Button.h"
 
 Button::Button(int width, int height, Texture* texture, LPCWSTR text, Vector2 position,
-	SpriteBatch* spriteBatch, SpriteFont* font, InputController* input, std::function<void()> onClickFunction)
+	SpriteFont* font, InputController* input, std::function<void()> onClickFunction)
 {
 	//Setting basic values
 	m_width = width;
@@ -19,7 +19,6 @@ Button::Button(int width, int height, Texture* texture, LPCWSTR text, Vector2 po
 	m_isEnabled = true;
 
 	//Setting the objects we'll be using to do stuff
-	m_spriteBatch = spriteBatch;
 	m_font = font;
 	m_input = input;
 
@@ -84,7 +83,7 @@ void Button::Update()
 	}
 }
 
-void Button::Render()
+void Button::Render(RenderSnapshot* snapshot)
 {
 	float alpha = 1.0f;
 
@@ -92,8 +91,8 @@ void Button::Render()
 		alpha = 0.3f;
 
 	//We now render the texture at our position, using the texture window and origin that we defined and a White colour
-	m_spriteBatch->Draw(m_buttonTexture->GetShaderResourceView(), m_position, &m_textureWindow, Color(1.0f, 1.0f, 1.0f, alpha), 0, m_origin);
+	snapshot->AddSprite(m_buttonTexture, m_position, &m_textureWindow, Color(1.0f, 1.0f, 1.0f, alpha), m_origin);
 
 	//Then we draw the text at our position, using the origin we calculated and the colour that was set
-	m_font->DrawString(m_spriteBatch, m_text, m_position, m_textColour, 0, m_textOrigin);
+	snapshot->AddText(m_font, m_text, m_position, m_textColour, m_textOrigin);
 }
\ No newline at end of file
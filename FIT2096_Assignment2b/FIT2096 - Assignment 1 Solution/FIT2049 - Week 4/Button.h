@@ -2,7 +2,7 @@
 *	Button.h
 *	Created by Elliott Wilson - 2015 - Monash University
 *	This class represents a Button in our scene
-*	It uses the sprite batch and a sprite font to render an image and the string on screen
+*	It adds an image and a string to the frame's render snapshot, which draws them with a sprite batch and font
 *	It also supports a hover state image which is achieved via a texture that contains the
 *	normal button texture on top and the hover state texture on the bottom (see Button.png for example)
 */
@@ -19,6 +19,7 @@
 
 #include "Texture.h"
 #include "InputController.h"
+#include "RenderSnapshot.h"
 
 using namespace DirectX;
 using namespace DirectX::SimpleMath;
@@ -37,8 +38,7 @@ private:
 	RECT m_textureWindow;		//This RECT define which portion of the texture we are going to draw
 	Color m_textColour;			//This colour will define the colour of the text on the button
 
-	SpriteBatch* m_spriteBatch;	//We need the sprite batch to draw the texture
-	SpriteFont* m_font;			//We need the font to draw the text
+	SpriteFont* m_font;			//We need the font to measure and draw the text
 	InputController* m_input;	//We need the input controller to find out what the mouse is up to
 
 	bool m_isEnabled;
@@ -50,7 +50,7 @@ private:
 public:
 	//The constructor takes in all of the required information including the function object that we want to call when the button is clicked
 	Button(int width, int height, Texture* texture, LPCWSTR text, Vector2 position,
-		SpriteBatch* spriteBatch, SpriteFont* font, InputController* input, std::function<void()> onClickFunction);
+		SpriteFont* font, InputController* input, std::function<void()> onClickFunction);
 	~Button();
 
 	//Mutators
@@ -61,7 +61,7 @@ public:
 	void Disable() { m_isEnabled = false; }
 
 	void Update();		//The Update method is going to be in charge of dealing with the mouse input
-	void Render();		//The Render method is going to make all of the calls to the sprite batch to render the texture and text
+	void Render(RenderSnapshot* snapshot);	//The Render method adds the texture and text to the snapshot, the sprite batch draws them later
 };
 
 #endif
\ No newline at end of file
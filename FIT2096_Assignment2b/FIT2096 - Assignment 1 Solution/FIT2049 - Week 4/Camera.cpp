@@ -17,6 +17,8 @@ Camera::Camera()
 	m_forward = Vector3::Forward;
 	m_right = Vector3::Right;
 	m_velocity = Vector3::Zero;
+	m_tickPosition = m_position;
+	m_tickLookAt = m_lookAtTarget;
 
 	m_aspectRatio = 1280.0f / 720.0f;
 	m_fieldOfView = ToRadians(45.0f);
@@ -39,6 +41,8 @@ Camera::Camera(Vector3 pos, Vector3 lookAt, Vector3 up, float aspect, float fov,
 	m_forward = Vector3::Forward;
 	m_right = Vector3::Right;
 	m_velocity = Vector3::Zero;
+	m_tickPosition = m_position;
+	m_tickLookAt = m_lookAtTarget;
 
 	m_aspectRatio = aspect;
 	m_fieldOfView = fov;
@@ -101,6 +105,12 @@ void Camera::SetFarClip(float farClip)
 	m_projectionDirty = true;
 }
 
+void Camera::StorePreviousTransform()
+{
+	m_tickPosition = m_position;
+	m_tickLookAt = m_lookAtTarget;
+}
+
 void Camera::Update(float timestep)
 {
 	// For third person view
@@ -41,6 +41,9 @@ protected:                      // <---- I change this into protected so I could
 	Vector3 m_forward;			//Local space forward (different to lookAt target)
 	Vector3 m_velocity;			//Vector from where we were on the last frame to now
 
+	Vector3 m_tickPosition;		//Where the camera was at the end of the last simulation tick
+	Vector3 m_tickLookAt;		//and what it was looking at. Used to blend the view between ticks
+
 public:
 	Camera();	//Constructor
 	Camera(Vector3 pos, Vector3 lookAt, Vector3 up, float aspect, float fov, float nearClip, float farClip);	//Parameter Constructor
@@ -62,11 +65,17 @@ public:
 	Matrix GetProjection() { return m_projection; }
 
 	Vector3 GetPosition() { return m_position; }
+	Vector3 GetLookAt() { return m_lookAtTarget; }
+	Vector3 GetViewUp() { return m_up; }	//The up the view matrix is built with, GetUp below is worked out from where we're facing
 	Vector3 GetVelocity() { return m_velocity; }
 	Vector3 GetUp() { return m_forward.Cross(m_right); }
 	Vector3 GetForward() { return m_forward; }
 	Vector3 GetRight() { return m_right; }
 
+	void StorePreviousTransform();		//Called at the start of every simulation tick before the camera moves
+	Vector3 GetTickPosition() { return m_tickPosition; }	//Where we were and what we were looking at on the last tick,
+	Vector3 GetTickLookAt() { return m_tickLookAt; }		//so the view can be blended between ticks when it's drawn
+
 	virtual void Update(float timestep);	//The Update method is used to recalculate the matrices, however later on we could use it to move the camera around
 };											//This is why it is virtual and why it receives the timestep as a parameter
 
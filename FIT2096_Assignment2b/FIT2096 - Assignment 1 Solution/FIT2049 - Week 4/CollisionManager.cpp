@@ -1,73 +1,210 @@
 #include "CollisionManager.h"
+#include <algorithm>
 
-CollisionManager::CollisionManager(std::vector<Player*>* players, std::vector<Enemy*>* enemies, std::vector<Bullet*>* bullets, std::vector<HealthPack*>* healthPacks)
+CollisionManager::CollisionManager(std::vector<Player*>* players, std::vector<Enemy*>* enemies, BulletPool* bullets, std::vector<HealthPack*>* healthPacks, int boardWidth, int boardHeight)
 {
 	m_players = players;
 	m_enemies = enemies;
 	m_bullets = bullets;
 	m_healthPacks = healthPacks;
 
-	// Clear our arrays to 0 (NULL)
-	memset(m_currentCollisions, 0, sizeof(m_currentCollisions));
-	memset(m_previousCollisions, 0, sizeof(m_previousCollisions));
+	m_currentCollisions = &m_collisionSets[0];
+	m_previousCollisions = &m_collisionSets[1];
 
-	m_nextCurrentCollisionSlot = 0;
+	// One grid cell per board cell. Everything in this game is about the size of a tile.
+	m_enemyGrid.Resize(boardWidth, boardHeight, 1.0f);
+	m_bulletGrid.Resize(boardWidth, boardHeight, 1.0f);
+	m_healthPackGrid.Resize(boardWidth, boardHeight, 1.0f);
+
+	memset(&m_stats, 0, sizeof(m_stats));
+
+	m_continuousBullets = true;
 }
 
 void CollisionManager::CheckCollisions()
 {
+	// Work out who is near who before doing any real collision tests
+	BuildBroadphase();
+
 	// Check all collisions
 	PlayerToEnemy();
 	PlayerToBullet();
 	EnemyToBullet();
 	PlayerToHealthPack();
 
-	// Move all current collisions into previous
-	memcpy(m_previousCollisions, m_currentCollisions, sizeof(m_currentCollisions));
+	// Current collisions become previous collisions, and the old previous set is reused for next tick
+	CollisionPairSet* temp = m_previousCollisions;
+	m_previousCollisions = m_currentCollisions;
+	m_currentCollisions = temp;
 
 	// Clear out current collisions
-	memset(m_currentCollisions, 0, sizeof(m_currentCollisions));
+	m_currentCollisions->Clear();
 
-	// Now current collisions is empty, we'll start adding from the start again
-	m_nextCurrentCollisionSlot = 0;
+	// This tick's cells become last tick's cells
+	m_previousPlayerCells.swap(m_playerCells);
+	m_previousEnemyCells.swap(m_enemyCells);
+	m_previousBulletCells.swap(m_bulletCells);
+	m_previousHealthPackCells.swap(m_healthPackCells);
 
+	m_stats.checks++;
 }
 
-bool CollisionManager::ArrayContainsCollision(GameObject* arrayToSearch[], GameObject* first, GameObject* second)
+void CollisionManager::BuildBroadphase()
 {
-	// See if these two GameObjects appear one after the other in specified collisions array
-	// Stop one before length so we don't overrun as we'll be checking two elements per iteration
-	for (int i = 0; i < MAX_ALLOWED_COLLISIONS - 1; i += 2)
+	m_enemyGrid.Clear();
+	m_bulletGrid.Clear();
+	m_healthPackGrid.Clear();
+
+	PrepareBulletSweeps();
+
+	// Bounding boxes only change in Update so they're the same for every test we do this tick
+	for (unsigned int i = 0; i < m_players->size(); i++)
+	{
+		UpdateCells(&m_playerCells, &m_previousPlayerCells, i, (*m_players)[i]->GetBounds());
+	}
+
+	int availableHealthPacks = 0;
+
+	for (unsigned int i = 0; i < m_enemies->size(); i++)
+	{
+		UpdateCells(&m_enemyCells, &m_previousEnemyCells, i, (*m_enemies)[i]->GetBounds());
+		InsertIntoGrid(&m_enemyGrid, i, m_enemyCells[i], m_previousEnemyCells[i]);
+	}
+
+	// Same rules as the narrowphase, bullets that aren't flying can't hit anything so we only look at the active ones
+	int activeBullets = m_bullets->GetActiveCount();
+
+	for (int slot = 0; slot < activeBullets; slot++)
+	{
+		int i = m_bullets->GetActiveIndex(slot);
+
+		// A bullet's cells need to cover everywhere it's been this tick, not just where it ended up
+		CBoundingBox bounds = m_bullets->GetActiveBounds(slot);
+		Vector3 start = m_bulletStartBounds[i].GetMin();
+		Vector3 end = bounds.GetMin();
+		Vector3 size = bounds.GetMax() - bounds.GetMin();
+		Vector3 sweptMin(start.x < end.x ? start.x : end.x, start.y < end.y ? start.y : end.y, start.z < end.z ? start.z : end.z);
+		Vector3 sweptMax(start.x > end.x ? start.x : end.x, start.y > end.y ? start.y : end.y, start.z > end.z ? start.z : end.z);
+
+		UpdateCells(&m_bulletCells, &m_previousBulletCells, i, CBoundingBox(sweptMin, sweptMax + size));
+		InsertIntoGrid(&m_bulletGrid, i, m_bulletCells[i], m_previousBulletCells[i]);
+	}
+
+	for (unsigned int i = 0; i < m_healthPacks->size(); i++)
 	{
-		if ((arrayToSearch[i] == first && arrayToSearch[i + 1] == second) ||
-			arrayToSearch[i] == second && arrayToSearch[i + 1] == first)
+		UpdateCells(&m_healthPackCells, &m_previousHealthPackCells, i, (*m_healthPacks)[i]->GetBounds());
+
+		if (!(*m_healthPacks)[i]->GetIsUsed())
 		{
-			// Found them!
-			return true;
+			InsertIntoGrid(&m_healthPackGrid, i, m_healthPackCells[i], m_previousHealthPackCells[i]);
+			availableHealthPacks++;
 		}
 	}
 
-	// These objects were not colliding last frame
-	return false;
+	// What the old everything-against-everything loops would have tested
+	long long players = m_players->size();
+	long long enemies = m_enemies->size();
+	m_stats.bruteForcePairs += players * enemies + players * activeBullets + enemies * activeBullets + players * availableHealthPacks;
 }
 
-void CollisionManager::AddCollision(GameObject* first, GameObject* second)
+void CollisionManager::PrepareBulletSweeps()
+{
+	// Indexed by position in the pool, which can grow between ticks
+	m_bulletStartBounds.resize(m_bullets->GetCapacity());
+	m_bulletDisplacements.resize(m_bullets->GetCapacity());
+
+	for (int slot = 0; slot < m_bullets->GetActiveCount(); slot++)
+	{
+		int i = m_bullets->GetActiveIndex(slot);
+		CBoundingBox bounds = m_bullets->GetActiveBounds(slot);
+
+		// Fired this tick counts as a teleport (Fire snaps the previous position too)
+		Vector3 displacement = Vector3::Zero;
+		if (m_continuousBullets)
+		{
+			displacement = m_bullets->GetActiveDisplacement(slot);
+		}
+
+		m_bulletStartBounds[i] = CBoundingBox(bounds.GetMin() - displacement, bounds.GetMax() - displacement);
+		m_bulletDisplacements[i] = displacement;
+	}
+}
+
+bool CollisionManager::BulletSweepHits(int bulletIndex, Bullet* bullet, GameObject* target, const CBoundingBox& targetBounds)
+{
+	// Bullets start off touching whoever fired them, the sweep shouldn't count that as a hit
+	if (!m_continuousBullets || bullet->GetMaster() == target)
+	{
+		return false;
+	}
+
+	return CheckSweep(m_bulletStartBounds[bulletIndex], m_bulletDisplacements[bulletIndex], targetBounds, NULL);
+}
+
+void CollisionManager::UpdateCells(std::vector<CellRect>* cells, std::vector<CellRect>* previousCells, int index, const CBoundingBox& bounds)
+{
+	if (index >= (int)cells->size())
+	{
+		cells->resize(index + 1);
+	}
+
+	(*cells)[index] = m_enemyGrid.GetCellRect(bounds);
+
+	// First time we've seen this object, there is no last tick
+	if (index >= (int)previousCells->size())
+	{
+		previousCells->resize(index + 1, (*cells)[index]);
+	}
+}
+
+void CollisionManager::InsertIntoGrid(BroadphaseGrid* grid, int index, const CellRect& cells, const CellRect& previousCells)
 {
-	// Add the two colliding objects to the current collisions array
-	// We keep track of the next free slot so no searching is required
-	m_currentCollisions[m_nextCurrentCollisionSlot] = first;
-	m_currentCollisions[m_nextCurrentCollisionSlot + 1] = second;
+	grid->Insert(index, cells);
+
+	// Most things haven't changed cell since last tick, no need to add them twice
+	if (!(previousCells == cells))
+	{
+		grid->Insert(index, previousCells);
+	}
+}
+
+void CollisionManager::GatherCandidates(BroadphaseGrid* grid, const CellRect& cells, const CellRect& previousCells)
+{
+	m_candidates.clear();
+
+	grid->BeginQuery();
+	grid->Query(cells, &m_candidates);
+	grid->Query(previousCells, &m_candidates);
+
+	// Test pairs in the same order the brute force loops did so callbacks fire in the same order
+	std::sort(m_candidates.begin(), m_candidates.end());
 
-	m_nextCurrentCollisionSlot += 2;
+	m_stats.broadphasePairs += m_candidates.size();
+}
+
+bool CollisionManager::WasColliding(GameObject* first, GameObject* second)
+{
+	// Pairs are stored by ID and the set doesn't care which way around they are
+	return m_previousCollisions->Contains(first->GetID(), second->GetID());
+}
+
+void CollisionManager::AddCollision(GameObject* first, GameObject* second)
+{
+	// Add the two colliding objects to the current collisions set, it grows if it needs to
+	m_currentCollisions->Add(first->GetID(), second->GetID());
 }
 
 void CollisionManager::PlayerToEnemy()
 {
-	// Here we check each player against each enemy
+	// Here we check each player against each enemy near it
 	for (unsigned int i = 0; i < m_players->size(); i++)
 	{
-		for (unsigned int j = 0; j < m_enemies->size(); j++)
+		GatherCandidates(&m_enemyGrid, m_playerCells[i], m_previousPlayerCells[i]);
+
+		for (unsigned int k = 0; k < m_candidates.size(); k++)
 		{
+			int j = m_candidates[k];
+
 			// Don't need to store pointer to these objects again but favouring clarity
 			// Can't index into these directly as they're a pointer to a vector. We need to dereference them first
 			Player* player = (*m_players)[i];
@@ -80,7 +217,7 @@ void CollisionManager::PlayerToEnemy()
 			bool isColliding = CheckCollision(playerBounds, enemyBounds);
 
 			// Were they colliding last frame?
-			bool wasColliding = ArrayContainsCollision(m_previousCollisions, player, enemy);
+			bool wasColliding = WasColliding(player, enemy);
 
 			// For this part, enemy doesn't need to know it collides with a player
 			// But a player must know it collides with an enemy
@@ -88,6 +225,7 @@ void CollisionManager::PlayerToEnemy()
 			{
 				// Register the collision
 				AddCollision(player, enemy);
+				m_stats.collidingPairs++;
 
 				if (wasColliding)
 				{
@@ -115,15 +253,19 @@ void CollisionManager::PlayerToEnemy()
 
 void CollisionManager::PlayerToBullet()
 {
-	// Here we check each player against each bullet
+	// Here we check each player against each bullet near it
 	for (unsigned int i = 0; i < m_players->size(); i++)
 	{
-		for (unsigned int j = 0; j < m_bullets->size(); j++)
+		GatherCandidates(&m_bulletGrid, m_playerCells[i], m_previousPlayerCells[i]);
+
+		for (unsigned int k = 0; k < m_candidates.size(); k++)
 		{
+			int j = m_candidates[k];
+
 			// Don't need to store pointer to these objects again but favouring clarity
 			// Can't index into these directly as they're a pointer to a vector. We need to dereference them first
 			Player* player = (*m_players)[i];
-			Bullet* bullet = (*m_bullets)[j];
+			Bullet* bullet = m_bullets->GetBullet(j);
 
 			// Only check collision if a bullet is being used
 			if (bullet->GetBeingUsed())
@@ -131,11 +273,11 @@ void CollisionManager::PlayerToBullet()
 				CBoundingBox playerBounds = player->GetBounds();
 				CBoundingBox bulletBounds = bullet->GetBounds();
 
-				// Are they colliding this frame?
-				bool isColliding = CheckCollision(playerBounds, bulletBounds);
+				// Are they colliding this frame? (or did the bullet pass through them on the way)
+				bool isColliding = CheckCollision(playerBounds, bulletBounds) || BulletSweepHits(j, bullet, player, playerBounds);
 
 				// Were they colliding last frame?
-				bool wasColliding = ArrayContainsCollision(m_previousCollisions, player, bullet);
+				bool wasColliding = WasColliding(player, bullet);
 
 				// For this part, enemy doesn't need to know it collides with a player
 				// But a player must know it collides with an enemy
@@ -143,6 +285,7 @@ void CollisionManager::PlayerToBullet()
 				{
 					// Register the collision
 					AddCollision(player, bullet);
+					m_stats.collidingPairs++;
 
 					if (wasColliding)
 					{
@@ -173,15 +316,19 @@ void CollisionManager::PlayerToBullet()
 
 void CollisionManager::EnemyToBullet()
 {
-	// Here we check each enemy against each bullet
+	// Here we check each enemy against each bullet near it
 	for (unsigned int i = 0; i < m_enemies->size(); i++)
 	{
-		for (unsigned int j = 0; j < m_bullets->size(); j++)
+		GatherCandidates(&m_bulletGrid, m_enemyCells[i], m_previousEnemyCells[i]);
+
+		for (unsigned int k = 0; k < m_candidates.size(); k++)
 		{
+			int j = m_candidates[k];
+
 			// Don't need to store pointer to these objects again but favouring clarity
 			// Can't index into these directly as they're a pointer to a vector. We need to dereference them first
 			Enemy* enemy = (*m_enemies)[i];
-			Bullet* bullet = (*m_bullets)[j];
+			Bullet* bullet = m_bullets->GetBullet(j);
 
 			// Only check collision if a bullet is being used
 			if (bullet->GetBeingUsed())
@@ -189,11 +336,11 @@ void CollisionManager::EnemyToBullet()
 				CBoundingBox enemyBounds = enemy->GetBounds();
 				CBoundingBox bulletBounds = bullet->GetBounds();
 
-				// Are they colliding this frame?
-				bool isColliding = CheckCollision(enemyBounds, bulletBounds);
+				// Are they colliding this frame? (or did the bullet pass through them on the way)
+				bool isColliding = CheckCollision(enemyBounds, bulletBounds) || BulletSweepHits(j, bullet, enemy, enemyBounds);
 
 				// Were they colliding last frame?
-				bool wasColliding = ArrayContainsCollision(m_previousCollisions, enemy, bullet);
+				bool wasColliding = WasColliding(enemy, bullet);
 
 				// For this part, enemy doesn't need to know it collides with a player
 				// But a player must know it collides with an enemy
@@ -201,6 +348,7 @@ void CollisionManager::EnemyToBullet()
 				{
 					// Register the collision
 					AddCollision(enemy, bullet);
+					m_stats.collidingPairs++;
 
 					if (wasColliding)
 					{
@@ -233,11 +381,15 @@ void CollisionManager::EnemyToBullet()
 
 void CollisionManager::PlayerToHealthPack()
 {
-	// Here we check each player against each health pack
+	// Here we check each player against each health pack near it
 	for (unsigned int i = 0; i < m_players->size(); i++)
 	{
-		for (unsigned int j = 0; j < m_healthPacks->size(); j++)
+		GatherCandidates(&m_healthPackGrid, m_playerCells[i], m_previousPlayerCells[i]);
+
+		for (unsigned int k = 0; k < m_candidates.size(); k++)
 		{
+			int j = m_candidates[k];
+
 			// Don't need to store pointer to these objects again but favouring clarity
 			// Can't index into these directly as they're a pointer to a vector. We need to dereference them first
 			Player* player = (*m_players)[i];
@@ -253,7 +405,7 @@ void CollisionManager::PlayerToHealthPack()
 				bool isColliding = CheckCollision(playerBounds, healthBounds);
 
 				// Were they colliding last frame?
-				bool wasColliding = ArrayContainsCollision(m_previousCollisions, player, healthPack);
+				bool wasColliding = WasColliding(player, healthPack);
 
 				// For this part, enemy doesn't need to know it collides with a player
 				// But a player must know it collides with an enemy
@@ -261,6 +413,7 @@ void CollisionManager::PlayerToHealthPack()
 				{
 					// Register the collision
 					AddCollision(player, healthPack);
+					m_stats.collidingPairs++;
 
 					if (wasColliding)
 					{
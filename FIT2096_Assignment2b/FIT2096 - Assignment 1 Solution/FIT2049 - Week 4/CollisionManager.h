@@ -4,11 +4,21 @@
 #define COLLISION_MANAGER_H
 
 #include <vector>
+#include "BroadphaseGrid.h"
+#include "CollisionPairSet.h"
 #include "Collisions.h"
 #include "Player.h"
 #include "Enemy.h"
+#include "BulletPool.h"
 
-#define MAX_ALLOWED_COLLISIONS 2048
+// Running totals so we can see how much work the broadphase is saving us
+struct CollisionStats
+{
+	int checks;						// How many times CheckCollisions has run
+	long long bruteForcePairs;		// Pairs we would have tested by checking everything against everything
+	long long broadphasePairs;		// Pairs that shared a cell and actually got a narrowphase test
+	long long collidingPairs;		// Pairs that were overlapping
+};
 
 class CollisionManager
 {
@@ -16,18 +26,56 @@ private:
 	// Check collision of player, enemies, bullets, healthpacks, walls, etc
 	std::vector<Player*>* m_players;
 	std::vector<Enemy*>* m_enemies;
-	std::vector<Bullet*>* m_bullets;
+	BulletPool* m_bullets;
 	std::vector<HealthPack*>* m_healthPacks;
 
-	GameObject* m_currentCollisions[MAX_ALLOWED_COLLISIONS];
+	// Two sets which swap roles every tick, so last tick's collisions never need copying
+	CollisionPairSet m_collisionSets[2];
+	CollisionPairSet* m_currentCollisions;
 
 	// We need to know what objects were colliding last frame so we can determine if a collision has just begun or ended
-	GameObject* m_previousCollisions[MAX_ALLOWED_COLLISIONS];
-
-	int m_nextCurrentCollisionSlot;
-
-	// Check if we already know about two objects colliding
-	bool ArrayContainsCollision(GameObject* arrayToSearch[], GameObject* first, GameObject* second);
+	CollisionPairSet* m_previousCollisions;
+
+	// Broadphase. Enemies, bullets and health packs are bucketed into grid cells each tick,
+	// players and enemies then only test against what's in the cells they cover.
+	BroadphaseGrid m_enemyGrid;
+	BroadphaseGrid m_bulletGrid;
+	BroadphaseGrid m_healthPackGrid;
+
+	// The cells each object covered this tick and last tick. Objects are found in both so that a pair
+	// which was colliding last tick is always tested again, otherwise we'd never see it exit.
+	std::vector<CellRect> m_playerCells;
+	std::vector<CellRect> m_enemyCells;
+	std::vector<CellRect> m_bulletCells;
+	std::vector<CellRect> m_healthPackCells;
+	std::vector<CellRect> m_previousPlayerCells;
+	std::vector<CellRect> m_previousEnemyCells;
+	std::vector<CellRect> m_previousBulletCells;
+	std::vector<CellRect> m_previousHealthPackCells;
+
+	std::vector<int> m_candidates;
+
+	// Continuous bullets. Where each bullet started this tick and how far it moved, worked out once
+	// for all bullets up front. Fast bullets (or long ticks) can jump right over something between
+	// two overlap tests, so we also check the path they took.
+	bool m_continuousBullets;
+	std::vector<CBoundingBox> m_bulletStartBounds;
+	std::vector<Vector3> m_bulletDisplacements;
+
+	void PrepareBulletSweeps();
+	bool BulletSweepHits(int bulletIndex, Bullet* bullet, GameObject* target, const CBoundingBox& targetBounds);
+	CollisionStats m_stats;
+
+	// Rebuilds the grids from this tick's bounding boxes
+	void BuildBroadphase();
+	void UpdateCells(std::vector<CellRect>* cells, std::vector<CellRect>* previousCells, int index, const CBoundingBox& bounds);
+	void InsertIntoGrid(BroadphaseGrid* grid, int index, const CellRect& cells, const CellRect& previousCells);
+
+	// Fills m_candidates with everything in the grid near an object, in index order
+	void GatherCandidates(BroadphaseGrid* grid, const CellRect& cells, const CellRect& previousCells);
+
+	// Check if two objects were colliding last tick
+	bool WasColliding(GameObject* first, GameObject* second);
 
 	// Register that a collision has occurred
 	void AddCollision(GameObject* first, GameObject* second);
@@ -40,9 +88,15 @@ private:
 
 
 public:
-	CollisionManager(std::vector<Player*>* players, std::vector<Enemy*>* enemies, std::vector<Bullet*>* bullets, std::vector<HealthPack*>* healthPacks);
+	CollisionManager(std::vector<Player*>* players, std::vector<Enemy*>* enemies, BulletPool* bullets, std::vector<HealthPack*>* healthPacks, int boardWidth, int boardHeight);
 	void CheckCollisions();
 
+	CollisionStats GetStats() { return m_stats; }
+
+	// On by default. With it off bullets only hit what they overlap at the end of a tick.
+	void SetContinuousBullets(bool continuous) { m_continuousBullets = continuous; }
+	bool GetContinuousBullets() { return m_continuousBullets; }
+
 };
 
 #endif
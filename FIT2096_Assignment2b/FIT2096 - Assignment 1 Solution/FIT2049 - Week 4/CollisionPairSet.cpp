@@ -0,0 +1,135 @@
+/*	FIT2096 - Assignment 2b
+*	CollisionPairSet.cpp
+*	Implementation of CollisionPairSet.h
+*/
+
+#include "CollisionPairSet.h"
+
+// Plenty for a normal game, we'll grow if we ever need more
+#define INITIAL_PAIR_CAPACITY 64
+
+CollisionPairSet::CollisionPairSet()
+{
+	m_keys.assign(INITIAL_PAIR_CAPACITY, 0);
+	m_generations.assign(INITIAL_PAIR_CAPACITY, 0);
+	m_generation = 1;
+	m_mask = INITIAL_PAIR_CAPACITY - 1;
+	m_count = 0;
+}
+
+unsigned long long CollisionPairSet::MakeKey(unsigned int first, unsigned int second)
+{
+	// Smallest ID always goes in the top half so the order the pair was given in doesn't matter
+	if (first > second)
+	{
+		unsigned int temp = first;
+		first = second;
+		second = temp;
+	}
+
+	return ((unsigned long long)first << 32) | second;
+}
+
+unsigned int CollisionPairSet::Hash(unsigned long long key)
+{
+	// IDs are handed out in order so neighbouring keys are very similar, mix the bits up before using them
+	key ^= key >> 33;
+	key *= 0xff51afd7ed558ccdULL;
+	key ^= key >> 33;
+	return (unsigned int)key;
+}
+
+void CollisionPairSet::Clear()
+{
+	m_generation++;
+	m_count = 0;
+
+	// Wrapped around, an old slot could now look like it's in use so really clear them this once
+	if (m_generation == 0)
+	{
+		m_generations.assign(m_generations.size(), 0);
+		m_generation = 1;
+	}
+}
+
+bool CollisionPairSet::Add(unsigned int first, unsigned int second)
+{
+	// Keep the table at most half full so probe runs stay short
+	if ((m_count + 1) * 2 > (int)m_keys.size())
+	{
+		Grow();
+	}
+
+	unsigned long long key = MakeKey(first, second);
+
+	for (unsigned int slot = Hash(key) & m_mask; ; slot = (slot + 1) & m_mask)
+	{
+		if (m_generations[slot] != m_generation)
+		{
+			// Empty slot, the pair isn't in here yet
+			m_keys[slot] = key;
+			m_generations[slot] = m_generation;
+			m_count++;
+			return true;
+		}
+
+		if (m_keys[slot] == key)
+		{
+			return false;
+		}
+	}
+}
+
+bool CollisionPairSet::Contains(unsigned int first, unsigned int second)
+{
+	unsigned long long key = MakeKey(first, second);
+
+	// There is always at least one empty slot so this will stop
+	for (unsigned int slot = Hash(key) & m_mask; ; slot = (slot + 1) & m_mask)
+	{
+		if (m_generations[slot] != m_generation)
+		{
+			return false;
+		}
+
+		if (m_keys[slot] == key)
+		{
+			return true;
+		}
+	}
+}
+
+void CollisionPairSet::Grow()
+{
+	std::vector<unsigned long long> oldKeys;
+	std::vector<unsigned int> oldGenerations;
+	oldKeys.swap(m_keys);
+	oldGenerations.swap(m_generations);
+
+	unsigned int oldGeneration = m_generation;
+	int capacity = (int)oldKeys.size() * 2;
+
+	m_keys.assign(capacity, 0);
+	m_generations.assign(capacity, 0);
+	m_generation = 1;
+	m_mask = capacity - 1;
+	m_count = 0;
+
+	// Put everything that's currently in the set back in with the new mask
+	for (unsigned int i = 0; i < oldKeys.size(); i++)
+	{
+		if (oldGenerations[i] == oldGeneration)
+		{
+			unsigned int slot = Hash(oldKeys[i]) & m_mask;
+
+			while (m_generations[slot] == m_generation)
+			{
+				slot = (slot + 1) & m_mask;
+			}
+
+			m_keys[slot] = oldKeys[i];
+			m_generations[slot] = m_generation;
+			m_count++;
+		}
+	}
+}
@@ -0,0 +1,44 @@
+/*	FIT2096 - Assignment 2b
+*	CollisionPairSet.h
+*	A hash set of pairs of GameObject IDs, used to remember which objects are colliding.
+*	Uses open addressing (linear probing) in one flat array so lookups don't chase pointers.
+*	Each slot is stamped with the generation it was written in, so emptying the whole set is
+*	just bumping the generation rather than clearing every slot. The table grows when it gets
+*	half full so there's no limit on how many collisions we can track.
+*/
+
+#ifndef COLLISION_PAIR_SET_H
+#define COLLISION_PAIR_SET_H
+
+#include <vector>
+
+class CollisionPairSet
+{
+private:
+	std::vector<unsigned long long> m_keys;
+	std::vector<unsigned int> m_generations;	// A slot is only in use if this matches m_generation
+	unsigned int m_generation;
+	unsigned int m_mask;						// Capacity is always a power of two so we can mask instead of mod
+	int m_count;
+
+	// The same key for (a, b) and (b, a)
+	static unsigned long long MakeKey(unsigned int first, unsigned int second);
+	static unsigned int Hash(unsigned long long key);
+
+	void Grow();
+
+public:
+	CollisionPairSet();
+
+	// Empties the set without touching the table
+	void Clear();
+
+	// Returns false if the pair was already in the set
+	bool Add(unsigned int first, unsigned int second);
+	bool Contains(unsigned int first, unsigned int second);
+
+	int GetCount() { return m_count; }
+	int GetCapacity() { return (int)m_keys.size(); }
+};
+
+#endif
@@ -2,6 +2,13 @@
 
 #include <DirectXMath.h>
 
+// DirectXMath has already worked out what this compiler/CPU can do, so we go with what it picked
+#if defined(_XM_AVX_INTRINSICS_)
+#include <immintrin.h>
+#elif defined(_XM_SSE_INTRINSICS_)
+#include <xmmintrin.h>
+#endif
+
 Vector3 ClosestPointInBoundingBox(const CBoundingBox& bb, const Vector3& point)
 {
 	Vector3 result = point;
@@ -51,6 +58,252 @@ bool CheckCollision(const CBoundingBox& bb1, const CBoundingBox& bb2)
 		bb1.GetMin().y < bb2.GetMax().y &&
 		bb1.GetMin().z < bb2.GetMax().z);
 }
+
+CBoundingBoxBlock::CBoundingBoxBlock()
+{
+	m_count = 0;
+}
+
+void CBoundingBoxBlock::Clear()
+{
+	// Turn everything back into padding, keeping the memory around for next time
+	for (int i = 0; i < m_count; i++)
+	{
+		m_minX[i] = m_minY[i] = m_minZ[i] = INFINITY;
+		m_maxX[i] = m_maxY[i] = m_maxZ[i] = -INFINITY;
+	}
+
+	m_count = 0;
+}
+
+int CBoundingBoxBlock::Add(const CBoundingBox& bb)
+{
+	if (m_count == (int)m_minX.size())
+	{
+		// Out of room, add another register's worth of padding
+		int paddedCount = m_count + COLLISION_BLOCK_WIDTH;
+		m_minX.resize(paddedCount, INFINITY);
+		m_minY.resize(paddedCount, INFINITY);
+		m_minZ.resize(paddedCount, INFINITY);
+		m_maxX.resize(paddedCount, -INFINITY);
+		m_maxY.resize(paddedCount, -INFINITY);
+		m_maxZ.resize(paddedCount, -INFINITY);
+	}
+
+	Set(m_count, bb);
+	return m_count++;
+}
+
+void CBoundingBoxBlock::Set(int index, const CBoundingBox& bb)
+{
+	Vector3 min = bb.GetMin();
+	Vector3 max = bb.GetMax();
+
+	m_minX[index] = min.x;
+	m_minY[index] = min.y;
+	m_minZ[index] = min.z;
+	m_maxX[index] = max.x;
+	m_maxY[index] = max.y;
+	m_maxZ[index] = max.z;
+}
+
+CBoundingSphereBlock::CBoundingSphereBlock()
+{
+	m_count = 0;
+}
+
+void CBoundingSphereBlock::Clear()
+{
+	for (int i = 0; i < m_count; i++)
+	{
+		m_centerX[i] = m_centerY[i] = m_centerZ[i] = INFINITY;
+		m_radius[i] = 0.0f;
+	}
+
+	m_count = 0;
+}
+
+int CBoundingSphereBlock::Add(const CBoundingSphere& sphere)
+{
+	if (m_count == (int)m_centerX.size())
+	{
+		int paddedCount = m_count + COLLISION_BLOCK_WIDTH;
+		m_centerX.resize(paddedCount, INFINITY);
+		m_centerY.resize(paddedCount, INFINITY);
+		m_centerZ.resize(paddedCount, INFINITY);
+		m_radius.resize(paddedCount, 0.0f);
+	}
+
+	Set(m_count, sphere);
+	return m_count++;
+}
+
+void CBoundingSphereBlock::Set(int index, const CBoundingSphere& sphere)
+{
+	Vector3 center = sphere.GetCenter();
+
+	m_centerX[index] = center.x;
+	m_centerY[index] = center.y;
+	m_centerZ[index] = center.z;
+	m_radius[index] = sphere.GetRadius();
+}
+
+static int CountBits(unsigned int bits)
+{
+	int count = 0;
+
+	while (bits)
+	{
+		// Clears the lowest set bit
+		bits &= bits - 1;
+		count++;
+	}
+
+	return count;
+}
+
+int CheckCollisionBatch(const CBoundingBox& bb, const CBoundingBoxBlock& block, std::vector<unsigned int>* hitMasks)
+{
+	// Padded count is a multiple of the block width (and of 4) so every load below is a full one
+	int paddedCount = block.GetPaddedCount();
+	hitMasks->assign((paddedCount + 31) / 32, 0);
+
+	const float* minX = block.GetMinX();
+	const float* minY = block.GetMinY();
+	const float* minZ = block.GetMinZ();
+	const float* maxX = block.GetMaxX();
+	const float* maxY = block.GetMaxY();
+	const float* maxZ = block.GetMaxZ();
+
+	// Same test as CheckCollision(bb1, bb2) with bb as the first box, just several at once
+	Vector3 bbMin = bb.GetMin();
+	Vector3 bbMax = bb.GetMax();
+	int hits = 0;
+
+#if defined(_XM_AVX_INTRINSICS_)
+	__m256 bbMinX = _mm256_set1_ps(bbMin.x);
+	__m256 bbMinY = _mm256_set1_ps(bbMin.y);
+	__m256 bbMinZ = _mm256_set1_ps(bbMin.z);
+	__m256 bbMaxX = _mm256_set1_ps(bbMax.x);
+	__m256 bbMaxY = _mm256_set1_ps(bbMax.y);
+	__m256 bbMaxZ = _mm256_set1_ps(bbMax.z);
+
+	for (int i = 0; i < paddedCount; i += 8)
+	{
+		__m256 overlapX = _mm256_and_ps(_mm256_cmp_ps(bbMaxX, _mm256_loadu_ps(minX + i), _CMP_GT_OQ), _mm256_cmp_ps(bbMinX, _mm256_loadu_ps(maxX + i), _CMP_LT_OQ));
+		__m256 overlapY = _mm256_and_ps(_mm256_cmp_ps(bbMaxY, _mm256_loadu_ps(minY + i), _CMP_GT_OQ), _mm256_cmp_ps(bbMinY, _mm256_loadu_ps(maxY + i), _CMP_LT_OQ));
+		__m256 overlapZ = _mm256_and_ps(_mm256_cmp_ps(bbMaxZ, _mm256_loadu_ps(minZ + i), _CMP_GT_OQ), _mm256_cmp_ps(bbMinZ, _mm256_loadu_ps(maxZ + i), _CMP_LT_OQ));
+
+		unsigned int bits = (unsigned int)_mm256_movemask_ps(_mm256_and_ps(overlapX, _mm256_and_ps(overlapY, overlapZ)));
+		(*hitMasks)[i >> 5] |= bits << (i & 31);
+		hits += CountBits(bits);
+	}
+#elif defined(_XM_SSE_INTRINSICS_)
+	__m128 bbMinX = _mm_set1_ps(bbMin.x);
+	__m128 bbMinY = _mm_set1_ps(bbMin.y);
+	__m128 bbMinZ = _mm_set1_ps(bbMin.z);
+	__m128 bbMaxX = _mm_set1_ps(bbMax.x);
+	__m128 bbMaxY = _mm_set1_ps(bbMax.y);
+	__m128 bbMaxZ = _mm_set1_ps(bbMax.z);
+
+	for (int i = 0; i < paddedCount; i += 4)
+	{
+		__m128 overlapX = _mm_and_ps(_mm_cmpgt_ps(bbMaxX, _mm_loadu_ps(minX + i)), _mm_cmplt_ps(bbMinX, _mm_loadu_ps(maxX + i)));
+		__m128 overlapY = _mm_and_ps(_mm_cmpgt_ps(bbMaxY, _mm_loadu_ps(minY + i)), _mm_cmplt_ps(bbMinY, _mm_loadu_ps(maxY + i)));
+		__m128 overlapZ = _mm_and_ps(_mm_cmpgt_ps(bbMaxZ, _mm_loadu_ps(minZ + i)), _mm_cmplt_ps(bbMinZ, _mm_loadu_ps(maxZ + i)));
+
+		unsigned int bits = (unsigned int)_mm_movemask_ps(_mm_and_ps(overlapX, _mm_and_ps(overlapY, overlapZ)));
+		(*hitMasks)[i >> 5] |= bits << (i & 31);
+		hits += CountBits(bits);
+	}
+#else
+	for (int i = 0; i < paddedCount; i++)
+	{
+		if (bbMax.x > minX[i] && bbMax.y > minY[i] && bbMax.z > minZ[i] &&
+			bbMin.x < maxX[i] && bbMin.y < maxY[i] && bbMin.z < maxZ[i])
+		{
+			(*hitMasks)[i >> 5] |= 1u << (i & 31);
+			hits++;
+		}
+	}
+#endif
+
+	return hits;
+}
+
+int CheckCollisionBatch(const CBoundingSphere& sphere, const CBoundingSphereBlock& block, std::vector<unsigned int>* hitMasks)
+{
+	int paddedCount = block.GetPaddedCount();
+	hitMasks->assign((paddedCount + 31) / 32, 0);
+
+	const float* centerX = block.GetCenterX();
+	const float* centerY = block.GetCenterY();
+	const float* centerZ = block.GetCenterZ();
+	const float* radius = block.GetRadius();
+
+	// Compares squared distances to avoid a square root per sphere
+	// (so right on the boundary it can disagree with CheckCollision by a rounding error)
+	Vector3 center = sphere.GetCenter();
+	float sphereRadius = sphere.GetRadius();
+	int hits = 0;
+
+#if defined(_XM_AVX_INTRINSICS_)
+	__m256 x = _mm256_set1_ps(center.x);
+	__m256 y = _mm256_set1_ps(center.y);
+	__m256 z = _mm256_set1_ps(center.z);
+	__m256 r = _mm256_set1_ps(sphereRadius);
+
+	for (int i = 0; i < paddedCount; i += 8)
+	{
+		__m256 dx = _mm256_sub_ps(_mm256_loadu_ps(centerX + i), x);
+		__m256 dy = _mm256_sub_ps(_mm256_loadu_ps(centerY + i), y);
+		__m256 dz = _mm256_sub_ps(_mm256_loadu_ps(centerZ + i), z);
+		__m256 reach = _mm256_add_ps(_mm256_loadu_ps(radius + i), r);
+
+		__m256 distanceSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_add_ps(_mm256_mul_ps(dy, dy), _mm256_mul_ps(dz, dz)));
+
+		unsigned int bits = (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(distanceSq, _mm256_mul_ps(reach, reach), _CMP_LE_OQ));
+		(*hitMasks)[i >> 5] |= bits << (i & 31);
+		hits += CountBits(bits);
+	}
+#elif defined(_XM_SSE_INTRINSICS_)
+	__m128 x = _mm_set1_ps(center.x);
+	__m128 y = _mm_set1_ps(center.y);
+	__m128 z = _mm_set1_ps(center.z);
+	__m128 r = _mm_set1_ps(sphereRadius);
+
+	for (int i = 0; i < paddedCount; i += 4)
+	{
+		__m128 dx = _mm_sub_ps(_mm_loadu_ps(centerX + i), x);
+		__m128 dy = _mm_sub_ps(_mm_loadu_ps(centerY + i), y);
+		__m128 dz = _mm_sub_ps(_mm_loadu_ps(centerZ + i), z);
+		__m128 reach = _mm_add_ps(_mm_loadu_ps(radius + i), r);
+
+		__m128 distanceSq = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_add_ps(_mm_mul_ps(dy, dy), _mm_mul_ps(dz, dz)));
+
+		unsigned int bits = (unsigned int)_mm_movemask_ps(_mm_cmple_ps(distanceSq, _mm_mul_ps(reach, reach)));
+		(*hitMasks)[i >> 5] |= bits << (i & 31);
+		hits += CountBits(bits);
+	}
+#else
+	for (int i = 0; i < paddedCount; i++)
+	{
+		float dx = centerX[i] - center.x;
+		float dy = centerY[i] - center.y;
+		float dz = centerZ[i] - center.z;
+		float reach = radius[i] + sphereRadius;
+
+		if (dx * dx + (dy * dy + dz * dz) <= reach * reach)
+		{
+			(*hitMasks)[i >> 5] |= 1u << (i & 31);
+			hits++;
+		}
+	}
+#endif
+
+	return hits;
+}
+
 PLANE_RESULT CheckPlane(const CPlane& plane, const Vector3& point)
 {
 	float distance = plane.GetNormal().Dot(point) + plane.GetDistance();
@@ -230,4 +483,61 @@ bool CheckRay(const CRay& ray, const CPlane& plane, Vector3* hitPoint)
 		hitPoint->z = pointOnPlane.z;
 	}
 	return true;
-}
\ No newline at end of file
+}
+
+// One axis of the sweep. Narrows [entry, exit] down to the part of the move spent strictly between slabMin
+// and slabMax, the same as CheckCollision counts overlap. Not moving on this axis means we're either between
+// them the whole time or never, dividing by the zero would give infinities (and NaN right on a face).
+static bool SweepAxis(float origin, float move, float slabMin, float slabMax, float* entry, float* exit)
+{
+	if (move == 0.0f)
+	{
+		return origin > slabMin && origin < slabMax;
+	}
+
+	float t1 = (slabMin - origin) / move;
+	float t2 = (slabMax - origin) / move;
+
+	*entry = max(*entry, min(t1, t2));
+	*exit = min(*exit, max(t1, t2));
+
+	return *entry < *exit;
+}
+
+bool CheckSweep(const CBoundingBox& box, const Vector3& displacement, const CBoundingBox& target, float* hitTime)
+{
+	// Sweeping a box against a box is the same as moving the moving box's min corner through
+	// the target grown by the size of the moving box, so it's a slab test over the move
+	Vector3 size = box.GetMax() - box.GetMin();
+	CBoundingBox grown(target.GetMin() - size, target.GetMax());
+	Vector3 origin = box.GetMin();
+
+	// Already touching at the start of the move
+	if (CheckCollision(box, target))
+	{
+		if (hitTime)
+			*hitTime = 0.0f;
+		return true;
+	}
+
+	// Didn't move, so the test above was the whole story
+	if (displacement.LengthSquared() == 0.0f)
+	{
+		return false;
+	}
+
+	// Displacement isn't normalised so these are fractions of the move, anything past 1 is next tick's problem
+	float entry = 0.0f;
+	float exit = 1.0f;
+
+	if (!SweepAxis(origin.x, displacement.x, grown.GetMin().x, grown.GetMax().x, &entry, &exit) ||
+		!SweepAxis(origin.y, displacement.y, grown.GetMin().y, grown.GetMax().y, &entry, &exit) ||
+		!SweepAxis(origin.z, displacement.z, grown.GetMin().z, grown.GetMax().z, &entry, &exit))
+	{
+		return false;
+	}
+
+	if (hitTime)
+		*hitTime = entry;
+	return true;
+}
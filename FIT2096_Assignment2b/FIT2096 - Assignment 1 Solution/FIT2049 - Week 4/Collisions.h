@@ -5,11 +5,15 @@
 
 #include <d3d11.h>
 #include "DirectXTK/SimpleMath.h"
+#include <vector>
 
 using namespace DirectX::SimpleMath;
 
 #define ON_PLANE_AMOUNT 0.001f
 
+// Blocks are padded to a multiple of this so the batch tests can always do a full SIMD register at a time
+#define COLLISION_BLOCK_WIDTH 8
+
 enum PLANE_RESULT
 {
 	PLANE_IN_FRONT = 0,
@@ -89,12 +93,70 @@ public:
 	void Verify() { m_direction.Normalize(); }
 };
 
+// Lots of boxes stored one component per array (structure of arrays), so the batch tests
+// can load the same component of several boxes with one instruction.
+// The unused end of the arrays is filled with inside out boxes that can never hit anything.
+class CBoundingBoxBlock
+{
+private:
+	std::vector<float> m_minX, m_minY, m_minZ;
+	std::vector<float> m_maxX, m_maxY, m_maxZ;
+	int m_count;
+
+public:
+	CBoundingBoxBlock();
+
+	void Clear();
+	int Add(const CBoundingBox& bb);
+	void Set(int index, const CBoundingBox& bb);
+
+	int GetCount() const { return m_count; }
+	int GetPaddedCount() const { return (int)m_minX.size(); }
+
+	const float* GetMinX() const { return m_minX.data(); }
+	const float* GetMinY() const { return m_minY.data(); }
+	const float* GetMinZ() const { return m_minZ.data(); }
+	const float* GetMaxX() const { return m_maxX.data(); }
+	const float* GetMaxY() const { return m_maxY.data(); }
+	const float* GetMaxZ() const { return m_maxZ.data(); }
+};
+
+// Same idea for spheres. Padding spheres sit infinitely far away.
+class CBoundingSphereBlock
+{
+private:
+	std::vector<float> m_centerX, m_centerY, m_centerZ;
+	std::vector<float> m_radius;
+	int m_count;
+
+public:
+	CBoundingSphereBlock();
+
+	void Clear();
+	int Add(const CBoundingSphere& sphere);
+	void Set(int index, const CBoundingSphere& sphere);
+
+	int GetCount() const { return m_count; }
+	int GetPaddedCount() const { return (int)m_centerX.size(); }
+
+	const float* GetCenterX() const { return m_centerX.data(); }
+	const float* GetCenterY() const { return m_centerY.data(); }
+	const float* GetCenterZ() const { return m_centerZ.data(); }
+	const float* GetRadius() const { return m_radius.data(); }
+};
+
 bool CheckCollision(const CBoundingSphere& sphere, const Vector3& point);
 bool CheckCollision(const CBoundingSphere& sphere1, const CBoundingSphere& sphere2);
 bool CheckCollision(const CBoundingSphere& sphere, const CBoundingBox& bb);
 bool CheckCollision(const CBoundingBox& bb, const Vector3& point);
 bool CheckCollision(const CBoundingBox& bb1, const CBoundingBox& bb2);
 
+// One against many. Bit (i % 32) of (*hitMasks)[i / 32] is set if the object hit block entry i.
+// hitMasks is resized to fit the block. Returns how many entries were hit.
+// Uses SSE (or AVX if the compiler is allowed to) when DirectXMath does, otherwise plain C++.
+int CheckCollisionBatch(const CBoundingBox& bb, const CBoundingBoxBlock& block, std::vector<unsigned int>* hitMasks);
+int CheckCollisionBatch(const CBoundingSphere& sphere, const CBoundingSphereBlock& block, std::vector<unsigned int>* hitMasks);
+
 PLANE_RESULT CheckPlane(const CPlane& plane, const Vector3& point);
 PLANE_RESULT CheckPlane(const CPlane& plane, const CBoundingSphere& sphere);
 PLANE_RESULT CheckPlane(const CPlane& plane, const CBoundingBox& bb);
@@ -103,4 +165,8 @@ bool CheckRay(const CRay& ray, const CBoundingSphere& sphere, Vector3* hitPoint)
 bool CheckRay(const CRay& ray, const CBoundingBox& bb, Vector3* hitPoint);
 bool CheckRay(const CRay& ray, const CPlane& plane, Vector3* hitPoint);
 
+// Continuous test for something that moved by displacement this tick, starting at box.
+// hitTime (optional) gets how far through the move the first touch was, 0 to 1.
+bool CheckSweep(const CBoundingBox& box, const Vector3& displacement, const CBoundingBox& target, float* hitTime);
+
 #endif
\ No newline at end of file
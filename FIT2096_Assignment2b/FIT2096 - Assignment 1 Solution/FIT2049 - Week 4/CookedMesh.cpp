@@ -0,0 +1,240 @@
+/*	FIT2096 - Assignment 2b
+*	CookedMesh.cpp
+*	Implementation of CookedMesh.h
+*/
+
+#include "CookedMesh.h"
+#include "MappedFile.h"
+#include "ObjParser.h"
+#include "MeshOptimiser.h"
+
+#include <Windows.h>
+#include <d3d11.h>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+
+using namespace std;
+
+bool CookedMesh::CookObj(const char* filename, CookedMesh* cooked)
+{
+	MappedFile file;
+
+	if (!file.Open(filename))
+		return false;
+
+	return CookObj(filename, file.GetData(), file.GetSize(), cooked);
+}
+
+bool CookedMesh::CookObj(const char* filename, const char* text, size_t length, CookedMesh* cooked)
+{
+	// The parser reads the whole file in one go. It gives us the raw positions, normals and uvs from the file,
+	// plus three corners for every triangle saying which of each to use (faces with more points are already cut into triangles)
+	ObjMeshData obj;
+	if (!ObjParser::Parse(text, length, &obj) || obj.corners.size() == 0)
+		return false;
+
+	int cornerCount = (int)obj.corners.size();
+
+	// First every corner gets its own vertex
+	vector<MeshVertex> corners(cornerCount);
+	for (int i = 0; i < cornerCount; i++)
+	{
+		const ObjCorner& corner = obj.corners[i];
+
+		corners[i].position = obj.positions[corner.position];
+		corners[i].colour = Color(1.0f, 1.0f, 1.0f);
+
+		// Faces don't have to give a uv or normal, we use zero if they don't
+		corners[i].texCoord = corner.uv >= 0 ? obj.uvs[corner.uv] : Vector2::Zero;
+		corners[i].normal = corner.normal >= 0 ? obj.normals[corner.normal] : Vector3::Zero;
+	}
+
+	// Most corners are shared by a few triangles and end up exactly the same, so they only need to be stored (and transformed) once.
+	// Welding gives each corner the number of its unique vertex, which is exactly what the index buffer needs.
+	vector<unsigned long> cornerToVertex;
+	int vertexCount = MeshOptimiser::Weld(&corners[0], cornerCount, sizeof(MeshVertex), &cornerToVertex);
+	cooked->indices = cornerToVertex;
+
+	// Then reorder the triangles so the GPU can reuse vertices it has just transformed,
+	// and number the vertices in the order they're drawn so they're read from memory in order too
+	float acmrBefore = MeshOptimiser::GetACMR(&cooked->indices[0], cornerCount, vertexCount);
+	MeshOptimiser::OptimiseVertexCache(&cooked->indices[0], cornerCount, vertexCount);
+	float acmrAfter = MeshOptimiser::GetACMR(&cooked->indices[0], cornerCount, vertexCount);
+
+	vector<unsigned long> vertexToFinal;
+	MeshOptimiser::OptimiseVertexFetch(&cooked->indices[0], cornerCount, vertexCount, &vertexToFinal);
+
+	// Every corner copies itself to wherever its vertex ended up (duplicates just write the same thing again)
+	cooked->vertices.resize(vertexCount);
+	for (int i = 0; i < cornerCount; i++)
+	{
+		cooked->vertices[vertexToFinal[cornerToVertex[i]]] = corners[i];
+	}
+
+	cooked->topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+
+	// For Bounding Box
+	float minX = 0, minY = 0, minZ = 0;
+	float maxX = 0, maxY = 0, maxZ = 0;
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		Vector3 currentPos = cooked->vertices[i].position;
+
+		if (currentPos.x > maxX)
+			maxX = currentPos.x;
+		else if (currentPos.x < minX)
+			minX = currentPos.x;
+
+		if (currentPos.y > maxY)
+			maxY = currentPos.y;
+		else if (currentPos.y < minY)
+			minY = currentPos.y;
+
+		if (currentPos.z > maxZ)
+			maxZ = currentPos.z;
+		else if (currentPos.z < minZ)
+			minZ = currentPos.z;
+	}
+
+	cooked->minimum = Vector3(minX, minY, minZ);
+	cooked->maximum = Vector3(maxX, maxY, maxZ);
+
+	cooked->radius = (cooked->maximum - cooked->minimum).Length() / 2.0f; // Radius is half the distance between min and max
+	cooked->centre = (cooked->maximum - cooked->minimum) / 2;
+	// End Bounding Box
+
+	stringstream report;
+	report << "Cooked " << filename << ": " << cornerCount << " corners welded to " << vertexCount << " vertices, ACMR "
+		<< acmrBefore << " -> " << acmrAfter << ", " << (vertexCount <= 0xffff ? 16 : 32) << " bit indices\n";
+	OutputDebugString(report.str().c_str());
+
+	return true;
+}
+
+bool CookedMesh::Save(const char* filename)
+{
+	if (vertices.size() == 0 || indices.size() == 0)
+		return false;
+
+	// 0xffff is left out because strips use it to mean "start a new strip"
+	bool shortIndices = vertices.size() <= 0xffff;
+
+	CookedMeshHeader header;
+	memset(&header, 0, sizeof(header));
+	header.magic = COOKED_MESH_MAGIC;
+	header.version = COOKED_MESH_VERSION;
+	header.vertexFormat = MESH_VERTEX_FORMAT;
+	header.vertexStride = VertexFormat::GetStride(MESH_VERTEX_FORMAT);
+	header.topology = topology;
+	header.vertexCount = (unsigned int)vertices.size();
+	header.indexCount = (unsigned int)indices.size();
+	header.indexSize = shortIndices ? 2 : 4;
+	header.vertexOffset = sizeof(CookedMeshHeader);
+	header.indexOffset = header.vertexOffset + header.vertexCount * header.vertexStride;
+
+	header.minimum[0] = minimum.x; header.minimum[1] = minimum.y; header.minimum[2] = minimum.z;
+	header.maximum[0] = maximum.x; header.maximum[1] = maximum.y; header.maximum[2] = maximum.z;
+	header.centre[0] = centre.x; header.centre[1] = centre.y; header.centre[2] = centre.z;
+	header.radius = radius;
+
+	vector<unsigned char> vertexBytes(header.vertexCount * header.vertexStride);
+	VertexFormat::Pack(MESH_VERTEX_FORMAT, &vertices[0], header.vertexCount, &vertexBytes[0]);
+
+	// Indices go out at their final size, unsigned long isn't 4 bytes everywhere
+	vector<unsigned char> indexBytes(header.indexCount * header.indexSize);
+	for (unsigned int i = 0; i < header.indexCount; i++)
+	{
+		if (shortIndices)
+		{
+			unsigned short index = (unsigned short)indices[i];
+			memcpy(&indexBytes[i * 2], &index, 2);
+		}
+		else
+		{
+			unsigned int index = (unsigned int)indices[i];
+			memcpy(&indexBytes[i * 4], &index, 4);
+		}
+	}
+
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(&vertexBytes[0], 1, vertexBytes.size(), file) == vertexBytes.size() &&
+		fwrite(&indexBytes[0], 1, indexBytes.size(), file) == indexBytes.size();
+
+	if (fclose(file) != 0 || !written)
+	{
+		// Don't leave half a file lying around looking newer than the OBJ
+		remove(filename);
+		return false;
+	}
+
+	return true;
+}
+
+const CookedMeshHeader* CookedMesh::Validate(const char* data, size_t size)
+{
+	if (!data || size < sizeof(CookedMeshHeader))
+		return NULL;
+
+	const CookedMeshHeader* header = (const CookedMeshHeader*)data;
+
+	if (header->magic != COOKED_MESH_MAGIC || header->version != COOKED_MESH_VERSION)
+		return NULL;
+
+	// Cooked for some other vertex format, so it won't match the shader
+	if (header->vertexFormat != MESH_VERTEX_FORMAT || header->vertexStride != VertexFormat::GetStride(MESH_VERTEX_FORMAT))
+		return NULL;
+
+	if (header->indexSize != 2 && header->indexSize != 4)
+		return NULL;
+
+	if (header->vertexCount == 0 || header->indexCount == 0)
+		return NULL;
+
+	// Worked out in 64 bits so a corrupt count can't wrap around and look like it fits
+	unsigned long long vertexEnd = (unsigned long long)header->vertexOffset + (unsigned long long)header->vertexCount * header->vertexStride;
+	unsigned long long indexEnd = (unsigned long long)header->indexOffset + (unsigned long long)header->indexCount * header->indexSize;
+
+	if (header->vertexOffset < sizeof(CookedMeshHeader) || header->indexOffset < vertexEnd || indexEnd > size)
+		return NULL;
+
+	// Vertices and indices are read in place, so they have to be lined up
+	if (header->vertexOffset % 4 != 0 || header->indexOffset % header->indexSize != 0)
+		return NULL;
+
+	return header;
+}
+
+string CookedMesh::GetCookedFilename(const char* sourceFilename)
+{
+	string filename = sourceFilename;
+
+	// Only replace an extension on the file itself, not a dot in a folder name
+	size_t dot = filename.find_last_of('.');
+	size_t slash = filename.find_last_of("/\\");
+
+	if (dot != string::npos && (slash == string::npos || dot > slash))
+		filename.erase(dot);
+
+	return filename + COOKED_MESH_EXTENSION;
+}
+
+bool CookedMesh::IsUpToDate(const char* sourceFilename, const char* cookedFilename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA source;
+	WIN32_FILE_ATTRIBUTE_DATA cooked;
+
+	if (!GetFileAttributesExA(cookedFilename, GetFileExInfoStandard, &cooked))
+		return false;
+
+	// No source to compare against (only the cooked file was shipped), so it's all we've got
+	if (!GetFileAttributesExA(sourceFilename, GetFileExInfoStandard, &source))
+		return true;
+
+	return CompareFileTime(&cooked.ftLastWriteTime, &source.ftLastWriteTime) > 0;
+}
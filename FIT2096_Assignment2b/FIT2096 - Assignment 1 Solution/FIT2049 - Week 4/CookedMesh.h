@@ -0,0 +1,78 @@
+/*	FIT2096 - Assignment 2b
+*	CookedMesh.h
+*	A binary mesh that's ready to hand to Direct3D. meshcook turns each OBJ in Assets/Meshes into
+*	one of these ahead of time (same name, .mesh instead of .obj) so the game doesn't have to
+*	parse, weld and reorder text every launch.
+*
+*	The file is a CookedMeshHeader followed by the vertices (already packed into MESH_VERTEX_FORMAT)
+*	and then the indices, exactly as they go into the vertex and index buffers. Loading maps the file and points the buffer uploads
+*	straight at it. Everything is little endian. The version goes up whenever the layout changes, and
+*	files with the wrong version or vertex format are ignored (and the OBJ used instead).
+*/
+
+#ifndef COOKED_MESH_H
+#define COOKED_MESH_H
+
+#include "DirectXTK/SimpleMath.h"
+#include "VertexFormat.h"
+#include <string>
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+#define COOKED_MESH_MAGIC 0x48534d43	// "CMSH"
+#define COOKED_MESH_VERSION 2
+#define COOKED_MESH_EXTENSION ".mesh"
+
+struct CookedMeshHeader
+{
+	unsigned int magic;
+	unsigned int version;
+	unsigned int vertexFormat;		// A VertexFormatType
+	unsigned int vertexStride;		// Its stride when it was cooked
+	unsigned int topology;			// A D3D11_PRIMITIVE_TOPOLOGY
+	unsigned int vertexCount;
+	unsigned int indexCount;
+	unsigned int indexSize;			// 2 or 4 bytes
+	unsigned int vertexOffset;		// From the start of the file
+	unsigned int indexOffset;
+	float minimum[3];
+	float maximum[3];
+	float centre[3];
+	float radius;
+};
+
+class CookedMesh
+{
+public:
+	unsigned int topology;
+	std::vector<MeshVertex> vertices;
+	std::vector<unsigned long> indices;
+	Vector3 minimum;
+	Vector3 maximum;
+	Vector3 centre;
+	float radius;
+
+	// Everything Mesh::Load used to do to an OBJ: parse it, weld the corners into unique vertices,
+	// reorder for the vertex cache and work out the bounds. Logs the before and after vertex counts.
+	static bool CookObj(const char* filename, CookedMesh* cooked);
+
+	// The same for an OBJ that's already in memory, such as out of the asset pack. filename is only for the log.
+	static bool CookObj(const char* filename, const char* text, size_t length, CookedMesh* cooked);
+
+	// Writes the file described above. Vertices are packed into MESH_VERTEX_FORMAT and
+	// indices are stored as 16 bits when every vertex fits.
+	bool Save(const char* filename);
+
+	// Checks the magic, version, vertex format and that everything the header points at is inside
+	// the file. Returns the header (the start of data) or NULL if it's no good.
+	static const CookedMeshHeader* Validate(const char* data, size_t size);
+
+	// Assets/Meshes/enemy.obj becomes Assets/Meshes/enemy.mesh
+	static std::string GetCookedFilename(const char* sourceFilename);
+
+	// True when the cooked file exists and was written after the source last changed
+	static bool IsUpToDate(const char* sourceFilename, const char* cookedFilename);
+};
+
+#endif
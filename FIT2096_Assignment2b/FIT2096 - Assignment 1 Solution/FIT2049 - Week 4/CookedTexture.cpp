@@ -0,0 +1,287 @@
+/*	FIT2096 - Assignment 2b
+*	CookedTexture.cpp
+*	Implementation of CookedTexture.h
+*/
+
+#include "CookedTexture.h"
+#include "BlockCompression.h"
+
+#include <Windows.h>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+// Halves an RGBA8 image, each pixel the average of the 2x2 above it. An odd last row or column is
+// repeated rather than read past. Colours are weighted by their alpha so the invisible colour
+// around a cutout doesn't bleed into the edge as it shrinks.
+static void Downsample(const unsigned char* source, unsigned int width, unsigned int height, unsigned char* destination)
+{
+	unsigned int halfWidth = width > 1 ? width / 2 : 1;
+	unsigned int halfHeight = height > 1 ? height / 2 : 1;
+
+	for (unsigned int y = 0; y < halfHeight; y++)
+	{
+		for (unsigned int x = 0; x < halfWidth; x++)
+		{
+			unsigned int sourceX[2] = { x * 2, x * 2 + 1 < width ? x * 2 + 1 : width - 1 };
+			unsigned int sourceY[2] = { y * 2, y * 2 + 1 < height ? y * 2 + 1 : height - 1 };
+
+			unsigned int weighted[3] = { 0, 0, 0 };
+			unsigned int plain[3] = { 0, 0, 0 };
+			unsigned int alpha = 0;
+
+			for (int i = 0; i < 4; i++)
+			{
+				const unsigned char* pixel = &source[(sourceY[i / 2] * width + sourceX[i % 2]) * 4];
+
+				for (int c = 0; c < 3; c++)
+				{
+					weighted[c] += pixel[c] * pixel[3];
+					plain[c] += pixel[c];
+				}
+
+				alpha += pixel[3];
+			}
+
+			unsigned char* pixel = &destination[(y * halfWidth + x) * 4];
+
+			for (int c = 0; c < 3; c++)
+			{
+				// Completely transparent has no colour to weight, so just take the average
+				pixel[c] = (unsigned char)(alpha > 0 ? (weighted[c] + alpha / 2) / alpha : (plain[c] + 2) / 4);
+			}
+
+			pixel[3] = (unsigned char)((alpha + 2) / 4);
+		}
+	}
+}
+
+bool CookedTexture::Cook(const unsigned char* pixels, unsigned int width, unsigned int height, DXGI_FORMAT format, CookedTexture* cooked)
+{
+	if (!IsSupported(format) || width == 0 || height == 0 || width > COOKED_TEXTURE_MAX_SIZE || height > COOKED_TEXTURE_MAX_SIZE)
+		return false;
+
+	// Direct3D won't make a compressed texture whose top level isn't whole blocks
+	if (BlockCompression::IsCompressed(format) && (width % 4 != 0 || height % 4 != 0))
+		return false;
+
+	cooked->width = width;
+	cooked->height = height;
+	cooked->format = format;
+	cooked->levels.resize(GetMipCount(width, height));
+
+	vector<unsigned char> level(pixels, pixels + (size_t)width * height * 4);
+	vector<unsigned char> nextLevel;
+
+	for (unsigned int i = 0; i < cooked->levels.size(); i++)
+	{
+		vector<unsigned char>& packed = cooked->levels[i];
+
+		if (BlockCompression::IsCompressed(format))
+		{
+			packed.resize(GetLevelSize(format, width, height));
+			BlockCompression::Encode(format, &level[0], width, height, &packed[0]);
+		}
+		else
+		{
+			packed = level;
+		}
+
+		if (i + 1 < cooked->levels.size())
+		{
+			// Each level comes from the one above rather than the original, a 2x2 box every time
+			nextLevel.resize((size_t)(width > 1 ? width / 2 : 1) * (height > 1 ? height / 2 : 1) * 4);
+			Downsample(&level[0], width, height, &nextLevel[0]);
+			level.swap(nextLevel);
+
+			width = width > 1 ? width / 2 : 1;
+			height = height > 1 ? height / 2 : 1;
+		}
+	}
+
+	return true;
+}
+
+bool CookedTexture::Save(const char* filename)
+{
+	unsigned int magic = DDS_MAGIC;
+
+	DdsHeader header;
+	memset(&header, 0, sizeof(header));
+	header.size = sizeof(DdsHeader);
+	header.flags = DDS_HEADER_FLAGS;
+	header.height = height;
+	header.width = width;
+	header.linearSize = (unsigned int)levels[0].size();
+	header.mipCount = (unsigned int)levels.size();
+	header.pixelFormat.size = sizeof(DdsPixelFormat);
+	header.pixelFormat.flags = DDS_PIXEL_FORMAT_FOURCC;
+	header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+	header.caps = DDS_CAPS_TEXTURE | (levels.size() > 1 ? DDS_CAPS_COMPLEX | DDS_CAPS_MIPMAP : 0);
+
+	DdsHeaderDx10 extraHeader;
+	memset(&extraHeader, 0, sizeof(extraHeader));
+	extraHeader.format = format;
+	extraHeader.dimension = DDS_DIMENSION_TEXTURE2D;
+	extraHeader.arraySize = 1;
+
+	FILE* file = fopen(filename, "wb");
+	if (!file)
+		return false;
+
+	bool written = fwrite(&magic, sizeof(magic), 1, file) == 1 &&
+		fwrite(&header, sizeof(header), 1, file) == 1 &&
+		fwrite(&extraHeader, sizeof(extraHeader), 1, file) == 1;
+
+	for (unsigned int i = 0; i < levels.size() && written; i++)
+	{
+		written = fwrite(&levels[i][0], 1, levels[i].size(), file) == levels[i].size();
+	}
+
+	if (fclose(file) != 0 || !written)
+	{
+		// Don't leave half a file lying around looking newer than the PNG
+		remove(filename);
+		return false;
+	}
+
+	return true;
+}
+
+bool CookedTexture::Validate(const char* data, size_t size, D3D11_TEXTURE2D_DESC* description, vector<D3D11_SUBRESOURCE_DATA>* levels)
+{
+	size_t headersSize = sizeof(unsigned int) + sizeof(DdsHeader) + sizeof(DdsHeaderDx10);
+
+	if (!data || size < headersSize)
+		return false;
+
+	unsigned int magic;
+	memcpy(&magic, data, sizeof(magic));
+
+	const DdsHeader* header = (const DdsHeader*)(data + sizeof(unsigned int));
+	const DdsHeaderDx10* extraHeader = (const DdsHeaderDx10*)(data + sizeof(unsigned int) + sizeof(DdsHeader));
+
+	if (magic != DDS_MAGIC || header->size != sizeof(DdsHeader) || header->pixelFormat.size != sizeof(DdsPixelFormat))
+		return false;
+
+	// Only the DX10 kind, which is all texturecook writes
+	if (!(header->pixelFormat.flags & DDS_PIXEL_FORMAT_FOURCC) || header->pixelFormat.fourCC != DDS_FOURCC_DX10)
+		return false;
+
+	if (extraHeader->dimension != DDS_DIMENSION_TEXTURE2D || extraHeader->arraySize != 1)
+		return false;
+
+	DXGI_FORMAT format = (DXGI_FORMAT)extraHeader->format;
+	unsigned int width = header->width;
+	unsigned int height = header->height;
+	unsigned int mipCount = header->mipCount > 0 ? header->mipCount : 1;
+
+	if (!IsSupported(format) || width == 0 || height == 0 || width > COOKED_TEXTURE_MAX_SIZE || height > COOKED_TEXTURE_MAX_SIZE)
+		return false;
+
+	if (mipCount > GetMipCount(width, height))
+		return false;
+
+	if (BlockCompression::IsCompressed(format) && (width % 4 != 0 || height % 4 != 0))
+		return false;
+
+	levels->resize(mipCount);
+	size_t offset = headersSize;
+
+	for (unsigned int i = 0; i < mipCount; i++)
+	{
+		size_t levelSize = GetLevelSize(format, width, height);
+
+		if (levelSize > size - offset)
+			return false;
+
+		(*levels)[i].pSysMem = data + offset;
+		(*levels)[i].SysMemPitch = GetRowPitch(format, width);
+		(*levels)[i].SysMemSlicePitch = (UINT)levelSize;
+
+		offset += levelSize;
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	memset(description, 0, sizeof(D3D11_TEXTURE2D_DESC));
+	description->Width = header->width;
+	description->Height = header->height;
+	description->MipLevels = mipCount;
+	description->ArraySize = 1;
+	description->Format = format;
+	description->SampleDesc.Count = 1;
+	description->SampleDesc.Quality = 0;
+	description->Usage = D3D11_USAGE_IMMUTABLE;		// Nothing ever changes it, so it can go wherever the GPU likes
+	description->BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	description->CPUAccessFlags = 0;
+	description->MiscFlags = 0;
+
+	return true;
+}
+
+bool CookedTexture::IsSupported(DXGI_FORMAT format)
+{
+	return format == DXGI_FORMAT_R8G8B8A8_UNORM || BlockCompression::IsCompressed(format);
+}
+
+unsigned int CookedTexture::GetMipCount(unsigned int width, unsigned int height)
+{
+	unsigned int count = 1;
+
+	while (width > 1 || height > 1)
+	{
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+		count++;
+	}
+
+	return count;
+}
+
+unsigned int CookedTexture::GetRowPitch(DXGI_FORMAT format, unsigned int width)
+{
+	if (BlockCompression::IsCompressed(format))
+		return ((width + 3) / 4) * BlockCompression::GetBlockSize(format);
+
+	return width * 4;
+}
+
+size_t CookedTexture::GetLevelSize(DXGI_FORMAT format, unsigned int width, unsigned int height)
+{
+	// The small levels of a compressed texture still take up a whole block
+	if (BlockCompression::IsCompressed(format))
+		return (size_t)GetRowPitch(format, width) * ((height + 3) / 4);
+
+	return (size_t)GetRowPitch(format, width) * height;
+}
+
+string CookedTexture::GetCookedFilename(const char* sourceFilename)
+{
+	string filename = sourceFilename;
+
+	// Only replace an extension on the file itself, not a dot in a folder name
+	size_t dot = filename.find_last_of('.');
+	size_t slash = filename.find_last_of("/\\");
+
+	if (dot != string::npos && (slash == string::npos || dot > slash))
+		filename.erase(dot);
+
+	return filename + COOKED_TEXTURE_EXTENSION;
+}
+
+bool CookedTexture::IsUpToDate(const char* sourceFilename, const char* cookedFilename)
+{
+	WIN32_FILE_ATTRIBUTE_DATA source;
+	WIN32_FILE_ATTRIBUTE_DATA cooked;
+
+	if (!GetFileAttributesExA(cookedFilename, GetFileExInfoStandard, &cooked))
+		return false;
+
+	// No source to compare against (only the cooked file was shipped), so it's all we've got
+	if (!GetFileAttributesExA(sourceFilename, GetFileExInfoStandard, &source))
+		return true;
+
+	return CompareFileTime(&cooked.ftLastWriteTime, &source.ftLastWriteTime) > 0;
+}
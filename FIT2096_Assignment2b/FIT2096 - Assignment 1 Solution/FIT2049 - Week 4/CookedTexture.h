@@ -0,0 +1,102 @@
+/*	FIT2096 - Assignment 2b
+*	CookedTexture.h
+*	A texture that's ready to hand to Direct3D, mip levels and all. texturecook turns each PNG in
+*	Assets/Textures into one of these ahead of time (same name, .dds instead of .png) so the game
+*	doesn't decode images through WIC every launch, and so tiles far across the board sample a
+*	small mip instead of thrashing the texture cache with the full size one.
+*
+*	The file is a plain DDS with the DX10 header, so any DDS viewer can open it: the magic, a
+*	DdsHeader, a DdsHeaderDx10 and then every mip level from the largest down, each exactly as
+*	Direct3D wants it. Pixels are RGBA8 or one of the block compressed formats in BlockCompression.h.
+*	Loading maps the file (on its own or in the pack) and uploads the levels straight out of it.
+*/
+
+#ifndef COOKED_TEXTURE_H
+#define COOKED_TEXTURE_H
+
+#include <d3d11.h>
+#include <string>
+#include <vector>
+
+#define COOKED_TEXTURE_EXTENSION ".dds"
+#define COOKED_TEXTURE_MAX_SIZE 16384		// The biggest texture Direct3D 11 will make
+
+#define DDS_MAGIC 0x20534444				// "DDS "
+#define DDS_FOURCC_DX10 0x30315844			// "DX10", the format is in the DdsHeaderDx10 instead
+#define DDS_HEADER_FLAGS 0x000a1007			// Caps, height, width, pixel format, mip count and linear size are all filled in
+#define DDS_PIXEL_FORMAT_FOURCC 0x00000004
+#define DDS_CAPS_TEXTURE 0x00001000
+#define DDS_CAPS_COMPLEX 0x00000008			// More than one surface, set along with the next one
+#define DDS_CAPS_MIPMAP 0x00400000
+#define DDS_DIMENSION_TEXTURE2D 3
+
+struct DdsPixelFormat
+{
+	unsigned int size;				// 32
+	unsigned int flags;
+	unsigned int fourCC;
+	unsigned int rgbBitCount;		// The rest is only for formats without a fourCC
+	unsigned int redMask;
+	unsigned int greenMask;
+	unsigned int blueMask;
+	unsigned int alphaMask;
+};
+
+struct DdsHeader
+{
+	unsigned int size;				// 124
+	unsigned int flags;
+	unsigned int height;
+	unsigned int width;
+	unsigned int linearSize;		// Bytes in the top level
+	unsigned int depth;
+	unsigned int mipCount;
+	unsigned int reserved1[11];
+	DdsPixelFormat pixelFormat;
+	unsigned int caps;
+	unsigned int caps2;
+	unsigned int caps3;
+	unsigned int caps4;
+	unsigned int reserved2;
+};
+
+struct DdsHeaderDx10
+{
+	unsigned int format;			// A DXGI_FORMAT
+	unsigned int dimension;			// DDS_DIMENSION_TEXTURE2D
+	unsigned int miscFlags;
+	unsigned int arraySize;
+	unsigned int miscFlags2;
+};
+
+class CookedTexture
+{
+public:
+	unsigned int width;
+	unsigned int height;
+	DXGI_FORMAT format;
+	std::vector<std::vector<unsigned char> > levels;	// Largest first, each already in format
+
+	// Builds every mip level from RGBA8 pixels, halving down to 1x1, and packs each into format.
+	// The block compressed formats need width and height to be multiples of 4.
+	static bool Cook(const unsigned char* pixels, unsigned int width, unsigned int height, DXGI_FORMAT format, CookedTexture* cooked);
+
+	bool Save(const char* filename);
+
+	// Checks the headers, the format and that every level is inside the file. Fills in how to make the
+	// texture and one subresource per level pointing into data, or returns false if it's no good.
+	static bool Validate(const char* data, size_t size, D3D11_TEXTURE2D_DESC* description, std::vector<D3D11_SUBRESOURCE_DATA>* levels);
+
+	static bool IsSupported(DXGI_FORMAT format);
+	static unsigned int GetMipCount(unsigned int width, unsigned int height);	// All the way down to 1x1
+	static unsigned int GetRowPitch(DXGI_FORMAT format, unsigned int width);	// A row of blocks for the compressed formats
+	static size_t GetLevelSize(DXGI_FORMAT format, unsigned int width, unsigned int height);
+
+	// Assets/Textures/tile_white.png becomes Assets/Textures/tile_white.dds
+	static std::string GetCookedFilename(const char* sourceFilename);
+
+	// True when the cooked file exists and was written after the source last changed
+	static bool IsUpToDate(const char* sourceFilename, const char* cookedFilename);
+};
+
+#endif
@@ -11,6 +11,7 @@ Direct3D::Direct3D()
 	m_depthStencilState = NULL;
 	m_depthStencilView = NULL;
 	m_rasterState = NULL;
+	m_interpolation = 1.0f;
 }
 
 Direct3D::~Direct3D()
@@ -50,6 +50,8 @@ private:
 
 	Shader* m_currentShader;
 
+	float m_interpolation;							//How far between the last two simulation ticks we are rendering (0 is the previous tick, 1 is the latest)
+
 	// Initialisation helpers
 	bool InitDepthBuffer(int width, int height);
 	bool InitDepthStencil();
@@ -76,6 +78,9 @@ public:
 
 	Shader* GetCurrentShader() { return m_currentShader; }
 	void SetCurrentShader(Shader* shader) { m_currentShader = shader; }
+
+	float GetInterpolation() { return m_interpolation; }
+	void SetInterpolation(float interpolation) { m_interpolation = interpolation; }
 };
 
 #endif
\ No newline at end of file
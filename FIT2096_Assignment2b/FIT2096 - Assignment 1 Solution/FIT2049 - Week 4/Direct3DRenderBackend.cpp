@@ -0,0 +1,106 @@
+/*	FIT2096 - Assignment 2b
+*	Direct3DRenderBackend.cpp
+*	Implementation of Direct3DRenderBackend.h
+*/
+
+#include "Direct3DRenderBackend.h"
+
+Direct3DRenderBackend::Direct3DRenderBackend(Direct3D* renderer)
+{
+	m_renderer = renderer;
+	m_spriteBatch = new SpriteBatch(m_renderer->GetDeviceContext());
+	m_states = new CommonStates(m_renderer->GetDevice());
+}
+
+Direct3DRenderBackend::~Direct3DRenderBackend()
+{
+	if (m_spriteBatch)
+	{
+		delete m_spriteBatch;
+		m_spriteBatch = NULL;
+	}
+
+	if (m_states)
+	{
+		delete m_states;
+		m_states = NULL;
+	}
+}
+
+void Direct3DRenderBackend::Draw(const RenderSnapshot* snapshot, float amount)
+{
+	m_renderer->BeginScene(snapshot->clearColour.x, snapshot->clearColour.y, snapshot->clearColour.z, snapshot->clearColour.w);
+
+	// The camera needs to be between the same two ticks as everything it's looking at
+	Matrix view = snapshot->GetView(amount);
+
+	for (unsigned int i = 0; i < snapshot->instancedMeshes.size(); i++)
+	{
+		DrawInstanced(snapshot, snapshot->instancedMeshes[i], view, amount);
+	}
+
+	for (unsigned int i = 0; i < snapshot->meshes.size(); i++)
+	{
+		const MeshDraw& draw = snapshot->meshes[i];
+		draw.mesh->Render(m_renderer, draw.shader, draw.GetWorld(amount), view, snapshot->projection, draw.texture);
+	}
+
+	if (snapshot->ui.size() > 0)
+	{
+		// Sprites don't use a shader
+		m_renderer->SetCurrentShader(NULL);
+		m_spriteBatch->Begin(SpriteSortMode_Deferred, m_states->NonPremultiplied());
+
+		for (unsigned int i = 0; i < snapshot->ui.size(); i++)
+		{
+			const UIDraw& draw = snapshot->ui[i];
+
+			if (draw.type == UIDrawType::TEXT)
+			{
+				draw.font->DrawString(m_spriteBatch, draw.text.c_str(), draw.position, draw.colour, 0, draw.origin);
+			}
+			else if (draw.useDestination)
+			{
+				m_spriteBatch->Draw(draw.texture->GetShaderResourceView(), draw.destination, draw.colour);
+			}
+			else
+			{
+				m_spriteBatch->Draw(draw.texture->GetShaderResourceView(), draw.position, draw.useSource ? &draw.source : NULL, draw.colour, 0, draw.origin);
+			}
+		}
+
+		m_spriteBatch->End();
+	}
+
+	m_renderer->EndScene();
+}
+
+void Direct3DRenderBackend::DrawInstanced(const RenderSnapshot* snapshot, const InstancedMeshDraw& draw, Matrix view, float amount)
+{
+	// More than fits in the instance buffer just takes a few draws
+	for (unsigned int start = 0; start < draw.instanceCount; start += INSTANCED_SHADER_MAX_INSTANCES)
+	{
+		unsigned int count = draw.instanceCount - start;
+		if (count > INSTANCED_SHADER_MAX_INSTANCES)
+		{
+			count = INSTANCED_SHADER_MAX_INSTANCES;
+		}
+
+		m_instanceData.resize(count);
+
+		for (unsigned int i = 0; i < count; i++)
+		{
+			const MeshInstance& instance = snapshot->instances[draw.firstInstance + start + i];
+			Vector3 position = Vector3::Lerp(instance.previousPosition, instance.position, amount);
+			m_instanceData[i] = Vector4(position.x, position.y, position.z, instance.layer);
+		}
+
+		if (!draw.shader->SetInstances(m_renderer->GetDeviceContext(), &m_instanceData[0], count))
+		{
+			return;
+		}
+
+		// The instances carry their own positions, the mesh itself stays where it was made
+		draw.mesh->RenderInstanced(m_renderer, draw.shader, Matrix::Identity, view, snapshot->projection, draw.textureArray, count);
+	}
+}
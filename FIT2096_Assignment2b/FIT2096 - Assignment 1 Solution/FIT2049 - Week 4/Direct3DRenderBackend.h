@@ -0,0 +1,37 @@
+/*	FIT2096 - Assignment 2b
+*	Direct3DRenderBackend.h
+*	Draws render snapshots with Direct3D: the instanced meshes, the rest of the meshes and then
+*	the UI with a sprite batch.
+*	This is the only thing that uses the device context once the game is running, so whichever
+*	thread calls Draw owns it. Loading can still use the device from anywhere.
+*/
+
+#ifndef DIRECT3D_RENDER_BACKEND_H
+#define DIRECT3D_RENDER_BACKEND_H
+
+#include "Direct3D.h"
+#include "RenderBackend.h"
+
+#include "DirectXTK/CommonStates.h"
+#include "DirectXTK/SpriteBatch.h"
+
+#include <vector>
+
+class Direct3DRenderBackend : public RenderBackend
+{
+private:
+	Direct3D* m_renderer;
+	SpriteBatch* m_spriteBatch;
+	CommonStates* m_states;
+	std::vector<Vector4> m_instanceData;	// The instances of one draw blended and ready for the shader, kept to save allocating each frame
+
+	void DrawInstanced(const RenderSnapshot* snapshot, const InstancedMeshDraw& draw, Matrix view, float amount);
+
+public:
+	Direct3DRenderBackend(Direct3D* renderer);
+	~Direct3DRenderBackend();
+
+	void Draw(const RenderSnapshot* snapshot, float amount);
+};
+
+#endif
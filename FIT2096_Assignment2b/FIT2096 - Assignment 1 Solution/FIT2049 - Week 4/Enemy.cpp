@@ -9,8 +9,14 @@ Enemy::Enemy()
 	m_isAlive = true;
 
 	m_isMoving = false;
+	m_behaviour = 0;
 
 	shootCounter = 5.0f;
+	m_bulletPool = NULL;
+	m_flowField = NULL;
+	m_pathfinder = NULL;
+	m_random = NULL;
+	m_pathIndex = 0;
 }
 
 Enemy::Enemy(int newHealth, int newSkill, Mesh* mesh, Shader* shader, Texture* texture)
@@ -23,14 +29,18 @@ Enemy::Enemy(int newHealth, int newSkill, Mesh* mesh, Shader* shader, Texture* t
 	m_shader = shader;
 	m_texture = texture;
 
-	m_moveSpeed = 0.001f;
-	m_moveLogic = 0;
+	m_behaviour = 0;
 	m_isMoving = false;
 
 	shootCounter = 5.0f;
+	m_bulletPool = NULL;
+	m_flowField = NULL;
+	m_pathfinder = NULL;
+	m_random = NULL;
+	m_pathIndex = 0;
 }
 
-Enemy::Enemy(int newHealth, int newSkill, int newMoveLogic, Mesh* mesh, Shader* shader, Texture* texture)
+Enemy::Enemy(int newHealth, int newSkill, int newBehaviour, Mesh* mesh, Shader* shader, Texture* texture)
 	: GameObject(mesh, shader, texture, Vector3::Zero)
 {
 	m_health = newHealth;
@@ -44,29 +54,13 @@ Enemy::Enemy(int newHealth, int newSkill, int newMoveLogic, Mesh* mesh, Shader*
 	m_boundingBox = CBoundingBox(m_position + m_mesh->GetMin(), m_position + m_mesh->GetMax());
 
 	shootCounter = 5.0f;
+	m_bulletPool = NULL;
+	m_flowField = NULL;
+	m_pathfinder = NULL;
+	m_random = NULL;
+	m_pathIndex = 0;
 	m_isMoving = false;
-	m_moveLogic = newMoveLogic;
-	// Move speed of enemy depends on their move logic
-	if (m_moveLogic == 1)
-	{
-		m_moveSpeed = 0.05f;
-	}
-	else if (m_moveLogic == 2)
-	{
-		m_moveSpeed = 0.04f;
-	}
-	else if (m_moveLogic == 3)
-	{
-		m_moveSpeed = 0.03f;
-	}
-	else if (m_moveLogic == 4)
-	{
-		m_moveSpeed = 0.02f;
-	}
-	else if (m_moveLogic == 5)
-	{
-		m_moveSpeed = 0.01f;
-	}
+	m_behaviour = newBehaviour;
 }
 
 Enemy::~Enemy()
@@ -89,36 +83,6 @@ void Enemy::Update(float timestep)
 {
 	if (IsAlive())
 	{
-		// TODO Let enemy faces the player
-		Vector3 directionToPlayer = m_playerPosition - m_position;
-		// Normalize vector
-		directionToPlayer.Normalize();
-		// Calculate the angle the enemy should be facing
-		// There are a couple of ways to do this, atan2 is fairly straightforward
-		m_rotY = atan2(directionToPlayer.x, directionToPlayer.z);
-
-		// Handle the movement of enemies
-		if (m_moveLogic == 1)
-		{
-			move1();
-		}
-		else if (m_moveLogic == 2)
-		{
-			move2();
-		}
-		else if (m_moveLogic == 3)
-		{
-			move3();
-		}
-		else if (m_moveLogic == 4)
-		{
-			move4();
-		}
-		else if (m_moveLogic == 5)
-		{
-			move5();
-		}
-
 		// Handle the shooting of enemy
 		shootCounter -= timestep;
 
@@ -134,171 +98,133 @@ void Enemy::Update(float timestep)
 	m_boundingBox.SetMax(m_position + m_mesh->GetMax());
 }
 
-// Constantly move towards the player
-void Enemy::move1()
+Vector3 Enemy::GetChaseDirection()
 {
-	float distanceToPlayer = Vector3::Distance(m_playerPosition, m_position);
-
-	if (distanceToPlayer >= 0.01f)
+	if (m_flowField && m_flowField->Covers(m_position))
 	{
-		m_isMoving = true;
-
-		Vector3 directionToPlayer = m_playerPosition - m_position;
+		Vector3 direction;
 
-		directionToPlayer.Normalize();
-
-		m_position += directionToPlayer * m_moveSpeed;
-	}
-	else
-	{
-		m_isMoving = false;
+		if (m_flowField->GetChaseDirection(m_position, &direction))
+		{
+			return direction;
+		}
 	}
-}
-
-// Constantly run away from the player
-void Enemy::move2()
-{
-	m_isMoving = true;
 
+	// No field, or we're already in the player's cell, so nothing can be in the way
 	Vector3 directionToPlayer = m_playerPosition - m_position;
-
 	directionToPlayer.Normalize();
 
-	Vector3 targetPosition = m_position - directionToPlayer * m_moveSpeed;
-
-	if (targetPosition.x >= 1.0f && targetPosition.x <= Board_Width - 1
-		&& targetPosition.z >= 1.0f && targetPosition.z <= Board_Height - 1)
-	{
-		m_position -= directionToPlayer * m_moveSpeed;
-	}
+	return directionToPlayer;
 }
 
-// Constantly moving to a random point on the board
-void Enemy::move3()
+Vector3 Enemy::GetFleeDirection()
 {
-	if (m_isMoving)
+	if (m_flowField && m_flowField->Covers(m_position))
 	{
-		Vector3 directionToPoint = m_randomPoint - m_position;
-		directionToPoint.Normalize();
-		m_position += directionToPoint * m_moveSpeed;
+		Vector3 direction;
 
-		float distanceToPoint = Vector3::Distance(m_position, m_randomPoint);
-		// Stop moving if close enough
-		if (distanceToPoint <= 0.1f)
+		// Nowhere further away to step means we're cornered, stay put
+		if (!m_flowField->GetFleeDirection(m_position, &direction))
 		{
-			m_isMoving = false;
+			return Vector3::Zero;
 		}
+
+		return direction;
 	}
-	else if (!m_isMoving)
-	{
-		// Generate a random point
-		m_isMoving = true;
 
-		float pointX = RandomRange(1.0, Board_Width);
-		float pointZ = RandomRange(1.0, Board_Height);
+	// Without a field just head directly away
+	Vector3 directionToPlayer = m_playerPosition - m_position;
+	directionToPlayer.Normalize();
 
-		m_randomPoint = Vector3(pointX, 0.0, pointZ);
-	}
+	return -directionToPlayer;
 }
 
-// Constantly move to some point near the player
-void Enemy::move4()
+bool Enemy::PlanPathTo(Vector3 target)
 {
-	float distanceToPlayer = Vector3::Distance(m_playerPosition, m_position);
+	m_path.clear();
+	m_pathIndex = 0;
 
-	if (distanceToPlayer >= 5.0f)
+	// Without a pathfinder just head straight there
+	if (!m_pathfinder)
 	{
-		m_isMoving = true;
+		m_path.push_back(target);
+		return true;
+	}
 
-		Vector3 directionToPlayer = m_playerPosition - m_position;
+	return m_pathfinder->FindPath(m_position, target, &m_path);
+}
 
-		directionToPlayer.Normalize();
+bool Enemy::MoveAlongPath(float distance)
+{
+	if (m_pathIndex >= (int)m_path.size())
+		return false;
 
-		m_position += directionToPlayer * m_moveSpeed;
-	}
-	else
+	// Waypoints are on the ground, stay at our own height
+	Vector3 waypoint(m_path[m_pathIndex].x, m_position.y, m_path[m_pathIndex].z);
+	Vector3 directionToPoint = waypoint - m_position;
+	float distanceToPoint = directionToPoint.Length();
+
+	// Close enough to land on it this update, then aim for the next one
+	if (distanceToPoint <= distance)
 	{
-		m_isMoving = false;
+		m_position = waypoint;
+		m_pathIndex++;
+
+		return m_pathIndex < (int)m_path.size();
 	}
+
+	directionToPoint /= distanceToPoint;
+	m_position += directionToPoint * distance;
+
+	return true;
 }
 
-// Stand still until the player get close, then run away to a random point
-void Enemy::move5()
+// Moving to a random point on the board, used by the WANDER behaviours
+void Enemy::Wander(float distance, bool canSetOff)
 {
-	float distanceToPlayer = Vector3::Distance(m_playerPosition, m_position);
-
 	if (m_isMoving)
 	{
-		Vector3 directionToPoint = m_randomPoint - m_position;
-		directionToPoint.Normalize();
-		m_position += directionToPoint * m_moveSpeed;
-
-		float distanceToPoint = Vector3::Distance(m_position, m_randomPoint);
-		// Stop moving if close enough
-		if (distanceToPoint <= 0.01f)
-		{
-			m_isMoving = false;
-		}
+		// Stop moving once we reach the point
+		m_isMoving = MoveAlongPath(distance);
 	}
-	else if (!m_isMoving && distanceToPlayer <= 5.0f)
+	else if (canSetOff)
 	{
 		// Generate a random point
-		m_isMoving = true;
-
 		float pointX = RandomRange(1.0, Board_Width);
 		float pointZ = RandomRange(1.0, Board_Height);
 
 		m_randomPoint = Vector3(pointX, 0.0, pointZ);
+
+		// If there's no way there (it's a wall, or walled off) we'll pick another point next time
+		m_isMoving = PlanPathTo(m_randomPoint);
 	}
 }
 
 void Enemy::Shoot()
 {
-	Bullet* the_bullet = NULL;
+	// Offset from pivot of enemy to the gun
+	Vector3 m_offset = Vector3(-0.133f, 1.2f, 1.137f);
 
-	for (int i = 0; i < m_bullets.size(); i++)
-	{
-		if (m_bullets[i]->GetBeingUsed() == false)
-		{
-			the_bullet = m_bullets[i];
-			break;
-		}
-	}
+	Matrix heading = Matrix::CreateRotationY(m_rotY);
 
-	if (the_bullet)
-	{
-		// Offset from pivot of enemy to the gun
-		Vector3 m_offset = Vector3(-0.133f, 1.2f, 1.137f);
-
-		Matrix heading = Matrix::CreateRotationY(m_rotY);
-
-		Matrix lookAtRotation = heading;
-
-		// The offset is still based on the world local, transform it into enemy's local
-		Vector3 spawnAt = Vector3::TransformNormal(m_offset, lookAtRotation);
+	Matrix lookAtRotation = heading;
 
-		spawnAt += m_position;
+	// The offset is still based on the world local, transform it into enemy's local
+	Vector3 spawnAt = Vector3::TransformNormal(m_offset, lookAtRotation);
 
-		Vector3 flyTowards = Vector3::TransformNormal(Vector3(0, 0, 10), heading);  // This is the direction enemy is facing
+	spawnAt += m_position;
 
-		the_bullet->SetPosition(spawnAt);                // Need to add some offset so the bullet appear in front of player and will not trigger hitbox
+	Vector3 flyTowards = Vector3::TransformNormal(Vector3(0, 0, 10), heading);  // This is the direction enemy is facing
 
-		the_bullet->SetFlyTowards(flyTowards);           // Fly towards the direction player is facing
-
-		the_bullet->SetYRotation(m_rotY);                // Rotate the bullet to the correct direction
-
-		the_bullet->SetBeingUsed(true);  // So the bullet will start updating
-	}
+	// Spawn at the gun, facing and flying the way we face
+	// Nothing happens if the pool is out of bullets
+	m_bulletPool->Fire(spawnAt, flyTowards, m_rotY, this);
 }
 
 float Enemy::RandomRange(float min, float max)
 {
-	// rand gives us a number between 0 and RAND_MAX
-	// Divide by RAND_MAX moves it into a 0-1 range
-	// max - min gives us the range our number needs to be in
-	// This is still relative to 0 though, so we shift it accross by min to move into the actual range
-
-	return ((rand() / float(RAND_MAX)) * (max - min)) + min;
+	// Wandering runs on whichever thread takes the enemies job, so this comes from the board's generator rather than rand
+	return MathsHelper::RandomRange(*m_random, min, max);
 }
 
 // Collisions
@@ -306,14 +232,14 @@ void Enemy::OnBulletCollisionEnter(Bullet* other)
 {
 	OutputDebugString("Enemy-Bullet Collision Enter\n");
 
-	int damage = rand() % 6 + 3;  // Damage to enemy is between 3 - 8
+	int damage = MathsHelper::RandomRange(*m_random, 3, 8);  // Damage to enemy is between 3 - 8
 
 	takeDamage(damage);
 
 	// If enemy got killed, move them to other position
 	if (!IsAlive())
 	{
-		m_position = Vector3(10.0f, -10.0f, 0.0f);  // Sink the enemy to the ground
+		SetPosition(Vector3(10.0f, -10.0f, 0.0f));  // Sink the enemy to the ground
 	}
 }
 
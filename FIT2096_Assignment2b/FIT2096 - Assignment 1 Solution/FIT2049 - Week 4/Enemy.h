@@ -4,11 +4,17 @@
 #define ENEMY_H
 
 #include "GameObject.h"
-#include "Bullet.h"
+#include "BulletPool.h"
+#include "FlowField.h"
+#include "HierarchicalPathfinder.h"
+#include <random>
 #include <vector>
 
 class Enemy : public GameObject
 {
+	// Moves and turns enemies in batches, straight from our members
+	friend class EnemyBehaviours;
+
 private:
 
 	// Enemy's variables
@@ -16,7 +22,10 @@ private:
 	int m_skill;
 	bool m_isAlive;
 	CBoundingBox m_boundingBox;
-	std::vector<Bullet*> m_bullets;  // Enemy will also know the vector of bullets
+	BulletPool* m_bulletPool;  // Enemy will also know where to get bullets from
+	FlowField* m_flowField;  // Shared with every other enemy, tells us which way to walk to reach the player
+	HierarchicalPathfinder* m_pathfinder;  // Also shared, finds routes to anywhere else on the board
+	std::mt19937* m_random;  // The board's, we can be updated on any thread so rand won't do
 
 	// Use them to make sure the enemy choose a point on the board
 	float Board_Width;  
@@ -24,20 +33,25 @@ private:
 
 	// The movement of enemy
 	Vector3 m_randomPoint;
+	std::vector<Vector3> m_path;  // Waypoints on the way to m_randomPoint
+	int m_pathIndex;  // The waypoint we're walking towards
 	bool m_isMoving;
-	float m_moveSpeed;
-	int m_moveLogic;
-
-	// Different enemies have different moving logic
-	void move1();
-	void move2();
-	void move3();
-	void move4();
-	void move5();
+	int m_behaviour;  // Row of the EnemyBehaviours table, says how we move and how fast
 
 	// Enemy must look at the player
 	Vector3 m_playerPosition;
 
+	// Which way to walk to get to (or away from) the player without going through walls
+	Vector3 GetChaseDirection();
+	Vector3 GetFleeDirection();
+
+	// Works out a route around walls to the target, returns false if there isn't one
+	bool PlanPathTo(Vector3 target);
+	bool MoveAlongPath(float distance);  // Returns false once we've reached the end
+
+	// Carries on along the current path, or picks a new random point if we're stopped and allowed to go
+	void Wander(float distance, bool canSetOff);
+
 	// Function to be called in Update function, a bullet will shoot out
 	void Shoot();
 	float shootCounter;  // Enemy will only shoot when the counter reach 0
@@ -49,11 +63,12 @@ public:
 
 	Enemy();
 	Enemy(int newHealth, int newSkill, Mesh* mesh, Shader* shader, Texture* texture);
-	Enemy(int newHealth, int newSkill, int newMoveLogic, Mesh* mesh, Shader* shader, Texture* texture);
+	Enemy(int newHealth, int newSkill, int newBehaviour, Mesh* mesh, Shader* shader, Texture* texture);
 	~Enemy();
 
 	void takeDamage(int amount);
 
+	// Shooting and bounds only, EnemyBehaviours turns and moves us first
 	void Update(float timestep);
 
 	// Collisions with other objects (Enemy doesn't need to know the collision with enemy)
@@ -65,6 +80,7 @@ public:
 	// Accessors
 	bool IsAlive() { return m_isAlive; }
 	int GetSkill() { return m_skill; }
+	int GetBehaviour() { return m_behaviour; }
 	Vector3 GetPlayerPosition() { return m_playerPosition; }
 	CBoundingBox GetBounds() { return m_boundingBox; }
 
@@ -72,7 +88,10 @@ public:
 	void SetPlayerPosition(Vector3 newPos) { m_playerPosition = newPos; }
 	void SetBoardWidth(int width) { Board_Width = (float) width; }
 	void SetBoardHeight(int height) { Board_Height = (float) height; }
-	void SetBulletVector(std::vector<Bullet*> the_vector) { m_bullets = the_vector; }
+	void SetBulletPool(BulletPool* pool) { m_bulletPool = pool; }
+	void SetFlowField(FlowField* field) { m_flowField = field; }
+	void SetPathfinder(HierarchicalPathfinder* pathfinder) { m_pathfinder = pathfinder; }
+	void SetRandom(std::mt19937* random) { m_random = random; }
 };
 
 
@@ -0,0 +1,335 @@
+/*	FIT2096 - Assignment 2b
+*	EnemyBehaviours.cpp
+*	Implementation of EnemyBehaviours.h
+*/
+
+#include "EnemyBehaviours.h"
+
+// Kernel, move speed, keep away radius, wander trigger, separation
+static const EnemyBehaviour BEHAVIOURS[ENEMY_BEHAVIOUR_COUNT] = {
+	{ BehaviourKernel::STAND, 0.0f, 0.0f, 0.0f, 0.0f },		// 0: Doesn't move
+	{ BehaviourKernel::CHASE, 3.0f, 0.01f, 0.0f, 1.5f },	// 1: Constantly move towards the player
+	{ BehaviourKernel::FLEE, 2.4f, 0.0f, 0.0f, 1.2f },		// 2: Constantly run away from the player
+	{ BehaviourKernel::WANDER, 1.8f, 0.0f, 0.0f, 0.0f },	// 3: Constantly moving to a random point on the board
+	{ BehaviourKernel::CHASE, 1.2f, 5.0f, 0.0f, 1.2f },		// 4: Constantly move to some point near the player
+	{ BehaviourKernel::WANDER, 0.6f, 0.0f, 5.0f, 0.0f }		// 5: Stand still until the player gets close, then run away to a random point
+};
+
+EnemyBehaviours::EnemyBehaviours()
+{
+	m_neighbours = NULL;
+	m_jobs = NULL;
+}
+
+const EnemyBehaviour& EnemyBehaviours::GetBehaviour(int id)
+{
+	// Anything we don't know about stands still
+	if (id < 0 || id >= ENEMY_BEHAVIOUR_COUNT)
+		return BEHAVIOURS[0];
+
+	return BEHAVIOURS[id];
+}
+
+// Close enough to atan2 for turning to face someone (within a thousandth of a degree) and has
+// no branches, so unlike the library version a loop of them can be vectorised
+static inline float FastAtan2(float y, float x)
+{
+	float absY = y < 0.0f ? -y : y;
+	float absX = x < 0.0f ? -x : x;
+	float smallest = absY < absX ? absY : absX;
+	float largest = absY < absX ? absX : absY;
+
+	// Tiny bit on the bottom so facing straight at ourselves comes out as 0 instead of a divide by zero
+	float a = smallest / (largest + 1e-30f);
+	float s = a * a;
+	float angle = ((-0.0464964749f * s + 0.15931422f) * s - 0.327622764f) * s * a + a;
+
+	angle = absY > absX ? 1.57079637f - angle : angle;
+	angle = x < 0.0f ? 3.14159274f - angle : angle;
+	angle = y < 0.0f ? -angle : angle;
+
+	return angle;
+}
+
+// Which way to face and how far away the player is, for every enemy in the group
+static void FaceKernel(int count, const float* x, const float* z, float playerX, float playerZ, float* rotY, float* distanceSquared)
+{
+	for (int i = 0; i < count; i++)
+	{
+		float dx = playerX - x[i];
+		float dz = playerZ - z[i];
+
+		rotY[i] = FastAtan2(dx, dz);
+		distanceSquared[i] = dx * dx + dz * dz;
+	}
+}
+
+// Everyone steps along their direction (a zero direction stays put)
+static void MoveKernel(int count, float* x, float* z, const float* directionX, const float* directionZ, const float* step)
+{
+	for (int i = 0; i < count; i++)
+	{
+		x[i] += directionX[i] * step[i];
+		z[i] += directionZ[i] * step[i];
+	}
+}
+
+void EnemyBehaviours::Resize(int count)
+{
+	m_positionX.resize(count);
+	m_positionZ.resize(count);
+	m_step.resize(count);
+	m_keepAwaySquared.resize(count);
+	m_triggerSquared.resize(count);
+	m_limitX.resize(count);
+	m_limitZ.resize(count);
+	m_distanceSquared.resize(count);
+	m_rotY.resize(count);
+	m_directionX.resize(count);
+	m_directionZ.resize(count);
+	m_active.resize(count);
+	m_separationStep.resize(count);
+}
+
+void EnemyBehaviours::Gather(std::vector<Enemy*>* enemies, std::vector<int>& group, const float* timesteps, int begin, int end)
+{
+	for (int n = begin; n < end; n++)
+	{
+		int i = group[n];
+		Enemy* enemy = (*enemies)[i];
+		const EnemyBehaviour& behaviour = GetBehaviour(enemy->m_behaviour);
+
+		m_positionX[n] = enemy->m_position.x;
+		m_positionZ[n] = enemy->m_position.z;
+		m_step[n] = behaviour.moveSpeed * timesteps[i];
+		m_keepAwaySquared[n] = behaviour.keepAwayRadius * behaviour.keepAwayRadius;
+		m_triggerSquared[n] = behaviour.wanderTrigger * behaviour.wanderTrigger;
+		m_limitX[n] = enemy->Board_Width - 1;
+		m_limitZ[n] = enemy->Board_Height - 1;
+		m_separationStep[n] = behaviour.separation * timesteps[i];
+	}
+}
+
+void EnemyBehaviours::Scatter(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end)
+{
+	for (int n = begin; n < end; n++)
+	{
+		Enemy* enemy = (*enemies)[group[n]];
+
+		enemy->m_position.x = m_positionX[n];
+		enemy->m_position.z = m_positionZ[n];
+		enemy->m_rotY = m_rotY[n];
+	}
+}
+
+void EnemyBehaviours::RunChase(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end)
+{
+	for (int n = begin; n < end; n++)
+	{
+		m_active[n] = m_distanceSquared[n] >= m_keepAwaySquared[n] ? 1 : 0;
+	}
+
+	// Which way to go around the walls is a lookup in the shared flow field, one enemy at a time
+	for (int n = begin; n < end; n++)
+	{
+		Enemy* enemy = (*enemies)[group[n]];
+		Vector3 direction = m_active[n] ? enemy->GetChaseDirection() : Vector3::Zero;
+
+		m_directionX[n] = direction.x;
+		m_directionZ[n] = direction.z;
+		enemy->m_isMoving = m_active[n] != 0;
+	}
+
+	MoveKernel(end - begin, &m_positionX[begin], &m_positionZ[begin], &m_directionX[begin], &m_directionZ[begin], &m_step[begin]);
+}
+
+void EnemyBehaviours::RunFlee(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end)
+{
+	for (int n = begin; n < end; n++)
+	{
+		Enemy* enemy = (*enemies)[group[n]];
+		Vector3 direction = enemy->GetFleeDirection();
+
+		m_directionX[n] = direction.x;
+		m_directionZ[n] = direction.z;
+		enemy->m_isMoving = true;
+	}
+
+	// Only take the step if it keeps us on the board
+	float* x = m_positionX.data();
+	float* z = m_positionZ.data();
+
+	for (int n = begin; n < end; n++)
+	{
+		float nextX = x[n] + m_directionX[n] * m_step[n];
+		float nextZ = z[n] + m_directionZ[n] * m_step[n];
+		bool inside = nextX >= 1.0f && nextX <= m_limitX[n] && nextZ >= 1.0f && nextZ <= m_limitZ[n];
+
+		x[n] = inside ? nextX : x[n];
+		z[n] = inside ? nextZ : z[n];
+	}
+}
+
+void EnemyBehaviours::RunWander(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end)
+{
+	for (int n = begin; n < end; n++)
+	{
+		m_active[n] = m_triggerSquared[n] == 0.0f || m_distanceSquared[n] <= m_triggerSquared[n] ? 1 : 0;
+	}
+
+	// Everyone is following their own path, so this part is one enemy at a time
+	for (int n = begin; n < end; n++)
+	{
+		Enemy* enemy = (*enemies)[group[n]];
+		enemy->Wander(m_step[n], m_active[n] != 0);
+
+		m_positionX[n] = enemy->m_position.x;
+		m_positionZ[n] = enemy->m_position.z;
+	}
+}
+
+void EnemyBehaviours::RunSeparation(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end)
+{
+	if (!m_neighbours)
+		return;
+
+	for (int n = begin; n < end; n++)
+	{
+		if (m_separationStep[n] <= 0.0f)
+			continue;
+
+		int self = group[n];
+		float x = m_positionX[n];
+		float z = m_positionZ[n];
+		float pushX = 0.0f;
+		float pushZ = 0.0f;
+
+		// Everyone we overlap pushes us away, harder the closer they are
+		m_neighbours->ForEachWithin(Vector3(x, 0.0f, z), ENEMY_SEPARATION_RADIUS,
+			[self, x, z, &pushX, &pushZ](int other, float otherX, float otherZ, float distanceSquared)
+		{
+			if (other == self)
+				return;
+
+			if (distanceSquared < 0.0001f)
+			{
+				// Right on top of each other, there's no direction to push in so split them by who's who
+				pushX += other < self ? 1.0f : -1.0f;
+				return;
+			}
+
+			float distance = sqrtf(distanceSquared);
+			float strength = (ENEMY_SEPARATION_RADIUS - distance) / (ENEMY_SEPARATION_RADIUS * distance);
+
+			pushX += (x - otherX) * strength;
+			pushZ += (z - otherZ) * strength;
+		});
+
+		// A big crowd shouldn't fling us any faster than a single neighbour would
+		float pushSquared = pushX * pushX + pushZ * pushZ;
+
+		if (pushSquared == 0.0f)
+			continue;
+
+		if (pushSquared > 1.0f)
+		{
+			float scale = 1.0f / sqrtf(pushSquared);
+			pushX *= scale;
+			pushZ *= scale;
+		}
+
+		// Don't get pushed off the board or into a wall
+		Enemy* enemy = (*enemies)[self];
+		Vector3 next(x + pushX * m_separationStep[n], enemy->m_position.y, z + pushZ * m_separationStep[n]);
+
+		if (next.x < 1.0f || next.x > m_limitX[n] || next.z < 1.0f || next.z > m_limitZ[n])
+			continue;
+
+		if (enemy->m_flowField && !enemy->m_flowField->Covers(next))
+			continue;
+
+		m_positionX[n] = next.x;
+		m_positionZ[n] = next.z;
+	}
+}
+
+void EnemyBehaviours::RunRange(std::vector<Enemy*>* enemies, std::vector<int>& group, BehaviourKernel kernel,
+	const float* timesteps, Vector3 playerPosition, int begin, int end)
+{
+	Gather(enemies, group, timesteps, begin, end);
+
+	// Everyone turns to face the player from where they started
+	FaceKernel(end - begin, &m_positionX[begin], &m_positionZ[begin], playerPosition.x, playerPosition.z,
+		&m_rotY[begin], &m_distanceSquared[begin]);
+
+	switch (kernel)
+	{
+	case BehaviourKernel::CHASE:
+		RunChase(enemies, group, begin, end);
+		RunSeparation(enemies, group, begin, end);
+		break;
+	case BehaviourKernel::FLEE:
+		RunFlee(enemies, group, begin, end);
+		RunSeparation(enemies, group, begin, end);
+		break;
+	case BehaviourKernel::WANDER:
+		RunWander(enemies, group, begin, end);
+		break;
+	default:
+		break;
+	}
+
+	Scatter(enemies, group, begin, end);
+}
+
+void EnemyBehaviours::Update(std::vector<Enemy*>* enemies, const int* indices, int count, const float* timesteps, Vector3 playerPosition)
+{
+	for (int k = 0; k < (int)BehaviourKernel::COUNT; k++)
+	{
+		m_groups[k].clear();
+	}
+
+	for (int n = 0; n < count; n++)
+	{
+		int i = indices[n];
+		Enemy* enemy = (*enemies)[i];
+		enemy->SetPlayerPosition(playerPosition);
+
+		if (enemy->IsAlive())
+		{
+			m_groups[(int)GetBehaviour(enemy->m_behaviour).kernel].push_back(i);
+		}
+		else
+		{
+			// Nothing to do but keep its bounds where it is
+			enemy->Update(timesteps[i]);
+		}
+	}
+
+	for (int k = 0; k < (int)BehaviourKernel::COUNT; k++)
+	{
+		BehaviourKernel kernel = (BehaviourKernel)k;
+		std::vector<int>& group = m_groups[k];
+
+		if (group.size() == 0)
+			continue;
+
+		Resize((int)group.size());
+
+		// Each enemy only writes to itself and reads where the others were at the start of the tick,
+		// so the group can be split up between threads. Wandering picks random points and plans
+		// paths through the shared pathfinder, so that stays on this thread.
+		JobSystem* jobs = kernel == BehaviourKernel::WANDER ? NULL : m_jobs;
+
+		ParallelFor(jobs, (int)group.size(), ENEMY_BEHAVIOUR_GRAIN, [this, enemies, &group, kernel, timesteps, playerPosition](int begin, int end)
+		{
+			RunRange(enemies, group, kernel, timesteps, playerPosition, begin, end);
+		});
+
+		// Shooting takes bullets from the pool, so it's done here in order after everyone has moved
+		for (unsigned int n = 0; n < group.size(); n++)
+		{
+			(*enemies)[group[n]]->Update(timesteps[group[n]]);
+		}
+	}
+}
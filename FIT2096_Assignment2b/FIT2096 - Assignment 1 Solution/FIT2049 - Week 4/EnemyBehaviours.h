@@ -0,0 +1,101 @@
+/*	FIT2096 - Assignment 2b
+*	EnemyBehaviours.h
+*	How enemies move, as data. Each behaviour is a row in a table saying which kernel drives it
+*	and the numbers it runs with, so a new enemy that moves like an existing one is just a new row.
+*	Enemies due an update are sorted by kernel and each kernel runs over its whole group at once.
+*	Positions are copied into flat arrays first so facing the player, distance checks and moving
+*	are simple loops the compiler can run several enemies at a time through.
+*	Enemies that walk at the player also step apart from anyone they're overlapping, using the
+*	SpatialHash the GameBoard fills in at the start of each tick, so a crowd doesn't pile up
+*	into one spot.
+*	With a job system each group is split up between threads. Shooting is still done afterwards
+*	on the calling thread, in the same order every time, so the result doesn't depend on how
+*	many threads there are.
+*/
+
+#ifndef ENEMY_BEHAVIOURS_H
+#define ENEMY_BEHAVIOURS_H
+
+#include "Enemy.h"
+#include "JobSystem.h"
+#include "SpatialHash.h"
+#include <vector>
+
+enum class BehaviourKernel
+{
+	STAND,		// Just turn to face the player
+	CHASE,		// Walk towards the player until within keepAwayRadius
+	FLEE,		// Walk away from the player, staying on the board
+	WANDER,		// Walk to random points on the board
+	COUNT
+};
+
+struct EnemyBehaviour
+{
+	BehaviourKernel kernel;
+	float moveSpeed;		// Units per second
+	float keepAwayRadius;	// CHASE stops this far from the player
+	float wanderTrigger;	// WANDER only picks a new point when the player is this close, 0 for any time
+	float separation;		// Units per second to step apart from a neighbour we're right on top of, 0 for none
+};
+
+// Behaviour IDs are rows of the table in EnemyBehaviours.cpp
+#define ENEMY_BEHAVIOUR_COUNT 6
+
+// Enemies are a unit across, so any closer than this and they're overlapping
+#define ENEMY_SEPARATION_RADIUS 1.0f
+
+// Enemies per job when a group is split between threads
+#define ENEMY_BEHAVIOUR_GRAIN 32
+
+class EnemyBehaviours
+{
+private:
+	// This tick's enemies (indices into the GameBoard's list) sorted by kernel
+	std::vector<int> m_groups[(int)BehaviourKernel::COUNT];
+
+	// One group at a time is copied into these
+	std::vector<float> m_positionX;
+	std::vector<float> m_positionZ;
+	std::vector<float> m_step;				// How far each can move this update
+	std::vector<float> m_keepAwaySquared;
+	std::vector<float> m_triggerSquared;
+	std::vector<float> m_limitX;			// Furthest along the board FLEE can go
+	std::vector<float> m_limitZ;
+	std::vector<float> m_distanceSquared;	// To the player
+	std::vector<float> m_rotY;
+	std::vector<float> m_directionX;
+	std::vector<float> m_directionZ;
+	std::vector<unsigned char> m_active;	// Moving (CHASE) or ready to set off (WANDER)
+	std::vector<float> m_separationStep;	// How far each can step apart this update
+
+	SpatialHash* m_neighbours;	// Where every living enemy was at the start of the tick, NULL to skip separation
+	JobSystem* m_jobs;			// NULL to do everything on the calling thread
+
+	// These all work on entries begin to end (not including end) of the group
+	void Resize(int count);
+	void Gather(std::vector<Enemy*>* enemies, std::vector<int>& group, const float* timesteps, int begin, int end);
+	void Scatter(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end);
+
+	void RunChase(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end);
+	void RunFlee(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end);
+	void RunWander(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end);
+	void RunSeparation(std::vector<Enemy*>* enemies, std::vector<int>& group, int begin, int end);
+
+	// Gathers, turns, moves and scatters part of a group
+	void RunRange(std::vector<Enemy*>* enemies, std::vector<int>& group, BehaviourKernel kernel,
+		const float* timesteps, Vector3 playerPosition, int begin, int end);
+
+public:
+	EnemyBehaviours();
+
+	static const EnemyBehaviour& GetBehaviour(int id);
+
+	void SetNeighbours(SpatialHash* neighbours) { m_neighbours = neighbours; }
+	void SetJobSystem(JobSystem* jobs) { m_jobs = jobs; }
+
+	// Updates the listed enemies, each by their own timestep (indexed the same as the enemies)
+	void Update(std::vector<Enemy*>* enemies, const int* indices, int count, const float* timesteps, Vector3 playerPosition);
+};
+
+#endif
@@ -0,0 +1,50 @@
+/*	FIT2096 - Assignment 2b
+*	FixedTimestep.cpp
+*	Implementation of FixedTimestep.h
+*/
+
+#include "FixedTimestep.h"
+
+FixedTimestep::FixedTimestep(float ticksPerSecond, int maxTicksPerFrame)
+{
+	m_stepSize = 1.0f / ticksPerSecond;
+	m_accumulator = 0.0f;
+	m_interpolation = 0.0f;
+	m_maxTicksPerFrame = maxTicksPerFrame;
+}
+
+int FixedTimestep::Advance(float frameTime)
+{
+	// A negative time can't be simulated (can happen if the counter is read on different cores)
+	if (frameTime > 0.0f)
+	{
+		m_accumulator += frameTime;
+	}
+
+	int ticks = 0;
+
+	while (m_accumulator >= m_stepSize && ticks < m_maxTicksPerFrame)
+	{
+		m_accumulator -= m_stepSize;
+		ticks++;
+	}
+
+	// If we hit the cap we're too far behind to ever catch up (breakpoint, window drag, slow machine)
+	// Throw away the backlog so the game slows down for a moment instead of simulating forever
+	if (ticks == m_maxTicksPerFrame && m_accumulator >= m_stepSize)
+	{
+		m_accumulator = 0.0f;
+	}
+
+	m_interpolation = m_accumulator / m_stepSize;
+
+	return ticks;
+}
+
+void FixedTimestep::SetTickRate(float ticksPerSecond, int maxTicksPerFrame)
+{
+	m_stepSize = 1.0f / ticksPerSecond;
+	m_maxTicksPerFrame = maxTicksPerFrame;
+	m_accumulator = 0.0f;
+	m_interpolation = 0.0f;
+}
@@ -0,0 +1,35 @@
+/*	FIT2096 - Assignment 2b
+*	FixedTimestep.h
+*	Decouples the simulation rate from the frame rate. Each frame we feed in however
+*	much real time has passed, it tells us how many fixed size ticks to simulate and
+*	how far we are between the last tick and the next one so rendering can blend.
+*	https://gafferongames.com/post/fix_your_timestep/
+*/
+
+#ifndef FIXED_TIMESTEP_H
+#define FIXED_TIMESTEP_H
+
+class FixedTimestep
+{
+private:
+	float m_stepSize;			// Length of one simulation tick in seconds
+	float m_accumulator;		// Real time that has passed but hasn't been simulated yet
+	float m_interpolation;		// How far we are between the previous tick and the current one (0 to 1)
+	int m_maxTicksPerFrame;		// Stops us spiralling if a frame takes longer to simulate than it covers
+
+public:
+	FixedTimestep(float ticksPerSecond, int maxTicksPerFrame);
+
+	// Returns the number of ticks to run this frame. The interpolation amount is valid after this returns.
+	int Advance(float frameTime);
+
+	float GetStepSize() { return m_stepSize; }
+	float GetInterpolation() { return m_interpolation; }
+	float GetTimeUntilNextTick() { return m_stepSize - m_accumulator; }	// Seconds, valid after Advance
+	int GetMaxTicksPerFrame() { return m_maxTicksPerFrame; }
+
+	// Changing the rate throws away any time that hasn't been simulated yet, it was measured in the old ticks
+	void SetTickRate(float ticksPerSecond, int maxTicksPerFrame);
+};
+
+#endif
@@ -0,0 +1,380 @@
+/*	FIT2096 - Assignment 2b
+*	FlowField.cpp
+*	Implementation of FlowField.h
+*/
+
+#include "FlowField.h"
+#include <algorithm>
+#include <cmath>
+
+// The eight neighbours of a cell and what it costs to step into each
+static const int NEIGHBOUR_COUNT = 8;
+static const int NEIGHBOUR_X[NEIGHBOUR_COUNT] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int NEIGHBOUR_Z[NEIGHBOUR_COUNT] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+static const int NEIGHBOUR_COST[NEIGHBOUR_COUNT] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+
+// The two straight neighbours a diagonal step squeezes between
+static const int DIAGONAL_SIDE_X[NEIGHBOUR_COUNT] = { -1, -1, -1, -1, 0, 0, 1, 1 };
+static const int DIAGONAL_SIDE_Z[NEIGHBOUR_COUNT] = { -1, -1, -1, -1, 2, 3, 2, 3 };
+
+FlowField::FlowField()
+{
+	m_tiles = NULL;
+	m_width = 0;
+	m_height = 0;
+	m_stride = 0;
+	m_targetIndex = -1;
+	m_rebuildCount = 0;
+	m_repairCount = 0;
+
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		m_neighbourOffsets[n] = 0;
+	}
+}
+
+void FlowField::Build(TileGrid* tiles)
+{
+	m_tiles = tiles;
+	m_width = tiles->GetWidth();
+	m_height = tiles->GetHeight();
+	m_stride = m_width + 2;
+
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		m_neighbourOffsets[n] = NEIGHBOUR_Z[n] * m_stride + NEIGHBOUR_X[n];
+	}
+
+	// The ring around the outside is never passable
+	m_passable.assign(m_stride * (m_height + 2), 0);
+
+	for (int z = 0; z < m_height; z++)
+	{
+		for (int x = 0; x < m_width; x++)
+		{
+			m_passable[GetIndex(x, z)] = tiles->IsWalkable(x, z) ? 1 : 0;
+		}
+	}
+
+	// Nothing to chase until someone sets a target
+	m_distances.resize(m_passable.size());
+	m_targetIndex = -1;
+	Rebuild();
+}
+
+void FlowField::GetSteps(int index, bool* steps)
+{
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		steps[n] = m_distances[index + m_neighbourOffsets[n]] != FLOW_FIELD_BLOCKED;
+	}
+
+	// Squeezing diagonally between two blocked cells (or around the corner of one) isn't allowed
+	for (int n = 4; n < NEIGHBOUR_COUNT; n++)
+	{
+		steps[n] = steps[n] && steps[DIAGONAL_SIDE_X[n]] && steps[DIAGONAL_SIDE_Z[n]];
+	}
+}
+
+void FlowField::SetTarget(int x, int z)
+{
+	if (!m_tiles)
+		return;
+
+	int index = m_tiles->IsInside(x, z) ? GetIndex(x, z) : -1;
+
+	if (index != m_targetIndex)
+	{
+		m_targetIndex = index;
+		Rebuild();
+		m_rebuildCount++;
+	}
+}
+
+void FlowField::SetTarget(Vector3 position)
+{
+	// Cells are centred on whole numbers
+	SetTarget((int)floorf(position.x + 0.5f), (int)floorf(position.z + 0.5f));
+}
+
+void FlowField::Rebuild()
+{
+	int count = (int)m_distances.size();
+
+	for (int i = 0; i < count; i++)
+	{
+		m_distances[i] = m_passable[i] ? FLOW_FIELD_UNREACHABLE : FLOW_FIELD_BLOCKED;
+	}
+
+	if (m_targetIndex == -1)
+		return;
+
+	// The target can always be walked on, wherever the player is standing
+	m_distances[m_targetIndex] = 0;
+	m_seeds.clear();
+	m_seeds.push_back(std::make_pair(0, m_targetIndex));
+	Propagate();
+}
+
+void FlowField::Propagate()
+{
+	// Dijkstra, but as every step costs at most 14 a ring of buckets indexed by distance
+	// does the job of a priority queue. Cells are expanded in order of distance in linear time.
+	std::sort(m_seeds.begin(), m_seeds.end());
+
+	unsigned int nextSeed = 0;
+	int pending = 0;
+	int current = 0;
+
+	while (nextSeed < m_seeds.size() || pending > 0)
+	{
+		// Nothing left at this distance or beyond, skip ahead to the next seed
+		if (pending == 0)
+		{
+			current = m_seeds[nextSeed].first;
+		}
+
+		while (nextSeed < m_seeds.size() && m_seeds[nextSeed].first == current)
+		{
+			m_buckets[current % FLOW_FIELD_BUCKET_COUNT].push_back(m_seeds[nextSeed].second);
+			pending++;
+			nextSeed++;
+		}
+
+		// Steps cost at least 10 so nothing we add while expanding lands back in this bucket
+		std::vector<int>& bucket = m_buckets[current % FLOW_FIELD_BUCKET_COUNT];
+
+		for (unsigned int i = 0; i < bucket.size(); i++)
+		{
+			int index = bucket[i];
+			pending--;
+
+			// Found a shorter way here since this was added
+			if (m_distances[index] != current)
+				continue;
+
+			bool steps[NEIGHBOUR_COUNT];
+			GetSteps(index, steps);
+
+			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+			{
+				if (!steps[n])
+					continue;
+
+				int neighbour = index + m_neighbourOffsets[n];
+				int distance = current + NEIGHBOUR_COST[n];
+
+				if (distance < m_distances[neighbour])
+				{
+					m_distances[neighbour] = distance;
+					m_buckets[distance % FLOW_FIELD_BUCKET_COUNT].push_back(neighbour);
+					pending++;
+				}
+			}
+		}
+
+		bucket.clear();
+		current++;
+	}
+
+	m_seeds.clear();
+}
+
+void FlowField::OnTileChanged(int x, int z)
+{
+	if (!m_tiles || !m_tiles->IsInside(x, z))
+		return;
+
+	int index = GetIndex(x, z);
+	unsigned char passable = m_tiles->IsWalkable(x, z) ? 1 : 0;
+
+	// Only matters if it changed whether you can walk on it
+	if (passable == m_passable[index])
+		return;
+
+	m_passable[index] = passable;
+
+	// The target counts as open whatever it's made of, so nothing changes
+	if (index == m_targetIndex)
+		return;
+
+	m_repairCount++;
+
+	if (passable)
+	{
+		RepairAfterOpening(index);
+	}
+	else
+	{
+		RepairAfterBlocking(index);
+	}
+}
+
+bool FlowField::IsSupported(int index)
+{
+	if (index == m_targetIndex)
+		return true;
+
+	// Still reachable at this distance if some neighbour we can step to is exactly one step closer
+	bool steps[NEIGHBOUR_COUNT];
+	GetSteps(index, steps);
+
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		int neighbour = index + m_neighbourOffsets[n];
+
+		if (steps[n] && HasDistance(neighbour) && m_distances[neighbour] + NEIGHBOUR_COST[n] == m_distances[index])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+int FlowField::GetBestFromNeighbours(int index)
+{
+	int best = FLOW_FIELD_UNREACHABLE;
+	bool steps[NEIGHBOUR_COUNT];
+	GetSteps(index, steps);
+
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		int neighbour = index + m_neighbourOffsets[n];
+
+		if (steps[n] && HasDistance(neighbour) && m_distances[neighbour] + NEIGHBOUR_COST[n] < best)
+		{
+			best = m_distances[neighbour] + NEIGHBOUR_COST[n];
+		}
+	}
+
+	return best;
+}
+
+void FlowField::RepairAfterBlocking(int index)
+{
+	// Distances can only go up when a cell is blocked. Throw away every distance whose path went
+	// through the blocked cell (or squeezed past its corner), then fill them back in from the
+	// edges of the hole. Everything else on the board is left alone.
+	m_distances[index] = FLOW_FIELD_BLOCKED;
+	m_invalidated.clear();
+	m_invalidated.push_back(index);
+
+	// Steps that used the blocked cell all start or end next to it, and anything that was relying
+	// on a cell we throw away might need to go too
+	for (unsigned int i = 0; i < m_invalidated.size(); i++)
+	{
+		int cell = m_invalidated[i];
+
+		for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+		{
+			int neighbour = cell + m_neighbourOffsets[n];
+
+			if (HasDistance(neighbour) && !IsSupported(neighbour))
+			{
+				m_distances[neighbour] = FLOW_FIELD_UNREACHABLE;
+				m_invalidated.push_back(neighbour);
+			}
+		}
+	}
+
+	// Start each thrown away cell from its best remaining neighbour and let them settle
+	// (the first one is the blocked cell itself, which stays blocked)
+	m_seeds.clear();
+
+	for (unsigned int i = 1; i < m_invalidated.size(); i++)
+	{
+		int cell = m_invalidated[i];
+		int best = GetBestFromNeighbours(cell);
+
+		if (best != FLOW_FIELD_UNREACHABLE)
+		{
+			m_distances[cell] = best;
+			m_seeds.push_back(std::make_pair(best, cell));
+		}
+	}
+
+	Propagate();
+}
+
+void FlowField::RepairAfterOpening(int index)
+{
+	// Distances can only go down when a cell opens up, and only through steps touching the new
+	// cell (including diagonals past its corners that used to be blocked). Lower whatever those
+	// steps improve and let the improvement spread outwards.
+	m_distances[index] = FLOW_FIELD_UNREACHABLE;
+	m_seeds.clear();
+
+	for (int n = -1; n < NEIGHBOUR_COUNT; n++)
+	{
+		int cell = n == -1 ? index : index + m_neighbourOffsets[n];
+
+		if (m_distances[cell] == FLOW_FIELD_BLOCKED)
+			continue;
+
+		int best = GetBestFromNeighbours(cell);
+
+		if (best < m_distances[cell])
+		{
+			m_distances[cell] = best;
+			m_seeds.push_back(std::make_pair(best, cell));
+		}
+	}
+
+	Propagate();
+}
+
+int FlowField::GetDistance(int x, int z)
+{
+	if (!m_tiles || !m_tiles->IsInside(x, z))
+		return FLOW_FIELD_UNREACHABLE;
+
+	int distance = m_distances[GetIndex(x, z)];
+	return distance == FLOW_FIELD_BLOCKED ? FLOW_FIELD_UNREACHABLE : distance;
+}
+
+bool FlowField::Covers(Vector3 position)
+{
+	return GetDistance((int)floorf(position.x + 0.5f), (int)floorf(position.z + 0.5f)) != FLOW_FIELD_UNREACHABLE;
+}
+
+bool FlowField::GetStep(Vector3 position, bool flee, Vector3* direction)
+{
+	int x = (int)floorf(position.x + 0.5f);
+	int z = (int)floorf(position.z + 0.5f);
+	int distance = GetDistance(x, z);
+
+	if (distance == FLOW_FIELD_UNREACHABLE)
+		return false;
+
+	// Look for the neighbour that takes us furthest in the direction we want to go
+	int index = GetIndex(x, z);
+	int best = -1;
+	int bestDistance = distance;
+	bool steps[NEIGHBOUR_COUNT];
+	GetSteps(index, steps);
+
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		int neighbour = index + m_neighbourOffsets[n];
+
+		if (!steps[n] || !HasDistance(neighbour))
+			continue;
+
+		if (flee ? m_distances[neighbour] > bestDistance : m_distances[neighbour] < bestDistance)
+		{
+			best = n;
+			bestDistance = m_distances[neighbour];
+		}
+	}
+
+	if (best == -1)
+		return false;
+
+	// Head for the middle of that cell, along the ground
+	Vector3 towards((float)(x + NEIGHBOUR_X[best]) - position.x, 0.0f, (float)(z + NEIGHBOUR_Z[best]) - position.z);
+	towards.Normalize();
+	*direction = towards;
+
+	return true;
+}
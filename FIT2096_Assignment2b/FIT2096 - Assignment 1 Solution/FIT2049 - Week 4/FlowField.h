@@ -0,0 +1,96 @@
+/*	FIT2096 - Assignment 2b
+*	FlowField.h
+*	Shared pathfinding for every enemy on the board. Instead of each enemy searching for its own
+*	path, we work out once how far every cell is from the player (walking around walls and
+*	disabled tiles) and store it in a flat array alongside the TileGrid.
+*	To chase, an enemy steps into whichever neighbouring cell is closest to the player.
+*	To flee, it steps into whichever is furthest away. Both are a handful of lookups, so it
+*	doesn't matter how many enemies are asking.
+*	The field is only worked out again when the player moves into a different cell. When a
+*	tile changes type only the cells whose distance actually depended on it are redone.
+*/
+
+#ifndef FLOW_FIELD_H
+#define FLOW_FIELD_H
+
+#include "TileGrid.h"
+#include <utility>
+#include <vector>
+
+// Distance for cells you can't get to the target from
+#define FLOW_FIELD_UNREACHABLE 0x7fffffff
+
+// Distance for cells that can't be walked on at all
+#define FLOW_FIELD_BLOCKED -1
+
+// Steps cost 10 straight and 14 diagonally (close enough to 1 and the square root of 2)
+// The longest step is 14, so distances waiting to be looked at never span more than this many buckets
+#define FLOW_FIELD_BUCKET_COUNT 16
+
+class FlowField
+{
+private:
+	TileGrid* m_tiles;
+	int m_width;
+	int m_height;
+	int m_stride;	// Width of a row in our arrays, which have a blocked cell at each end
+
+	// Cost to reach the target from each cell, or FLOW_FIELD_BLOCKED if it can't be walked on.
+	// There's a ring of blocked cells around the outside so stepping in any direction is always in bounds.
+	std::vector<int> m_distances;
+	std::vector<unsigned char> m_passable;	// What each cell's type was when we last looked, so we can spot changes
+
+	int m_targetIndex;	// -1 when there's no target
+	int m_neighbourOffsets[8];	// How far away each neighbour is in the arrays
+
+	// Scratch space, kept between updates so we don't allocate every time
+	std::vector<int> m_buckets[FLOW_FIELD_BUCKET_COUNT];	// Cells waiting to be expanded, by distance
+	std::vector<std::pair<int, int> > m_seeds;				// Distance and cell to start expanding from
+	std::vector<int> m_invalidated;							// Cells whose distance was thrown away
+
+	// For checking the field is only being redone when it should be
+	int m_rebuildCount;
+	int m_repairCount;
+
+	int GetIndex(int x, int z) { return (z + 1) * m_stride + x + 1; }
+	bool HasDistance(int index) { return m_distances[index] >= 0 && m_distances[index] != FLOW_FIELD_UNREACHABLE; }
+
+	// Which of the eight neighbours of a cell can be stepped into
+	// Moving diagonally can't cut the corner of a blocked cell
+	void GetSteps(int index, bool* steps);
+	bool IsSupported(int index);	// Does a neighbour still explain this cell's distance?
+	int GetBestFromNeighbours(int index);
+
+	void Rebuild();
+	void Propagate();	// Expands outwards from m_seeds, lowering distances as it goes
+	void RepairAfterBlocking(int index);
+	void RepairAfterOpening(int index);
+
+	bool GetStep(Vector3 position, bool flee, Vector3* direction);
+
+public:
+	FlowField();
+
+	// Takes a copy of which cells can be walked on. Call again if the board is regenerated.
+	void Build(TileGrid* tiles);
+
+	// Redoes the field if this is a different cell from last time
+	void SetTarget(int x, int z);
+	void SetTarget(Vector3 position);
+
+	// Call after changing a tile's type in the TileGrid
+	void OnTileChanged(int x, int z);
+
+	int GetDistance(int x, int z);
+	bool Covers(Vector3 position);	// Is this position somewhere the target can be reached from?
+
+	// Direction along the ground to walk to get closer to (or further from) the target
+	// Returns false if there's no better cell to step into (at the target, or cornered)
+	bool GetChaseDirection(Vector3 position, Vector3* direction) { return GetStep(position, false, direction); }
+	bool GetFleeDirection(Vector3 position, Vector3* direction) { return GetStep(position, true, direction); }
+
+	int GetRebuildCount() { return m_rebuildCount; }
+	int GetRepairCount() { return m_repairCount; }
+};
+
+#endif
@@ -7,7 +7,7 @@
 #include "TexturedShader.h"
 #include "StaticObject.h"
 
-#include "DirectXTK/CommonStates.h"
+#include <cstring>
 #include <sstream>
 
 Game::Game()
@@ -20,7 +20,23 @@ Game::Game()
 	m_meshManager = NULL;
 	m_textureManager = NULL;
 	m_diffuseTexturedShader = NULL;
+	m_instancedShader = NULL;
 	m_gameBoard = NULL;
+	m_boardWidth = GameBoard::DEFAULT_BOARD_WIDTH;
+	m_boardHeight = GameBoard::DEFAULT_BOARD_HEIGHT;
+	m_extraEnemies = 0;
+	m_jobSystem = NULL;
+	m_threadCount = 0;
+	m_assetPack = NULL;
+	m_assetLoader = NULL;
+	m_loadingMusic = NULL;
+	m_loadingFailed = false;
+	m_player = NULL;
+	m_collisionManager = NULL;
+	m_HealthBarSprite = NULL;
+	m_renderBackend = NULL;
+	m_buildingSnapshot = NULL;
+	m_tickCount = 0;
 	
 	m_stateMachine = NULL;
 	m_startButton = NULL;
@@ -41,177 +57,227 @@ bool Game::Initialise(Direct3D* renderer, AudioSystem* audio, InputController* i
 	if (!InitShaders())
 		return false;
 
-	if (!LoadMeshes())
-		return false;
-
-	if (!LoadTextures())
-		return false;
-
-	if (!LoadAudio())
-		return false;
+	// Only the render thread touches the device context after this
+	m_renderBackend = new Direct3DRenderBackend(m_renderer);
 
-	// Ready background music
-	m_backgroundMusic = m_audio->Play("Assets/Sounds/rocket_race.mp3", false);
+	// One thread per core unless we've been told otherwise
+	int threadCount = m_threadCount > 0 ? m_threadCount : (int)std::thread::hardware_concurrency();
+	m_jobSystem = new JobSystem(threadCount);
 
-	if (m_backgroundMusic)
+	// Everything comes out of one file when assetpack has made one, otherwise straight from the Assets folder
+	m_assetPack = new AssetPack();
+	if (m_assetPack->Open(ASSET_PACK_FILENAME))
 	{
-		m_backgroundMusic->SetLoopCount(-1);
-		m_backgroundMusic->SetPaused(false);
+		m_assetPack->SetJobSystem(m_jobSystem);
+		m_meshManager->SetAssetPack(m_assetPack);
+		m_textureManager->SetAssetPack(m_assetPack);
+		m_audio->SetAssetPack(m_assetPack);
 	}
+	else
+	{
+		delete m_assetPack;
+		m_assetPack = NULL;
+	}
+
+	// Everything the game needs is loaded on the job system's threads while the menu is up.
+	// Only what the menu itself shows is loaded here first.
+	m_assetLoader = new AssetLoader(m_jobSystem);
+
+	if (!m_textureManager->Load(m_renderer, "Assets/Textures/button.png"))
+		return false;
+
+	LoadMeshes();
+	LoadTextures();
+	LoadAudio();
 
 	// Prepare the sprites
 	LoadFonts();
 	// Initialize UI
 	InitUI();
-	// Initialize Game World
-	InitGameWorld();
 	// Ready State Machine
 	InitStates();
 
 	m_countDown = 90.0f;
 	m_isTimeTrial = false;
 
-	m_collisionManager = new CollisionManager(&m_players, &m_enemies, &m_bullets, &m_healthPacks);
-
-	// Create the camera after player has appeared
-	//m_currentCam = new Camera();  // For third person view
-	m_currentCam = new FirstPersonCamera(m_input, m_player->GetPosition() + Vector3(0.0f, 5.0f, 0.0f));  // For first person view
+	m_assetLoader->AddMark("menu ready");
 
 	return true;
 }
 
-bool Game::InitShaders()
+bool Game::FinishLoading()
 {
-	m_diffuseTexturedShader = new TexturedShader();
-	if (!m_diffuseTexturedShader->Initialise(m_renderer->GetDevice(), L"Assets/Shaders/VertexShader.vs", L"Assets/Shaders/TexturedPixelShader.ps"))
-		return false;
+	if (m_gameBoard)
+		return true;
 
-	return true;
+	m_assetLoader->Finish();
+	return OnAssetsLoaded();
 }
 
-void Game::LoadFonts()
+void Game::UpdateLoading()
 {
-	// There's a few different size fonts in there, you know
-	m_arialFont12 = new SpriteFont(m_renderer->GetDevice(), L"Assets/Fonts/Arial-12pt.spritefont");
-	m_arialFont18 = new SpriteFont(m_renderer->GetDevice(), L"Assets/Fonts/Arial-18pt.spritefont");
-}
+	// We're on our way out, don't keep telling them
+	if (m_loadingFailed)
+		return;
 
-bool Game::LoadAudio()
-{
-	if (!m_audio->Load("Assets/Sounds/rocket_race.mp3"))
-		return false;
+	m_assetLoader->Update();
 
-	return true;
+	if (m_assetLoader->IsFinished() && !OnAssetsLoaded())
+	{
+		m_loadingFailed = true;
+		OutputDebugString(m_assetLoader->GetTimeline().c_str());
+
+		MessageBox(NULL, "Some of the game's assets could not be loaded.", "Loading Failed", MB_OK);
+		PostQuitMessage(0);
+	}
 }
 
-bool Game::LoadMeshes()
+bool Game::OnAssetsLoaded()
 {
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/floor_tile.obj"))
-		return false;
+	for (unsigned int i = 0; i < m_loadingAssets.size(); i++)
+	{
+		if (!m_loadingAssets[i].get())
+			return false;
+	}
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/wall_tile.obj"))
-		return false;
+	m_loadingAssets.clear();
+	m_assetLoader->AddMark("assets ready");
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/player_capsule.obj"))
-		return false;
+	// Ready background music
+	m_backgroundMusic = m_audio->Play("Assets/Sounds/rocket_race.mp3", false);
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/progress_cube.obj"))
-		return false;
-	
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/ammoBlock.obj"))
-		return false;
+	if (m_backgroundMusic)
+	{
+		m_backgroundMusic->SetLoopCount(-1);
+		m_backgroundMusic->SetPaused(false);
+	}
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/bullet.obj"))
-		return false;
+	m_HealthBarSprite = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/sprite_healthBar.png"));  // To show the healthbar
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/enemy.obj"))
-		return false;
+	// Initialize Game World
+	InitGameWorld();
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/ground.obj"))
-		return false;
+	m_collisionManager = new CollisionManager(&m_players, &m_enemies, m_gameBoard->GetBulletPool(), &m_healthPacks, m_gameBoard->GetWidth(), m_gameBoard->GetHeight());
 
-	if (!m_meshManager->Load(m_renderer, "Assets/Meshes/ruby.obj"))
-		return false;
+	// Create the camera after player has appeared
+	//m_currentCam = new Camera();  // For third person view
+	m_currentCam = new FirstPersonCamera(m_input, m_player->GetPosition() + Vector3(0.0f, 5.0f, 0.0f));  // For first person view
+
+	m_assetLoader->AddMark("game ready");
+	OutputDebugString(m_assetLoader->GetTimeline().c_str());
 
 	return true;
 }
 
-bool Game::LoadTextures()
+bool Game::InitShaders()
 {
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/button.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_blue.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_disabled.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_green.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_orange.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_purple.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_red.png"))
-		return false;
-
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/tile_white.png"))
+	m_diffuseTexturedShader = new TexturedShader();
+	if (!m_diffuseTexturedShader->Initialise(m_renderer->GetDevice(), L"Assets/Shaders/VertexShader.vs", L"Assets/Shaders/TexturedPixelShader.ps", MESH_VERTEX_FORMAT))
 		return false;
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/bullet.png"))
+	m_instancedShader = new InstancedShader();
+	if (!m_instancedShader->Initialise(m_renderer->GetDevice(), L"Assets/Shaders/VertexShader.vs", L"Assets/Shaders/TexturedPixelShader.ps", MESH_VERTEX_FORMAT))
 		return false;
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/gradient_red.png"))
-		return false;
+	return true;
+}
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/gradient_redDarker.png"))
-		return false;
+void Game::LoadFonts()
+{
+	// There's a few different size fonts in there, you know
+	m_arialFont12 = LoadFont("Assets/Fonts/Arial-12pt.spritefont");
+	m_arialFont18 = LoadFont("Assets/Fonts/Arial-18pt.spritefont");
+}
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/gradient_redLighter.png"))
-		return false;
+SpriteFont* Game::LoadFont(const char* filename)
+{
+	// The font is built from the bytes as it's made, so they're only needed until then
+	AssetData data;
+	if (m_assetPack && m_assetPack->Read(filename, &data))
+		return new SpriteFont(m_renderer->GetDevice(), (const uint8_t*)data.GetData(), data.GetSize());
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/gradient_redOrange.png"))
-		return false;
+	std::wstring wideFilename(filename, filename + strlen(filename));
+	return new SpriteFont(m_renderer->GetDevice(), wideFilename.c_str());
+}
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/gradient_redPink.png"))
-		return false;
+void Game::LoadAudio()
+{
+	// FMOD decodes the whole song when it's opened, which is most of the wait, so that happens on the loader's threads too
+	m_loadingAssets.push_back(m_assetLoader->Load("Assets/Sounds/rocket_race.mp3",
+		[this]()
+		{
+			return m_audio->OpenSound("Assets/Sounds/rocket_race.mp3", false, &m_loadingMusic);
+		},
+		[this](bool decoded)
+		{
+			if (decoded)
+				m_audio->AddSound("Assets/Sounds/rocket_race.mp3", m_loadingMusic);
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/ground.png"))
-		return false;
+			m_loadingMusic = NULL;
+			return decoded;
+		}));
+}
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/sprite_healthBar.png"))
-		return false;
+void Game::LoadMeshes()
+{
+	// These all return straight away, the futures tell us when each one is in its manager
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/floor_tile.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/wall_tile.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/player_capsule.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/progress_cube.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/ammoBlock.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/bullet.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/enemy.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/ground.obj"));
+	m_loadingAssets.push_back(m_meshManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Meshes/ruby.obj"));
+}
 
-	if (!m_textureManager->Load(m_renderer, "Assets/Textures/sprite_hurtOverlay.png"))
-		return false;
+void Game::LoadTextures()
+{
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_blue.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_disabled.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_green.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_orange.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_purple.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_red.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/tile_white.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/bullet.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/gradient_red.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/gradient_redDarker.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/gradient_redLighter.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/gradient_redOrange.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/gradient_redPink.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/ground.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/sprite_healthBar.png"));
+	m_loadingAssets.push_back(m_textureManager->LoadAsync(m_assetLoader, m_renderer, "Assets/Textures/sprite_hurtOverlay.png"));
 
-	return true;
+	// Only there when the tile textures have been cooked, without it the board just draws each tile on its own.
+	// So it isn't waited on like the rest, though the loader still has it done before the board is made.
+	m_textureManager->LoadArrayAsync(m_assetLoader, m_renderer, TILE_TEXTURE_ARRAY, GameBoard::TILE_LAYER_FILENAMES, TILE_LAYER_COUNT);
 }
 
 void Game::InitGameWorld()
 {
 	// A GameBoard creates the world layout and manages the Tiles.
 	// We pass it the Mesh and Texture managers as it will be creating tiles and walls
-	m_gameBoard = new GameBoard(m_meshManager, m_textureManager, m_diffuseTexturedShader);
+	m_gameBoard = new GameBoard(m_meshManager, m_textureManager, m_diffuseTexturedShader, m_boardWidth, m_boardHeight);
+	m_gameBoard->SpawnEnemies(m_extraEnemies);
+	m_gameBoard->SetJobSystem(m_jobSystem);
+	m_gameBoard->SetInstancedShader(m_instancedShader);
 
 
 	// A player will select a random starting position.
 	// We need to tell the player about the board it is standing on so it can validate movement
 	// and ask the board what type of tile it is standing on.
-	m_player = new Player(m_meshManager->GetMesh("Assets/Meshes/enemy.obj"),
+	m_player = new Player(m_meshManager->GetMesh(PATH_HASH("Assets/Meshes/enemy.obj")),
 						  m_diffuseTexturedShader,
-						  m_textureManager->GetTexture("Assets/Textures/tile_white.png"),
+						  m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_white.png")),
 						  m_input,
 						  m_gameBoard);
 
 	// To be passed into Collision Manager
 	m_players.push_back(m_player);
 	m_enemies = m_gameBoard->getEnemyVector();
-	m_bullets = m_gameBoard->getBulletVector();
 	m_healthPacks = m_gameBoard->getHealthPackVector();
 
 }
@@ -241,6 +307,13 @@ void Game::Update(float timestep)
 	// Our only job out here is to Update the board and player, and check if the game is over.
 	m_input->BeginUpdate();
 
+	// Until everything has loaded there's only the menu to look at
+	if (!IsLoaded())
+		UpdateLoading();
+
+	StorePreviousTransforms();
+	m_tickCount++;
+
 	// Update audio
 	m_audio->Update();
 
@@ -285,21 +358,59 @@ void Game::Update(float timestep)
 
 void Game::Render()
 {
-	m_renderer->BeginScene(0.2f, 0.2f, 0.2f, 1.0f);
+	BuildSnapshot(&m_snapshot, m_renderer->GetInterpolation());
+	m_renderBackend->Draw(&m_snapshot, m_renderer->GetInterpolation());
+}
+
+void Game::BuildSnapshot(RenderSnapshot* snapshot, float interpolation)
+{
+	snapshot->Clear();
+	snapshot->tick = m_tickCount;
+	snapshot->interpolation = interpolation;
+	snapshot->clearColour = Color(0.2f, 0.2f, 0.2f, 1.0f);
 
+	// The camera is blended between the same two ticks as everything it's looking at
+	if (m_currentCam)
+	{
+		snapshot->previousCameraPosition = m_currentCam->GetTickPosition();
+		snapshot->cameraPosition = m_currentCam->GetPosition();
+		snapshot->previousCameraLookAt = m_currentCam->GetTickLookAt();
+		snapshot->cameraLookAt = m_currentCam->GetLookAt();
+		snapshot->cameraUp = m_currentCam->GetViewUp();
+		snapshot->projection = m_currentCam->GetProjection();
+	}
+	else
+	{
+		// No camera until the world has loaded, there's only the menu to draw anyway
+		snapshot->previousCameraPosition = snapshot->cameraPosition = Vector3::Zero;
+		snapshot->previousCameraLookAt = snapshot->cameraLookAt = Vector3::Forward;
+		snapshot->cameraUp = Vector3::Up;
+		snapshot->projection = Matrix::Identity;
+	}
+
+	m_buildingSnapshot = snapshot;
 	m_stateMachine->Render();
+	m_buildingSnapshot = NULL;
 
 	/*
 	// The board renders all of its tiles
-	m_gameBoard->Render(m_renderer, m_currentCam);
+	m_gameBoard->Render(snapshot);
 	
-	//m_player->Render(m_renderer, m_currentCam);  // Don't render the player in first person view
+	//m_player->Render(snapshot);  // Don't render the player in first person view
 	
 	// Draw UI here
 	DrawGameUI();
 	*/
+}
+
+void Game::StorePreviousTransforms()
+{
+	if (!IsLoaded())
+		return;
 
-	m_renderer->EndScene();		
+	m_gameBoard->StorePreviousTransforms();
+	m_player->StorePreviousTransform();
+	m_currentCam->StorePreviousTransform();
 }
 
 void Game::CheckGameOver()
@@ -339,6 +450,13 @@ void Game::CheckGameOver()
 
 void Game::Shutdown()
 {
+	// Anything still loading is finished off first, it's going into the managers and job system below
+	if (m_assetLoader)
+	{
+		delete m_assetLoader;
+		m_assetLoader = NULL;
+	}
+
 	if (m_player)
 	{
 		delete m_player;
@@ -351,6 +469,13 @@ void Game::Shutdown()
 		m_gameBoard = NULL;
 	}
 
+	// Nothing is using the threads once the board has gone
+	if (m_jobSystem)
+	{
+		delete m_jobSystem;
+		m_jobSystem = NULL;
+	}
+
 	if (m_currentCam)
 	{
 		delete m_currentCam;
@@ -378,10 +503,17 @@ void Game::Shutdown()
 		m_diffuseTexturedShader = NULL;
 	}
 
-	if (m_spriteBatch)
+	if (m_instancedShader)
+	{
+		m_instancedShader->Release();
+		delete m_instancedShader;
+		m_instancedShader = NULL;
+	}
+
+	if (m_renderBackend)
 	{
-		delete m_spriteBatch;
-		m_spriteBatch = NULL;
+		delete m_renderBackend;
+		m_renderBackend = NULL;
 	}
 
 	if (m_arialFont12)
@@ -403,6 +535,13 @@ void Game::Shutdown()
 		m_audio = NULL;
 	}
 
+	// Streams play straight out of the pack, so it stays open until the audio has gone
+	if (m_assetPack)
+	{
+		delete m_assetPack;
+		m_assetPack = NULL;
+	}
+
 	if (m_backgroundMusic)
 	{
 		delete m_backgroundMusic;
@@ -435,20 +574,16 @@ void Game::Shutdown()
 
 void Game::InitUI()
 {
-	m_spriteBatch = new SpriteBatch(m_renderer->GetDeviceContext());
-
-	m_HealthBarSprite = m_textureManager->GetTexture("Assets/Textures/sprite_healthBar.png");  // To show the healthbar
-
 	// Prepare Menu UI
-	Texture* buttonTexture = m_textureManager->GetTexture("Assets/Textures/button.png");
+	Texture* buttonTexture = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/button.png"));
 																							   // Also init any buttons here
-	m_startButton = new Button(128, 64, buttonTexture, L"Start Game", Vector2(574, 385), m_spriteBatch, m_arialFont12, m_input, [this]
+	m_startButton = new Button(128, 64, buttonTexture, L"Start Game", Vector2(574, 385), m_arialFont12, m_input, [this]
 	{
 		// Transition into the Gameplay state (these buttons are only used on the menu screen)
 		m_stateMachine->ChangeState(GameStates::GAMEPLAY_STATE);
 	});
 
-	m_timeTrialButton = new Button(128, 64, buttonTexture, L"Time Trial", Vector2(574, 600), m_spriteBatch, m_arialFont12, m_input, [this]
+	m_timeTrialButton = new Button(128, 64, buttonTexture, L"Time Trial", Vector2(574, 600), m_arialFont12, m_input, [this]
 	{
 		// Transition into the Gameplay state (these buttons are only used on the menu screen)
 		m_stateMachine->ChangeState(GameStates::TIMETRIAL_STATE);
@@ -456,7 +591,7 @@ void Game::InitUI()
 		m_isTimeTrial = true;
 	});
 
-	m_quitButton = new Button(128, 64, buttonTexture, L"Quit", Vector2(706, 385), m_spriteBatch, m_arialFont12, m_input, [this]
+	m_quitButton = new Button(128, 64, buttonTexture, L"Quit", Vector2(706, 385), m_arialFont12, m_input, [this]
 	{
 		// Tell windows to send a WM_QUIT message into our message pump
 		PostQuitMessage(0);
@@ -466,49 +601,44 @@ void Game::InitUI()
 
 void Game::DrawMenuUI()
 {
-	BeginUI();
-
-	m_startButton->Render();
-	m_timeTrialButton->Render();
-	m_quitButton->Render();
+	m_startButton->Render(m_buildingSnapshot);
+	m_timeTrialButton->Render(m_buildingSnapshot);
+	m_quitButton->Render(m_buildingSnapshot);
 	
 	// The game title
-	m_arialFont18->DrawString(m_spriteBatch, L"FIT2096 Assignment 2B", Vector2(500, 100), Color(1.0f, 1.0f, 1.0f), 0, Vector2(0, 0));
+	m_buildingSnapshot->AddText(m_arialFont18, L"FIT2096 Assignment 2B", Vector2(500, 100), Color(1.0f, 1.0f, 1.0f), Vector2(0, 0));
 
-	EndUI();
+	if (!IsLoaded())
+	{
+		std::wstringstream ss;
+		ss << "Loading... " << m_assetLoader->GetAssetCount() - m_assetLoader->GetPendingCount() << " of " << m_assetLoader->GetAssetCount();
+		m_buildingSnapshot->AddText(m_arialFont12, ss.str(), Vector2(574, 300), Color(1.0f, 1.0f, 1.0f), Vector2(0, 0));
+	}
 }
 
 void Game::DrawPauseUI()
 {
-	BeginUI();
-
-	m_arialFont18->DrawString(m_spriteBatch, L"Paused", Vector2(605, 10), Color(0.0f, 0.0f, 0.0f), 0, Vector2(0, 0));
-	
-	EndUI();
+	m_buildingSnapshot->AddText(m_arialFont18, L"Paused", Vector2(605, 10), Color(0.0f, 0.0f, 0.0f), Vector2(0, 0));
 }
 
 void Game::DrawGameUI()
 {
-	BeginUI();
-
-	// Do UI drawing between the Begin and End calls
+	// UI is drawn in the order it's added, over the top of the meshes
 	// This is for time trial mode
 	if (m_isTimeTrial)
 	{
-		m_arialFont18->DrawString(m_spriteBatch, m_countDownTimerText.c_str(), Vector2(1100, 10), Color(1.0f, 1.0f, 1.0f), 0, Vector2(0, 0));
+		m_buildingSnapshot->AddText(m_arialFont18, m_countDownTimerText, Vector2(1100, 10), Color(1.0f, 1.0f, 1.0f), Vector2(0, 0));
 	}
 
 	// So player knows they could pause
-	m_arialFont18->DrawString(m_spriteBatch, L"P to toggle pause", Vector2(1080, 680), Color(0.0f, 0.0f, 0.0f), 0, Vector2(0, 0));
+	m_buildingSnapshot->AddText(m_arialFont18, L"P to toggle pause", Vector2(1080, 680), Color(0.0f, 0.0f, 0.0f), Vector2(0, 0));
 
 	// Here to show the Player's Score
-	m_arialFont18->DrawString(m_spriteBatch, m_playerScoreText.c_str(), Vector2(500, 680), Color(0.0f, 0.0f, 0.0f), 0, Vector2(0, 0));
+	m_buildingSnapshot->AddText(m_arialFont18, m_playerScoreText, Vector2(500, 680), Color(0.0f, 0.0f, 0.0f), Vector2(0, 0));
 
 	// Here's how we draw a sprite over our game
 	RECT r1 = { 20, 20, m_player->GetHealth() * 2, 40 };
-	m_spriteBatch->Draw(m_HealthBarSprite->GetShaderResourceView(), r1, Color(0.0f, 1.0f, 0.0f));
-	
-	EndUI();
+	m_buildingSnapshot->AddSprite(m_HealthBarSprite, r1, Color(0.0f, 1.0f, 0.0f));
 }
 
 void Game::RefreshUI()
@@ -537,20 +667,6 @@ void Game::RefreshUI()
 	}
 }
 
-void Game::BeginUI()
-{
-	// Sprites don't use a shader 
-	m_renderer->SetCurrentShader(NULL);
-
-	CommonStates states(m_renderer->GetDevice());
-	m_spriteBatch->Begin(SpriteSortMode_Deferred, states.NonPremultiplied());
-}
-
-void Game::EndUI()
-{
-	m_spriteBatch->End();
-}
-
 
 // All states
 void Game::Menu_OnEnter()
@@ -560,6 +676,10 @@ void Game::Menu_OnEnter()
 
 void Game::Menu_OnUpdate(float timestep)
 {
+	// There's nothing to start until the world has loaded
+	if (!IsLoaded())
+		return;
+
 	// Only update the buttons in menu state
 	m_startButton->Update();
 	m_timeTrialButton->Update();
@@ -594,7 +714,7 @@ void Game::Gameplay_OnUpdate(float timestep)
 	m_gameBoard->SetCurrentPlayerPosition(m_player->GetPosition());
 	m_gameBoard->Update(timestep);
 
-	// Check collisions
+	// Check collisions, the board's jobs have all finished by now
 	if (m_collisionManager)
 	{
 		m_collisionManager->CheckCollisions();
@@ -626,9 +746,9 @@ void Game::Gameplay_OnUpdate(float timestep)
 void Game::Gameplay_OnRender()
 {
 	// The board renders all of its tiles
-	m_gameBoard->Render(m_renderer, m_currentCam);
+	m_gameBoard->Render(m_buildingSnapshot);
 
-	//m_player->Render(m_renderer, m_currentCam);  // Don't render the player in first person view
+	//m_player->Render(m_buildingSnapshot);  // Don't render the player in first person view
 
 	// Draw UI here
 	DrawGameUI();
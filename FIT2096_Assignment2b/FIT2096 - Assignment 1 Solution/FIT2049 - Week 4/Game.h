@@ -10,19 +10,25 @@
 #ifndef GAME_H
 #define GAME_H
 
+#include "AssetLoader.h"
+#include "AssetPack.h"
 #include "AudioSystem.h"
 #include "Button.h"
 #include "Direct3D.h"
+#include "Direct3DRenderBackend.h"
 #include "Camera.h"
 #include "Enemy.h"
 #include "FirstPersonCamera.h"
 #include "InputController.h"
+#include "InstancedShader.h"
 #include "CollisionManager.h"
 #include "MeshManager.h"
 #include "TextureManager.h"
 #include "GameObject.h"
 #include "GameBoard.h"
+#include "JobSystem.h"
 #include "Player.h"
+#include "RenderSnapshot.h"
 
 #include "StateMachine.h"
 
@@ -69,19 +75,23 @@ private:
 	CollisionManager* m_collisionManager;
 
 	Shader* m_diffuseTexturedShader;
+	InstancedShader* m_instancedShader;  // The same shaders drawing many copies of a mesh at once, for the board's tiles
 
 	// Our game data. The Game class only needs to manage three objects for this game.
 	GameBoard* m_gameBoard;
+	int m_boardWidth;
+	int m_boardHeight;
+	int m_extraEnemies;  // Spawned on top of the usual five
+	JobSystem* m_jobSystem;  // The board's update is spread over these threads
+	int m_threadCount;  // 0 for one per core
 	Player* m_player;
 	// Pass these to collision manager
 	std::vector<Player*> m_players;
 	std::vector<Enemy*> m_enemies;
-	std::vector<Bullet*> m_bullets;
 	std::vector<HealthPack*> m_healthPacks;	
 
 	// Sprites / Text Fonts
 	Texture* m_HealthBarSprite;
-	SpriteBatch* m_spriteBatch;
 	SpriteFont* m_arialFont12;
 	SpriteFont* m_arialFont18;
 
@@ -91,15 +101,26 @@ private:
 	std::wstring m_countDownTimerText;
 
 
+	// Assets load in the background while the menu is up, the world is made once they're all in
+	AssetPack* m_assetPack;  // NULL when there's no pack and everything comes from the Assets folder
+	AssetLoader* m_assetLoader;
+	std::vector<AssetFuture> m_loadingAssets;
+	FMOD::Sound* m_loadingMusic;  // Opened on a loader thread, handed to the audio system once it's done
+	bool m_loadingFailed;
+
 	// Splitting initialisation up into several steps
 	// Initialisation Helpers
 	bool InitShaders();
-	bool LoadAudio();
-	bool LoadMeshes();
-	bool LoadTextures();
+	void LoadAudio();  // These three only queue everything up on the asset loader
+	void LoadMeshes();
+	void LoadTextures();
 	void LoadFonts();
+	SpriteFont* LoadFont(const char* filename);  // Out of the pack when it has it
 	void InitGameWorld();
 	void InitStates();
+
+	void UpdateLoading();  // Called each Update until the world exists
+	bool OnAssetsLoaded();  // Makes the world, false if anything failed to load
 	
 
 	// UI drawing helpers
@@ -108,12 +129,19 @@ private:
 	void DrawGameUI();
 	void DrawPauseUI();
 	void RefreshUI();
-	void BeginUI();
-	void EndUI();
+
+	// Everything is drawn from a snapshot of the game, the render callbacks below fill in this one
+	Direct3DRenderBackend* m_renderBackend;
+	RenderSnapshot* m_buildingSnapshot;
+	RenderSnapshot m_snapshot;  // Used when Render draws on this thread
+	unsigned int m_tickCount;
 
 
 	void CheckGameOver();
 
+	// Each tick remembers where everything was before it moves so Render can blend between ticks
+	void StorePreviousTransforms();
+
 	// Every state in our game will have four callbacks
 	// We register these with the StateMachine and it calls them for us
 	void Menu_OnEnter();
@@ -140,12 +168,34 @@ public:
 	Game();	
 	~Game();
 
-	bool Initialise(Direct3D* renderer, AudioSystem* audio, InputController* input); //The initialise method will load all of the content for the game (meshes, textures, etc.)
+	bool Initialise(Direct3D* renderer, AudioSystem* audio, InputController* input); //Gets the menu going and starts loading all of the content for the game (meshes, textures, etc.)
+
+	// Everything else loads while the menu is up. This waits for it instead, for when there's nothing to show in the meantime.
+	bool FinishLoading();
+	bool IsLoaded() { return m_gameBoard != NULL; }
+	AssetLoader* GetAssetLoader() { return m_assetLoader; }
+	AssetPack* GetAssetPack() { return m_assetPack; }
 
 	void Update(float timestep);	//The overall Update method for the game. All gameplay logic will be done somewhere within this method
-	void Render();					//The overall Render method for the game. Here all of the meshes that need to be drawn will be drawn
+	void Render();					//The overall Render method for the game. Builds a snapshot and draws it straight away on this thread
+
+	// Copies what should be on screen into the snapshot, interpolation is how far past the last tick the clock already is.
+	// Draw it with GetRenderBackend, on this thread or another.
+	void BuildSnapshot(RenderSnapshot* snapshot, float interpolation);
+	RenderBackend* GetRenderBackend() { return m_renderBackend; }
 
 	void Shutdown(); //Cleanup everything we initialised
+
+	// Must be called before Initialise to have any effect
+	void SetBoardSize(int width, int height) { m_boardWidth = width; m_boardHeight = height; }
+	void SetExtraEnemyCount(int count) { m_extraEnemies = count; }
+	void SetThreadCount(int count) { m_threadCount = count; }
+
+	// The headless build uses these to report on the simulation
+	GameBoard* GetGameBoard() { return m_gameBoard; }
+	Player* GetPlayer() { return m_player; }
+	CollisionManager* GetCollisionManager() { return m_collisionManager; }
+	JobSystem* GetJobSystem() { return m_jobSystem; }
 };
 
 #endif
\ No newline at end of file
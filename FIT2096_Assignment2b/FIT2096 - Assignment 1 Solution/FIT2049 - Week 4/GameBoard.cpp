@@ -2,24 +2,67 @@
 #include "MathsHelper.h"
 #include <vector>
 
+// Scratch for the enemy queries, one per thread since enemies updating in jobs ask too
+static thread_local std::vector<int> t_enemyQueryResults;
+
+const char* const GameBoard::TILE_LAYER_FILENAMES[TILE_LAYER_COUNT] =
+{
+	"Assets/Textures/tile_white.png",
+	"Assets/Textures/tile_green.png",
+	"Assets/Textures/tile_red.png",
+	"Assets/Textures/tile_blue.png",
+	"Assets/Textures/tile_disabled.png",
+	"Assets/Textures/tile_orange.png",
+};
+
 GameBoard::GameBoard()
 {
 	m_meshManager = NULL;
 	m_textureManager = NULL;
 	m_texturedShader = NULL;
+	m_instancedShader = NULL;
+	m_floorMesh = NULL;
+	m_wallMesh = NULL;
+	m_tileTextureArray = NULL;
+	m_bulletPool = NULL;
+	m_jobSystem = NULL;
+
+	for (int i = 0; i < TILE_TYPE_COUNT; i++)
+	{
+		m_tileTextures[i] = NULL;
+		m_tileLayers[i] = TILE_LAYER_WHITE;
+	}
+}
+
+GameBoard::GameBoard(MeshManager* meshManager, TextureManager* textureManager, Shader* tileShader) :
+	GameBoard(meshManager, textureManager, tileShader, DEFAULT_BOARD_WIDTH, DEFAULT_BOARD_HEIGHT)
+{
 }
 
-GameBoard::GameBoard(MeshManager* meshManager, TextureManager* textureManager, Shader* tileShader)
+GameBoard::GameBoard(MeshManager* meshManager, TextureManager* textureManager, Shader* tileShader, int width, int height)
 {
 	m_meshManager = meshManager;
 	m_textureManager = textureManager;
 	m_texturedShader = tileShader;
+	m_instancedShader = NULL;
+	m_jobSystem = NULL;
+
+	// Seeded from rand on this thread, so whatever seed the game was started with still decides everything
+	m_random.seed((unsigned int)rand());
+
+	LoadResources();
 	
 	// Generate Bullets
 	GenerateBullets();
 
 	// Generate GameBoard
-	Generate();
+	Generate(width, height);
+	// Enemies path around walls and disabled tiles, so the flow field needs to know where they are
+	m_flowField.Build(&m_tiles);
+	m_pathfinder.Build(&m_tiles);
+	// Enemies look each other up by cell to keep from overlapping
+	m_enemyHash.SetCellSize(ENEMY_SEPARATION_RADIUS);
+	m_aiScheduler.SetNeighbours(&m_enemyHash);
 	// Generate enemies
 	GenerateEnemies();
 	// Put enemies
@@ -31,14 +74,8 @@ GameBoard::GameBoard(MeshManager* meshManager, TextureManager* textureManager, S
 
 GameBoard::~GameBoard()
 {
-	for (unsigned int z = 0; z < BOARD_HEIGHT; z++)
-	{
-		for (unsigned int x = 0; x < BOARD_WIDTH; x++)
-		{
-			delete m_tiles[z][x];
-			m_tiles[z][x] = NULL;
-		}
-	}
+	// Tiles are owned by the TileGrid, it cleans itself up
+
 	// Delete enemies
 	for (int i = 0; i < m_enemies.size(); i++)
 	{
@@ -51,55 +88,119 @@ GameBoard::~GameBoard()
 		delete m_healthPacks[i];
 		m_healthPacks[i] = NULL;
 	}
-	// Delete bullets
-	for (int i = 0; i < m_bullets.size(); i++)
+	// Delete bullets (the pool owns them)
+	if (m_bulletPool)
 	{
-		delete m_bullets[i];
-		m_bullets[i] = NULL;
+		delete m_bulletPool;
+		m_bulletPool = NULL;
 	}
 }
 
+void GameBoard::SetJobSystem(JobSystem* jobs)
+{
+	m_jobSystem = jobs;
+	m_aiScheduler.SetJobSystem(jobs);
+}
+
 void GameBoard::Update(float timestep)
 {
-	// Update all the tiles we manage.
-	// Our tiles will have an animation so they need to be Updated each frame.
+	// Only does any work when the player has moved into a different cell
+	m_flowField.SetTarget(currentPlayerPosition);
 
-	for (unsigned int z = 0; z < BOARD_HEIGHT; z++)
+	// Everyone gets the same picture of where the other enemies are for this tick
+	m_enemyHash.Clear();
+	for (int i = 0; i < m_enemies.size(); i++)
 	{
-		for (unsigned int x = 0; x < BOARD_WIDTH; x++)
+		if (m_enemies[i]->IsAlive())
 		{
-			m_tiles[z][x]->Update(timestep);
+			m_enemyHash.Add(i, m_enemies[i]->GetPosition());
 		}
 	}
-	// Update enemies
-	for (int i = 0; i < m_enemies.size(); i++)
-	{
-		// Enemies update current player position
-		m_enemies[i]->SetPlayerPosition(currentPlayerPosition);
+	m_enemyHash.Build();
 
-		m_enemies[i]->Update(timestep);
+	if (!m_jobSystem)
+	{
+		// Same order as the jobs below would finish in
+		m_tiles.Update(timestep);
+		UpdateEnemies(timestep);
+		UpdateHealthPacks(timestep);
+		m_bulletPool->Update(timestep);
+		return;
 	}
-	// Update HealthPacks
+
+	// The tiles and health packs don't care about anyone else so they can animate while everything
+	// else goes. Enemies fire bullets, so bullets wait for them. Wandering enemies draw from m_random,
+	// which nothing else touches until collisions, after we've waited for everyone.
+	JobCounter done;
+	Job* tiles = m_jobSystem->CreateJob([this, timestep] { m_tiles.Update(timestep, m_jobSystem); }, &done);
+	Job* enemies = m_jobSystem->CreateJob([this, timestep] { UpdateEnemies(timestep); }, &done);
+	Job* healthPacks = m_jobSystem->CreateJob([this, timestep] { UpdateHealthPacks(timestep); }, &done);
+	Job* bullets = m_jobSystem->CreateJob([this, timestep] { m_bulletPool->Update(timestep, m_jobSystem); }, &done);
+
+	m_jobSystem->AddDependency(bullets, enemies);
+
+	m_jobSystem->Submit(bullets);
+	m_jobSystem->Submit(healthPacks);
+	m_jobSystem->Submit(tiles);
+	m_jobSystem->Submit(enemies);
+
+	// Collisions are checked straight after we return, so everything has to be done
+	m_jobSystem->Wait(&done);
+}
+
+void GameBoard::UpdateEnemies(float timestep)
+{
+	// Nearby ones every tick and the rest when it's their turn
+	m_aiScheduler.Update(&m_enemies, currentPlayerPosition, timestep);
+}
+
+void GameBoard::UpdateHealthPacks(float timestep)
+{
 	for (int i = 0; i < m_healthPacks.size(); i++)
-	{		
+	{
 		m_healthPacks[i]->Update(timestep);
 	}
-	// Update Bullets
-	for (int i = 0; i < m_bullets.size(); i++)
+}
+
+void GameBoard::StorePreviousTransforms()
+{
+	m_tiles.StorePreviousHeights();
+
+	for (int i = 0; i < m_enemies.size(); i++)
+	{
+		m_enemies[i]->StorePreviousTransform();
+	}
+	for (int i = 0; i < m_healthPacks.size(); i++)
 	{
-		m_bullets[i]->Update(timestep);
+		m_healthPacks[i]->StorePreviousTransform();
 	}
+	m_bulletPool->StorePreviousPositions();
 }
 
-void GameBoard::Render(Direct3D* renderer, Camera* camera)
+void GameBoard::Render(RenderSnapshot* snapshot)
 {
 	// Render all the tiles we manage
-
-	for (unsigned int z = 0; z < BOARD_HEIGHT; z++)
+	if (m_instancedShader && m_tileTextureArray)
+	{
+		// One draw for the floor and one for the walls, the layer each tile samples gives it its colour
+		AddTileInstances(snapshot, false);
+		AddTileInstances(snapshot, true);
+	}
+	else
 	{
-		for (unsigned int x = 0; x < BOARD_WIDTH; x++)
+		// Cells are stored row by row so we can walk them with a single index
+		int index = 0;
+
+		for (int z = 0; z < m_tiles.GetHeight(); z++)
 		{
-			m_tiles[z][x]->Render(renderer, camera);
+			for (int x = 0; x < m_tiles.GetWidth(); x++, index++)
+			{
+				TileType type = m_tiles.GetTypeAt(index);
+				Mesh* mesh = (type == TileType::WALL) ? m_wallMesh : m_floorMesh;
+
+				snapshot->AddMesh(mesh, m_texturedShader, m_tileTextures[(int)type],
+					Vector3((float)x, m_tiles.GetPreviousHeightAt(index), (float)z), Vector3((float)x, m_tiles.GetHeightAt(index), (float)z));
+			}
 		}
 	}
 	// Render enemies
@@ -107,7 +208,7 @@ void GameBoard::Render(Direct3D* renderer, Camera* camera)
 	{
 		if (m_enemies[i]->IsAlive())
 		{
-			m_enemies[i]->Render(renderer, camera);
+			m_enemies[i]->Render(snapshot);
 		}
 	}
 	// Render HealthPacks
@@ -115,55 +216,115 @@ void GameBoard::Render(Direct3D* renderer, Camera* camera)
 	{
 		if (!m_healthPacks[i]->GetIsUsed())
 		{
-			m_healthPacks[i]->Render(renderer, camera);
+			m_healthPacks[i]->Render(snapshot);
+		}
+	}
+	// Render bullets, only the ones in flight
+	m_bulletPool->Render(snapshot);
+}
+
+void GameBoard::AddTileInstances(RenderSnapshot* snapshot, bool walls)
+{
+	snapshot->AddInstancedMesh(walls ? m_wallMesh : m_floorMesh, m_instancedShader, m_tileTextureArray);
+
+	int index = 0;
+
+	for (int z = 0; z < m_tiles.GetHeight(); z++)
+	{
+		for (int x = 0; x < m_tiles.GetWidth(); x++, index++)
+		{
+			TileType type = m_tiles.GetTypeAt(index);
+
+			if ((type == TileType::WALL) != walls)
+				continue;
+
+			snapshot->AddInstance(Vector3((float)x, m_tiles.GetPreviousHeightAt(index), (float)z),
+				Vector3((float)x, m_tiles.GetHeightAt(index), (float)z), m_tileLayers[(int)type]);
 		}
 	}
-	// Render bullets
-	for (int i = 0; i < m_bullets.size(); i++)
+}
+
+void GameBoard::LoadResources()
+{
+	m_floorMesh = m_meshManager->GetMesh(PATH_HASH("Assets/Meshes/floor_tile.obj"));
+	m_wallMesh = m_meshManager->GetMesh(PATH_HASH("Assets/Meshes/wall_tile.obj"));
+
+	// Asks the texture manager for the texture matching each type (i.e. red texture for "damage" type)
+	for (int i = 0; i < TILE_TYPE_COUNT; i++)
+	{
+		m_tileTextures[i] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_white.png"));
+	}
+
+	m_tileTextures[(int)TileType::HEALTH] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_green.png"));
+	m_tileTextures[(int)TileType::DAMAGE] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_red.png"));
+	m_tileTextures[(int)TileType::TELEPORT] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_blue.png"));
+	m_tileTextures[(int)TileType::DISABLED] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_disabled.png"));
+	m_tileTextures[(int)TileType::MONSTER_VAR1] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_orange.png"));
+	// We only need one monster tile in this game
+	//m_tileTextures[(int)TileType::MONSTER_VAR2] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_purple.png"));
+	m_tileTextures[(int)TileType::WALL] = m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_disabled.png"));
+
+	// The same colours again as layers of the texture array, for when the tiles are instanced
+	for (int i = 0; i < TILE_TYPE_COUNT; i++)
 	{
-		m_bullets[i]->Render(renderer, camera);	
+		m_tileLayers[i] = TILE_LAYER_WHITE;
 	}
+
+	m_tileLayers[(int)TileType::HEALTH] = TILE_LAYER_GREEN;
+	m_tileLayers[(int)TileType::DAMAGE] = TILE_LAYER_RED;
+	m_tileLayers[(int)TileType::TELEPORT] = TILE_LAYER_BLUE;
+	m_tileLayers[(int)TileType::DISABLED] = TILE_LAYER_DISABLED;
+	m_tileLayers[(int)TileType::MONSTER_VAR1] = TILE_LAYER_ORANGE;
+	m_tileLayers[(int)TileType::WALL] = TILE_LAYER_DISABLED;
+
+	m_tileTextureArray = m_textureManager->GetTexture(PATH_HASH(TILE_TEXTURE_ARRAY));
+
+	m_enemyMesh = m_meshManager->GetHandle(PATH_HASH("Assets/Meshes/enemy.obj"));
+	m_enemyTextures[0] = m_textureManager->GetHandle(PATH_HASH("Assets/Textures/gradient_red.png"));
+	m_enemyTextures[1] = m_textureManager->GetHandle(PATH_HASH("Assets/Textures/gradient_redDarker.png"));
+	m_enemyTextures[2] = m_textureManager->GetHandle(PATH_HASH("Assets/Textures/gradient_redLighter.png"));
+	m_enemyTextures[3] = m_textureManager->GetHandle(PATH_HASH("Assets/Textures/gradient_redOrange.png"));
+	m_enemyTextures[4] = m_textureManager->GetHandle(PATH_HASH("Assets/Textures/gradient_redPink.png"));
+
+	m_healthPackMesh = m_meshManager->GetHandle(PATH_HASH("Assets/Meshes/ammoBlock.obj"));
+	m_healthPackTexture = m_textureManager->GetHandle(PATH_HASH("Assets/Textures/tile_green.png"));
+}
+
+TileType GameBoard::SelectTileType()
+{
+	// Each floor tile gets its type (colour) using basic random numbers
+	// Higher probability for normal white tiles than the rest
+
+	int roll = MathsHelper::RandomRange(1, 100);
+
+	if (roll < 75)
+		return TileType::NORMAL;
+	// The board doesn't need to choose monster tile, just set random white tile into monster tile
+	else if (roll < 80)
+		return TileType::DAMAGE;
+	else if (roll < 85)
+		return TileType::HEALTH;
+	else if (roll < 88)
+		return TileType::TELEPORT;
+	else
+		return TileType::DISABLED;
 }
 
-void GameBoard::Generate()
+void GameBoard::Generate(int width, int height)
 {
 	// Just a plain old square world for now. In the week eight lecture, we'll
 	// implement an algorithm which creates cave like structures.
 
 	// In this function, I need to make sure only five enemy tiles can be generated
 
-	for (unsigned int z = 1; z < BOARD_HEIGHT - 1; z++)
+	m_tiles.Resize(width, height);
+
+	for (int z = 1; z < height - 1; z++)
 	{
-		for (unsigned int x = 1; x < BOARD_WIDTH - 1; x++)
+		for (int x = 1; x < width - 1; x++)
 		{
-			bool tileTypeValid = false;
-			while (!tileTypeValid)
-			{
-				tileTypeValid = true;
-
-				// We give a tile its mesh and shader, but it picks its own texture
-				m_tiles[z][x] = new Tile(m_meshManager->GetMesh("Assets/Meshes/floor_tile.obj"),
-					m_texturedShader,
-					Vector3(x, 0, z),
-					m_textureManager);
-
-				/*
-				// If is enemy tile and count < 5
-				if ((m_tiles[z][x]->GetType() == TileType::MONSTER_VAR1) && enemyTileCount < 5)
-				{
-					enemyTileCount += 1;
-				}
-				// If is enemy tile but count >= 5
-				else if ((m_tiles[z][x]->GetType() == TileType::MONSTER_VAR1) && enemyTileCount >= 5)
-				{	
-					// Recreate a tile
-					tileTypeValid = false;
-
-					delete m_tiles[z][x];
-					m_tiles[z][x] = NULL;
-				}
-				*/
-			}	
+			m_tiles.SetType(x, z, SelectTileType());
+			m_tiles.DropFromHeight(x, z, 40.0f, MathsHelper::RandomRange(0.0f, 2.0f));
 		}
 	}
 	AddWalls();
@@ -177,11 +338,14 @@ void GameBoard::Generate()
 		for (int i = 0; i < enemyTileLeft; i++)
 		{
 			// Pick a random white tile
-			Tile* tileChosen = GetRandomTileOfType(TileType::NORMAL);  // <---- This function can only be called after the walls are created, as this function also consider the walls
-			// Set the type to enemy tile
-			tileChosen->SetType(TileType::MONSTER_VAR1);
-			// +1 to enemyTileCount
-			enemyTileCount += 1;
+			int x, z;
+			if (GetRandomTileOfType(TileType::NORMAL, &x, &z))  // <---- This function can only be called after the walls are created, as this function also consider the walls
+			{
+				// Set the type to enemy tile
+				m_tiles.SetType(x, z, TileType::MONSTER_VAR1);
+				// +1 to enemyTileCount
+				enemyTileCount += 1;
+			}
 		}
 	}
 	// Till here we must already have five enemy tiles on gameBoard
@@ -190,134 +354,164 @@ void GameBoard::Generate()
 void GameBoard::AddWalls()
 {
 	// Adds a strip of walls around the outer edge of the world
+	int width = m_tiles.GetWidth();
+	int height = m_tiles.GetHeight();
 
 	// Outer walls horizontal
-	for (unsigned int x = 0; x < BOARD_WIDTH; x++)
+	for (int x = 0; x < width; x++)
 	{
 		// Top 
-		m_tiles[BOARD_HEIGHT-1][x] = new Tile(m_meshManager->GetMesh("Assets/Meshes/wall_tile.obj"),
-			m_texturedShader,
-			Vector3(x, 0, BOARD_HEIGHT-1),
-			m_textureManager,
-			TileType::WALL);
+		m_tiles.SetType(x, height - 1, TileType::WALL);
+		m_tiles.DropFromHeight(x, height - 1, 40.0f, MathsHelper::RandomRange(0.0f, 2.0f));
 
 		// Bottom
-		m_tiles[0][x] = new Tile(m_meshManager->GetMesh("Assets/Meshes/wall_tile.obj"),
-			m_texturedShader,
-			Vector3(x, 0, 0),
-			m_textureManager,
-			TileType::WALL);
+		m_tiles.SetType(x, 0, TileType::WALL);
+		m_tiles.DropFromHeight(x, 0, 40.0f, MathsHelper::RandomRange(0.0f, 2.0f));
 	}
 
 	// Outer walls vertical (avoding corners so we don't double up)
-	for (unsigned int z = 1; z < BOARD_HEIGHT - 1; z++)
+	for (int z = 1; z < height - 1; z++)
 	{
 		// Left
-		m_tiles[z][0] = new Tile(m_meshManager->GetMesh("Assets/Meshes/wall_tile.obj"),
-			m_texturedShader,
-			Vector3(0, 0, z),
-			m_textureManager,
-			TileType::WALL);
+		m_tiles.SetType(0, z, TileType::WALL);
+		m_tiles.DropFromHeight(0, z, 40.0f, MathsHelper::RandomRange(0.0f, 2.0f));
 
 		// Right
-		m_tiles[z][BOARD_WIDTH-1] = new Tile(m_meshManager->GetMesh("Assets/Meshes/wall_tile.obj"),
-			m_texturedShader,
-			Vector3(BOARD_WIDTH - 1, 0, z),
-			m_textureManager,
-			TileType::WALL);
+		m_tiles.SetType(width - 1, z, TileType::WALL);
+		m_tiles.DropFromHeight(width - 1, z, 40.0f, MathsHelper::RandomRange(0.0f, 2.0f));
 	}
 }
 
 TileType GameBoard::GetTileTypeForPosition(int x, int z)
 {
-	// Index directly into our 2D array using the passed in position.
+	// Index directly into our grid using the passed in position.
 
 	// It's possible we may accidentally check a tile outside of the board. 
-	// Even though walls will prevent this, we'll still be defensive.
+	// Even though walls will prevent this, we'll still be defensive (the grid returns INVALID).
 
-	if ((x < 0 || x >= BOARD_WIDTH) ||
-		(z < 0 || z >= BOARD_HEIGHT))
-	{
-		return TileType::INVALID;
-	}
+	return m_tiles.GetType(x, z);
+}
 
-	return m_tiles[z][x]->GetType();
+void GameBoard::SetTileType(int x, int z, TileType type)
+{
+	if (!m_tiles.IsInside(x, z))
+		return;
+
+	m_tiles.SetType(x, z, type);
+
+	// Only the part of the field that went through this tile gets redone, and only its sector's entrances
+	m_flowField.OnTileChanged(x, z);
+	m_pathfinder.OnTileChanged(x, z);
 }
 
-Tile* GameBoard::GetRandomTileOfType(TileType type)
+bool GameBoard::GetRandomTileOfType(TileType type, int* x, int* z)
 {
-	std::vector<Tile*> shortlist;
+	std::vector<int> shortlist;
 
 	// Find all tiles matching the type we want
-	for (unsigned int z = 0; z < BOARD_HEIGHT; z++)
+	int cellCount = m_tiles.GetCellCount();
+	for (int i = 0; i < cellCount; i++)
 	{
-		for (unsigned int x = 0; x < BOARD_WIDTH; x++)
+		if (m_tiles.GetTypeAt(i) == type)
 		{
-			if (m_tiles[z][x]->GetType() == type)
-			{
-				shortlist.push_back(m_tiles[z][x]);
-			}
+			shortlist.push_back(i);
 		}
 	}
 
 	// There are no more tiles left matching this type
 	if (shortlist.size() == 0)
-		return NULL;
+		return false;
 
 	// Return a random tile from the shortlist
-	return shortlist[MathsHelper::RandomRange(0, shortlist.size() - 1)];
+	int index = shortlist[MathsHelper::RandomRange(0, shortlist.size() - 1)];
+	*x = index % m_tiles.GetWidth();
+	*z = index / m_tiles.GetWidth();
+
+	return true;
 }
 
 // Find an enemy tile which has no enemy yet
-Tile* GameBoard::GetEmptyEnemyTile(TileType type)
+bool GameBoard::GetEmptyEnemyTile(TileType type, int* x, int* z)
 {
-	std::vector<Tile*> shortlist;
+	std::vector<int> shortlist;
 
 	// Find all tiles matching the type we want
-	for (unsigned int z = 0; z < BOARD_HEIGHT; z++)
+	for (int tileZ = 0; tileZ < m_tiles.GetHeight(); tileZ++)
 	{
-		for (unsigned int x = 0; x < BOARD_WIDTH; x++)
+		for (int tileX = 0; tileX < m_tiles.GetWidth(); tileX++)
 		{
-			if (m_tiles[z][x]->GetType() == type &&
-				m_tiles[z][x]->GetHasEnemy() == false)
+			if (m_tiles.GetType(tileX, tileZ) == type &&
+				m_tiles.GetHasEnemy(tileX, tileZ) == false)
 			{
-				shortlist.push_back(m_tiles[z][x]);
+				shortlist.push_back(m_tiles.GetIndex(tileX, tileZ));
 			}
 		}
 	}
 
 	// There are no more tiles left matching this type
 	if (shortlist.size() == 0)
-		return NULL;
+		return false;
 
 	// Return a random tile from the shortlist
-	return shortlist[MathsHelper::RandomRange(0, shortlist.size() - 1)];
+	int index = shortlist[MathsHelper::RandomRange(0, shortlist.size() - 1)];
+	*x = index % m_tiles.GetWidth();
+	*z = index / m_tiles.GetWidth();
+
+	return true;
 }
 
 
-void GameBoard::GenerateEnemies()
+Enemy* GameBoard::CreateEnemy(int behaviour)
 {
-	m_enemies.push_back(new Enemy(20, 2, 1, m_meshManager->GetMesh("Assets/Meshes/enemy.obj"),
-		m_texturedShader, m_textureManager->GetTexture("Assets/Textures/gradient_red.png")));
+	const static int healths[5] = { 20, 40, 60, 80, 90 };
+	const static int skills[5] = { 2, 4, 6, 8, 10 };
 
-	m_enemies.push_back(new Enemy(40, 4, 2, m_meshManager->GetMesh("Assets/Meshes/enemy.obj"),
-		m_texturedShader, m_textureManager->GetTexture("Assets/Textures/gradient_redDarker.png")));
+	Enemy* enemy = new Enemy(healths[behaviour - 1], skills[behaviour - 1], behaviour, m_meshManager->GetMesh(m_enemyMesh),
+		m_texturedShader, m_textureManager->GetTexture(m_enemyTextures[behaviour - 1]));
 
-	m_enemies.push_back(new Enemy(60, 6, 3, m_meshManager->GetMesh("Assets/Meshes/enemy.obj"),
-		m_texturedShader, m_textureManager->GetTexture("Assets/Textures/gradient_redLighter.png")));
+	enemy->SetBoardWidth(m_tiles.GetWidth());
+	enemy->SetBoardHeight(m_tiles.GetHeight());
 
-	m_enemies.push_back(new Enemy(80, 8, 4, m_meshManager->GetMesh("Assets/Meshes/enemy.obj"),
-		m_texturedShader, m_textureManager->GetTexture("Assets/Textures/gradient_redOrange.png")));
+	enemy->SetBulletPool(m_bulletPool);  // Enemies shoot from the same pool as the player
+	enemy->SetFlowField(&m_flowField);  // and all find their way with the same flow field
+	enemy->SetPathfinder(&m_pathfinder);  // and pathfinder
+	enemy->SetRandom(&m_random);  // and random numbers
 
-	m_enemies.push_back(new Enemy(90, 10, 5, m_meshManager->GetMesh("Assets/Meshes/enemy.obj"),
-		m_texturedShader, m_textureManager->GetTexture("Assets/Textures/gradient_redPink.png")));
+	return enemy;
+}
 
-	for (int i = 0; i < m_enemies.size(); i++)
+void GameBoard::GenerateEnemies()
+{
+	for (int behaviour = 1; behaviour <= 5; behaviour++)
 	{
-		m_enemies[i]->SetBoardWidth(BOARD_WIDTH);
-		m_enemies[i]->SetBoardHeight(BOARD_HEIGHT);
+		m_enemies.push_back(CreateEnemy(behaviour));
+	}
+}
 
-		m_enemies[i]->SetBulletVector(m_bullets);  // Pass the bullet vector to enemies
+void GameBoard::SpawnEnemies(int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		// Anywhere an enemy could walk, there aren't enough red tiles to go around
+		int x = 0;
+		int z = 0;
+		int attempts = 0;
+
+		while (!m_tiles.IsWalkable(x, z))
+		{
+			// A tiny board might not have anywhere left to stand
+			if (++attempts > 1000)
+				return;
+
+			x = MathsHelper::RandomRange(1, m_tiles.GetWidth() - 2);
+			z = MathsHelper::RandomRange(1, m_tiles.GetHeight() - 2);
+		}
+
+		Enemy* enemy = CreateEnemy(i % 5 + 1);
+		enemy->SetPosition(m_tiles.GetPosition(x, z));
+		enemy->SetYPosition(0.0f);  // To ensure enemy spawn on the ground
+
+		m_enemies.push_back(enemy);
 	}
 }
 
@@ -325,19 +519,41 @@ void GameBoard::PutEnemies()
 {
 	for (int i = 0; i < m_enemies.size(); i++)
 	{
-		Tile* destinationTile = GetEmptyEnemyTile(TileType::MONSTER_VAR1);
+		int x, z;
 
-		if (destinationTile)
+		if (GetEmptyEnemyTile(TileType::MONSTER_VAR1, &x, &z))
 		{
-			destinationTile->SetHasEnemy(true);
+			m_tiles.SetHasEnemy(x, z, true);
 
-			m_enemies[i]->SetPosition(destinationTile->GetPosition());
+			m_enemies[i]->SetPosition(m_tiles.GetPosition(x, z));
 
 			m_enemies[i]->SetYPosition(0.0f);  // To ensure enemy spawn on the ground
 		}
 	}
 }
 
+void GameBoard::GetEnemiesWithinRadius(Vector3 position, float radius, std::vector<Enemy*>* results)
+{
+	t_enemyQueryResults.clear();
+	m_enemyHash.QueryRadius(position, radius, &t_enemyQueryResults);
+
+	for (unsigned int i = 0; i < t_enemyQueryResults.size(); i++)
+	{
+		results->push_back(m_enemies[t_enemyQueryResults[i]]);
+	}
+}
+
+void GameBoard::GetNearestEnemies(Vector3 position, int count, float maxRadius, std::vector<Enemy*>* results)
+{
+	t_enemyQueryResults.clear();
+	m_enemyHash.QueryNearest(position, count, maxRadius, &t_enemyQueryResults);
+
+	for (unsigned int i = 0; i < t_enemyQueryResults.size(); i++)
+	{
+		results->push_back(m_enemies[t_enemyQueryResults[i]]);
+	}
+}
+
 Enemy* GameBoard::GetEnemy(Vector3 position)
 {
 	for (int i = 0; i < m_enemies.size(); i++)
@@ -367,17 +583,17 @@ int GameBoard::GetDeadEnemyAmount()
 
 void GameBoard::GenerateHealthPacks()
 {
-	for (unsigned int z = 0; z < BOARD_HEIGHT; z++)
+	for (int z = 0; z < m_tiles.GetHeight(); z++)
 	{
-		for (unsigned int x = 0; x < BOARD_WIDTH; x++)
+		for (int x = 0; x < m_tiles.GetWidth(); x++)
 		{
 			// If it is a health tile, put a health pack there
-			if (m_tiles[z][x]->GetType() == TileType::HEALTH)
+			if (m_tiles.GetType(x, z) == TileType::HEALTH)
 			{
-				HealthPack* h1 = new HealthPack(m_meshManager->GetMesh("Assets/Meshes/ammoBlock.obj"), 
-					m_texturedShader, m_textureManager->GetTexture("Assets/Textures/tile_green.png"));
+				HealthPack* h1 = new HealthPack(m_meshManager->GetMesh(m_healthPackMesh), 
+					m_texturedShader, m_textureManager->GetTexture(m_healthPackTexture));
 
-				h1->SetPosition(m_tiles[z][x]->GetPosition());
+				h1->SetPosition(m_tiles.GetPosition(x, z));
 				h1->SetYPosition(0.0f);
 
 				h1->SetSpawnPoint(h1->GetPosition());  // Let healthpack knows their spawn point at here
@@ -404,11 +620,9 @@ HealthPack* GameBoard::GetHealthPack(Vector3 position)
 
 void GameBoard::GenerateBullets()
 {
-	for (int i = 0; i < 80; i++)
-	{
-		// Make their location far below the map
-		m_bullets.push_back(new Bullet(m_meshManager->GetMesh("Assets/Meshes/bullet.obj"),
-			m_texturedShader, m_textureManager->GetTexture("Assets/Textures/tile_white.png"), Vector3(0.0f, -10.0f, 0.0f)));
-	}
+	m_bulletPool = new BulletPool(m_meshManager->GetMesh(PATH_HASH("Assets/Meshes/bullet.obj")),
+		m_texturedShader, m_textureManager->GetTexture(PATH_HASH("Assets/Textures/tile_white.png")), INITIAL_BULLET_COUNT);
+
+	m_bulletPool->SetOverflowPolicy(BulletPoolOverflow::GROW, MAX_BULLET_COUNT);
 }
 
@@ -7,69 +7,155 @@
 #ifndef GAMEBOARD_H
 #define GAMEBOARD_H
 
+#include "AIScheduler.h"
 #include "Enemy.h"
 #include "HealthPack.h"
-#include "Tile.h"
+#include "BulletPool.h"
+#include "TileGrid.h"
+#include "FlowField.h"
+#include "HierarchicalPathfinder.h"
+#include "InstancedShader.h"
+#include "JobSystem.h"
+#include "SpatialHash.h"
 #include "MeshManager.h"
 #include "TextureManager.h"
+#include <random>
 #include <vector>
 
+// The tile textures stacked into one texture array, so the whole board can be drawn without changing texture.
+// It's only made when the tile textures have been cooked (see CookedTexture.h), otherwise tiles are drawn one by one.
+#define TILE_TEXTURE_ARRAY "Assets/Textures/tile_array"	// What it's called in the TextureManager, there's no file
+
+enum TileLayer
+{
+	TILE_LAYER_WHITE,
+	TILE_LAYER_GREEN,
+	TILE_LAYER_RED,
+	TILE_LAYER_BLUE,
+	TILE_LAYER_DISABLED,
+	TILE_LAYER_ORANGE,
+	TILE_LAYER_COUNT
+};
+
 class GameBoard
 {
 private:
 	MeshManager* m_meshManager;
 	TextureManager* m_textureManager;
 	Shader* m_texturedShader;
+	InstancedShader* m_instancedShader;  // NULL to draw tiles one at a time
 
-	// How many tiles does this board manage
-	const static int BOARD_WIDTH = 30;
-	const static int BOARD_HEIGHT = 30;
 
 	// Game objects handled by GameBoard
 	std::vector<Enemy*> m_enemies;  // A vector of enemies
-	std::vector<Bullet*> m_bullets;  // A vector of bullets
+	AIScheduler m_aiScheduler;  // Decides which enemies update each tick
+	SpatialHash m_enemyHash;  // Where every living enemy is, filled in at the start of each tick
+	BulletPool* m_bulletPool;  // Every bullet, shared by everyone who shoots
 	std::vector<HealthPack*> m_healthPacks;  // A vector of health packs
 	
-	// Storing tiles in a 2D array to make neighbour checking easier
-	Tile* m_tiles[BOARD_HEIGHT][BOARD_WIDTH];
+	// Every cell of the board lives in here, neighbour checking is still just x/z indexing
+	TileGrid m_tiles;
+
+	// How far every cell is from the player, enemies use this to find their way around
+	FlowField m_flowField;
+
+	// Routes to anywhere else on the board, for enemies wandering to random points
+	HierarchicalPathfinder m_pathfinder;
+
+	// Runs the parts of Update that can go at the same time on other threads, NULL for all on this one
+	JobSystem* m_jobSystem;
+
+	// Random numbers for anything that happens during Update. rand has a sequence per thread on Windows and
+	// the jobs land on different threads every tick, so they'd never play out the same twice.
+	std::mt19937 m_random;
+
+	// The pieces of Update, as jobs
+	void UpdateEnemies(float timestep);
+	void UpdateHealthPacks(float timestep);
+
+	// Tiles share their meshes and textures so we look them up once instead of per tile
+	Mesh* m_floorMesh;
+	Mesh* m_wallMesh;
+	Texture* m_tileTextures[TILE_TYPE_COUNT];
+	Texture* m_tileTextureArray;  // NULL when it wasn't made
+	int m_tileLayers[TILE_TYPE_COUNT];  // The layer of the array each type uses, the same colour as its texture above
+
+	void AddTileInstances(RenderSnapshot* snapshot, bool walls);  // Every wall or every floor tile, as instances of one mesh
+
+	// Enemies and health packs can be made any time, so we keep handles to what they use rather than finding it by name each time
+	MeshHandle m_enemyMesh;
+	TextureHandle m_enemyTextures[5];  // One per behaviour
+	MeshHandle m_healthPackMesh;
+	TextureHandle m_healthPackTexture;
+
+	TileType SelectTileType();  // Picks a random type for a new floor tile
+	void LoadResources();
 
 	Vector3 currentPlayerPosition;  // Need this to rotate the enemies
 
-	void Generate();  // Generate the ground
+	void Generate(int width, int height);  // Generate the ground
 	void AddWalls();  // Called in the function above, to generate the walls
 
 	void GenerateEnemies();  // Generate five enemies
+	Enemy* CreateEnemy(int behaviour);  // Health, skill and colour all go with the behaviour (1 to 5)
 	void PutEnemies();       // Put enemies on enemy tiles
 	int enemyTileCount = 0;  // Keep track of how many enemy tile has been spawned
 
 	void GenerateHealthPacks();  // Generate health packs on all health tiles
-	void GenerateBullets();  // Generate bullets to be used
+	void GenerateBullets();  // Create the bullet pool
 	
 public:
+	// The size we've always played on
+	const static int DEFAULT_BOARD_WIDTH = 30;
+	const static int DEFAULT_BOARD_HEIGHT = 30;
+
+	// The pool starts this big and doubles whenever it runs out, up to the maximum
+	const static int INITIAL_BULLET_COUNT = 80;
+	const static int MAX_BULLET_COUNT = 16384;
+
+	// The textures that go into TILE_TEXTURE_ARRAY, in TileLayer order
+	static const char* const TILE_LAYER_FILENAMES[TILE_LAYER_COUNT];
+
 	GameBoard();
 	GameBoard(MeshManager* meshManager, TextureManager* textureManager, Shader* tileShader);
+	GameBoard(MeshManager* meshManager, TextureManager* textureManager, Shader* tileShader, int width, int height);
 	~GameBoard();
 
-	void Update(float timestep);
-	void Render(Direct3D* renderer, Camera* camera);
+	void Update(float timestep);  // Everything has finished updating by the time this returns
+	void Render(RenderSnapshot* snapshot);
+	void StorePreviousTransforms();  // Called at the start of each simulation tick so rendering can blend between ticks
 
 	TileType GetTileTypeForPosition(int x, int z);
-	Tile* GetRandomTileOfType(TileType type);
-	Tile* GetEmptyEnemyTile(TileType type);  // Used to find an empty red tile to spawn an enemy
+	void SetTileType(int x, int z, TileType type);  // Changing a tile once the game is running has to go through here so enemies know
+	bool GetRandomTileOfType(TileType type, int* x, int* z);  // Returns false if there are no tiles of this type
+	bool GetEmptyEnemyTile(TileType type, int* x, int* z);  // Used to find an empty red tile to spawn an enemy
+	void SpawnEnemies(int count);  // Extra enemies anywhere on the board, cycling through the behaviours
 
 	Enemy* GetEnemy(Vector3 position);  // Used to get an enemy for player according to position
+
+	// Living enemies near a point, as of the start of this tick. Results are appended to the vector.
+	void GetEnemiesWithinRadius(Vector3 position, float radius, std::vector<Enemy*>* results);
+	void GetNearestEnemies(Vector3 position, int count, float maxRadius, std::vector<Enemy*>* results);  // Closest first
 	HealthPack* GetHealthPack(Vector3 position);  // Used to get the healthpack at player's target position
 
 	// Mutators
 	void SetCurrentPlayerPosition(Vector3 pos) { currentPlayerPosition = pos; }
+	void SetJobSystem(JobSystem* jobs);
+	void SetInstancedShader(InstancedShader* shader) { m_instancedShader = shader; }  // Tiles are instanced once this and the texture array are both there
 
 	// Accessors
 	Vector3 GetCurrentPlayerPosition() { return currentPlayerPosition; }
 	int GetEnemyTileCount() { return enemyTileCount; }
 	int GetDeadEnemyAmount();  // Used to check if all enemies are dead
+	int GetTileCount() { return m_tiles.GetCellCount(); }
+	int GetWidth() { return m_tiles.GetWidth(); }
+	int GetHeight() { return m_tiles.GetHeight(); }
+	FlowField* GetFlowField() { return &m_flowField; }
+	AIScheduler* GetAIScheduler() { return &m_aiScheduler; }
+	HierarchicalPathfinder* GetPathfinder() { return &m_pathfinder; }
 
 	std::vector<Enemy*> getEnemyVector() { return m_enemies; }
-	std::vector<Bullet*> getBulletVector() { return m_bullets; }
+	BulletPool* GetBulletPool() { return m_bulletPool; }
 	std::vector<HealthPack*> getHealthPackVector() { return m_healthPacks; }
 };
 
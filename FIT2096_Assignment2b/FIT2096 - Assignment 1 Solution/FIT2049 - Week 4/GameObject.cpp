@@ -1,65 +1,88 @@
 #include "GameObject.h"
+#include "MathsHelper.h"
+
+// 0 is never handed out so it can be used to mean "no object"
+unsigned int GameObject::s_nextId = 1;
 
 GameObject::GameObject()
 {
 	m_position = Vector3::Zero;
 	m_rotX = m_rotY = m_rotZ = 0;
 	SetUniformScale(1.0f);
+	StorePreviousTransform();
 	m_world = Matrix::Identity;
 	m_mesh = NULL;
 	m_texture = NULL;
 	m_shader = NULL;
+	m_id = s_nextId++;
 }
 GameObject::GameObject(Mesh* mesh, Shader* shader)
 {
 	m_position = Vector3::Zero;
 	m_rotX = m_rotY = m_rotZ = 0;
 	SetUniformScale(1.0f);
+	StorePreviousTransform();
 	m_world = Matrix::Identity;
 	m_mesh = mesh;
 	m_texture = NULL;
 	m_shader = shader;
+	m_id = s_nextId++;
 }
 GameObject::GameObject(Mesh* mesh, Shader* shader, Texture* texture)
 {
 	m_position = Vector3::Zero;
 	m_rotX = m_rotY = m_rotZ = 0;
 	SetUniformScale(1.0f);
+	StorePreviousTransform();
 	m_world = Matrix::Identity;
 	m_mesh = mesh;
 	m_texture = texture;
 	m_shader = shader;
+	m_id = s_nextId++;
 }
 GameObject::GameObject(Mesh* mesh, Shader* shader, Vector3 position)
 {
 	m_position = position;
 	m_rotX = m_rotY = m_rotZ = 0;
 	SetUniformScale(1.0f);
+	StorePreviousTransform();
 	m_world = Matrix::Identity;
 	m_mesh = mesh;
 	m_texture = NULL;
 	m_shader = shader;
+	m_id = s_nextId++;
 }
 GameObject::GameObject(Mesh* mesh, Shader* shader, Texture* texture, Vector3 position)
 {
 	m_position = position;
 	m_rotX = m_rotY = m_rotZ = 0;
 	SetUniformScale(1.0f);
+	StorePreviousTransform();
 	m_world = Matrix::Identity;
 	m_mesh = mesh;
 	m_texture = texture;
 	m_shader = shader;
+	m_id = s_nextId++;
 }
 
 GameObject::~GameObject() {}
 
-void GameObject::Render(Direct3D* renderer, Camera* cam)
+void GameObject::Render(RenderSnapshot* snapshot)
 {
 	if (m_mesh)
 	{
-		// If creating these matrices every frame worries you, a "dirty" system like the camera uses could apply here too
-		m_world = Matrix::CreateScale(m_scaleX, m_scaleY, m_scaleZ) * Matrix::CreateFromYawPitchRoll(m_rotY, m_rotX, m_rotZ) * Matrix::CreateTranslation(m_position);
-		m_mesh->Render(renderer, m_shader, m_world, cam, m_texture);
+		// The simulation runs at a fixed rate so we're usually drawn somewhere between two ticks,
+		// the snapshot keeps both ends and the world matrix is made when it's drawn
+		snapshot->AddMesh(m_mesh, m_shader, m_texture, m_previousPosition, m_position,
+			Vector3(m_previousRotX, m_previousRotY, m_previousRotZ), Vector3(m_rotX, m_rotY, m_rotZ), Vector3(m_scaleX, m_scaleY, m_scaleZ));
 	}
 
+}
+
+void GameObject::StorePreviousTransform()
+{
+	m_previousPosition = m_position;
+	m_previousRotX = m_rotX;
+	m_previousRotY = m_rotY;
+	m_previousRotZ = m_rotZ;
 }
\ No newline at end of file
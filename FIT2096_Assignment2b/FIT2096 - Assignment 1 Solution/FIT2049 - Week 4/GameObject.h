@@ -3,6 +3,7 @@
 
 #include "Direct3D.h"
 #include "Mesh.h"
+#include "RenderSnapshot.h"
 
 #include "Collisions.h"
 
@@ -13,11 +14,20 @@ protected:
 	float m_rotX, m_rotY, m_rotZ;
 	float m_scaleX, m_scaleY, m_scaleZ;
 
+	// Where we were at the end of the last simulation tick, rendering blends from here to the current values
+	Vector3 m_previousPosition;
+	float m_previousRotX, m_previousRotY, m_previousRotZ;
+
 	Matrix m_world;
 	Mesh* m_mesh;
 	Texture* m_texture;
 	Shader* m_shader;
 
+private:
+	// Unique for the lifetime of the program, used to identify pairs of colliding objects
+	unsigned int m_id;
+	static unsigned int s_nextId;
+
 public:
 	GameObject();
 	GameObject(Mesh* mesh, Shader* shader);
@@ -28,10 +38,14 @@ public:
 
 	// GameObject is now an abstract class as Update is pure virtual
 	virtual void Update(float timestep) = 0;
-	virtual void Render(Direct3D* renderer, Camera* cam);
+	virtual void Render(RenderSnapshot* snapshot);	// Adds us to the frame being built, it's drawn later
+
+	// Called at the start of every simulation tick before anything moves
+	void StorePreviousTransform();
 
 	// Accessors
 	Vector3 GetPosition() { return m_position; }
+	Vector3 GetPreviousPosition() { return m_previousPosition; }
 	float GetXRotation() { return m_rotX; }
 	float GetYRotation() { return m_rotY; }
 	float GetZRotation() { return m_rotZ; }
@@ -41,13 +55,15 @@ public:
 	Mesh* GetMesh() { return m_mesh; }
 	Texture* GetTexture() { return m_texture; }
 	Shader* GetShader() { return m_shader; }
+	unsigned int GetID() { return m_id; }
 
 	float GetXPosition() { return m_position.x; }
 	float GetYPosition() { return m_position.y; }
 	float GetZPosition() { return m_position.z; }
 
 	// Mutators
-	void SetPosition(Vector3 pos) { m_position = pos; }
+	// Placing an object somewhere is a teleport, we don't want it to be drawn sliding there
+	void SetPosition(Vector3 pos) { m_position = m_previousPosition = pos; }
 	void SetXRotation(float xRot) { m_rotX = xRot; }
 	void SetYRotation(float yRot) { m_rotY = yRot; }
 	void SetZRotation(float zRot) { m_rotZ = zRot; }
@@ -0,0 +1,295 @@
+/*	FIT2096 - Assignment 2b
+*	AssetPacker.cpp
+*	Packs everything under Assets into the asset pack described in AssetPack.h.
+*	Meshes go in as their cooked .mesh when meshcook has made one that's up to date and as the OBJ
+*	otherwise, never both. Textures are the same with texturecook's .dds and the PNG. Sounds are always stored as they are, streams play straight out of the
+*	pack and can't be pointed at a decompressed copy. Everything else is compressed if it's worth it.
+*	The finished pack is opened the way the game opens it and every file read back and compared,
+*	and the time to read the lot out of the pack and out of loose files is printed.
+*
+*	Usage: assetpack [--store] [--dir folder] [--output file.pak]
+*/
+
+#include "AssetPack.h"
+#include "CookedMesh.h"
+#include "CookedTexture.h"
+#include "JobSystem.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+struct PackOptions
+{
+	bool store;
+	const char* folder;
+	const char* output;
+};
+
+static bool ParseOptions(int argc, char** argv, PackOptions* options)
+{
+	options->store = false;
+	options->folder = "Assets";
+	options->output = ASSET_PACK_FILENAME;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--store") == 0)
+			options->store = true;
+		else if (strcmp(argv[i], "--dir") == 0 && hasValue)
+			options->folder = argv[++i];
+		else if (strcmp(argv[i], "--output") == 0 && hasValue)
+			options->output = argv[++i];
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool EndsWith(const string& text, const char* suffix)
+{
+	size_t length = strlen(suffix);
+	return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// Every file under the folder and the folders in it, sorted so the output is always in the same order.
+// Hidden files and the desktop.ini Windows leaves everywhere are skipped.
+static bool FindFiles(const string& folder, vector<string>* files)
+{
+	DIR* directory = opendir(folder.c_str());
+	if (!directory)
+		return false;
+
+	struct dirent* entry;
+	while ((entry = readdir(directory)) != NULL)
+	{
+		string name = entry->d_name;
+		if (name[0] == '.' || name == "desktop.ini")
+			continue;
+
+		string path = folder + "/" + name;
+
+		struct stat status;
+		if (stat(path.c_str(), &status) != 0)
+			continue;
+
+		if (S_ISDIR(status.st_mode))
+			FindFiles(path, files);
+		else if (S_ISREG(status.st_mode))
+			files->push_back(path);
+	}
+
+	closedir(directory);
+	sort(files->begin(), files->end());
+	return true;
+}
+
+// The cooked mesh or texture replaces the OBJ or PNG when it's up to date, and is left out when it isn't
+static bool ShouldPack(const string& path)
+{
+	if (EndsWith(path, ".obj"))
+		return !CookedMesh::IsUpToDate(path.c_str(), CookedMesh::GetCookedFilename(path.c_str()).c_str());
+
+	if (EndsWith(path, COOKED_MESH_EXTENSION))
+	{
+		string source = path.substr(0, path.size() - strlen(COOKED_MESH_EXTENSION)) + ".obj";
+		return CookedMesh::IsUpToDate(source.c_str(), path.c_str());
+	}
+
+	if (EndsWith(path, ".png"))
+		return !CookedTexture::IsUpToDate(path.c_str(), CookedTexture::GetCookedFilename(path.c_str()).c_str());
+
+	if (EndsWith(path, COOKED_TEXTURE_EXTENSION))
+	{
+		string source = path.substr(0, path.size() - strlen(COOKED_TEXTURE_EXTENSION)) + ".png";
+		return CookedTexture::IsUpToDate(source.c_str(), path.c_str());
+	}
+
+	return true;
+}
+
+static bool IsSound(const string& path)
+{
+	return EndsWith(path, ".mp3") || EndsWith(path, ".ogg") || EndsWith(path, ".wav");
+}
+
+// Adds every byte up so reading can't be skipped, and so the pages really are touched
+static unsigned int Touch(const char* data, size_t size)
+{
+	unsigned int sum = 0;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		sum += (unsigned char)data[i];
+	}
+
+	return sum;
+}
+
+int main(int argc, char** argv)
+{
+	PackOptions options;
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--store] [--dir folder] [--output file.pak]\n", argv[0]);
+		return 1;
+	}
+
+	vector<string> found;
+	if (!FindFiles(options.folder, &found))
+	{
+		fprintf(stderr, "Could not read %s\n", options.folder);
+		return 1;
+	}
+
+	vector<string> paths;
+	for (unsigned int i = 0; i < found.size(); i++)
+	{
+		if (ShouldPack(found[i]))
+			paths.push_back(found[i]);
+	}
+
+	// Every file stays mapped until the pack is written, nothing is copied to get it in
+	vector<AssetData*> files(paths.size());
+	vector<AssetPackSource> sources(paths.size());
+
+	for (unsigned int i = 0; i < paths.size(); i++)
+	{
+		files[i] = new AssetData();
+		if (!files[i]->OpenFile(paths[i].c_str()))
+		{
+			fprintf(stderr, "  %-40s could not be read\n", paths[i].c_str());
+			return 1;
+		}
+
+		sources[i].path = paths[i];
+		sources[i].data = files[i]->GetData();
+		sources[i].size = files[i]->GetSize();
+		sources[i].compress = !options.store && !IsSound(paths[i]);
+	}
+
+	// Save would refuse these anyway, but it can't say which files they were
+	for (unsigned int i = 0; i < paths.size(); i++)
+	{
+		for (unsigned int j = i + 1; j < paths.size(); j++)
+		{
+			if (HashPath(paths[i].c_str()) == HashPath(paths[j].c_str()))
+			{
+				fprintf(stderr, "  %s and %s have the same hash, rename one of them\n", paths[i].c_str(), paths[j].c_str());
+				return 1;
+			}
+		}
+	}
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	if (!AssetPack::Save(options.output, sources))
+	{
+		fprintf(stderr, "Could not write %s\n", options.output);
+		return 1;
+	}
+
+	double packSeconds = SecondsSince(start);
+
+	JobSystem jobs((int)std::thread::hardware_concurrency());
+
+	AssetPack pack;
+	pack.SetJobSystem(&jobs);
+
+	if (!pack.Open(options.output))
+	{
+		fprintf(stderr, "Could not open %s after writing it\n", options.output);
+		remove(options.output);
+		return 1;
+	}
+
+	int failedCount = 0;
+	unsigned long long totalSize = 0;
+	unsigned long long totalStored = 0;
+
+	for (unsigned int i = 0; i < sources.size(); i++)
+	{
+		const AssetPackEntry* entry = pack.Find(sources[i].path.c_str());
+
+		AssetData data;
+		if (!entry || !pack.Read(sources[i].path.c_str(), &data) || data.GetSize() != sources[i].size ||
+			memcmp(data.GetData(), sources[i].data, sources[i].size) != 0)
+		{
+			fprintf(stderr, "  %-40s did not read back the same\n", sources[i].path.c_str());
+			failedCount++;
+			continue;
+		}
+
+		printf("  %-40s %8.1f KB -> %8.1f KB  %s\n", sources[i].path.c_str(), entry->size / 1024.0, entry->storedSize / 1024.0,
+			entry->compression == ASSET_PACK_LZ4 ? "lz4" : "stored");
+
+		totalSize += entry->size;
+		totalStored += entry->storedSize;
+	}
+
+	if (failedCount > 0)
+	{
+		remove(options.output);
+		return 1;
+	}
+
+	// Read everything both ways. The files are all in the page cache by now, so this is the cost of
+	// opening, mapping and decompressing, not of the disk.
+	unsigned int looseSum = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (unsigned int i = 0; i < paths.size(); i++)
+	{
+		AssetData data;
+		data.OpenFile(paths[i].c_str());
+		looseSum += Touch(data.GetData(), data.GetSize());
+	}
+	double looseSeconds = SecondsSince(start);
+
+	unsigned int packSum = 0;
+	start = std::chrono::high_resolution_clock::now();
+	{
+		AssetPack timedPack;
+		timedPack.SetJobSystem(&jobs);
+		timedPack.Open(options.output);
+
+		for (unsigned int i = 0; i < paths.size(); i++)
+		{
+			AssetData data;
+			timedPack.Read(paths[i].c_str(), &data);
+			packSum += Touch(data.GetData(), data.GetSize());
+		}
+	}
+	double packReadSeconds = SecondsSince(start);
+
+	printf("%s: %d files, %.1f KB -> %.1f KB (%.1f KB with the table and padding), written in %.1f ms\n", options.output,
+		(int)paths.size(), totalSize / 1024.0, totalStored / 1024.0, pack.GetSize() / 1024.0, packSeconds * 1000.0);
+	printf("Reading everything: %.2f ms from loose files, %.2f ms from the pack over %d threads%s\n",
+		looseSeconds * 1000.0, packReadSeconds * 1000.0, jobs.GetThreadCount(), looseSum == packSum ? "" : " (DIFFERENT)");
+
+	for (unsigned int i = 0; i < files.size(); i++)
+	{
+		delete files[i];
+		files[i] = NULL;
+	}
+
+	return 0;
+}
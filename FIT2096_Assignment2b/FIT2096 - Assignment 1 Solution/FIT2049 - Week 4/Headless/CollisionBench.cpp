@@ -0,0 +1,271 @@
+/*	FIT2096 - Assignment 2b
+*	CollisionBench.cpp
+*	Microbenchmark for the batch collision tests in Collisions.cpp.
+*	Scatters a lot of small boxes and spheres over a board sized area, then tests a tile sized
+*	object against all of them, once with the scalar CheckCollision in a loop and once with
+*	CheckCollisionBatch. Both must agree on every hit or the run fails.
+*	It also runs CheckSweep over a table of awkward moves (straight along one axis, sliding along
+*	a face, ending up just touching, starting inside) and fails if any answer is wrong.
+*
+*	Usage: collision_bench [--count N] [--repeat N] [--area size] [--seed N]
+*/
+
+#include "Collisions.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+struct BenchOptions
+{
+	int count;
+	int repeat;
+	float area;
+	unsigned int seed;
+};
+
+static bool ParseOptions(int argc, char** argv, BenchOptions* options)
+{
+	options->count = 4096;
+	options->repeat = 2000;
+	options->area = 30.0f;
+	options->seed = 2096;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--count") == 0 && hasValue)
+			options->count = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--repeat") == 0 && hasValue)
+			options->repeat = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--area") == 0 && hasValue)
+			options->area = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			options->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return options->count > 0 && options->repeat > 0 && options->area > 0.0f;
+}
+
+static float RandomFloat(float min, float max)
+{
+	return min + (max - min) * ((float)rand() / (float)RAND_MAX);
+}
+
+static double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool MaskHasBit(const std::vector<unsigned int>& masks, int index)
+{
+	return (masks[index >> 5] & (1u << (index & 31))) != 0;
+}
+
+// One move for CheckSweep and what it should say about it
+struct SweepCase
+{
+	const char* name;
+	Vector3 boxMin;
+	Vector3 boxMax;
+	Vector3 displacement;
+	Vector3 targetMin;
+	Vector3 targetMax;
+	bool hit;
+	float hitTime;
+};
+
+// Boxes only overlap if they share some volume, faces that just touch don't count
+static const SweepCase SWEEP_CASES[] =
+{
+	{ "along x",                  Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(4, 0, 0),    Vector3(3, 0, 0), Vector3(4, 1, 1),    true,  0.5f },
+	{ "along -x",                 Vector3(5, 0, 0), Vector3(6, 1, 1), Vector3(-4, 0, 0),   Vector3(3, 0, 0), Vector3(4, 1, 1),    true,  0.25f },
+	{ "along y",                  Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(0, 4, 0),    Vector3(0, 3, 0), Vector3(1, 4, 1),    true,  0.5f },
+	{ "along z",                  Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(0, 0, 4),    Vector3(0, 0, 3), Vector3(1, 1, 4),    true,  0.5f },
+	{ "through a thin wall",      Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(10, 0, 0),   Vector3(2, 0, 0), Vector3(2.1f, 1, 1), true,  0.1f },
+	{ "partly overlapping",       Vector3(0, 0.5f, 0), Vector3(1, 1.5f, 1), Vector3(4, 0, 0), Vector3(3, 0, 0), Vector3(4, 1, 1),  true,  0.5f },
+	{ "along x beside it",        Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(4, 0, 0),    Vector3(3, 2, 0), Vector3(4, 3, 1),    false, 0.0f },
+	{ "sliding along a face",     Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(4, 0, 0),    Vector3(2, 1, 0), Vector3(3, 2, 1),    false, 0.0f },
+	{ "sliding along an edge",    Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(4, 0, 0),    Vector3(2, 1, 1), Vector3(3, 2, 2),    false, 0.0f },
+	{ "stopping just touching",   Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(2, 0, 0),    Vector3(3, 0, 0), Vector3(4, 1, 1),    false, 0.0f },
+	{ "stopping short",           Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(1, 0, 0),    Vector3(3, 0, 0), Vector3(4, 1, 1),    false, 0.0f },
+	{ "touching, moving in",      Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(1, 0, 0),    Vector3(1, 0, 0), Vector3(2, 1, 1),    true,  0.0f },
+	{ "touching, moving away",    Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(-1, 0, 0),   Vector3(1, 0, 0), Vector3(2, 1, 1),    false, 0.0f },
+	{ "touching, not moving",     Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(0, 0, 0),    Vector3(1, 0, 0), Vector3(2, 1, 1),    false, 0.0f },
+	{ "inside, moving",           Vector3(0.25f, 0.25f, 0.25f), Vector3(0.75f, 0.75f, 0.75f), Vector3(3, 0, 0), Vector3(0, 0, 0), Vector3(1, 1, 1), true, 0.0f },
+	{ "inside, not moving",       Vector3(0.25f, 0.25f, 0.25f), Vector3(0.75f, 0.75f, 0.75f), Vector3(0, 0, 0), Vector3(0, 0, 0), Vector3(1, 1, 1), true, 0.0f },
+	{ "around it, moving",        Vector3(-1, -1, -1), Vector3(2, 2, 2), Vector3(0, 0, 5), Vector3(0, 0, 0), Vector3(1, 1, 1),     true,  0.0f },
+	{ "apart, not moving",        Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(0, 0, 0),    Vector3(3, 0, 0), Vector3(4, 1, 1),    false, 0.0f },
+	{ "diagonal into it",         Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(4, 0, 4),    Vector3(3, 0, 3), Vector3(4, 1, 4),    true,  0.5f },
+	{ "diagonal past a corner",   Vector3(0, 0, 0), Vector3(1, 1, 1), Vector3(4, 0, 4),    Vector3(3, 0, 0), Vector3(4, 1, 1),    false, 0.0f },
+};
+
+// Returns how many of the sweep cases gave the wrong answer
+static int RunSweepCases()
+{
+	int caseCount = sizeof(SWEEP_CASES) / sizeof(SWEEP_CASES[0]);
+	int failures = 0;
+
+	for (int i = 0; i < caseCount; i++)
+	{
+		const SweepCase& sweep = SWEEP_CASES[i];
+		float hitTime = -1.0f;
+		bool hit = CheckSweep(CBoundingBox(sweep.boxMin, sweep.boxMax), sweep.displacement,
+			CBoundingBox(sweep.targetMin, sweep.targetMax), &hitTime);
+
+		if (hit != sweep.hit || (hit && fabsf(hitTime - sweep.hitTime) > 0.0001f))
+		{
+			fprintf(stderr, "Sweep %s: %s at %.4f, expected %s at %.4f\n", sweep.name, hit ? "hit" : "missed", hitTime,
+				sweep.hit ? "hit" : "miss", sweep.hitTime);
+			failures++;
+		}
+	}
+
+	printf("  sweeps   %d of %d cases right\n", caseCount - failures, caseCount);
+	return failures;
+}
+
+static void PrintResult(const char* name, double scalarSeconds, double batchSeconds, long long tests, long long hits)
+{
+	printf("  %-8s scalar %7.3f ns/test, batch %7.3f ns/test, %.1fx faster (%lld hits)\n", name,
+		scalarSeconds * 1e9 / tests, batchSeconds * 1e9 / tests, scalarSeconds / batchSeconds, hits);
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--count N] [--repeat N] [--area size] [--seed N]\n", argv[0]);
+		return 1;
+	}
+
+	srand(options.seed);
+
+	// Bullet sized objects scattered over the board
+	std::vector<CBoundingBox> boxes;
+	std::vector<CBoundingSphere> spheres;
+	CBoundingBoxBlock boxBlock;
+	CBoundingSphereBlock sphereBlock;
+
+	for (int i = 0; i < options.count; i++)
+	{
+		Vector3 position(RandomFloat(0.0f, options.area), RandomFloat(0.0f, 1.0f), RandomFloat(0.0f, options.area));
+		Vector3 halfSize(RandomFloat(0.05f, 0.5f), RandomFloat(0.05f, 0.5f), RandomFloat(0.05f, 0.5f));
+
+		boxes.push_back(CBoundingBox(position - halfSize, position + halfSize));
+		boxBlock.Add(boxes.back());
+
+		spheres.push_back(CBoundingSphere(position, halfSize.x));
+		sphereBlock.Add(spheres.back());
+	}
+
+	// Tile sized things moving around the middle of the board, moved each repeat so nothing gets optimised away
+	std::vector<CBoundingBox> queryBoxes;
+	std::vector<CBoundingSphere> querySpheres;
+
+	for (int i = 0; i < options.repeat; i++)
+	{
+		Vector3 position(RandomFloat(0.0f, options.area), 0.5f, RandomFloat(0.0f, options.area));
+		queryBoxes.push_back(CBoundingBox(position - Vector3(0.5f, 0.5f, 0.5f), position + Vector3(0.5f, 0.5f, 0.5f)));
+		querySpheres.push_back(CBoundingSphere(position, 0.5f));
+	}
+
+	long long tests = (long long)options.count * options.repeat;
+	std::vector<unsigned int> hitMasks;
+	bool agreed = true;
+
+	// Boxes
+	long long scalarHits = 0;
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < options.repeat; r++)
+	{
+		for (int i = 0; i < options.count; i++)
+		{
+			if (CheckCollision(queryBoxes[r], boxes[i]))
+				scalarHits++;
+		}
+	}
+	double scalarSeconds = SecondsSince(start);
+
+	long long batchHits = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < options.repeat; r++)
+	{
+		batchHits += CheckCollisionBatch(queryBoxes[r], boxBlock, &hitMasks);
+	}
+	double batchSeconds = SecondsSince(start);
+
+	// Check the bits land on the right boxes, not just that the totals match
+	for (int r = 0; r < options.repeat && agreed; r++)
+	{
+		CheckCollisionBatch(queryBoxes[r], boxBlock, &hitMasks);
+
+		for (int i = 0; i < options.count; i++)
+		{
+			if (MaskHasBit(hitMasks, i) != CheckCollision(queryBoxes[r], boxes[i]))
+			{
+				fprintf(stderr, "Box %d disagrees on repeat %d\n", i, r);
+				agreed = false;
+				break;
+			}
+		}
+	}
+
+	printf("Collision batch benchmark (%d objects, %d repeats)\n", options.count, options.repeat);
+	PrintResult("boxes", scalarSeconds, batchSeconds, tests, batchHits);
+	agreed = agreed && scalarHits == batchHits;
+
+	// Spheres
+	scalarHits = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < options.repeat; r++)
+	{
+		for (int i = 0; i < options.count; i++)
+		{
+			if (CheckCollision(querySpheres[r], spheres[i]))
+				scalarHits++;
+		}
+	}
+	scalarSeconds = SecondsSince(start);
+
+	batchHits = 0;
+	start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < options.repeat; r++)
+	{
+		batchHits += CheckCollisionBatch(querySpheres[r], sphereBlock, &hitMasks);
+	}
+	batchSeconds = SecondsSince(start);
+
+	PrintResult("spheres", scalarSeconds, batchSeconds, tests, batchHits);
+
+	if (RunSweepCases() > 0)
+	{
+		agreed = false;
+	}
+
+	// Squared vs square rooted distances can round differently right on the boundary, allow for the odd one
+	long long difference = scalarHits > batchHits ? scalarHits - batchHits : batchHits - scalarHits;
+	if (difference > tests / 100000)
+	{
+		fprintf(stderr, "Sphere hits disagree: scalar %lld, batch %lld\n", scalarHits, batchHits);
+		agreed = false;
+	}
+
+	if (!agreed)
+	{
+		fprintf(stderr, "Batch and scalar results do not match, or a sweep was wrong\n");
+		return 1;
+	}
+
+	return 0;
+}
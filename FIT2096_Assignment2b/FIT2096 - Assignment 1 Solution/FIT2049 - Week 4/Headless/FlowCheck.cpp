@@ -0,0 +1,168 @@
+/*	FIT2096 - Assignment 2b
+*	FlowCheck.cpp
+*	Checks that repairing the FlowField after a tile changes gives the same distances as working
+*	the whole field out again. A board is scattered with walls and disabled tiles, then tiles are
+*	changed to random types one at a time. After each change the repaired field is compared cell
+*	by cell with a fresh one built from the same board. Every so often the target moves too, so
+*	the repairs don't always start from the same field.
+*
+*	Usage: flow_check [--board width height] [--changes N] [--walls fraction] [--seed N]
+*/
+
+#include "FlowField.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+
+// Changes between each move of the target
+#define FLOW_CHECK_TARGET_INTERVAL 100
+
+struct CheckOptions
+{
+	int boardWidth;
+	int boardHeight;
+	int changes;
+	float walls;
+	unsigned int seed;
+};
+
+static bool ParseOptions(int argc, char** argv, CheckOptions* options)
+{
+	options->boardWidth = 48;
+	options->boardHeight = 32;
+	options->changes = 3000;
+	options->walls = 0.3f;
+	options->seed = 2096;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--board") == 0 && i + 2 < argc)
+		{
+			options->boardWidth = atoi(argv[++i]);
+			options->boardHeight = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--changes") == 0 && hasValue)
+			options->changes = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--walls") == 0 && hasValue)
+			options->walls = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			options->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return options->boardWidth > 0 && options->boardHeight > 0 && options->changes > 0;
+}
+
+// Walls and disabled tiles block the way, everything else can be walked on
+static const TileType BLOCKING_TYPES[] = { TileType::WALL, TileType::DISABLED };
+static const TileType WALKABLE_TYPES[] = { TileType::HEALTH, TileType::DAMAGE, TileType::TELEPORT,
+	TileType::NORMAL, TileType::MONSTER_VAR1, TileType::MONSTER_VAR2 };
+
+static TileType GetRandomType(std::mt19937* random, float walls)
+{
+	if (std::uniform_real_distribution<float>(0.0f, 1.0f)(*random) < walls)
+		return BLOCKING_TYPES[std::uniform_int_distribution<int>(0, 1)(*random)];
+
+	return WALKABLE_TYPES[std::uniform_int_distribution<int>(0, 5)(*random)];
+}
+
+// Prints the first cell that differs, returns whether they all matched
+static bool Compare(TileGrid* tiles, FlowField* repaired, FlowField* fresh, int change)
+{
+	for (int z = 0; z < tiles->GetHeight(); z++)
+	{
+		for (int x = 0; x < tiles->GetWidth(); x++)
+		{
+			if (repaired->GetDistance(x, z) != fresh->GetDistance(x, z))
+			{
+				fprintf(stderr, "  after change %d cell (%d, %d) is %d repaired, %d rebuilt\n", change, x, z,
+					repaired->GetDistance(x, z), fresh->GetDistance(x, z));
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	CheckOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--board width height] [--changes N] [--walls fraction] [--seed N]\n", argv[0]);
+		return 1;
+	}
+
+	std::mt19937 random(options.seed);
+	std::uniform_int_distribution<int> randomX(0, options.boardWidth - 1);
+	std::uniform_int_distribution<int> randomZ(0, options.boardHeight - 1);
+
+	TileGrid tiles;
+	tiles.Resize(options.boardWidth, options.boardHeight);
+
+	for (int z = 0; z < options.boardHeight; z++)
+	{
+		for (int x = 0; x < options.boardWidth; x++)
+		{
+			tiles.SetType(x, z, GetRandomType(&random, options.walls));
+		}
+	}
+
+	FlowField repaired;
+	repaired.Build(&tiles);
+
+	int targetX = 0;
+	int targetZ = 0;
+	int mismatches = 0;
+
+	for (int change = 0; change < options.changes; change++)
+	{
+		if (change % FLOW_CHECK_TARGET_INTERVAL == 0)
+		{
+			targetX = randomX(random);
+			targetZ = randomZ(random);
+			repaired.SetTarget(targetX, targetZ);
+		}
+
+		int x = randomX(random);
+		int z = randomZ(random);
+		tiles.SetType(x, z, GetRandomType(&random, options.walls));
+		repaired.OnTileChanged(x, z);
+
+		FlowField fresh;
+		fresh.Build(&tiles);
+		fresh.SetTarget(targetX, targetZ);
+
+		if (!Compare(&tiles, &repaired, &fresh, change))
+		{
+			mismatches++;
+
+			// Start again from a good field so one mistake isn't reported over and over
+			repaired.Build(&tiles);
+			repaired.SetTarget(targetX, targetZ);
+		}
+	}
+
+	printf("Flow field repair check (%dx%d board, %d changes)\n", options.boardWidth, options.boardHeight, options.changes);
+	printf("  %d repairs, %d rebuilds, %d changes gave a different field\n", repaired.GetRepairCount(),
+		repaired.GetRebuildCount(), mismatches);
+
+	// A board where nothing ever needed repairing hasn't checked anything
+	if (mismatches > 0 || repaired.GetRepairCount() == 0)
+	{
+		fprintf(stderr, "Repaired and rebuilt flow fields do not match\n");
+		return 1;
+	}
+
+	return 0;
+}
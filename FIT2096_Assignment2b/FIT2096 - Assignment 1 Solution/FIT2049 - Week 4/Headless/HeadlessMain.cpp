@@ -0,0 +1,730 @@
+/*	FIT2096 - Assignment 2b
+*	HeadlessMain.cpp
+*	Entry point for the headless simulation. Does what Window does, minus the window:
+*	creates the (null) renderer, audio and input, initialises the Game and then
+*	calls Game::Update in a tight loop with scripted input and a fixed timestep.
+*	At the end it reports frames per second and the cost of each entity update.
+*
+*	Usage: headless_sim [--frames N] [--timestep seconds] [--seed N] [--root dir]
+*	                    [--board width height] [--render] [--stop-at-game-over] [--verbose]
+*	                    [--discrete-bullets] [--projectiles N] [--paths N] [--check-paths N]
+*	                    [--enemies N] [--ai-budget N] [--threads N] [--scaling N] [--render-thread]
+*
+*	--projectiles also times a separate BulletPool with N bullets in flight at once,
+*	to see what the projectile simulation costs well past what a real game fires.
+*	--paths times N routes between random cells of the board using the enemies' pathfinder.
+*	--check-paths asks the pathfinder for N routes between random cells, then changes some tiles and
+*	asks for the same routes again, a few times over. Every answer is checked against a flood fill of
+*	the board and it exits with 1 if the pathfinder found a route that isn't there or missed one that is.
+*	--enemies spawns N more enemies around the board, --ai-budget sets how many of the ones away from
+*	the player can update each tick.
+*	--threads sets how many threads the board's update is spread over (default one per core).
+*	--scaling plays the same game again on 1 to N threads and checks they all finish in the same
+*	state, exiting with 1 if any of them don't.
+*	--render-thread publishes a render snapshot after every tick and has a render thread draw them
+*	with a backend that only records what it was asked to draw, then reports what got through.
+*/
+
+#include "Game.h"
+#include "HeadlessPlatform.h"
+#include "InputScript.h"
+#include "RecordingRenderBackend.h"
+#include "RenderMailbox.h"
+#include "RenderThread.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <unistd.h>
+
+// How many times --check-paths changes tiles and asks again, and how many tiles it changes each time
+#define PATH_CHECK_ROUNDS 4
+#define PATH_CHECK_CHANGES 200
+
+struct HeadlessOptions
+{
+	int frames;
+	float timestep;
+	unsigned int seed;
+	const char* root;
+	int boardWidth;
+	int boardHeight;
+	bool render;
+	bool stopAtGameOver;
+	bool verbose;
+	bool discreteBullets;
+	int projectiles;
+	int paths;
+	int checkPaths;
+	int enemies;
+	int aiBudget;
+	int threads;
+	int scaling;
+	bool renderThread;
+};
+
+static bool ParseOptions(int argc, char** argv, HeadlessOptions* options)
+{
+	options->frames = 10000;
+	options->timestep = 1.0f / 60.0f;
+	options->seed = 2096;
+	options->root = NULL;
+	options->boardWidth = GameBoard::DEFAULT_BOARD_WIDTH;
+	options->boardHeight = GameBoard::DEFAULT_BOARD_HEIGHT;
+	options->render = false;
+	options->stopAtGameOver = false;
+	options->verbose = false;
+	options->discreteBullets = false;
+	options->projectiles = 0;
+	options->paths = 0;
+	options->checkPaths = 0;
+	options->enemies = 0;
+	options->aiBudget = AI_DEFAULT_BUDGET;
+	options->threads = 0;
+	options->scaling = 0;
+	options->renderThread = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--frames") == 0 && hasValue)
+			options->frames = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--timestep") == 0 && hasValue)
+			options->timestep = (float)atof(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			options->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		else if (strcmp(argv[i], "--root") == 0 && hasValue)
+			options->root = argv[++i];
+		else if (strcmp(argv[i], "--board") == 0 && i + 2 < argc)
+		{
+			options->boardWidth = atoi(argv[++i]);
+			options->boardHeight = atoi(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--render") == 0)
+			options->render = true;
+		else if (strcmp(argv[i], "--stop-at-game-over") == 0)
+			options->stopAtGameOver = true;
+		else if (strcmp(argv[i], "--verbose") == 0)
+			options->verbose = true;
+		else if (strcmp(argv[i], "--discrete-bullets") == 0)
+			options->discreteBullets = true;
+		else if (strcmp(argv[i], "--projectiles") == 0 && hasValue)
+			options->projectiles = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--paths") == 0 && hasValue)
+			options->paths = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--check-paths") == 0 && hasValue)
+			options->checkPaths = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--enemies") == 0 && hasValue)
+			options->enemies = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--ai-budget") == 0 && hasValue)
+			options->aiBudget = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--threads") == 0 && hasValue)
+			options->threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--scaling") == 0 && hasValue)
+			options->scaling = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--render-thread") == 0)
+			options->renderThread = true;
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	// Walls take up the outside ring so anything smaller than this has no floor to stand on
+	return options->frames > 0 && options->timestep > 0.0f &&
+		options->boardWidth >= 3 && options->boardHeight >= 3 && options->projectiles >= 0 && options->paths >= 0 && options->checkPaths >= 0 && options->enemies >= 0 &&
+		options->threads >= 0 && options->scaling >= 0;
+}
+
+// Fills a pool with bullets flying in every direction and times how long each tick takes to move them
+static void RunProjectileBenchmark(int count, float timestep)
+{
+	// No mesh, so nothing is drawn and bullets are points, which is all we need to time the simulation
+	BulletPool* pool = new BulletPool(NULL, NULL, NULL, count);
+
+	for (int i = 0; i < count; i++)
+	{
+		float angle = (float)i / count * 6.2831853f;
+		Vector3 position((float)(i % 256), 1.0f, (float)(i / 256));
+		pool->Fire(position, Vector3(sinf(angle), 0.0f, cosf(angle)) * 10.0f, angle, NULL);
+	}
+
+	// Stop short of the lifetime so every tick moves every bullet
+	int ticks = (int)(BULLET_LIFETIME / timestep) - 1;
+	if (ticks < 1)
+		ticks = 1;
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int tick = 0; tick < ticks; tick++)
+	{
+		pool->StorePreviousPositions();
+		pool->Update(timestep);
+	}
+
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	printf("  projectiles     %d in flight for %d ticks, %.4f ms/tick, %.2f ns/bullet (%d still flying)\n",
+		count, ticks, seconds * 1000.0 / ticks, seconds * 1e9 / ((double)ticks * count), pool->GetActiveCount());
+
+	delete pool;
+}
+
+// Picks a random cell an enemy could stand on, gives up after a while on a board that's all walls
+static bool GetRandomWalkableCell(GameBoard* board, Vector3* position)
+{
+	for (int attempt = 0; attempt < 1000; attempt++)
+	{
+		int x = rand() % board->GetWidth();
+		int z = rand() % board->GetHeight();
+		TileType type = board->GetTileTypeForPosition(x, z);
+
+		if (type != TileType::WALL && type != TileType::DISABLED && type != TileType::INVALID)
+		{
+			*position = Vector3((float)x, 0.0f, (float)z);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+// Asks the board's pathfinder for routes between random cells and times each one
+static void RunPathBenchmark(GameBoard* board, int count)
+{
+	HierarchicalPathfinder* pathfinder = board->GetPathfinder();
+	std::vector<Vector3> waypoints;
+	double totalSeconds = 0.0;
+	double worstSeconds = 0.0;
+	long long totalWaypoints = 0;
+	int found = 0;
+
+	for (int i = 0; i < count; i++)
+	{
+		Vector3 start;
+		Vector3 goal;
+
+		if (!GetRandomWalkableCell(board, &start) || !GetRandomWalkableCell(board, &goal))
+			break;
+
+		std::chrono::steady_clock::time_point queryStart = std::chrono::steady_clock::now();
+		bool success = pathfinder->FindPath(start, goal, &waypoints);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - queryStart).count();
+
+		totalSeconds += seconds;
+		if (seconds > worstSeconds)
+			worstSeconds = seconds;
+
+		if (success)
+		{
+			found++;
+			totalWaypoints += waypoints.size();
+		}
+	}
+
+	printf("  paths           %d queries, %d found, %.3f ms/query (worst %.3f ms), %.1f waypoints/path\n",
+		count, found, totalSeconds * 1000.0 / count, worstSeconds * 1000.0, found > 0 ? (double)totalWaypoints / found : 0.0);
+	printf("  pathfinder      %d sectors (%d connected), %d entrance nodes, %d cache hits, %d sector rebuilds, %lld nodes expanded\n",
+		pathfinder->GetSectorCount(), pathfinder->GetSectorConnects(), pathfinder->GetNodeCount(), pathfinder->GetCacheHits(),
+		pathfinder->GetSectorRebuilds(), pathfinder->GetExpansions());
+}
+
+static bool IsWalkableCell(GameBoard* board, int x, int z)
+{
+	TileType type = board->GetTileTypeForPosition(x, z);
+	return type != TileType::WALL && type != TileType::DISABLED && type != TileType::INVALID;
+}
+
+// Numbers each area of the board you can walk around in, -1 for cells that can't be walked on.
+// Straight steps are enough, a diagonal that doesn't cut a corner can always be walked the long way.
+static void LabelAreas(GameBoard* board, std::vector<int>* areas)
+{
+	int width = board->GetWidth();
+	int height = board->GetHeight();
+	std::deque<int> open;
+	int areaCount = 0;
+
+	areas->assign(width * height, -1);
+
+	for (int first = 0; first < width * height; first++)
+	{
+		if ((*areas)[first] != -1 || !IsWalkableCell(board, first % width, first / width))
+			continue;
+
+		(*areas)[first] = areaCount;
+		open.push_back(first);
+
+		while (!open.empty())
+		{
+			int cell = open.front();
+			open.pop_front();
+
+			int x = cell % width;
+			int z = cell / width;
+			int neighbours[4][2] = { { x + 1, z }, { x - 1, z }, { x, z + 1 }, { x, z - 1 } };
+
+			for (int n = 0; n < 4; n++)
+			{
+				int nx = neighbours[n][0];
+				int nz = neighbours[n][1];
+
+				if (nx < 0 || nx >= width || nz < 0 || nz >= height || (*areas)[nz * width + nx] != -1)
+					continue;
+
+				if (IsWalkableCell(board, nx, nz))
+				{
+					(*areas)[nz * width + nx] = areaCount;
+					open.push_back(nz * width + nx);
+				}
+			}
+		}
+
+		areaCount++;
+	}
+}
+
+// Is every waypoint one step on from the last, onto a cell that can be walked on, without cutting a corner?
+static bool IsPathWalkable(GameBoard* board, Vector3 start, Vector3 goal, const std::vector<Vector3>& waypoints)
+{
+	int x = (int)start.x;
+	int z = (int)start.z;
+
+	for (unsigned int i = 0; i < waypoints.size(); i++)
+	{
+		int nextX = (int)floorf(waypoints[i].x + 0.5f);
+		int nextZ = (int)floorf(waypoints[i].z + 0.5f);
+		int stepX = nextX - x;
+		int stepZ = nextZ - z;
+
+		if (stepX < -1 || stepX > 1 || stepZ < -1 || stepZ > 1 || !IsWalkableCell(board, nextX, nextZ))
+			return false;
+
+		if (stepX != 0 && stepZ != 0 && (!IsWalkableCell(board, x + stepX, z) || !IsWalkableCell(board, x, z + stepZ)))
+			return false;
+
+		x = nextX;
+		z = nextZ;
+	}
+
+	return x == (int)goal.x && z == (int)goal.z;
+}
+
+// Asks the pathfinder for the same routes between random cells while changing tiles in between, so
+// sectors get rebuilt under routes it remembers. Returns false if any answer disagrees with the board.
+static bool RunPathCheck(GameBoard* board, int count)
+{
+	HierarchicalPathfinder* pathfinder = board->GetPathfinder();
+	std::vector<Vector3> starts;
+	std::vector<Vector3> goals;
+	std::vector<Vector3> waypoints;
+	std::vector<int> areas;
+	int found = 0;
+	int problems = 0;
+
+	// A capped search could give up on a route that's there
+	pathfinder->SetSearchLimit(0);
+
+	for (int i = 0; i < count; i++)
+	{
+		Vector3 start;
+		Vector3 goal;
+
+		if (!GetRandomWalkableCell(board, &start) || !GetRandomWalkableCell(board, &goal))
+			break;
+
+		starts.push_back(start);
+		goals.push_back(goal);
+	}
+
+	for (int round = 0; round < PATH_CHECK_ROUNDS; round++)
+	{
+		LabelAreas(board, &areas);
+
+		for (unsigned int i = 0; i < starts.size(); i++)
+		{
+			int startCell = (int)starts[i].z * board->GetWidth() + (int)starts[i].x;
+			int goalCell = (int)goals[i].z * board->GetWidth() + (int)goals[i].x;
+			bool connected = areas[startCell] != -1 && areas[startCell] == areas[goalCell];
+			bool success = pathfinder->FindPath(starts[i], goals[i], &waypoints);
+
+			if (success)
+				found++;
+
+			if (success != connected || (success && !IsPathWalkable(board, starts[i], goals[i], waypoints)))
+			{
+				if (problems < 10)
+				{
+					fprintf(stderr, "  round %d, (%.0f, %.0f) to (%.0f, %.0f): %s\n", round, starts[i].x, starts[i].z,
+						goals[i].x, goals[i].z, !success ? "no route found but the cells are connected" :
+						!connected ? "found a route between cells that aren't connected" : "route can't be walked");
+				}
+				problems++;
+			}
+		}
+
+		// Knock down or put up walls all over, the next round asks for the same routes across them
+		for (int i = 0; i < PATH_CHECK_CHANGES; i++)
+		{
+			int x = rand() % board->GetWidth();
+			int z = rand() % board->GetHeight();
+			board->SetTileType(x, z, IsWalkableCell(board, x, z) ? TileType::WALL : TileType::NORMAL);
+		}
+	}
+
+	printf("  path check      %d rounds of %d queries, %d found, %d cache hits, %d sector rebuilds, %d wrong\n",
+		PATH_CHECK_ROUNDS, (int)starts.size(), found, pathfinder->GetCacheHits(), pathfinder->GetSectorRebuilds(), problems);
+
+	return problems == 0;
+}
+
+// Mixes in the bits of a float, so any difference at all shows up
+static unsigned int HashFloat(unsigned int hash, float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, sizeof(bits));
+
+	for (int i = 0; i < 4; i++)
+	{
+		hash = (hash ^ ((bits >> (i * 8)) & 0xff)) * 16777619u;
+	}
+
+	return hash;
+}
+
+// Where everything ended up, two games that played out the same get the same number
+static unsigned int GetStateChecksum(Game* game)
+{
+	unsigned int hash = 2166136261u;
+	GameBoard* board = game->GetGameBoard();
+	std::vector<Enemy*> enemies = board->getEnemyVector();
+
+	for (unsigned int i = 0; i < enemies.size(); i++)
+	{
+		Vector3 position = enemies[i]->GetPosition();
+		hash = HashFloat(hash, position.x);
+		hash = HashFloat(hash, position.z);
+		hash = HashFloat(hash, enemies[i]->IsAlive() ? 1.0f : 0.0f);
+	}
+
+	BulletPool* bulletPool = board->GetBulletPool();
+
+	for (int i = 0; i < bulletPool->GetActiveCount(); i++)
+	{
+		Vector3 position = bulletPool->GetActivePosition(i);
+		hash = HashFloat(hash, position.x);
+		hash = HashFloat(hash, position.z);
+	}
+
+	Player* player = game->GetPlayer();
+	hash = HashFloat(hash, player->GetPosition().x);
+	hash = HashFloat(hash, player->GetPosition().z);
+	hash = HashFloat(hash, player->GetHealth());
+
+	return hash;
+}
+
+// Plays the same game from the start on 1 to options.scaling threads and times each one.
+// Returns false if any of them finished in a different state to the 1 thread run.
+static bool RunScalingBenchmark(const HeadlessOptions& options, Direct3D* renderer, InputController* input)
+{
+	double oneThreadSeconds = 0.0;
+	unsigned int oneThreadChecksum = 0;
+	bool matching = true;
+
+	for (int threads = 1; threads <= options.scaling; threads++)
+	{
+		// Same seed and same script, so the only difference is the thread count
+		srand(options.seed);
+		HeadlessPlatform::ClearQuitRequest();
+
+		// The game shuts down its audio system with it, so each run needs its own
+		AudioSystem* audio = new AudioSystem();
+		Game* game = new Game();
+		game->SetBoardSize(options.boardWidth, options.boardHeight);
+		game->SetExtraEnemyCount(options.enemies);
+		game->SetThreadCount(threads);
+
+		if (!audio->Initialise() || !game->Initialise(renderer, audio, input) || !game->FinishLoading())
+		{
+			fprintf(stderr, "Could not initialise the game for the scaling run\n");
+			return false;
+		}
+
+		game->GetCollisionManager()->SetContinuousBullets(!options.discreteBullets);
+		game->GetGameBoard()->GetAIScheduler()->SetBudget(options.aiBudget);
+
+		InputScript script(input);
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		for (int frame = 0; frame < options.frames; frame++)
+		{
+			script.Apply(frame);
+			game->Update(options.timestep);
+
+			if (HeadlessPlatform::IsQuitRequested())
+				HeadlessPlatform::ClearQuitRequest();
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		unsigned int checksum = GetStateChecksum(game);
+
+		if (threads == 1)
+		{
+			oneThreadSeconds = seconds;
+			oneThreadChecksum = checksum;
+		}
+
+		if (checksum != oneThreadChecksum)
+			matching = false;
+
+		printf("  scaling         %2d threads, %.4f ms/frame, %.2fx, state %08x%s\n", threads,
+			seconds * 1000.0 / options.frames, oneThreadSeconds / seconds, checksum,
+			checksum == oneThreadChecksum ? "" : " (differs from 1 thread)");
+
+		game->Shutdown();
+		delete game;
+	}
+
+	return matching;
+}
+
+int main(int argc, char** argv)
+{
+	HeadlessOptions options;
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--frames N] [--timestep seconds] [--seed N] [--root dir] [--board width height] [--render] [--stop-at-game-over] [--verbose] [--discrete-bullets] [--projectiles N] [--paths N] [--check-paths N] [--enemies N] [--ai-budget N] [--threads N] [--scaling N] [--render-thread]\n", argv[0]);
+		return 1;
+	}
+
+	// The game loads everything relative to the project folder
+	if (options.root && chdir(options.root) != 0)
+	{
+		fprintf(stderr, "Could not change into %s\n", options.root);
+		return 1;
+	}
+
+	HeadlessPlatform::SetVerbose(options.verbose);
+	srand(options.seed);
+
+	Direct3D* renderer = new Direct3D();
+	AudioSystem* audio = new AudioSystem();
+	InputController* input = new InputController(NULL);
+	Game* game = new Game();
+	game->SetBoardSize(options.boardWidth, options.boardHeight);
+	game->SetExtraEnemyCount(options.enemies);
+	game->SetThreadCount(options.threads);
+
+	if (!renderer->Initialise(1280, 720, NULL, false, false) || !audio->Initialise())
+	{
+		fprintf(stderr, "Could not create the null renderer or audio system\n");
+		return 1;
+	}
+
+	// The scripted input starts pressing buttons on the first frame, so everything has to be loaded before then
+	if (!game->Initialise(renderer, audio, input) || !game->FinishLoading())
+	{
+		fprintf(stderr, "Could not initialise the game, is --root pointing at the folder with Assets in it?\n");
+		return 1;
+	}
+
+	// Only the swept test can be switched off, for comparing hit rates at long timesteps
+	game->GetCollisionManager()->SetContinuousBullets(!options.discreteBullets);
+
+	GameBoard* board = game->GetGameBoard();
+	board->GetAIScheduler()->SetBudget(options.aiBudget);
+	int tileCount = board->GetTileCount();
+	int enemyCount = (int)board->getEnemyVector().size();
+	int bulletCount = board->GetBulletPool()->GetCapacity();
+	int healthPackCount = (int)board->getHealthPackVector().size();
+	int entityCount = tileCount + enemyCount + bulletCount + healthPackCount + 1;
+
+	InputScript script(input);
+	int gameOverFrame = -1;
+	int framesRun = 0;
+
+	// Drawing on another thread, the same way Window does it but recording instead of drawing
+	RecordingRenderBackend* recorder = NULL;
+	RenderMailbox* renderMailbox = NULL;
+	RenderThread* renderThread = NULL;
+	if (options.renderThread)
+	{
+		recorder = new RecordingRenderBackend();
+		renderMailbox = new RenderMailbox();
+		renderThread = new RenderThread(renderMailbox, recorder, options.timestep);
+		renderThread->Start();
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int frame = 0; frame < options.frames; frame++)
+	{
+		script.Apply(frame);
+
+		game->Update(options.timestep);
+
+		if (options.render)
+		{
+			game->Render();
+		}
+
+		if (renderThread)
+		{
+			game->BuildSnapshot(renderMailbox->GetWriteSnapshot(), 0.0f);
+			renderMailbox->Publish();
+		}
+
+		framesRun++;
+
+		if (HeadlessPlatform::IsQuitRequested())
+		{
+			if (gameOverFrame < 0)
+				gameOverFrame = frame;
+
+			if (options.stopAtGameOver)
+				break;
+
+			// Keep simulating, the board is still alive even if the player isn't
+			HeadlessPlatform::ClearQuitRequest();
+		}
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+
+	if (renderThread)
+	{
+		renderThread->Stop();
+	}
+
+	double seconds = std::chrono::duration<double>(end - start).count();
+	double nanoseconds = seconds * 1e9;
+
+	printf("Headless simulation\n");
+	printf("  frames          %d (timestep %.5f s, seed %u%s%s)\n", framesRun, options.timestep, options.seed,
+		options.render ? ", rendering" : "", options.discreteBullets ? ", discrete bullets" : "");
+	printf("  board           %d x %d\n", board->GetWidth(), board->GetHeight());
+	printf("  threads         %d\n", game->GetJobSystem()->GetThreadCount());
+	AssetLoader* loader = game->GetAssetLoader();
+	AssetLoaderStats loadStats = loader->GetStats();
+	printf("  startup         menu after %.2f ms, %d assets ready after %.2f ms (%.2f ms of decoding, %.2f ms of creating)\n",
+		loader->GetMarkTime("menu ready") * 1000.0, loadStats.assetCount, loadStats.readyTime * 1000.0,
+		loadStats.decodeTime * 1000.0, loadStats.createTime * 1000.0);
+	AssetPack* pack = game->GetAssetPack();
+	if (pack)
+		printf("  asset pack      %s, %d files in %.1f KB\n", ASSET_PACK_FILENAME, pack->GetEntryCount(), pack->GetSize() / 1024.0);
+	else
+		printf("  asset pack      none, loose files from Assets\n");
+	printf("  entities        %d (%d tiles, %d enemies, %d bullets, %d health packs, 1 player)\n",
+		entityCount, tileCount, enemyCount, bulletCount, healthPackCount);
+	printf("  wall time       %.3f s\n", seconds);
+	printf("  frames/sec      %.1f\n", framesRun / seconds);
+	printf("  ms/frame        %.4f\n", seconds * 1000.0 / framesRun);
+	printf("  ns/entity       %.1f\n", nanoseconds / ((double)framesRun * entityCount));
+	if (options.render)
+	{
+		printf("  draw calls      %llu\n", renderer->GetDeviceContext()->m_drawCalls);
+	}
+	if (renderThread)
+	{
+		printf("  render thread   %d snapshots published, %d picked up, %d dropped\n",
+			renderMailbox->GetPublishedCount(), renderMailbox->GetAcquiredCount(), renderMailbox->GetDroppedCount());
+		printf("                  %d frames drawn from %d snapshots, %.1f meshes and %.1f UI per frame, %d out of order, %d bad blends\n",
+			recorder->GetFrameCount(), recorder->GetSnapshotCount(),
+			recorder->GetFrameCount() > 0 ? (double)recorder->GetMeshCount() / recorder->GetFrameCount() : 0.0,
+			recorder->GetFrameCount() > 0 ? (double)recorder->GetUICount() / recorder->GetFrameCount() : 0.0,
+			recorder->GetOutOfOrderCount(), recorder->GetBadAmountCount());
+		printf("  last frame      tick %u\n", recorder->GetLastTick());
+		const std::vector<std::string>& lastFrame = recorder->GetLastFrame();
+		for (unsigned int i = 0; i < lastFrame.size(); i++)
+		{
+			printf("                  %s\n", lastFrame[i].c_str());
+		}
+	}
+	BulletPool* bulletPool = board->GetBulletPool();
+	printf("  bullet pool     %d made, at most %d in flight, %d shots refused\n",
+		bulletPool->GetCapacity(), bulletPool->GetHighWaterMark(), bulletPool->GetFailedAcquires());
+	FlowField* flowField = board->GetFlowField();
+	printf("  flow field      %d rebuilds, %d tile repairs\n", flowField->GetRebuildCount(), flowField->GetRepairCount());
+	AIScheduler* aiScheduler = board->GetAIScheduler();
+	printf("  ai scheduler    %.1f enemy updates per tick, %d deferred, %d ticks over time budget, slowest tick %.3f ms\n",
+		(double)aiScheduler->GetUpdateCount() / framesRun, aiScheduler->GetDeferredCount(),
+		aiScheduler->GetOverrunCount(), aiScheduler->GetSlowestTick());
+	// Separation should keep enemies from piling up on each other, the closest will be themselves
+	std::vector<Enemy*> enemies = board->getEnemyVector();
+	std::vector<Enemy*> nearest;
+	int livingEnemies = 0;
+	int stackedEnemies = 0;
+	for (unsigned int i = 0; i < enemies.size(); i++)
+	{
+		if (!enemies[i]->IsAlive())
+			continue;
+
+		nearest.clear();
+		board->GetNearestEnemies(enemies[i]->GetPosition(), 2, 0.5f, &nearest);
+		livingEnemies++;
+		stackedEnemies += nearest.size() > 1 ? 1 : 0;
+	}
+	printf("  enemy overlap   %d of %d living enemies within half a unit of another\n", stackedEnemies, livingEnemies);
+	CollisionStats collisionStats = game->GetCollisionManager()->GetStats();
+	if (collisionStats.checks > 0)
+	{
+		printf("  collision pairs %.1f tested per tick (%.1f brute force), %.1f colliding\n",
+			(double)collisionStats.broadphasePairs / collisionStats.checks,
+			(double)collisionStats.bruteForcePairs / collisionStats.checks,
+			(double)collisionStats.collidingPairs / collisionStats.checks);
+	}
+	if (gameOverFrame >= 0)
+	{
+		printf("  game over       frame %d\n", gameOverFrame);
+	}
+	printf("  player          health %.0f, score %d, monsters defeated %d\n",
+		game->GetPlayer()->GetHealth(), game->GetPlayer()->GetScore(), game->GetPlayer()->GetNumberOfMonstersDefeated());
+
+	if (options.projectiles > 0)
+	{
+		RunProjectileBenchmark(options.projectiles, options.timestep);
+	}
+
+	if (options.paths > 0)
+	{
+		RunPathBenchmark(board, options.paths);
+	}
+
+	bool pathsMatched = true;
+
+	if (options.checkPaths > 0)
+	{
+		pathsMatched = RunPathCheck(board, options.checkPaths);
+	}
+
+	bool scalingMatched = true;
+
+	if (options.scaling > 0)
+	{
+		scalingMatched = RunScalingBenchmark(options, renderer, input);
+	}
+
+	if (renderThread)
+	{
+		delete renderThread;
+		delete renderMailbox;
+		delete recorder;
+	}
+
+	game->Shutdown();
+	delete game;
+	game = NULL;
+
+	renderer->Shutdown();
+	delete renderer;
+	renderer = NULL;
+
+	delete input;
+	input = NULL;
+
+	return pathsMatched && scalingMatched ? 0 : 1;
+}
@@ -0,0 +1,29 @@
+/*	FIT2096 - Assignment 2b
+*	HeadlessPlatform.h
+*	Lets the headless driver see and steer what the null Win32 layer is doing.
+*	The game asks Windows to quit, show message boxes and report the cursor.
+*	Here those requests are remembered so the driver can react to them.
+*/
+
+#ifndef HEADLESS_PLATFORM_H
+#define HEADLESS_PLATFORM_H
+
+class HeadlessPlatform
+{
+public:
+	// OutputDebugString is silent unless verbose output is switched on
+	static void SetVerbose(bool verbose);
+	static bool IsVerbose();
+
+	// PostQuitMessage just raises a flag the driver checks every frame
+	static bool IsQuitRequested();
+	static void ClearQuitRequest();
+
+	// How many message boxes the game has tried to show
+	static int GetMessageBoxCount();
+
+	// Seconds of wall clock time according to the performance counter
+	static double GetSeconds();
+};
+
+#endif
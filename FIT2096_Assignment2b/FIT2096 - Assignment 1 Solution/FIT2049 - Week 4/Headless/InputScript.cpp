@@ -0,0 +1,63 @@
+/*	FIT2096 - Assignment 2b
+*	InputScript.cpp
+*	Implementation of InputScript.h
+*/
+
+#include "InputScript.h"
+
+// Where Game::InitUI puts the Start button
+#define START_BUTTON_X 574
+#define START_BUTTON_Y 385
+
+static const UINT s_movementKeys[] = { 'W', 'D', 'S', 'A' };
+
+InputScript::InputScript(InputController* input)
+{
+	m_input = input;
+	m_framesPerLeg = 90;
+	m_turnPerFrame = 2;
+}
+
+void InputScript::Apply(int frame)
+{
+	// Menu. Park the cursor over Start, press, then release (buttons fire on release)
+	if (frame == 0)
+	{
+		SetCursorPos(START_BUTTON_X, START_BUTTON_Y);
+		return;
+	}
+	if (frame == 1)
+	{
+		m_input->SetMouseDown(LEFT_MOUSE);
+		return;
+	}
+	if (frame == 2)
+	{
+		m_input->SetMouseUp(LEFT_MOUSE);
+		return;
+	}
+
+	// The cursor has to stay on the button until the release has been seen, move it away now
+	if (frame == GetFirstGameplayFrame())
+	{
+		SetCursorPos(0, 0);
+	}
+
+	// Gameplay. Walk each side of a square, keep turning and keep shooting
+	int leg = ((frame - GetFirstGameplayFrame()) / m_framesPerLeg) % 4;
+	SetMovementKey(s_movementKeys[leg]);
+
+	m_input->SetMouseDeltaX(m_turnPerFrame);
+	m_input->SetMouseDown(LEFT_MOUSE);
+}
+
+void InputScript::SetMovementKey(UINT keyCode)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		if (s_movementKeys[i] == keyCode)
+			m_input->SetKeyDown(s_movementKeys[i]);
+		else
+			m_input->SetKeyUp(s_movementKeys[i]);
+	}
+}
@@ -0,0 +1,33 @@
+/*	FIT2096 - Assignment 2b
+*	InputScript.h
+*	Plays the part of the person at the keyboard for the headless build.
+*	It clicks Start on the menu, then walks a square while turning and holding
+*	the fire button. The same frame number always produces the same input.
+*/
+
+#ifndef INPUT_SCRIPT_H
+#define INPUT_SCRIPT_H
+
+#include "InputController.h"
+
+class InputScript
+{
+private:
+	InputController* m_input;
+
+	int m_framesPerLeg;		// How long we hold each movement key before switching to the next
+	int m_turnPerFrame;		// Mouse delta fed in every frame so the player slowly spins
+
+	void SetMovementKey(UINT keyCode);
+
+public:
+	InputScript(InputController* input);
+
+	// Push the input for this frame into the controller, call before Game::Update
+	void Apply(int frame);
+
+	// The first frame where the game is past the menu
+	int GetFirstGameplayFrame() { return 3; }
+};
+
+#endif
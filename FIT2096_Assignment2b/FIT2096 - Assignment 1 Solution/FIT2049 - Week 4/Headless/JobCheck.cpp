@@ -0,0 +1,209 @@
+/*	FIT2096 - Assignment 2b
+*	JobCheck.cpp
+*	Checks the JobSystem runs job graphs in the right order and doesn't lose any of them.
+*	Each round builds a random graph of jobs plus one job with a lot of dependents (fan out)
+*	and one with a lot of dependencies (fan in), then submits the lot and waits. Every job
+*	notes when it started and finished, so afterwards we can check each one started after
+*	everything it depended on had finished, and that each ran exactly once.
+*	The rounds together hand out more jobs than JOB_RING_SIZE, so the ring gets reused.
+*	It's all done again for every thread count from 1 up.
+*
+*	Usage: job_check [--threads N] [--rounds N] [--jobs N] [--fan N] [--seed N]
+*/
+
+#include "JobSystem.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+struct CheckOptions
+{
+	int threads;
+	int rounds;
+	int jobs;
+	int fan;
+	unsigned int seed;
+};
+
+// What one job did this round
+struct JobRecord
+{
+	std::atomic<int> runs;
+	int started;
+	int finished;
+	std::vector<int> dependencies;
+};
+
+static bool ParseOptions(int argc, char** argv, CheckOptions* options)
+{
+	options->threads = 4;
+	options->rounds = 20;
+	options->jobs = 500;
+	options->fan = 300;
+	options->seed = 2096;
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--threads") == 0 && hasValue)
+			options->threads = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--rounds") == 0 && hasValue)
+			options->rounds = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--jobs") == 0 && hasValue)
+			options->jobs = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--fan") == 0 && hasValue)
+			options->fan = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--seed") == 0 && hasValue)
+			options->seed = (unsigned int)strtoul(argv[++i], NULL, 10);
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	// Everything in a round is unfinished at once, so it all has to fit in the ring
+	return options->threads > 0 && options->rounds > 0 && options->jobs > 0 && options->fan > 0 &&
+		options->jobs + options->fan + 2 <= JOB_RING_SIZE;
+}
+
+// Builds one round's graph, runs it and checks it. Returns the number of problems found.
+static int RunRound(JobSystem* jobs, const CheckOptions& options, std::mt19937* random)
+{
+	int jobCount = options.jobs + options.fan + 2;
+	std::vector<JobRecord> records(jobCount);
+
+	// Random dependencies on earlier jobs, so it's always a graph that can finish
+	std::uniform_int_distribution<int> dependencyCount(0, 4);
+	for (int i = 1; i < options.jobs; i++)
+	{
+		int count = dependencyCount(*random);
+		for (int d = 0; d < count; d++)
+		{
+			records[i].dependencies.push_back(std::uniform_int_distribution<int>(0, i - 1)(*random));
+		}
+	}
+
+	// One job everyone in the fan out waits on, and one job that waits on all of them
+	int fanOutRoot = options.jobs;
+	int fanInJoin = fanOutRoot + options.fan + 1;
+	for (int i = 0; i < options.fan; i++)
+	{
+		records[fanOutRoot + 1 + i].dependencies.push_back(fanOutRoot);
+		records[fanInJoin].dependencies.push_back(fanOutRoot + 1 + i);
+	}
+
+	std::atomic<int> clock(0);
+	JobCounter counter;
+	std::vector<Job*> created(jobCount);
+
+	for (int i = 0; i < jobCount; i++)
+	{
+		JobRecord* record = &records[i];
+		record->runs = 0;
+		record->started = -1;
+		record->finished = -1;
+
+		created[i] = jobs->CreateJob([record, &clock]()
+		{
+			record->started = clock++;
+			record->runs++;
+			record->finished = clock++;
+		}, &counter);
+	}
+
+	// Every dependency goes in before anything is submitted, as AddDependency asks
+	for (int i = 0; i < jobCount; i++)
+	{
+		for (unsigned int d = 0; d < records[i].dependencies.size(); d++)
+		{
+			jobs->AddDependency(created[i], created[records[i].dependencies[d]]);
+		}
+	}
+
+	for (int i = 0; i < jobCount; i++)
+	{
+		jobs->Submit(created[i]);
+	}
+
+	jobs->Wait(&counter);
+
+	int problems = 0;
+
+	for (int i = 0; i < jobCount; i++)
+	{
+		const JobRecord& record = records[i];
+
+		if (record.runs != 1)
+		{
+			fprintf(stderr, "  job %d ran %d times\n", i, (int)record.runs);
+			problems++;
+			continue;
+		}
+
+		for (unsigned int d = 0; d < record.dependencies.size(); d++)
+		{
+			const JobRecord& dependency = records[record.dependencies[d]];
+
+			if (record.started < dependency.finished)
+			{
+				fprintf(stderr, "  job %d started at %d, before job %d finished at %d\n", i, record.started,
+					record.dependencies[d], dependency.finished);
+				problems++;
+			}
+		}
+	}
+
+	if (counter.count != 0)
+	{
+		fprintf(stderr, "  counter finished on %d\n", (int)counter.count);
+		problems++;
+	}
+
+	return problems;
+}
+
+int main(int argc, char** argv)
+{
+	CheckOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--threads N] [--rounds N] [--jobs N] [--fan N] [--seed N]\n", argv[0]);
+		return 1;
+	}
+
+	printf("Job graph check (%d rounds of %d jobs, fan out and in of %d)\n", options.rounds,
+		options.jobs + options.fan + 2, options.fan);
+
+	int totalProblems = 0;
+
+	for (int threads = 1; threads <= options.threads; threads++)
+	{
+		// Same graphs for every thread count
+		std::mt19937 random(options.seed);
+		JobSystem jobs(threads);
+		int problems = 0;
+
+		for (int round = 0; round < options.rounds; round++)
+		{
+			problems += RunRound(&jobs, options, &random);
+		}
+
+		printf("  %2d threads      %s\n", threads, problems == 0 ? "ok" : "FAILED");
+		totalProblems += problems;
+	}
+
+	if (totalProblems > 0)
+	{
+		fprintf(stderr, "%d jobs ran out of order or not exactly once\n", totalProblems);
+		return 1;
+	}
+
+	return 0;
+}
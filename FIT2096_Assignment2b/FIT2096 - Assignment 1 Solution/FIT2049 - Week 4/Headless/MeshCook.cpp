@@ -0,0 +1,243 @@
+/*	FIT2096 - Assignment 2b
+*	MeshCook.cpp
+*	Offline converter from OBJ to the cooked mesh format in CookedMesh.h.
+*	With no files given it cooks every .obj in Assets/Meshes, skipping any whose .mesh is already
+*	newer. Each cooked file is read back through the same mapped path the game uses and checked
+*	against what was written, and the time to load it both ways is printed along with how much
+*	precision packing the vertices cost.
+*
+*	Usage: meshcook [--force] [--dir folder] [file.obj ...]
+*/
+
+#include "CookedMesh.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+
+using namespace std;
+
+struct CookOptions
+{
+	bool force;
+	const char* folder;
+	vector<string> files;
+};
+
+static bool ParseOptions(int argc, char** argv, CookOptions* options)
+{
+	options->force = false;
+	options->folder = "Assets/Meshes";
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--force") == 0)
+			options->force = true;
+		else if (strcmp(argv[i], "--dir") == 0 && hasValue)
+			options->folder = argv[++i];
+		else if (argv[i][0] != '-')
+			options->files.push_back(argv[i]);
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool EndsWith(const string& text, const char* suffix)
+{
+	size_t length = strlen(suffix);
+	return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// Every .obj directly inside the folder, sorted so the output is always in the same order
+static bool FindObjFiles(const char* folder, vector<string>* files)
+{
+	DIR* directory = opendir(folder);
+	if (!directory)
+		return false;
+
+	struct dirent* entry;
+	while ((entry = readdir(directory)) != NULL)
+	{
+		string name = entry->d_name;
+		if (EndsWith(name, ".obj"))
+			files->push_back(string(folder) + "/" + name);
+	}
+
+	closedir(directory);
+	sort(files->begin(), files->end());
+	return true;
+}
+
+// Reads the file back the way Mesh::Read does and makes sure every byte is what we meant to write
+static bool CheckCookedFile(const char* filename, CookedMesh* cooked, double* loadSeconds)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	MappedFile file;
+	if (!file.Open(filename))
+		return false;
+
+	const CookedMeshHeader* header = CookedMesh::Validate(file.GetData(), file.GetSize());
+	if (!header)
+		return false;
+
+	// Stand in for the buffer upload by copying everything out once
+	vector<char> upload(file.GetData() + header->vertexOffset, file.GetData() + file.GetSize());
+	*loadSeconds = SecondsSince(start);
+
+	if (header->vertexCount != cooked->vertices.size() || header->indexCount != cooked->indices.size())
+		return false;
+
+	vector<unsigned char> packed(header->vertexCount * header->vertexStride);
+	VertexFormat::Pack(MESH_VERTEX_FORMAT, &cooked->vertices[0], header->vertexCount, &packed[0]);
+
+	if (memcmp(file.GetData() + header->vertexOffset, &packed[0], packed.size()) != 0)
+		return false;
+
+	const char* indexData = file.GetData() + header->indexOffset;
+	for (unsigned int i = 0; i < header->indexCount; i++)
+	{
+		unsigned long index;
+
+		if (header->indexSize == 2)
+		{
+			unsigned short shortIndex;
+			memcpy(&shortIndex, indexData + i * 2, 2);
+			index = shortIndex;
+		}
+		else
+		{
+			unsigned int longIndex;
+			memcpy(&longIndex, indexData + i * 4, 4);
+			index = longIndex;
+		}
+
+		if (index != cooked->indices[i])
+			return false;
+	}
+
+	return header->radius == cooked->radius;
+}
+
+// How far the packed normals and uvs ended up from the originals. Normals are compared as an angle.
+static void MeasurePackingError(CookedMesh* cooked, float* normalDegrees, float* uvError)
+{
+	vector<unsigned char> packed(cooked->vertices.size() * VertexFormat::GetStride(MESH_VERTEX_FORMAT));
+	VertexFormat::Pack(MESH_VERTEX_FORMAT, &cooked->vertices[0], (int)cooked->vertices.size(), &packed[0]);
+
+	*normalDegrees = 0.0f;
+	*uvError = 0.0f;
+
+	for (unsigned int i = 0; i < cooked->vertices.size(); i++)
+	{
+		MeshVertex unpacked;
+		VertexFormat::Unpack(MESH_VERTEX_FORMAT, &packed[0], i, &unpacked);
+
+		Vector3 original = cooked->vertices[i].normal;
+		if (original.LengthSquared() > 0.0f)
+		{
+			original.Normalize();
+			unpacked.normal.Normalize();
+
+			float cosine = original.Dot(unpacked.normal);
+			cosine = cosine > 1.0f ? 1.0f : (cosine < -1.0f ? -1.0f : cosine);
+			*normalDegrees = max(*normalDegrees, acosf(cosine) * 57.2957795f);
+		}
+
+		Vector2 uvDifference = unpacked.texCoord - cooked->vertices[i].texCoord;
+		*uvError = max(*uvError, max(fabsf(uvDifference.x), fabsf(uvDifference.y)));
+	}
+}
+
+int main(int argc, char** argv)
+{
+	CookOptions options;
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--force] [--dir folder] [file.obj ...]\n", argv[0]);
+		return 1;
+	}
+
+	if (options.files.empty() && !FindObjFiles(options.folder, &options.files))
+	{
+		fprintf(stderr, "Could not read %s\n", options.folder);
+		return 1;
+	}
+
+	int cookedCount = 0;
+	int skippedCount = 0;
+	int failedCount = 0;
+
+	for (unsigned int i = 0; i < options.files.size(); i++)
+	{
+		const char* source = options.files[i].c_str();
+		string target = CookedMesh::GetCookedFilename(source);
+
+		if (!options.force && CookedMesh::IsUpToDate(source, target.c_str()))
+		{
+			printf("  %-32s up to date\n", target.c_str());
+			skippedCount++;
+			continue;
+		}
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+		CookedMesh cooked;
+		if (!CookedMesh::CookObj(source, &cooked))
+		{
+			fprintf(stderr, "  %-32s could not be read\n", source);
+			failedCount++;
+			continue;
+		}
+
+		double cookSeconds = SecondsSince(start);
+		double loadSeconds = 0.0;
+
+		if (!cooked.Save(target.c_str()) || !CheckCookedFile(target.c_str(), &cooked, &loadSeconds))
+		{
+			fprintf(stderr, "  %-32s could not be written\n", target.c_str());
+			remove(target.c_str());
+			failedCount++;
+			continue;
+		}
+
+		MappedFile sourceFile;
+		MappedFile targetFile;
+		sourceFile.Open(source);
+		targetFile.Open(target.c_str());
+
+		float normalDegrees;
+		float uvError;
+		MeasurePackingError(&cooked, &normalDegrees, &uvError);
+
+		printf("  %-32s %6d triangles, %6d vertices, %2d bit indices, %7.1f KB -> %6.1f KB, load %7.3f ms -> %6.3f ms\n",
+			target.c_str(), (int)cooked.indices.size() / 3, (int)cooked.vertices.size(), cooked.vertices.size() <= 0xffff ? 16 : 32,
+			sourceFile.GetSize() / 1024.0, targetFile.GetSize() / 1024.0, cookSeconds * 1000.0, loadSeconds * 1000.0);
+		printf("  %-32s %s vertices %d bytes (standard %d), normals within %.3f degrees, uvs within %.5f\n", "",
+			VertexFormat::GetName(MESH_VERTEX_FORMAT), VertexFormat::GetStride(MESH_VERTEX_FORMAT),
+			VertexFormat::GetStride(VERTEX_FORMAT_STANDARD), normalDegrees, uvError);
+		cookedCount++;
+	}
+
+	printf("%d cooked, %d up to date, %d failed\n", cookedCount, skippedCount, failedCount);
+	return failedCount > 0 ? 1 : 0;
+}
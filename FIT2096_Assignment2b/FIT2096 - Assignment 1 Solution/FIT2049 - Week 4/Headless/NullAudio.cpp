@@ -0,0 +1,91 @@
+/*	FIT2096 - Assignment 2b
+*	NullAudio.cpp
+*	Replaces AudioSystem.cpp and AudioClip.cpp in the headless build.
+*	Sounds are "loaded" if the file exists (or the asset pack has it) but nothing is ever
+*	played, so Play always hands back NULL (the game already copes with that).
+*/
+
+#include "AudioSystem.h"
+#include <fstream>
+
+AudioSystem::AudioSystem()
+{
+	m_audioEngine = NULL;
+	m_assetPack = NULL;
+}
+
+bool AudioSystem::Initialise()
+{
+	return true;
+}
+
+bool AudioSystem::Load(const char* filepath)
+{
+	FMOD::Sound* sound;
+	if (!OpenSound(filepath, false, &sound))
+		return false;
+
+	AddSound(filepath, sound);
+	return true;
+}
+
+bool AudioSystem::LoadStream(const char* filepath)
+{
+	return Load(filepath);
+}
+
+bool AudioSystem::OpenSound(const char* filepath, bool stream, FMOD::Sound** sound)
+{
+	*sound = NULL;
+
+	if (m_assetPack && m_assetPack->IsOpen() && m_assetPack->Contains(filepath))
+		return true;
+
+	std::ifstream file(filepath);
+	return file.good();
+}
+
+void AudioSystem::AddSound(const char* filepath, FMOD::Sound* sound)
+{
+	m_audioMap[filepath] = sound;
+}
+
+AudioClip* AudioSystem::Play(const char* filepath, bool startPaused)
+{
+	return NULL;
+}
+
+void AudioSystem::Update()
+{
+
+}
+
+bool AudioSystem::SetListener3DAttributes(const Vector3& pos, const Vector3& forward, const Vector3& up, const Vector3& velocity)
+{
+	return true;
+}
+
+void AudioSystem::Shutdown()
+{
+	m_audioMap.clear();
+}
+
+bool AudioSystem::ReleaseSound(const char* filepath)
+{
+	return m_audioMap.erase(filepath) > 0;
+}
+
+AudioClip::AudioClip(FMOD::Channel* channel)
+{
+	m_channel = channel;
+}
+
+void AudioClip::Stop() {}
+void AudioClip::SetVolume(float volume) {}
+void AudioClip::SetMute(bool mute) {}
+void AudioClip::SetPaused(bool paused) {}
+void AudioClip::SetLoopCount(int loopCount) {}
+void AudioClip::SetPan(float pan) {}
+void AudioClip::SetIs3D(bool is3D) {}
+bool AudioClip::Set3DAttributes(const Vector3& pos, const Vector3& velocity) { return true; }
+void AudioClip::SetMinMaxDistance(float min, float max) {}
@@ -0,0 +1,257 @@
+/*	FIT2096 - Assignment 2b
+*	NullDirect3D.cpp
+*	Replaces Direct3D.cpp in the headless build. The renderer creates a null
+*	device and context and otherwise behaves exactly like the real one so the
+*	rest of the engine never knows the difference.
+*	Also home to the null shader compiler.
+*/
+
+#include "Direct3D.h"
+#include <d3dcompiler.h>
+#include <fstream>
+#include <string>
+
+Direct3D::Direct3D()
+{
+	m_vsync = false;
+	m_swapChain = NULL;
+	m_device = NULL;
+	m_deviceContext = NULL;
+	m_renderTargetView = NULL;
+	m_depthStencilBuffer = NULL;
+	m_depthStencilState = NULL;
+	m_depthStencilView = NULL;
+	m_rasterState = NULL;
+	m_interpolation = 1.0f;
+	m_currentShader = NULL;
+}
+
+Direct3D::~Direct3D()
+{
+
+}
+
+bool Direct3D::Initialise(int width, int height, HWND windowHandle, bool fullscreen, bool vsync)
+{
+	m_vsync = vsync;
+	m_videoCardMemory = 0;
+	m_videoCardDescription = "Null Device";
+
+	m_swapChain = new IDXGISwapChain();
+	m_device = new ID3D11Device();
+	m_deviceContext = new ID3D11DeviceContext();
+
+	// The back buffer is just another texture as far as the null device is concerned
+	D3D11_TEXTURE2D_DESC backBufferDescription;
+	memset(&backBufferDescription, 0, sizeof(backBufferDescription));
+	backBufferDescription.Width = width;
+	backBufferDescription.Height = height;
+	backBufferDescription.MipLevels = 1;
+	backBufferDescription.ArraySize = 1;
+	backBufferDescription.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	backBufferDescription.SampleDesc.Count = 1;
+	backBufferDescription.BindFlags = D3D11_BIND_RENDER_TARGET;
+
+	ID3D11Texture2D* backBuffer;
+	if (FAILED(m_device->CreateTexture2D(&backBufferDescription, NULL, &backBuffer)))
+		return false;
+
+	if (FAILED(m_device->CreateRenderTargetView(backBuffer, NULL, &m_renderTargetView)))
+		return false;
+
+	backBuffer->Release();
+	backBuffer = NULL;
+
+	if (!InitDepthBuffer(width, height))
+		return false;
+
+	if (!InitDepthStencil())
+		return false;
+
+	if (!InitRasteriser())
+		return false;
+
+	InitViewport(width, height);
+
+	return true;
+}
+
+bool Direct3D::InitDepthBuffer(int width, int height)
+{
+	D3D11_TEXTURE2D_DESC depthBufferDescription;
+	memset(&depthBufferDescription, 0, sizeof(depthBufferDescription));
+
+	depthBufferDescription.Width = width;
+	depthBufferDescription.Height = height;
+	depthBufferDescription.MipLevels = 1;
+	depthBufferDescription.ArraySize = 1;
+	depthBufferDescription.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthBufferDescription.SampleDesc.Count = 1;
+	depthBufferDescription.Usage = D3D11_USAGE_DEFAULT;
+	depthBufferDescription.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+
+	if (FAILED(m_device->CreateTexture2D(&depthBufferDescription, NULL, &m_depthStencilBuffer)))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool Direct3D::InitDepthStencil()
+{
+	D3D11_DEPTH_STENCIL_DESC depthStencilDescription;
+	memset(&depthStencilDescription, 0, sizeof(depthStencilDescription));
+
+	if (FAILED(m_device->CreateDepthStencilState(&depthStencilDescription, &m_depthStencilState)))
+	{
+		return false;
+	}
+
+	m_deviceContext->OMSetDepthStencilState(m_depthStencilState, 1);
+
+	D3D11_DEPTH_STENCIL_VIEW_DESC depthStencilViewDescription;
+	memset(&depthStencilViewDescription, 0, sizeof(depthStencilViewDescription));
+	depthStencilViewDescription.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+	depthStencilViewDescription.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2D;
+
+	if (FAILED(m_device->CreateDepthStencilView(m_depthStencilBuffer, &depthStencilViewDescription, &m_depthStencilView)))
+	{
+		return false;
+	}
+
+	m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
+
+	return true;
+}
+
+bool Direct3D::InitRasteriser()
+{
+	D3D11_RASTERIZER_DESC rasterDescription;
+	memset(&rasterDescription, 0, sizeof(rasterDescription));
+	rasterDescription.CullMode = D3D11_CULL_BACK;
+	rasterDescription.FillMode = D3D11_FILL_SOLID;
+	rasterDescription.DepthClipEnable = true;
+
+	if (FAILED(m_device->CreateRasterizerState(&rasterDescription, &m_rasterState)))
+	{
+		return false;
+	}
+
+	m_deviceContext->RSSetState(m_rasterState);
+
+	return true;
+}
+
+void Direct3D::InitViewport(int width, int height)
+{
+	D3D11_VIEWPORT viewport;
+	viewport.Width = (float)width;
+	viewport.Height = (float)height;
+	viewport.MinDepth = 0.0f;
+	viewport.MaxDepth = 1.0f;
+	viewport.TopLeftX = 0.0f;
+	viewport.TopLeftY = 0.0f;
+
+	m_deviceContext->RSSetViewports(1, &viewport);
+}
+
+void Direct3D::Shutdown()
+{
+	if (m_rasterState)
+	{
+		m_rasterState->Release();
+		m_rasterState = 0;
+	}
+
+	if (m_depthStencilView)
+	{
+		m_depthStencilView->Release();
+		m_depthStencilView = 0;
+	}
+
+	if (m_depthStencilState)
+	{
+		m_depthStencilState->Release();
+		m_depthStencilState = 0;
+	}
+
+	if (m_depthStencilBuffer)
+	{
+		m_depthStencilBuffer->Release();
+		m_depthStencilBuffer = 0;
+	}
+
+	if (m_renderTargetView)
+	{
+		m_renderTargetView->Release();
+		m_renderTargetView = 0;
+	}
+
+	if (m_deviceContext)
+	{
+		m_deviceContext->Release();
+		m_deviceContext = 0;
+	}
+
+	if (m_device)
+	{
+		m_device->Release();
+		m_device = 0;
+	}
+
+	if (m_swapChain)
+	{
+		m_swapChain->Release();
+		m_swapChain = 0;
+	}
+}
+
+void Direct3D::BeginScene(float red, float green, float blue, float alpha)
+{
+	float colour[4];
+	colour[0] = red;
+	colour[1] = green;
+	colour[2] = blue;
+	colour[3] = alpha;
+
+	m_deviceContext->OMSetBlendState(NULL, NULL, 0xFFFFFFFF);
+	m_deviceContext->OMSetDepthStencilState(m_depthStencilState, 0);
+	m_deviceContext->RSSetState(m_rasterState);
+	m_deviceContext->OMSetRenderTargets(1, &m_renderTargetView, m_depthStencilView);
+
+	m_deviceContext->ClearRenderTargetView(m_renderTargetView, colour);
+	m_deviceContext->ClearDepthStencilView(m_depthStencilView, D3D11_CLEAR_DEPTH, 1.0f, 0);
+}
+
+void Direct3D::EndScene()
+{
+	m_swapChain->Present(m_vsync ? 1 : 0, 0);
+}
+
+HRESULT D3DCompileFromFile(LPCWSTR fileName, const D3D_SHADER_MACRO* defines, ID3DInclude* include,
+	LPCSTR entryPoint, LPCSTR target, UINT flags1, UINT flags2, ID3DBlob** code, ID3DBlob** errorMessages)
+{
+	// We can't compile HLSL but we can at least make sure the file is where the game expects it
+	std::wstring wideName = fileName;
+	std::string narrowName(wideName.begin(), wideName.end());
+
+	std::ifstream source(narrowName.c_str());
+	if (!source.good())
+	{
+		if (errorMessages)
+		{
+			std::string message = "Shader source not found: " + narrowName + "\n";
+			*errorMessages = new ID3DBlob(message.size() + 1);
+			memcpy((*errorMessages)->GetBufferPointer(), message.c_str(), message.size() + 1);
+		}
+		return E_FAIL;
+	}
+
+	*code = new ID3DBlob(16);
+	if (errorMessages)
+	{
+		*errorMessages = NULL;
+	}
+	return S_OK;
+}
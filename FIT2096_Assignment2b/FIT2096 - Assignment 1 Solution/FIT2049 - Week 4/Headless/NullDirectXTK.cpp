@@ -0,0 +1,131 @@
+/*	FIT2096 - Assignment 2b
+*	NullDirectXTK.cpp
+*	The headless build doesn't link DirectXTK. These are the pieces of it the
+*	game touches: sprite batches and fonts that draw nothing, a states object
+*	with no states, and a texture loader that only checks the file exists
+*	(or that it was given some data).
+*/
+
+#include <d3d11.h>
+#include "DirectXTK/SpriteBatch.h"
+#include "DirectXTK/SpriteFont.h"
+#include "DirectXTK/CommonStates.h"
+#include "DirectXTK/WICTextureLoader.h"
+
+#include <fstream>
+#include <string>
+
+using namespace DirectX;
+
+// SpriteBatch and SpriteFont hold their state behind a pImpl, ours is empty
+class SpriteBatch::Impl
+{
+};
+
+class SpriteFont::Impl
+{
+};
+
+class CommonStates::Impl
+{
+};
+
+const XMMATRIX SpriteBatch::MatrixIdentity = XMMatrixIdentity();
+const XMFLOAT2 SpriteBatch::Float2Zero(0, 0);
+const XMFLOAT2 SpriteFont::Float2Zero(0, 0);
+
+SpriteBatch::SpriteBatch(ID3D11DeviceContext* deviceContext) : pImpl(new Impl()) {}
+SpriteBatch::~SpriteBatch() {}
+
+void XM_CALLCONV SpriteBatch::Begin(SpriteSortMode sortMode, ID3D11BlendState* blendState, ID3D11SamplerState* samplerState, ID3D11DepthStencilState* depthStencilState, ID3D11RasterizerState* rasterizerState,
+	std::function<void __cdecl()> setCustomShaders, FXMMATRIX transformMatrix) {}
+void __cdecl SpriteBatch::End() {}
+
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, XMFLOAT2 const& position, FXMVECTOR color) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, XMFLOAT2 const& position, RECT const* sourceRectangle, FXMVECTOR color, float rotation, XMFLOAT2 const& origin, float scale, SpriteEffects effects, float layerDepth) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, XMFLOAT2 const& position, RECT const* sourceRectangle, FXMVECTOR color, float rotation, XMFLOAT2 const& origin, XMFLOAT2 const& scale, SpriteEffects effects, float layerDepth) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, FXMVECTOR position, FXMVECTOR color) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, FXMVECTOR position, RECT const* sourceRectangle, FXMVECTOR color, float rotation, FXMVECTOR origin, float scale, SpriteEffects effects, float layerDepth) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, FXMVECTOR position, RECT const* sourceRectangle, FXMVECTOR color, float rotation, FXMVECTOR origin, GXMVECTOR scale, SpriteEffects effects, float layerDepth) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, RECT const& destinationRectangle, FXMVECTOR color) {}
+void XM_CALLCONV SpriteBatch::Draw(ID3D11ShaderResourceView* texture, RECT const& destinationRectangle, RECT const* sourceRectangle, FXMVECTOR color, float rotation, XMFLOAT2 const& origin, SpriteEffects effects, float layerDepth) {}
+
+SpriteFont::SpriteFont(ID3D11Device* device, wchar_t const* fileName) : pImpl(new Impl()) {}
+SpriteFont::SpriteFont(ID3D11Device* device, uint8_t const* dataBlob, size_t dataSize) : pImpl(new Impl()) {}
+SpriteFont::~SpriteFont() {}
+
+void XM_CALLCONV SpriteFont::DrawString(SpriteBatch* spriteBatch, wchar_t const* text, XMFLOAT2 const& position, FXMVECTOR color, float rotation, XMFLOAT2 const& origin, float scale, SpriteEffects effects, float layerDepth) const {}
+void XM_CALLCONV SpriteFont::DrawString(SpriteBatch* spriteBatch, wchar_t const* text, XMFLOAT2 const& position, FXMVECTOR color, float rotation, XMFLOAT2 const& origin, XMFLOAT2 const& scale, SpriteEffects effects, float layerDepth) const {}
+void XM_CALLCONV SpriteFont::DrawString(SpriteBatch* spriteBatch, wchar_t const* text, FXMVECTOR position, FXMVECTOR color, float rotation, FXMVECTOR origin, float scale, SpriteEffects effects, float layerDepth) const {}
+void XM_CALLCONV SpriteFont::DrawString(SpriteBatch* spriteBatch, wchar_t const* text, FXMVECTOR position, FXMVECTOR color, float rotation, FXMVECTOR origin, GXMVECTOR scale, SpriteEffects effects, float layerDepth) const {}
+
+XMVECTOR XM_CALLCONV SpriteFont::MeasureString(wchar_t const* text) const
+{
+	// Pretend every glyph is 8x16 so buttons can still centre their labels
+	size_t length = text ? wcslen(text) : 0;
+	return XMVectorSet(8.0f * length, 16.0f, 0.0f, 0.0f);
+}
+
+CommonStates::CommonStates(ID3D11Device* device) : pImpl(new Impl()) {}
+CommonStates::~CommonStates() {}
+
+ID3D11BlendState* __cdecl CommonStates::Opaque() const { return NULL; }
+ID3D11BlendState* __cdecl CommonStates::AlphaBlend() const { return NULL; }
+ID3D11BlendState* __cdecl CommonStates::Additive() const { return NULL; }
+ID3D11BlendState* __cdecl CommonStates::NonPremultiplied() const { return NULL; }
+
+// A 1x1 stand in, the headless build never samples it
+static HRESULT CreateStandInTexture(ID3D11Device* d3dDevice, ID3D11Resource** texture, ID3D11ShaderResourceView** textureView)
+{
+	D3D11_TEXTURE2D_DESC description;
+	memset(&description, 0, sizeof(description));
+	description.Width = 1;
+	description.Height = 1;
+	description.MipLevels = 1;
+	description.ArraySize = 1;
+	description.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	description.SampleDesc.Count = 1;
+	description.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	ID3D11Texture2D* texture2D = NULL;
+	if (FAILED(d3dDevice->CreateTexture2D(&description, NULL, &texture2D)))
+		return E_FAIL;
+
+	if (textureView)
+	{
+		d3dDevice->CreateShaderResourceView(texture2D, NULL, textureView);
+	}
+
+	if (texture)
+	{
+		*texture = texture2D;
+	}
+	else
+	{
+		texture2D->Release();
+	}
+
+	return S_OK;
+}
+
+HRESULT __cdecl DirectX::CreateWICTextureFromFile(ID3D11Device* d3dDevice, const wchar_t* szFileName,
+	ID3D11Resource** texture, ID3D11ShaderResourceView** textureView, size_t maxsize)
+{
+	std::wstring wideName = szFileName;
+	std::string narrowName(wideName.begin(), wideName.end());
+
+	std::ifstream file(narrowName.c_str(), std::ios::binary);
+	if (!file.good())
+		return E_FAIL;
+
+	return CreateStandInTexture(d3dDevice, texture, textureView);
+}
+
+HRESULT __cdecl DirectX::CreateWICTextureFromMemory(ID3D11Device* d3dDevice, const uint8_t* wicData, size_t wicDataSize,
+	ID3D11Resource** texture, ID3D11ShaderResourceView** textureView, size_t maxsize)
+{
+	if (!wicData || wicDataSize == 0)
+		return E_FAIL;
+
+	return CreateStandInTexture(d3dDevice, texture, textureView);
+}
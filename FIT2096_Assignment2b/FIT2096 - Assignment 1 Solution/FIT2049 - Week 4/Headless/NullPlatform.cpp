@@ -0,0 +1,287 @@
+/*	FIT2096 - Assignment 2b
+*	NullPlatform.cpp
+*	Implementation of the Win32 calls declared in Platform/Windows.h and of HeadlessPlatform.h
+*/
+
+#include <Windows.h>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <map>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "HeadlessPlatform.h"
+
+static bool s_verbose = false;
+static bool s_quitRequested = false;
+static int s_messageBoxCount = 0;
+static POINT s_cursor = { 0, 0 };
+
+void HeadlessPlatform::SetVerbose(bool verbose)
+{
+	s_verbose = verbose;
+}
+
+bool HeadlessPlatform::IsVerbose()
+{
+	return s_verbose;
+}
+
+bool HeadlessPlatform::IsQuitRequested()
+{
+	return s_quitRequested;
+}
+
+void HeadlessPlatform::ClearQuitRequest()
+{
+	s_quitRequested = false;
+}
+
+int HeadlessPlatform::GetMessageBoxCount()
+{
+	return s_messageBoxCount;
+}
+
+double HeadlessPlatform::GetSeconds()
+{
+	LARGE_INTEGER count;
+	LARGE_INTEGER frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return (double)count.QuadPart / (double)frequency.QuadPart;
+}
+
+void OutputDebugString(LPCSTR message)
+{
+	if (s_verbose && message)
+	{
+		fputs(message, stderr);
+	}
+}
+
+int MessageBox(HWND window, LPCSTR text, LPCSTR caption, UINT type)
+{
+	// There's nobody to click OK so just print it. The game keeps asking once it's over, only say it once.
+	s_messageBoxCount++;
+	if (s_messageBoxCount == 1 || s_verbose)
+	{
+		printf("[%s] %s\n", caption ? caption : "", text ? text : "");
+	}
+	return 1;
+}
+
+void PostQuitMessage(int exitCode)
+{
+	s_quitRequested = true;
+}
+
+BOOL GetCursorPos(POINT* point)
+{
+	*point = s_cursor;
+	return 1;
+}
+
+BOOL SetCursorPos(int x, int y)
+{
+	s_cursor.x = x;
+	s_cursor.y = y;
+	return 1;
+}
+
+BOOL ScreenToClient(HWND window, POINT* point)
+{
+	// There is no window border, screen and client space are the same thing
+	return 1;
+}
+
+BOOL RegisterRawInputDevices(const RAWINPUTDEVICE* devices, UINT numDevices, UINT size)
+{
+	return 1;
+}
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count)
+{
+	count->QuadPart = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	return 1;
+}
+
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency)
+{
+	// The counter above ticks in nanoseconds
+	frequency->QuadPart = 1000000000LL;
+	return 1;
+}
+
+HRESULT CoInitializeEx(LPVOID reserved, DWORD coInit)
+{
+	return S_OK;
+}
+
+void CoUninitialize()
+{
+}
+
+// CreateFileA and CreateFileMappingA both hand out one of these. A mapping keeps its own
+// copy of the descriptor so it outlives the file handle, the same as on Windows.
+struct NullFileHandle
+{
+	int descriptor;
+	bool isMapping;
+};
+
+// munmap needs the length, UnmapViewOfFile only gets the address
+static std::mutex s_viewLock;
+static std::map<const void*, std::size_t> s_viewLengths;
+
+HANDLE CreateFileA(LPCSTR fileName, DWORD access, DWORD shareMode, LPSECURITY_ATTRIBUTES security, DWORD creation, DWORD flags, HANDLE templateFile)
+{
+	// Only reading existing files is supported
+	if (creation != OPEN_EXISTING || (access & ~GENERIC_READ) != 0)
+		return INVALID_HANDLE_VALUE;
+
+	int descriptor = open(fileName, O_RDONLY);
+	if (descriptor < 0)
+		return INVALID_HANDLE_VALUE;
+
+	NullFileHandle* handle = new NullFileHandle();
+	handle->descriptor = descriptor;
+	handle->isMapping = false;
+	return handle;
+}
+
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size)
+{
+	struct stat status;
+	if (file == INVALID_HANDLE_VALUE || !file || fstat(((NullFileHandle*)file)->descriptor, &status) != 0)
+		return 0;
+
+	size->QuadPart = status.st_size;
+	return 1;
+}
+
+HANDLE CreateFileMappingA(HANDLE file, LPSECURITY_ATTRIBUTES security, DWORD protect, DWORD maximumSizeHigh, DWORD maximumSizeLow, LPCSTR name)
+{
+	// Like Windows, an empty file can't be mapped
+	LARGE_INTEGER size;
+	if (protect != PAGE_READONLY || !GetFileSizeEx(file, &size) || size.QuadPart == 0)
+		return NULL;
+
+	int descriptor = dup(((NullFileHandle*)file)->descriptor);
+	if (descriptor < 0)
+		return NULL;
+
+	NullFileHandle* handle = new NullFileHandle();
+	handle->descriptor = descriptor;
+	handle->isMapping = true;
+	return handle;
+}
+
+LPVOID MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T bytes)
+{
+	NullFileHandle* handle = (NullFileHandle*)mapping;
+	if (!handle || !handle->isMapping || access != FILE_MAP_READ)
+		return NULL;
+
+	long long offset = ((long long)offsetHigh << 32) | offsetLow;
+
+	// Zero means everything from the offset to the end
+	if (bytes == 0)
+	{
+		struct stat status;
+		if (fstat(handle->descriptor, &status) != 0 || status.st_size <= offset)
+			return NULL;
+
+		bytes = (SIZE_T)(status.st_size - offset);
+	}
+
+	void* view = mmap(NULL, bytes, PROT_READ, MAP_PRIVATE, handle->descriptor, (off_t)offset);
+	if (view == MAP_FAILED)
+		return NULL;
+
+	std::lock_guard<std::mutex> guard(s_viewLock);
+	s_viewLengths[view] = bytes;
+	return view;
+}
+
+BOOL UnmapViewOfFile(LPCVOID address)
+{
+	std::size_t length;
+	{
+		std::lock_guard<std::mutex> guard(s_viewLock);
+		std::map<const void*, std::size_t>::iterator view = s_viewLengths.find(address);
+		if (view == s_viewLengths.end())
+			return 0;
+
+		length = view->second;
+		s_viewLengths.erase(view);
+	}
+
+	return munmap((void*)address, length) == 0;
+}
+
+BOOL CloseHandle(HANDLE handle)
+{
+	if (handle == INVALID_HANDLE_VALUE || !handle)
+		return 0;
+
+	NullFileHandle* file = (NullFileHandle*)handle;
+	close(file->descriptor);
+	delete file;
+	return 1;
+}
+
+BOOL GetFileAttributesExA(LPCSTR fileName, GET_FILEEX_INFO_LEVELS infoLevel, LPVOID fileInformation)
+{
+	struct stat status;
+	if (infoLevel != GetFileExInfoStandard || stat(fileName, &status) != 0)
+		return 0;
+
+	// Unix time counts seconds from 1970, FILETIME counts 100ns ticks from 1601
+	unsigned long long ticks = ((unsigned long long)status.st_mtim.tv_sec + 11644473600ULL) * 10000000ULL + status.st_mtim.tv_nsec / 100;
+
+	WIN32_FILE_ATTRIBUTE_DATA* data = (WIN32_FILE_ATTRIBUTE_DATA*)fileInformation;
+	memset(data, 0, sizeof(WIN32_FILE_ATTRIBUTE_DATA));
+	data->dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+	data->ftLastWriteTime.dwLowDateTime = (DWORD)(ticks & 0xffffffffULL);
+	data->ftLastWriteTime.dwHighDateTime = (DWORD)(ticks >> 32);
+	data->nFileSizeLow = (DWORD)((unsigned long long)status.st_size & 0xffffffffULL);
+	data->nFileSizeHigh = (DWORD)((unsigned long long)status.st_size >> 32);
+	return 1;
+}
+
+LONG CompareFileTime(const FILETIME* first, const FILETIME* second)
+{
+	unsigned long long a = ((unsigned long long)first->dwHighDateTime << 32) | first->dwLowDateTime;
+	unsigned long long b = ((unsigned long long)second->dwHighDateTime << 32) | second->dwLowDateTime;
+
+	return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+int mbstowcs_s(std::size_t* converted, wchar_t* dest, std::size_t destSize, const char* source, std::size_t count)
+{
+	std::size_t maxChars = (count == _TRUNCATE || count >= destSize) ? destSize - 1 : count;
+	std::size_t written = mbstowcs(dest, source, maxChars);
+
+	if (written == (std::size_t)-1)
+	{
+		dest[0] = L'\0';
+		written = 0;
+	}
+	else
+	{
+		dest[written] = L'\0';
+	}
+
+	if (converted)
+	{
+		*converted = written + 1;
+	}
+	return 0;
+}
@@ -0,0 +1,408 @@
+/*	FIT2096 - Assignment 2b
+*	ObjBench.cpp
+*	Benchmark for ObjParser against the loader Mesh::Load used to have, which read the file
+*	twice through an ifstream: once char by char to count lines, then again with operator>>.
+*	Loads a real mesh from Assets over and over, then writes out a big synthetic grid mesh
+*	and loads that. Both loaders must produce the same triangles or the run fails.
+*	Also checks the parser copes with the things the old loader couldn't: quads and bigger
+*	faces, negative indices, and faces that leave out uvs or normals.
+*
+*	Usage: obj_bench [--file path] [--repeat N] [--triangles N] [--scratch path]
+*/
+
+#include "ObjParser.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+using namespace std;
+
+struct BenchOptions
+{
+	const char* file;
+	int repeat;
+	int triangles;
+	const char* scratch;
+};
+
+static bool ParseOptions(int argc, char** argv, BenchOptions* options)
+{
+	options->file = "Assets/Meshes/enemy.obj";
+	options->repeat = 200;
+	options->triangles = 1000000;
+	options->scratch = "obj_bench_synthetic.obj";
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--file") == 0 && hasValue)
+			options->file = argv[++i];
+		else if (strcmp(argv[i], "--repeat") == 0 && hasValue)
+			options->repeat = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--triangles") == 0 && hasValue)
+			options->triangles = atoi(argv[++i]);
+		else if (strcmp(argv[i], "--scratch") == 0 && hasValue)
+			options->scratch = argv[++i];
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return options->repeat > 0 && options->triangles >= 0;
+}
+
+static double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+// The parsing half of the old Mesh::Load, kept as it was so there's something to compare against.
+// Only understands triangles with all three of position/uv/normal.
+static bool LegacyLoad(const char* filename, ObjMeshData* data)
+{
+	struct Face
+	{
+		int vert1, uv1, normal1;
+		int vert2, uv2, normal2;
+		int vert3, uv3, normal3;
+	};
+
+	int vertexCount = 0;
+	int normalCount = 0;
+	int textureCount = 0;
+	int faceCount = 0;
+
+	ifstream fileIn;
+	fileIn.open(filename);
+
+	if (!fileIn.good())
+		return false;
+
+	char input;
+	while (!fileIn.eof())
+	{
+		fileIn.get(input);
+
+		if (input == 'v')
+		{
+			fileIn.get(input);
+			if (input == ' ') { vertexCount++; }
+			if (input == 't') { textureCount++; }
+			if (input == 'n') { normalCount++; }
+		}
+
+		if (input == 'f')
+		{
+			fileIn.get(input);
+			if (input == ' ') { faceCount++; }
+		}
+
+		while (input != '\n')
+		{
+			fileIn.get(input);
+		}
+	}
+	fileIn.close();
+
+	fileIn.open(filename);
+	if (!fileIn.good())
+		return false;
+
+	data->Clear();
+	data->positions.resize(vertexCount);
+	data->normals.resize(normalCount);
+	data->uvs.resize(textureCount);
+	Face* faces = new Face[faceCount];
+
+	int vertIndex = 0;
+	int normalIndex = 0;
+	int uvIndex = 0;
+	int faceIndex = 0;
+
+	while (!fileIn.eof())
+	{
+		fileIn.get(input);
+		if (input == 'v')
+		{
+			fileIn.get(input);
+
+			if (input == ' ')
+			{
+				fileIn >> data->positions[vertIndex].x >> data->positions[vertIndex].y >> data->positions[vertIndex].z;
+				vertIndex++;
+			}
+			if (input == 't')
+			{
+				fileIn >> data->uvs[uvIndex].x >> data->uvs[uvIndex].y;
+				data->uvs[uvIndex].y = -data->uvs[uvIndex].y;
+				uvIndex++;
+			}
+			if (input == 'n')
+			{
+				fileIn >> data->normals[normalIndex].x >> data->normals[normalIndex].y >> data->normals[normalIndex].z;
+				normalIndex++;
+			}
+		}
+		if (input == 'f')
+		{
+			char junk;
+			fileIn >> faces[faceIndex].vert1 >> junk >> faces[faceIndex].uv1 >> junk >> faces[faceIndex].normal1
+				>> faces[faceIndex].vert2 >> junk >> faces[faceIndex].uv2 >> junk >> faces[faceIndex].normal2
+				>> faces[faceIndex].vert3 >> junk >> faces[faceIndex].uv3 >> junk >> faces[faceIndex].normal3;
+			faceIndex++;
+		}
+
+		while (input != '\n')
+		{
+			fileIn.get(input);
+		}
+	}
+	fileIn.close();
+
+	for (int i = 0; i < faceCount; i++)
+	{
+		ObjCorner corner;
+		corner.position = faces[i].vert1 - 1; corner.uv = faces[i].uv1 - 1; corner.normal = faces[i].normal1 - 1;
+		data->corners.push_back(corner);
+		corner.position = faces[i].vert2 - 1; corner.uv = faces[i].uv2 - 1; corner.normal = faces[i].normal2 - 1;
+		data->corners.push_back(corner);
+		corner.position = faces[i].vert3 - 1; corner.uv = faces[i].uv3 - 1; corner.normal = faces[i].normal3 - 1;
+		data->corners.push_back(corner);
+	}
+
+	delete[] faces;
+	return true;
+}
+
+static bool NearlyEqual(float a, float b)
+{
+	return fabsf(a - b) <= 1e-6f * (1.0f + fabsf(a));
+}
+
+// Compares what each triangle corner ends up as rather than the raw arrays
+static bool SameMesh(ObjMeshData* a, ObjMeshData* b)
+{
+	if (a->corners.size() != b->corners.size())
+	{
+		fprintf(stderr, "Corner counts differ: %d and %d\n", (int)a->corners.size(), (int)b->corners.size());
+		return false;
+	}
+
+	for (unsigned int i = 0; i < a->corners.size(); i++)
+	{
+		Vector3 positionA = a->positions[a->corners[i].position];
+		Vector3 positionB = b->positions[b->corners[i].position];
+		Vector2 uvA = a->uvs[a->corners[i].uv];
+		Vector2 uvB = b->uvs[b->corners[i].uv];
+		Vector3 normalA = a->normals[a->corners[i].normal];
+		Vector3 normalB = b->normals[b->corners[i].normal];
+
+		if (!NearlyEqual(positionA.x, positionB.x) || !NearlyEqual(positionA.y, positionB.y) || !NearlyEqual(positionA.z, positionB.z) ||
+			!NearlyEqual(uvA.x, uvB.x) || !NearlyEqual(uvA.y, uvB.y) ||
+			!NearlyEqual(normalA.x, normalB.x) || !NearlyEqual(normalA.y, normalB.y) || !NearlyEqual(normalA.z, normalB.z))
+		{
+			fprintf(stderr, "Corner %d differs\n", i);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// A gently rolling grid with at least this many triangles, written the way exporters usually write them
+static bool WriteSyntheticMesh(const char* filename, int triangles)
+{
+	int side = (int)ceil(sqrt(triangles / 2.0));
+	if (side < 1)
+		side = 1;
+
+	FILE* file = fopen(filename, "w");
+	if (!file)
+		return false;
+
+	fprintf(file, "# Synthetic grid, %d x %d quads\no grid\n", side, side);
+
+	for (int z = 0; z <= side; z++)
+	{
+		for (int x = 0; x <= side; x++)
+		{
+			fprintf(file, "v %.6f %.6f %.6f\n", x * 0.1f, sinf(x * 0.05f) * cosf(z * 0.05f), z * 0.1f);
+		}
+	}
+
+	for (int z = 0; z <= side; z++)
+	{
+		for (int x = 0; x <= side; x++)
+		{
+			fprintf(file, "vt %.6f %.6f\n", (float)x / side, (float)z / side);
+		}
+	}
+
+	fprintf(file, "vn 0.000000 1.000000 0.000000\n");
+
+	for (int z = 0; z < side; z++)
+	{
+		for (int x = 0; x < side; x++)
+		{
+			int a = z * (side + 1) + x + 1;
+			int b = a + 1;
+			int c = a + side + 1;
+			int d = c + 1;
+
+			fprintf(file, "f %d/%d/1 %d/%d/1 %d/%d/1\n", a, a, c, c, b, b);
+			fprintf(file, "f %d/%d/1 %d/%d/1 %d/%d/1\n", b, b, c, c, d, d);
+		}
+	}
+
+	fclose(file);
+	return true;
+}
+
+static void PrintResult(const char* name, double legacySeconds, double parserSeconds, int loads, double megabytes)
+{
+	printf("  %-10s ifstream %9.3f ms/load, parser %8.3f ms/load (%.0f MB/s), %.1fx faster\n", name,
+		legacySeconds * 1000.0 / loads, parserSeconds * 1000.0 / loads, megabytes * loads / parserSeconds, legacySeconds / parserSeconds);
+}
+
+static double GetMegabytes(const char* filename)
+{
+	FILE* file = fopen(filename, "rb");
+	if (!file)
+		return 0.0;
+
+	fseek(file, 0, SEEK_END);
+	double megabytes = ftell(file) / (1024.0 * 1024.0);
+	fclose(file);
+	return megabytes;
+}
+
+// The faces here can't be read by the old loader, check they come out as the right triangles
+static bool CheckFaceFormats()
+{
+	const char* text =
+		"v 0 0 0\nv 1 0 0\nv 1 0 1\nv 0 0 1\nv 0.5 1e0 .5\n"
+		"vt 0 0\nvt 1 1\n"
+		"vn 0 1 0\n"
+		"f 1/1/1 2/2/1 3/1/1 4/2/1\r\n"		// Quad, with a Windows line ending
+		"f -5 -4 -3 -2 -1\n"				// Pentagon counting back from the end, positions only
+		"f\t1//1\t2//1\t5//1\n"				// Tabs, no uvs
+		"f 1/2 3/1 5/2 # comment\n";		// No normals
+
+	ObjMeshData data;
+	if (!ObjParser::Parse(text, strlen(text), &data))
+		return false;
+
+	// 2 + 3 + 1 + 1 triangles
+	if (data.corners.size() != 21)
+		return false;
+
+	// The pentagon fans out from its first point, so its last triangle is points 0, 3 and 4
+	if (data.corners[12].position != 0 || data.corners[13].position != 3 || data.corners[14].position != 4)
+		return false;
+
+	if (data.corners[15].uv != -1 || data.corners[15].normal != 0 || data.corners[18].uv != 1 || data.corners[18].normal != -1)
+		return false;
+
+	if (!NearlyEqual(data.positions[4].y, 1.0f) || !NearlyEqual(data.uvs[1].y, -1.0f))
+		return false;
+
+	// Pointing past the end has to fail rather than read off the end of an array
+	const char* broken = "v 0 0 0\nf 1 2 3\n";
+	return !ObjParser::Parse(broken, strlen(broken), &data);
+}
+
+int main(int argc, char** argv)
+{
+	BenchOptions options;
+
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--file path] [--repeat N] [--triangles N] [--scratch path]\n", argv[0]);
+		return 1;
+	}
+
+	bool agreed = true;
+
+	if (!CheckFaceFormats())
+	{
+		fprintf(stderr, "Quads, negative indices or missing uvs and normals came out wrong\n");
+		agreed = false;
+	}
+
+	ObjMeshData legacy;
+	ObjMeshData parsed;
+
+	// A real mesh, small enough that it's mostly about the fixed costs
+	if (!LegacyLoad(options.file, &legacy) || !ObjParser::ParseFile(options.file, &parsed))
+	{
+		fprintf(stderr, "Could not load %s\n", options.file);
+		return 1;
+	}
+
+	agreed = agreed && SameMesh(&legacy, &parsed);
+
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < options.repeat; r++)
+	{
+		LegacyLoad(options.file, &legacy);
+	}
+	double legacySeconds = SecondsSince(start);
+
+	start = std::chrono::high_resolution_clock::now();
+	for (int r = 0; r < options.repeat; r++)
+	{
+		ObjParser::ParseFile(options.file, &parsed);
+	}
+	double parserSeconds = SecondsSince(start);
+
+	printf("OBJ load benchmark\n");
+	printf("  %s: %d triangles, %.2f MB, %d loads\n", options.file, (int)parsed.corners.size() / 3, GetMegabytes(options.file), options.repeat);
+	PrintResult("real", legacySeconds, parserSeconds, options.repeat, GetMegabytes(options.file));
+
+	// A big one, where it's all about how fast we get through the text
+	if (options.triangles > 0)
+	{
+		if (!WriteSyntheticMesh(options.scratch, options.triangles))
+		{
+			fprintf(stderr, "Could not write %s\n", options.scratch);
+			return 1;
+		}
+
+		start = std::chrono::high_resolution_clock::now();
+		bool legacyLoaded = LegacyLoad(options.scratch, &legacy);
+		legacySeconds = SecondsSince(start);
+
+		start = std::chrono::high_resolution_clock::now();
+		bool parserLoaded = ObjParser::ParseFile(options.scratch, &parsed);
+		parserSeconds = SecondsSince(start);
+
+		double megabytes = GetMegabytes(options.scratch);
+		remove(options.scratch);
+
+		if (!legacyLoaded || !parserLoaded)
+		{
+			fprintf(stderr, "Could not load the synthetic mesh back in\n");
+			return 1;
+		}
+
+		agreed = agreed && SameMesh(&legacy, &parsed);
+
+		printf("  synthetic grid: %d triangles, %.2f MB\n", (int)parsed.corners.size() / 3, megabytes);
+		PrintResult("synthetic", legacySeconds, parserSeconds, 1, megabytes);
+	}
+
+	if (!agreed)
+	{
+		fprintf(stderr, "The parser and the old loader do not agree\n");
+		return 1;
+	}
+
+	return 0;
+}
@@ -0,0 +1,175 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/Windows.h
+*	Stand-in for the Win32 header when building the headless simulation.
+*	Only the types and calls the gameplay code touches are declared here. The
+*	functions are implemented in NullPlatform.cpp so the driver can script them.
+*/
+
+#ifndef HEADLESS_WINDOWS_H
+#define HEADLESS_WINDOWS_H
+
+#include <sal.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Calling conventions and annotations mean nothing outside of MSVC
+#ifndef WINAPI
+#define WINAPI
+#endif
+#ifndef CALLBACK
+#define CALLBACK
+#endif
+#ifndef __cdecl
+#define __cdecl
+#endif
+#ifndef __stdcall
+#define __stdcall
+#endif
+
+typedef unsigned char BYTE;
+typedef unsigned short WORD;
+typedef unsigned short USHORT;
+typedef unsigned long DWORD;
+typedef unsigned long ULONG;
+typedef long LONG;
+typedef int INT;
+typedef unsigned int UINT;
+typedef int BOOL;
+typedef long HRESULT;
+typedef std::size_t SIZE_T;
+typedef std::uintptr_t UINT_PTR;
+typedef std::uintptr_t WPARAM;
+typedef std::intptr_t LPARAM;
+typedef std::intptr_t LRESULT;
+typedef char* PSTR;
+typedef const char* LPCSTR;
+typedef const wchar_t* LPCWSTR;
+typedef void* LPVOID;
+typedef const void* LPCVOID;
+
+typedef void* HANDLE;
+typedef struct HWND__* HWND;
+typedef struct HINSTANCE__* HINSTANCE;
+typedef struct HRAWINPUT__* HRAWINPUT;
+
+#define S_OK ((HRESULT)0L)
+#define S_FALSE ((HRESULT)1L)
+#define E_FAIL ((HRESULT)0x80004005L)
+#define E_NOTIMPL ((HRESULT)0x80004001L)
+#define E_INVALIDARG ((HRESULT)0x80070057L)
+#define SUCCEEDED(hr) (((HRESULT)(hr)) >= 0)
+#define FAILED(hr) (((HRESULT)(hr)) < 0)
+
+#define MB_OK 0x00000000L
+#define COINIT_MULTITHREADED 0x0
+#define RIDEV_INPUTSINK 0x00000100
+#define _TRUNCATE ((std::size_t)-1)
+
+// Just enough to open a file read only and map it into memory
+#define INVALID_HANDLE_VALUE ((HANDLE)(std::intptr_t)-1)
+#define GENERIC_READ 0x80000000L
+#define FILE_SHARE_READ 0x00000001
+#define OPEN_EXISTING 3
+#define FILE_ATTRIBUTE_NORMAL 0x00000080
+#define FILE_FLAG_SEQUENTIAL_SCAN 0x08000000
+#define PAGE_READONLY 0x02
+#define FILE_MAP_READ 0x0004
+
+typedef union _LARGE_INTEGER
+{
+	struct
+	{
+		DWORD LowPart;
+		LONG HighPart;
+	} u;
+	long long QuadPart;
+} LARGE_INTEGER;
+
+// 100 nanosecond ticks since 1601, split in two
+typedef struct _FILETIME
+{
+	DWORD dwLowDateTime;
+	DWORD dwHighDateTime;
+} FILETIME;
+
+typedef struct _WIN32_FILE_ATTRIBUTE_DATA
+{
+	DWORD dwFileAttributes;
+	FILETIME ftCreationTime;
+	FILETIME ftLastAccessTime;
+	FILETIME ftLastWriteTime;
+	DWORD nFileSizeHigh;
+	DWORD nFileSizeLow;
+} WIN32_FILE_ATTRIBUTE_DATA;
+
+typedef enum _GET_FILEEX_INFO_LEVELS
+{
+	GetFileExInfoStandard
+} GET_FILEEX_INFO_LEVELS;
+
+typedef struct tagRECT
+{
+	LONG left;
+	LONG top;
+	LONG right;
+	LONG bottom;
+} RECT;
+
+typedef struct tagPOINT
+{
+	LONG x;
+	LONG y;
+} POINT;
+
+typedef struct tagRAWINPUTDEVICE
+{
+	USHORT usUsagePage;
+	USHORT usUsage;
+	DWORD dwFlags;
+	HWND hwndTarget;
+} RAWINPUTDEVICE;
+
+// Windows.h drags min and max into the global namespace and the collision code relies on it
+using std::min;
+using std::max;
+
+// Debug output, message boxes and the quit message all go through the headless platform
+void OutputDebugString(LPCSTR message);
+int MessageBox(HWND window, LPCSTR text, LPCSTR caption, UINT type);
+void PostQuitMessage(int exitCode);
+
+// The cursor is whatever the input script last said it was
+BOOL GetCursorPos(POINT* point);
+BOOL SetCursorPos(int x, int y);
+BOOL ScreenToClient(HWND window, POINT* point);
+BOOL RegisterRawInputDevices(const RAWINPUTDEVICE* devices, UINT numDevices, UINT size);
+
+// There's no COM, so every thread is as ready for it as it needs to be
+HRESULT CoInitializeEx(LPVOID reserved, DWORD coInit);
+void CoUninitialize();
+
+BOOL QueryPerformanceCounter(LARGE_INTEGER* count);
+BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency);
+
+// Files are opened with open() and mapped with mmap(), the handles are only meaningful to these calls
+typedef struct _SECURITY_ATTRIBUTES* LPSECURITY_ATTRIBUTES;
+HANDLE CreateFileA(LPCSTR fileName, DWORD access, DWORD shareMode, LPSECURITY_ATTRIBUTES security, DWORD creation, DWORD flags, HANDLE templateFile);
+BOOL GetFileSizeEx(HANDLE file, LARGE_INTEGER* size);
+HANDLE CreateFileMappingA(HANDLE file, LPSECURITY_ATTRIBUTES security, DWORD protect, DWORD maximumSizeHigh, DWORD maximumSizeLow, LPCSTR name);
+LPVOID MapViewOfFile(HANDLE mapping, DWORD access, DWORD offsetHigh, DWORD offsetLow, SIZE_T bytes);
+BOOL UnmapViewOfFile(LPCVOID address);
+BOOL CloseHandle(HANDLE handle);
+
+// Sizes and times come from stat(), only the last write time and size are filled in
+BOOL GetFileAttributesExA(LPCSTR fileName, GET_FILEEX_INFO_LEVELS infoLevel, LPVOID fileInformation);
+LONG CompareFileTime(const FILETIME* first, const FILETIME* second);
+
+int mbstowcs_s(std::size_t* converted, wchar_t* dest, std::size_t destSize, const char* source, std::size_t count);
+
+#endif
@@ -0,0 +1,528 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/d3d11.h
+*	A null Direct3D 11. Every object can be created and released like the real
+*	thing but nothing is ever drawn. The device context counts what it was asked
+*	to draw so the headless driver can report it.
+*	The methods are virtual so a test backend can subclass the device or context
+*	and record the calls it receives.
+*/
+
+#ifndef HEADLESS_D3D11_H
+#define HEADLESS_D3D11_H
+
+// SimpleMath refuses to compile unless it thinks the real header has been included
+#define __d3d11_h__
+
+#include <Windows.h>
+#include <dxgi.h>
+#include <d3dcommon.h>
+#include <cfloat>
+#include <cstring>
+#include <vector>
+
+#define D3D11_APPEND_ALIGNED_ELEMENT (0xffffffff)
+#define D3D11_FLOAT32_MAX (3.402823466e+38f)
+
+typedef D3D_PRIMITIVE_TOPOLOGY D3D11_PRIMITIVE_TOPOLOGY;
+#define D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED D3D_PRIMITIVE_TOPOLOGY_UNDEFINED
+#define D3D11_PRIMITIVE_TOPOLOGY_POINTLIST D3D_PRIMITIVE_TOPOLOGY_POINTLIST
+#define D3D11_PRIMITIVE_TOPOLOGY_LINELIST D3D_PRIMITIVE_TOPOLOGY_LINELIST
+#define D3D11_PRIMITIVE_TOPOLOGY_LINESTRIP D3D_PRIMITIVE_TOPOLOGY_LINESTRIP
+#define D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+#define D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP
+
+enum D3D11_USAGE
+{
+	D3D11_USAGE_DEFAULT = 0,
+	D3D11_USAGE_IMMUTABLE = 1,
+	D3D11_USAGE_DYNAMIC = 2,
+	D3D11_USAGE_STAGING = 3
+};
+
+enum D3D11_BIND_FLAG
+{
+	D3D11_BIND_VERTEX_BUFFER = 0x1L,
+	D3D11_BIND_INDEX_BUFFER = 0x2L,
+	D3D11_BIND_CONSTANT_BUFFER = 0x4L,
+	D3D11_BIND_SHADER_RESOURCE = 0x8L,
+	D3D11_BIND_RENDER_TARGET = 0x20L,
+	D3D11_BIND_DEPTH_STENCIL = 0x40L
+};
+
+enum D3D11_CPU_ACCESS_FLAG
+{
+	D3D11_CPU_ACCESS_WRITE = 0x10000L,
+	D3D11_CPU_ACCESS_READ = 0x20000L
+};
+
+enum D3D11_MAP
+{
+	D3D11_MAP_READ = 1,
+	D3D11_MAP_WRITE = 2,
+	D3D11_MAP_READ_WRITE = 3,
+	D3D11_MAP_WRITE_DISCARD = 4,
+	D3D11_MAP_WRITE_NO_OVERWRITE = 5
+};
+
+enum D3D11_INPUT_CLASSIFICATION
+{
+	D3D11_INPUT_PER_VERTEX_DATA = 0,
+	D3D11_INPUT_PER_INSTANCE_DATA = 1
+};
+
+enum D3D11_FILTER
+{
+	D3D11_FILTER_MIN_MAG_MIP_POINT = 0,
+	D3D11_FILTER_MIN_MAG_MIP_LINEAR = 0x15,
+	D3D11_FILTER_ANISOTROPIC = 0x55
+};
+
+enum D3D11_TEXTURE_ADDRESS_MODE
+{
+	D3D11_TEXTURE_ADDRESS_WRAP = 1,
+	D3D11_TEXTURE_ADDRESS_MIRROR = 2,
+	D3D11_TEXTURE_ADDRESS_CLAMP = 3,
+	D3D11_TEXTURE_ADDRESS_BORDER = 4
+};
+
+enum D3D11_COMPARISON_FUNC
+{
+	D3D11_COMPARISON_NEVER = 1,
+	D3D11_COMPARISON_LESS = 2,
+	D3D11_COMPARISON_EQUAL = 3,
+	D3D11_COMPARISON_LESS_EQUAL = 4,
+	D3D11_COMPARISON_GREATER = 5,
+	D3D11_COMPARISON_NOT_EQUAL = 6,
+	D3D11_COMPARISON_GREATER_EQUAL = 7,
+	D3D11_COMPARISON_ALWAYS = 8
+};
+
+enum D3D11_DEPTH_WRITE_MASK
+{
+	D3D11_DEPTH_WRITE_MASK_ZERO = 0,
+	D3D11_DEPTH_WRITE_MASK_ALL = 1
+};
+
+enum D3D11_STENCIL_OP
+{
+	D3D11_STENCIL_OP_KEEP = 1,
+	D3D11_STENCIL_OP_ZERO = 2,
+	D3D11_STENCIL_OP_REPLACE = 3,
+	D3D11_STENCIL_OP_INCR_SAT = 4,
+	D3D11_STENCIL_OP_DECR_SAT = 5,
+	D3D11_STENCIL_OP_INVERT = 6,
+	D3D11_STENCIL_OP_INCR = 7,
+	D3D11_STENCIL_OP_DECR = 8
+};
+
+enum D3D11_DSV_DIMENSION
+{
+	D3D11_DSV_DIMENSION_UNKNOWN = 0,
+	D3D11_DSV_DIMENSION_TEXTURE2D = 3
+};
+
+enum D3D11_SRV_DIMENSION
+{
+	D3D11_SRV_DIMENSION_UNKNOWN = 0,
+	D3D11_SRV_DIMENSION_TEXTURE2D = 4,
+	D3D11_SRV_DIMENSION_TEXTURE2DARRAY = 5
+};
+
+enum D3D11_CULL_MODE
+{
+	D3D11_CULL_NONE = 1,
+	D3D11_CULL_FRONT = 2,
+	D3D11_CULL_BACK = 3
+};
+
+enum D3D11_FILL_MODE
+{
+	D3D11_FILL_WIREFRAME = 2,
+	D3D11_FILL_SOLID = 3
+};
+
+enum D3D11_CLEAR_FLAG
+{
+	D3D11_CLEAR_DEPTH = 0x1L,
+	D3D11_CLEAR_STENCIL = 0x2L
+};
+
+struct D3D11_BUFFER_DESC
+{
+	UINT ByteWidth;
+	D3D11_USAGE Usage;
+	UINT BindFlags;
+	UINT CPUAccessFlags;
+	UINT MiscFlags;
+	UINT StructureByteStride;
+};
+
+struct D3D11_SUBRESOURCE_DATA
+{
+	const void* pSysMem;
+	UINT SysMemPitch;
+	UINT SysMemSlicePitch;
+};
+
+struct D3D11_MAPPED_SUBRESOURCE
+{
+	void* pData;
+	UINT RowPitch;
+	UINT DepthPitch;
+};
+
+struct D3D11_INPUT_ELEMENT_DESC
+{
+	LPCSTR SemanticName;
+	UINT SemanticIndex;
+	DXGI_FORMAT Format;
+	UINT InputSlot;
+	UINT AlignedByteOffset;
+	D3D11_INPUT_CLASSIFICATION InputSlotClass;
+	UINT InstanceDataStepRate;
+};
+
+struct D3D11_SAMPLER_DESC
+{
+	D3D11_FILTER Filter;
+	D3D11_TEXTURE_ADDRESS_MODE AddressU;
+	D3D11_TEXTURE_ADDRESS_MODE AddressV;
+	D3D11_TEXTURE_ADDRESS_MODE AddressW;
+	float MipLODBias;
+	UINT MaxAnisotropy;
+	D3D11_COMPARISON_FUNC ComparisonFunc;
+	float BorderColor[4];
+	float MinLOD;
+	float MaxLOD;
+};
+
+struct D3D11_TEXTURE2D_DESC
+{
+	UINT Width;
+	UINT Height;
+	UINT MipLevels;
+	UINT ArraySize;
+	DXGI_FORMAT Format;
+	DXGI_SAMPLE_DESC SampleDesc;
+	D3D11_USAGE Usage;
+	UINT BindFlags;
+	UINT CPUAccessFlags;
+	UINT MiscFlags;
+};
+
+struct D3D11_TEX2D_SRV
+{
+	UINT MostDetailedMip;
+	UINT MipLevels;
+};
+
+struct D3D11_TEX2D_ARRAY_SRV
+{
+	UINT MostDetailedMip;
+	UINT MipLevels;
+	UINT FirstArraySlice;
+	UINT ArraySize;
+};
+
+struct D3D11_SHADER_RESOURCE_VIEW_DESC
+{
+	DXGI_FORMAT Format;
+	D3D11_SRV_DIMENSION ViewDimension;
+	union
+	{
+		D3D11_TEX2D_SRV Texture2D;
+		D3D11_TEX2D_ARRAY_SRV Texture2DArray;
+	};
+};
+
+struct D3D11_DEPTH_STENCILOP_DESC
+{
+	D3D11_STENCIL_OP StencilFailOp;
+	D3D11_STENCIL_OP StencilDepthFailOp;
+	D3D11_STENCIL_OP StencilPassOp;
+	D3D11_COMPARISON_FUNC StencilFunc;
+};
+
+struct D3D11_DEPTH_STENCIL_DESC
+{
+	BOOL DepthEnable;
+	D3D11_DEPTH_WRITE_MASK DepthWriteMask;
+	D3D11_COMPARISON_FUNC DepthFunc;
+	BOOL StencilEnable;
+	BYTE StencilReadMask;
+	BYTE StencilWriteMask;
+	D3D11_DEPTH_STENCILOP_DESC FrontFace;
+	D3D11_DEPTH_STENCILOP_DESC BackFace;
+};
+
+struct D3D11_TEX2D_DSV
+{
+	UINT MipSlice;
+};
+
+struct D3D11_DEPTH_STENCIL_VIEW_DESC
+{
+	DXGI_FORMAT Format;
+	D3D11_DSV_DIMENSION ViewDimension;
+	UINT Flags;
+	union
+	{
+		D3D11_TEX2D_DSV Texture2D;
+	};
+};
+
+struct D3D11_RASTERIZER_DESC
+{
+	D3D11_FILL_MODE FillMode;
+	D3D11_CULL_MODE CullMode;
+	BOOL FrontCounterClockwise;
+	INT DepthBias;
+	float DepthBiasClamp;
+	float SlopeScaledDepthBias;
+	BOOL DepthClipEnable;
+	BOOL ScissorEnable;
+	BOOL MultisampleEnable;
+	BOOL AntialiasedLineEnable;
+};
+
+struct D3D11_VIEWPORT
+{
+	float TopLeftX;
+	float TopLeftY;
+	float Width;
+	float Height;
+	float MinDepth;
+	float MaxDepth;
+};
+
+// Device children. None of these own anything on a GPU, they just remember how they were described.
+
+struct ID3D11DeviceChild : public IUnknown
+{
+};
+
+struct ID3D11Resource : public ID3D11DeviceChild
+{
+};
+
+struct ID3D11Buffer : public ID3D11Resource
+{
+	D3D11_BUFFER_DESC m_description;
+	std::vector<unsigned char> m_storage;	// Only CPU writable buffers get storage, Map hands it out
+
+	explicit ID3D11Buffer(const D3D11_BUFFER_DESC& description)
+	{
+		m_description = description;
+		if (description.CPUAccessFlags & D3D11_CPU_ACCESS_WRITE)
+		{
+			m_storage.resize(description.ByteWidth > 0 ? description.ByteWidth : 1);
+		}
+	}
+};
+
+struct ID3D11Texture2D : public ID3D11Resource
+{
+	D3D11_TEXTURE2D_DESC m_description;
+
+	explicit ID3D11Texture2D(const D3D11_TEXTURE2D_DESC& description) { m_description = description; }
+};
+
+struct ID3D11View : public ID3D11DeviceChild
+{
+	ID3D11Resource* m_resource;
+
+	explicit ID3D11View(ID3D11Resource* resource)
+	{
+		m_resource = resource;
+		if (m_resource)
+		{
+			m_resource->AddRef();
+		}
+	}
+	~ID3D11View()
+	{
+		if (m_resource)
+		{
+			m_resource->Release();
+		}
+	}
+
+	void GetResource(ID3D11Resource** resource)
+	{
+		if (m_resource)
+		{
+			m_resource->AddRef();
+		}
+		*resource = m_resource;
+	}
+};
+
+struct ID3D11ShaderResourceView : public ID3D11View
+{
+	explicit ID3D11ShaderResourceView(ID3D11Resource* resource) : ID3D11View(resource) {}
+};
+
+struct ID3D11RenderTargetView : public ID3D11View
+{
+	explicit ID3D11RenderTargetView(ID3D11Resource* resource) : ID3D11View(resource) {}
+};
+
+struct ID3D11DepthStencilView : public ID3D11View
+{
+	explicit ID3D11DepthStencilView(ID3D11Resource* resource) : ID3D11View(resource) {}
+};
+
+struct ID3D11BlendState : public ID3D11DeviceChild {};
+struct ID3D11SamplerState : public ID3D11DeviceChild {};
+struct ID3D11DepthStencilState : public ID3D11DeviceChild {};
+struct ID3D11RasterizerState : public ID3D11DeviceChild {};
+struct ID3D11VertexShader : public ID3D11DeviceChild {};
+struct ID3D11PixelShader : public ID3D11DeviceChild {};
+struct ID3D11InputLayout : public ID3D11DeviceChild {};
+struct ID3D11ClassLinkage : public ID3D11DeviceChild {};
+struct ID3D11ClassInstance : public ID3D11DeviceChild {};
+
+// The device hands out fresh objects for everything and never fails
+
+struct ID3D11Device : public IUnknown
+{
+	virtual HRESULT CreateBuffer(const D3D11_BUFFER_DESC* description, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Buffer** buffer)
+	{
+		if (buffer)
+			*buffer = new ID3D11Buffer(*description);
+		return S_OK;
+	}
+
+	virtual HRESULT CreateTexture2D(const D3D11_TEXTURE2D_DESC* description, const D3D11_SUBRESOURCE_DATA* initialData, ID3D11Texture2D** texture)
+	{
+		if (texture)
+			*texture = new ID3D11Texture2D(*description);
+		return S_OK;
+	}
+
+	virtual HRESULT CreateShaderResourceView(ID3D11Resource* resource, const D3D11_SHADER_RESOURCE_VIEW_DESC* description, ID3D11ShaderResourceView** view)
+	{
+		if (view)
+			*view = new ID3D11ShaderResourceView(resource);
+		return S_OK;
+	}
+
+	virtual HRESULT CreateRenderTargetView(ID3D11Resource* resource, const void* description, ID3D11RenderTargetView** view)
+	{
+		if (view)
+			*view = new ID3D11RenderTargetView(resource);
+		return S_OK;
+	}
+
+	virtual HRESULT CreateDepthStencilView(ID3D11Resource* resource, const D3D11_DEPTH_STENCIL_VIEW_DESC* description, ID3D11DepthStencilView** view)
+	{
+		if (view)
+			*view = new ID3D11DepthStencilView(resource);
+		return S_OK;
+	}
+
+	virtual HRESULT CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* description, ID3D11DepthStencilState** state)
+	{
+		if (state)
+			*state = new ID3D11DepthStencilState();
+		return S_OK;
+	}
+
+	virtual HRESULT CreateRasterizerState(const D3D11_RASTERIZER_DESC* description, ID3D11RasterizerState** state)
+	{
+		if (state)
+			*state = new ID3D11RasterizerState();
+		return S_OK;
+	}
+
+	virtual HRESULT CreateSamplerState(const D3D11_SAMPLER_DESC* description, ID3D11SamplerState** state)
+	{
+		if (state)
+			*state = new ID3D11SamplerState();
+		return S_OK;
+	}
+
+	virtual HRESULT CreateVertexShader(const void* bytecode, SIZE_T length, ID3D11ClassLinkage* linkage, ID3D11VertexShader** shader)
+	{
+		if (shader)
+			*shader = new ID3D11VertexShader();
+		return S_OK;
+	}
+
+	virtual HRESULT CreatePixelShader(const void* bytecode, SIZE_T length, ID3D11ClassLinkage* linkage, ID3D11PixelShader** shader)
+	{
+		if (shader)
+			*shader = new ID3D11PixelShader();
+		return S_OK;
+	}
+
+	virtual HRESULT CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* elements, UINT numElements, const void* bytecode, SIZE_T length, ID3D11InputLayout** layout)
+	{
+		if (layout)
+			*layout = new ID3D11InputLayout();
+		return S_OK;
+	}
+};
+
+// The context accepts state changes and draw calls, and keeps a tally of the draws
+
+struct ID3D11DeviceContext : public IUnknown
+{
+	unsigned long long m_drawCalls;
+	unsigned long long m_indicesDrawn;
+
+	ID3D11DeviceContext() { m_drawCalls = 0; m_indicesDrawn = 0; }
+
+	virtual void IASetInputLayout(ID3D11InputLayout* layout) {}
+	virtual void IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets) {}
+	virtual void IASetIndexBuffer(ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset) {}
+	virtual void IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) {}
+
+	virtual void VSSetShader(ID3D11VertexShader* shader, ID3D11ClassInstance* const* instances, UINT numInstances) {}
+	virtual void VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) {}
+	virtual void VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) {}
+	virtual void PSSetShader(ID3D11PixelShader* shader, ID3D11ClassInstance* const* instances, UINT numInstances) {}
+	virtual void PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* buffers) {}
+	virtual void PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* samplers) {}
+	virtual void PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* views) {}
+
+	virtual void OMSetBlendState(ID3D11BlendState* state, const float blendFactor[4], UINT sampleMask) {}
+	virtual void OMSetDepthStencilState(ID3D11DepthStencilState* state, UINT stencilRef) {}
+	virtual void OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* renderTargets, ID3D11DepthStencilView* depthStencil) {}
+	virtual void RSSetState(ID3D11RasterizerState* state) {}
+	virtual void RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* viewports) {}
+
+	virtual void ClearRenderTargetView(ID3D11RenderTargetView* view, const float colour[4]) {}
+	virtual void ClearDepthStencilView(ID3D11DepthStencilView* view, UINT clearFlags, float depth, BYTE stencil) {}
+
+	virtual HRESULT Map(ID3D11Resource* resource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* mapped)
+	{
+		ID3D11Buffer* buffer = dynamic_cast<ID3D11Buffer*>(resource);
+		if (!buffer || buffer->m_storage.empty())
+			return E_INVALIDARG;
+
+		mapped->pData = &buffer->m_storage[0];
+		mapped->RowPitch = (UINT)buffer->m_storage.size();
+		mapped->DepthPitch = mapped->RowPitch;
+		return S_OK;
+	}
+	virtual void Unmap(ID3D11Resource* resource, UINT subresource) {}
+	virtual void UpdateSubresource(ID3D11Resource* resource, UINT subresource, const void* box, const void* data, UINT rowPitch, UINT depthPitch) {}
+
+	virtual void Draw(UINT vertexCount, UINT startVertex)
+	{
+		m_drawCalls++;
+	}
+	virtual void DrawIndexed(UINT indexCount, UINT startIndex, INT baseVertex)
+	{
+		m_drawCalls++;
+		m_indicesDrawn += indexCount;
+	}
+	virtual void DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance)
+	{
+		m_drawCalls++;
+		m_indicesDrawn += (unsigned long long)indexCountPerInstance * instanceCount;
+	}
+};
+
+#endif
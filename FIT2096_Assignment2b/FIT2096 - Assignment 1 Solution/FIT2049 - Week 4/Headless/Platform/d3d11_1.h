@@ -0,0 +1,11 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/d3d11_1.h
+*	DirectXTK includes the 11.1 header. Nothing from 11.1 is used so it just forwards.
+*/
+
+#ifndef HEADLESS_D3D11_1_H
+#define HEADLESS_D3D11_1_H
+
+#include <d3d11.h>
+
+#endif
@@ -0,0 +1,83 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/d3dcommon.h
+*	Stand-in for the shared Direct3D header. Holds the COM base class the
+*	null device objects derive from, the topology enum and the shader blob.
+*/
+
+#ifndef HEADLESS_D3DCOMMON_H
+#define HEADLESS_D3DCOMMON_H
+
+#include <Windows.h>
+#include <vector>
+
+// Every Direct3D object is reference counted and deletes itself when the last reference goes
+struct IUnknown
+{
+	ULONG m_referenceCount;
+
+	IUnknown() { m_referenceCount = 1; }
+	virtual ~IUnknown() {}
+
+	ULONG AddRef() { return ++m_referenceCount; }
+	ULONG Release()
+	{
+		ULONG remaining = --m_referenceCount;
+		if (remaining == 0)
+		{
+			delete this;
+		}
+		return remaining;
+	}
+};
+
+enum D3D_PRIMITIVE_TOPOLOGY
+{
+	D3D_PRIMITIVE_TOPOLOGY_UNDEFINED = 0,
+	D3D_PRIMITIVE_TOPOLOGY_POINTLIST = 1,
+	D3D_PRIMITIVE_TOPOLOGY_LINELIST = 2,
+	D3D_PRIMITIVE_TOPOLOGY_LINESTRIP = 3,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST = 4,
+	D3D_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP = 5
+};
+
+enum D3D_DRIVER_TYPE
+{
+	D3D_DRIVER_TYPE_UNKNOWN = 0,
+	D3D_DRIVER_TYPE_HARDWARE,
+	D3D_DRIVER_TYPE_REFERENCE,
+	D3D_DRIVER_TYPE_NULL,
+	D3D_DRIVER_TYPE_SOFTWARE,
+	D3D_DRIVER_TYPE_WARP
+};
+
+enum D3D_FEATURE_LEVEL
+{
+	D3D_FEATURE_LEVEL_10_0 = 0xa000,
+	D3D_FEATURE_LEVEL_10_1 = 0xa100,
+	D3D_FEATURE_LEVEL_11_0 = 0xb000
+};
+
+struct D3D_SHADER_MACRO
+{
+	LPCSTR Name;
+	LPCSTR Definition;
+};
+
+struct ID3DInclude
+{
+};
+
+// A compiled shader. The null compiler hands back a few bytes of nothing.
+struct ID3D10Blob : public IUnknown
+{
+	std::vector<unsigned char> m_data;
+
+	explicit ID3D10Blob(SIZE_T size) : m_data(size > 0 ? size : 1, 0) {}
+
+	void* GetBufferPointer() { return &m_data[0]; }
+	SIZE_T GetBufferSize() { return m_data.size(); }
+};
+
+typedef ID3D10Blob ID3DBlob;
+
+#endif
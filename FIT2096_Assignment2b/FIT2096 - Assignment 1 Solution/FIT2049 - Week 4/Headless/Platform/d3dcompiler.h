@@ -0,0 +1,19 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/d3dcompiler.h
+*	There is no HLSL compiler here. Compiling a shader just checks the source
+*	file exists and hands back an empty blob so Shader::Initialise carries on.
+*/
+
+#ifndef HEADLESS_D3DCOMPILER_H
+#define HEADLESS_D3DCOMPILER_H
+
+#include <d3dcommon.h>
+
+#define D3D_COMPILE_STANDARD_FILE_INCLUDE ((ID3DInclude*)(UINT_PTR)1)
+#define D3DCOMPILE_DEBUG (1 << 0)
+#define D3DCOMPILE_ENABLE_STRICTNESS (1 << 11)
+
+HRESULT D3DCompileFromFile(LPCWSTR fileName, const D3D_SHADER_MACRO* defines, ID3DInclude* include,
+	LPCSTR entryPoint, LPCSTR target, UINT flags1, UINT flags2, ID3DBlob** code, ID3DBlob** errorMessages);
+
+#endif
@@ -0,0 +1,56 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/dxgi.h
+*	Stand-in for DXGI. Only the formats and swap chain bits the engine names.
+*/
+
+#ifndef HEADLESS_DXGI_H
+#define HEADLESS_DXGI_H
+
+#include <d3dcommon.h>
+
+enum DXGI_FORMAT
+{
+	DXGI_FORMAT_UNKNOWN = 0,
+	DXGI_FORMAT_R32G32B32A32_FLOAT = 2,
+	DXGI_FORMAT_R32G32B32_FLOAT = 6,
+	DXGI_FORMAT_R16G16B16A16_FLOAT = 10,
+	DXGI_FORMAT_R32G32_FLOAT = 16,
+	DXGI_FORMAT_R10G10B10A2_UNORM = 24,
+	DXGI_FORMAT_R8G8B8A8_UNORM = 28,
+	DXGI_FORMAT_R8G8B8A8_UNORM_SRGB = 29,
+	DXGI_FORMAT_R8G8B8A8_SNORM = 31,
+	DXGI_FORMAT_R16G16_FLOAT = 34,
+	DXGI_FORMAT_R16G16_SNORM = 37,
+	DXGI_FORMAT_R32_FLOAT = 41,
+	DXGI_FORMAT_R32_UINT = 42,
+	DXGI_FORMAT_D24_UNORM_S8_UINT = 45,
+	DXGI_FORMAT_R16_UINT = 57,
+	DXGI_FORMAT_BC1_UNORM = 71,
+	DXGI_FORMAT_BC3_UNORM = 77,
+	DXGI_FORMAT_B8G8R8A8_UNORM = 87,
+	DXGI_FORMAT_BC7_UNORM = 98
+};
+
+enum DXGI_MODE_ROTATION
+{
+	DXGI_MODE_ROTATION_UNSPECIFIED = 0,
+	DXGI_MODE_ROTATION_IDENTITY = 1,
+	DXGI_MODE_ROTATION_ROTATE90 = 2,
+	DXGI_MODE_ROTATION_ROTATE180 = 3,
+	DXGI_MODE_ROTATION_ROTATE270 = 4
+};
+
+struct DXGI_SAMPLE_DESC
+{
+	UINT Count;
+	UINT Quality;
+};
+
+// Presenting does nothing when there is nothing to present to
+struct IDXGISwapChain : public IUnknown
+{
+	HRESULT Present(UINT syncInterval, UINT flags) { return S_OK; }
+	HRESULT SetFullscreenState(BOOL fullscreen, void* target) { return S_OK; }
+};
+
+#endif
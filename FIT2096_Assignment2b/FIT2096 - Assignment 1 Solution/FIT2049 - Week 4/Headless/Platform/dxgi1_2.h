@@ -0,0 +1,18 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/dxgi1_2.h
+*	SimpleMath pulls this in for the scaling enum, nothing else is needed.
+*/
+
+#ifndef HEADLESS_DXGI1_2_H
+#define HEADLESS_DXGI1_2_H
+
+#include <dxgi.h>
+
+enum DXGI_SCALING
+{
+	DXGI_SCALING_STRETCH = 0,
+	DXGI_SCALING_NONE = 1,
+	DXGI_SCALING_ASPECT_RATIO_STRETCH = 2
+};
+
+#endif
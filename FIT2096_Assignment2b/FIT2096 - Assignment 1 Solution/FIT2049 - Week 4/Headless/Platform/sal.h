@@ -0,0 +1,47 @@
+/*	FIT2096 - Assignment 2b
+*	Headless/Platform/sal.h
+*	The source annotation language only means something to the MSVC analyser.
+*	DirectXMath and DirectXTK sprinkle it everywhere so we define it all away.
+*/
+
+#ifndef HEADLESS_SAL_H
+#define HEADLESS_SAL_H
+
+#define _In_
+#define _In_opt_
+#define _In_z_
+#define _In_opt_z_
+#define _In_reads_(size)
+#define _In_reads_opt_(size)
+#define _In_reads_bytes_(size)
+#define _In_reads_bytes_opt_(size)
+#define _In_range_(low, high)
+#define _Inout_
+#define _Inout_opt_
+#define _Inout_updates_(size)
+#define _Inout_updates_bytes_(size)
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_(size)
+#define _Out_writes_opt_(size)
+#define _Out_writes_bytes_(size)
+#define _Out_writes_bytes_opt_(size)
+#define _Out_writes_all_(size)
+#define _Outptr_
+#define _Outptr_opt_
+#define _Outptr_result_maybenull_
+#define _Outptr_opt_result_maybenull_
+#define _COM_Outptr_
+#define _COM_Outptr_opt_
+#define _Ret_maybenull_
+#define _Ret_notnull_
+#define _Check_return_
+#define _Success_(expr)
+#define _When_(expr, annotation)
+#define _Field_size_(size)
+#define _Field_size_bytes_(size)
+#define _Analysis_assume_(expr)
+#define _Use_decl_annotations_
+#define _Printf_format_string_
+
+#endif
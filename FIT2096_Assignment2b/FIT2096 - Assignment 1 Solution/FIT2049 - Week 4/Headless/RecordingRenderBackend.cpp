@@ -0,0 +1,108 @@
+/*	FIT2096 - Assignment 2b
+*	RecordingRenderBackend.cpp
+*	Implementation of RecordingRenderBackend.h
+*/
+
+#include "RecordingRenderBackend.h"
+
+#include <cstdio>
+#include <map>
+
+RecordingRenderBackend::RecordingRenderBackend()
+{
+	m_frameCount = 0;
+	m_snapshotCount = 0;
+	m_meshCount = 0;
+	m_uiCount = 0;
+	m_outOfOrderCount = 0;
+	m_badAmountCount = 0;
+	m_lastTick = 0;
+	m_lastSnapshot = NULL;
+}
+
+void RecordingRenderBackend::Draw(const RenderSnapshot* snapshot, float amount)
+{
+	if (m_frameCount == 0 || snapshot->tick > m_lastTick)
+	{
+		m_snapshotCount++;
+	}
+	else if (snapshot->tick < m_lastTick)
+	{
+		m_outOfOrderCount++;
+	}
+
+	if (amount < 0.0f || amount > 1.0f)
+	{
+		m_badAmountCount++;
+	}
+
+	m_frameCount++;
+	m_meshCount += snapshot->meshes.size() + snapshot->instances.size();
+	m_uiCount += snapshot->ui.size();
+
+	// The blend changes every frame even when the snapshot doesn't, so these do too
+	m_lastWorlds.resize(snapshot->meshes.size());
+	for (unsigned int i = 0; i < snapshot->meshes.size(); i++)
+	{
+		m_lastWorlds[i] = snapshot->meshes[i].GetWorld(amount);
+	}
+
+	// Same snapshot as last frame, only the blend has changed
+	if (snapshot == m_lastSnapshot && snapshot->tick == m_lastTick)
+		return;
+
+	m_lastTick = snapshot->tick;
+	m_lastSnapshot = snapshot;
+	m_lastFrame.clear();
+
+	std::map<std::string, int> meshCounts;
+
+	for (unsigned int i = 0; i < snapshot->meshes.size(); i++)
+	{
+		const MeshDraw& draw = snapshot->meshes[i];
+		meshCounts[draw.mesh ? draw.mesh->GetFilename() : "(no mesh)"]++;
+	}
+
+	// Instanced copies count the same as if they'd been drawn one at a time
+	for (unsigned int i = 0; i < snapshot->instancedMeshes.size(); i++)
+	{
+		const InstancedMeshDraw& draw = snapshot->instancedMeshes[i];
+		meshCounts[draw.mesh ? draw.mesh->GetFilename() : "(no mesh)"] += draw.instanceCount;
+	}
+
+	char line[256];
+
+	for (std::map<std::string, int>::iterator it = meshCounts.begin(); it != meshCounts.end(); it++)
+	{
+		snprintf(line, sizeof(line), "mesh %s x %d", it->first.c_str(), it->second);
+		m_lastFrame.push_back(line);
+	}
+
+	for (unsigned int i = 0; i < snapshot->ui.size(); i++)
+	{
+		const UIDraw& draw = snapshot->ui[i];
+
+		if (draw.type == UIDrawType::TEXT)
+		{
+			// Everything the game writes is plain ASCII
+			std::string text;
+			for (unsigned int c = 0; c < draw.text.size(); c++)
+			{
+				text += (char)draw.text[c];
+			}
+
+			snprintf(line, sizeof(line), "text \"%s\" at %.0f, %.0f", text.c_str(), draw.position.x, draw.position.y);
+		}
+		else if (draw.useDestination)
+		{
+			snprintf(line, sizeof(line), "sprite over %ld, %ld to %ld, %ld", (long)draw.destination.left, (long)draw.destination.top,
+				(long)draw.destination.right, (long)draw.destination.bottom);
+		}
+		else
+		{
+			snprintf(line, sizeof(line), "sprite at %.0f, %.0f", draw.position.x, draw.position.y);
+		}
+
+		m_lastFrame.push_back(line);
+	}
+}
@@ -0,0 +1,53 @@
+/*	FIT2096 - Assignment 2b
+*	RecordingRenderBackend.h
+*	A render backend that writes down what it was asked to draw instead of drawing it.
+*	Keeps a running count of frames and draw commands, checks that snapshots only ever
+*	arrive newest last and that every blend amount is between 0 and 1, and holds on to the
+*	commands of the most recent frame so the driver can look at what would be on screen.
+*	Every mesh's world matrix is worked out each frame, the same as a real backend would.
+*	Only read the results once whoever is calling Draw has stopped.
+*/
+
+#ifndef RECORDING_RENDER_BACKEND_H
+#define RECORDING_RENDER_BACKEND_H
+
+#include "RenderBackend.h"
+#include <string>
+#include <vector>
+
+class RecordingRenderBackend : public RenderBackend
+{
+private:
+	int m_frameCount;
+	int m_snapshotCount;		// Frames that drew a different snapshot to the frame before
+	long long m_meshCount;
+	long long m_uiCount;
+	int m_outOfOrderCount;		// Frames that drew an older snapshot than one already drawn
+	int m_badAmountCount;		// Frames asked to blend outside 0 to 1
+	unsigned int m_lastTick;
+	const RenderSnapshot* m_lastSnapshot;
+
+	std::vector<std::string> m_lastFrame;
+	std::vector<Matrix> m_lastWorlds;
+
+public:
+	RecordingRenderBackend();
+
+	void Draw(const RenderSnapshot* snapshot, float amount);
+
+	int GetFrameCount() { return m_frameCount; }
+	int GetSnapshotCount() { return m_snapshotCount; }
+	long long GetMeshCount() { return m_meshCount; }
+	long long GetUICount() { return m_uiCount; }
+	int GetOutOfOrderCount() { return m_outOfOrderCount; }
+	int GetBadAmountCount() { return m_badAmountCount; }
+	unsigned int GetLastTick() { return m_lastTick; }
+
+	// One line per command, meshes summed up by file and UI in the order it was drawn
+	const std::vector<std::string>& GetLastFrame() { return m_lastFrame; }
+
+	// World matrix of each of the last frame's meshes (not instances), at the blend it was drawn with
+	const std::vector<Matrix>& GetLastWorlds() { return m_lastWorlds; }
+};
+
+#endif
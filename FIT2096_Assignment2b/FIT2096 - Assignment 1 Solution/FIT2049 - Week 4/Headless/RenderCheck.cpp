@@ -0,0 +1,142 @@
+/*	FIT2096 - Assignment 2b
+*	RenderCheck.cpp
+*	Checks that meshes turning across ±PI are blended the short way round. Each case puts a
+*	mesh in a snapshot turned one way on the tick before and another way on the current tick,
+*	then has the recording backend draw it at blend amounts from 0 to 1. The world matrices it
+*	worked out have to match a rotation that took the shortest way between the two, for pitch,
+*	yaw and roll on their own and all three together.
+*
+*	Usage: render_check [--steps N]
+*/
+
+#include "RecordingRenderBackend.h"
+#include "MathsHelper.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Matrices more different than this in any element don't match
+#define RENDER_CHECK_TOLERANCE 0.0001f
+
+struct AngleCase
+{
+	const char* name;
+	float from;
+	float to;
+};
+
+static const AngleCase ANGLE_CASES[] =
+{
+	{ "3.1 to -3.1",              3.1f,                     -3.1f },
+	{ "-3.1 to 3.1",              -3.1f,                    3.1f },
+	{ "just under PI to -PI",     (float)PI - 0.001f,       -(float)PI + 0.001f },
+	{ "PI to -PI",                (float)PI,                -(float)PI },
+	{ "0 to nearly a full turn",  0.0f,                     2.0f * (float)PI - 0.1f },
+	{ "past a full turn to 0.1",  6.2f,                     0.1f },
+	{ "two turns to 3",           -4.0f * (float)PI + 3.0f, 3.05f },
+	{ "1 to 2",                   1.0f,                     2.0f },
+};
+
+// The rotation each axis should have at amount, worked out from sin and cos rather than LerpAngle
+static float GetExpectedAngle(float from, float to, float amount)
+{
+	float difference = atan2f(sinf(to - from), cosf(to - from));
+	return from + difference * amount;
+}
+
+static bool MatricesMatch(const Matrix& a, const Matrix& b)
+{
+	for (int row = 0; row < 4; row++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			if (fabsf(a.m[row][column] - b.m[row][column]) > RENDER_CHECK_TOLERANCE)
+				return false;
+		}
+	}
+
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	int steps = 16;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--steps") == 0 && i + 1 < argc)
+		{
+			steps = atoi(argv[++i]);
+		}
+		else
+		{
+			fprintf(stderr, "Usage: %s [--steps N]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	if (steps < 1)
+		steps = 1;
+
+	// Turning around x, y, z on their own and then all at once
+	const Vector3 axes[] = { Vector3(1, 0, 0), Vector3(0, 1, 0), Vector3(0, 0, 1), Vector3(1, 1, 1) };
+	const char* axisNames[] = { "pitch", "yaw", "roll", "all three" };
+	const int axisCount = 4;
+
+	int caseCount = sizeof(ANGLE_CASES) / sizeof(ANGLE_CASES[0]);
+	int failures = 0;
+
+	RecordingRenderBackend recorder;
+	RenderSnapshot snapshot;
+
+	for (int c = 0; c < caseCount; c++)
+	{
+		const AngleCase& angles = ANGLE_CASES[c];
+
+		// One mesh per axis, moving as well so the translation is checked alongside
+		snapshot.Clear();
+		snapshot.tick++;
+
+		for (int a = 0; a < axisCount; a++)
+		{
+			snapshot.AddMesh(NULL, NULL, NULL, Vector3((float)a, 0.0f, 0.0f), Vector3((float)a, 1.0f, 2.0f),
+				axes[a] * angles.from, axes[a] * angles.to, Vector3(1.0f, 2.0f, 3.0f));
+		}
+
+		for (int step = 0; step <= steps; step++)
+		{
+			float amount = step / (float)steps;
+			recorder.Draw(&snapshot, amount);
+
+			const std::vector<Matrix>& worlds = recorder.GetLastWorlds();
+			float angle = GetExpectedAngle(angles.from, angles.to, amount);
+
+			for (int a = 0; a < axisCount; a++)
+			{
+				Vector3 rotation = axes[a] * angle;
+				Vector3 position = Vector3::Lerp(Vector3((float)a, 0.0f, 0.0f), Vector3((float)a, 1.0f, 2.0f), amount);
+				Matrix expected = Matrix::CreateScale(1.0f, 2.0f, 3.0f) *
+					Matrix::CreateFromYawPitchRoll(rotation.y, rotation.x, rotation.z) * Matrix::CreateTranslation(position);
+
+				if (worlds.size() != (unsigned int)axisCount || !MatricesMatch(worlds[a], expected))
+				{
+					fprintf(stderr, "  %s, %s at %.3f: not turned the short way round\n", angles.name, axisNames[a], amount);
+					failures++;
+				}
+			}
+		}
+	}
+
+	printf("Render blend check (%d turns, %d axes, %d steps each)\n", caseCount, axisCount, steps);
+	printf("  %d frames drawn, %d wrong world matrices\n", recorder.GetFrameCount(), failures);
+
+	if (failures > 0 || recorder.GetBadAmountCount() > 0 || recorder.GetOutOfOrderCount() > 0)
+	{
+		fprintf(stderr, "Meshes were not blended the short way round\n");
+		return 1;
+	}
+
+	return 0;
+}
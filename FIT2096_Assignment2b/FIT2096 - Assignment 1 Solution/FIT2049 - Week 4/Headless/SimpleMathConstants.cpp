@@ -0,0 +1,45 @@
+/*	FIT2096 - Assignment 2b
+*	SimpleMathConstants.cpp
+*	SimpleMath.h declares its constants (Vector3::Zero, Matrix::Identity and friends) but the
+*	definitions live in DirectXTK's SimpleMath.cpp, which the Linux targets don't link.
+*	These are the same values DirectXTK uses.
+*/
+
+#include "DirectXTK/SimpleMath.h"
+
+namespace DirectX
+{
+namespace SimpleMath
+{
+	const Vector2 Vector2::Zero(0.f, 0.f);
+	const Vector2 Vector2::One(1.f, 1.f);
+	const Vector2 Vector2::UnitX(1.f, 0.f);
+	const Vector2 Vector2::UnitY(0.f, 1.f);
+
+	const Vector3 Vector3::Zero(0.f, 0.f, 0.f);
+	const Vector3 Vector3::One(1.f, 1.f, 1.f);
+	const Vector3 Vector3::UnitX(1.f, 0.f, 0.f);
+	const Vector3 Vector3::UnitY(0.f, 1.f, 0.f);
+	const Vector3 Vector3::UnitZ(0.f, 0.f, 1.f);
+	const Vector3 Vector3::Up(0.f, 1.f, 0.f);
+	const Vector3 Vector3::Down(0.f, -1.f, 0.f);
+	const Vector3 Vector3::Right(1.f, 0.f, 0.f);
+	const Vector3 Vector3::Left(-1.f, 0.f, 0.f);
+	const Vector3 Vector3::Forward(0.f, 0.f, -1.f);
+	const Vector3 Vector3::Backward(0.f, 0.f, 1.f);
+
+	const Vector4 Vector4::Zero(0.f, 0.f, 0.f, 0.f);
+	const Vector4 Vector4::One(1.f, 1.f, 1.f, 1.f);
+	const Vector4 Vector4::UnitX(1.f, 0.f, 0.f, 0.f);
+	const Vector4 Vector4::UnitY(0.f, 1.f, 0.f, 0.f);
+	const Vector4 Vector4::UnitZ(0.f, 0.f, 1.f, 0.f);
+	const Vector4 Vector4::UnitW(0.f, 0.f, 0.f, 1.f);
+
+	const Matrix Matrix::Identity(1.f, 0.f, 0.f, 0.f,
+		0.f, 1.f, 0.f, 0.f,
+		0.f, 0.f, 1.f, 0.f,
+		0.f, 0.f, 0.f, 1.f);
+
+	const Quaternion Quaternion::Identity(0.f, 0.f, 0.f, 1.f);
+}
+}
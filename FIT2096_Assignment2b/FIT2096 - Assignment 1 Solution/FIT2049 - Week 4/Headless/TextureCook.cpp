@@ -0,0 +1,322 @@
+/*	FIT2096 - Assignment 2b
+*	TextureCook.cpp
+*	Offline converter from PNG to the cooked texture format in CookedTexture.h.
+*	With no files given it cooks every .png in Assets/Textures, skipping any whose .dds is already
+*	newer. PNGs are read with libpng, which is everywhere on Linux and doesn't need WIC.
+*
+*	The format defaults to BC1 for opaque images and BC3 for ones with any transparency. BC7 is
+*	there for smooth gradients that band in BC1. Images that aren't a multiple of 4 across and down
+*	can't be block compressed, so they're stored as RGBA8 (still with their mips).
+*
+*	Each cooked file is read back through the same mapped path the game uses and checked against
+*	what was written. The time to decode the PNG and to load the cooked file is printed, along with
+*	how far the compressed top level is from the original as a PSNR.
+*
+*	Usage: texturecook [--force] [--format auto|rgba|bc1|bc3|bc7] [--dir folder] [file.png ...]
+*/
+
+#include "BlockCompression.h"
+#include "CookedTexture.h"
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <png.h>
+
+using namespace std;
+
+// DXGI_FORMAT_UNKNOWN stands for auto
+struct CookOptions
+{
+	bool force;
+	DXGI_FORMAT format;
+	const char* folder;
+	vector<string> files;
+};
+
+static bool ParseFormat(const char* name, DXGI_FORMAT* format)
+{
+	if (strcmp(name, "auto") == 0)
+		*format = DXGI_FORMAT_UNKNOWN;
+	else if (strcmp(name, "rgba") == 0)
+		*format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	else if (strcmp(name, "bc1") == 0)
+		*format = DXGI_FORMAT_BC1_UNORM;
+	else if (strcmp(name, "bc3") == 0)
+		*format = DXGI_FORMAT_BC3_UNORM;
+	else if (strcmp(name, "bc7") == 0)
+		*format = DXGI_FORMAT_BC7_UNORM;
+	else
+		return false;
+
+	return true;
+}
+
+static const char* GetFormatName(DXGI_FORMAT format)
+{
+	switch (format)
+	{
+	case DXGI_FORMAT_BC1_UNORM:
+		return "BC1";
+	case DXGI_FORMAT_BC3_UNORM:
+		return "BC3";
+	case DXGI_FORMAT_BC7_UNORM:
+		return "BC7";
+	default:
+		return "RGBA8";
+	}
+}
+
+static bool ParseOptions(int argc, char** argv, CookOptions* options)
+{
+	options->force = false;
+	options->format = DXGI_FORMAT_UNKNOWN;
+	options->folder = "Assets/Textures";
+
+	for (int i = 1; i < argc; i++)
+	{
+		bool hasValue = i + 1 < argc;
+
+		if (strcmp(argv[i], "--force") == 0)
+			options->force = true;
+		else if (strcmp(argv[i], "--format") == 0 && hasValue && ParseFormat(argv[i + 1], &options->format))
+			i++;
+		else if (strcmp(argv[i], "--dir") == 0 && hasValue)
+			options->folder = argv[++i];
+		else if (argv[i][0] != '-')
+			options->files.push_back(argv[i]);
+		else
+		{
+			fprintf(stderr, "Unknown or incomplete option: %s\n", argv[i]);
+			return false;
+		}
+	}
+
+	return true;
+}
+
+static double SecondsSince(std::chrono::high_resolution_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+static bool EndsWith(const string& text, const char* suffix)
+{
+	size_t length = strlen(suffix);
+	return text.size() >= length && text.compare(text.size() - length, length, suffix) == 0;
+}
+
+// Every .png directly inside the folder, sorted so the output is always in the same order
+static bool FindPngFiles(const char* folder, vector<string>* files)
+{
+	DIR* directory = opendir(folder);
+	if (!directory)
+		return false;
+
+	struct dirent* entry;
+	while ((entry = readdir(directory)) != NULL)
+	{
+		string name = entry->d_name;
+		if (EndsWith(name, ".png"))
+			files->push_back(string(folder) + "/" + name);
+	}
+
+	closedir(directory);
+	sort(files->begin(), files->end());
+	return true;
+}
+
+// Whatever the PNG holds (palette, grey, 16 bit) comes out as RGBA8, the same as WIC gives the game
+static bool ReadPng(const char* filename, vector<unsigned char>* pixels, unsigned int* width, unsigned int* height)
+{
+	png_image image;
+	memset(&image, 0, sizeof(image));
+	image.version = PNG_IMAGE_VERSION;
+
+	if (!png_image_begin_read_from_file(&image, filename))
+		return false;
+
+	image.format = PNG_FORMAT_RGBA;
+	pixels->resize(PNG_IMAGE_SIZE(image));
+
+	if (!png_image_finish_read(&image, NULL, &(*pixels)[0], 0, NULL))
+	{
+		png_image_free(&image);
+		return false;
+	}
+
+	*width = image.width;
+	*height = image.height;
+	return true;
+}
+
+static DXGI_FORMAT ChooseFormat(DXGI_FORMAT requested, const vector<unsigned char>& pixels, unsigned int width, unsigned int height)
+{
+	if (width % 4 != 0 || height % 4 != 0)
+		return DXGI_FORMAT_R8G8B8A8_UNORM;
+
+	if (requested != DXGI_FORMAT_UNKNOWN)
+		return requested;
+
+	for (size_t i = 3; i < pixels.size(); i += 4)
+	{
+		if (pixels[i] != 255)
+			return DXGI_FORMAT_BC3_UNORM;
+	}
+
+	return DXGI_FORMAT_BC1_UNORM;
+}
+
+// Reads the file back the way Texture::Load does and makes sure every level is what we meant to write
+static bool CheckCookedFile(const char* filename, CookedTexture* cooked, double* loadSeconds)
+{
+	std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+	MappedFile file;
+	if (!file.Open(filename))
+		return false;
+
+	D3D11_TEXTURE2D_DESC description;
+	vector<D3D11_SUBRESOURCE_DATA> levels;
+	if (!CookedTexture::Validate(file.GetData(), file.GetSize(), &description, &levels))
+		return false;
+
+	// Stand in for the upload by copying every level out once
+	vector<char> upload;
+	for (unsigned int i = 0; i < levels.size(); i++)
+	{
+		const char* data = (const char*)levels[i].pSysMem;
+		upload.insert(upload.end(), data, data + levels[i].SysMemSlicePitch);
+	}
+
+	*loadSeconds = SecondsSince(start);
+
+	if (description.Width != cooked->width || description.Height != cooked->height || description.Format != cooked->format ||
+		levels.size() != cooked->levels.size())
+		return false;
+
+	for (unsigned int i = 0; i < levels.size(); i++)
+	{
+		if (levels[i].SysMemSlicePitch != cooked->levels[i].size() || memcmp(levels[i].pSysMem, &cooked->levels[i][0], cooked->levels[i].size()) != 0)
+			return false;
+	}
+
+	return true;
+}
+
+// How close the top level decodes to the original, over all four channels. Infinite when it's exact.
+static double MeasurePsnr(CookedTexture* cooked, const vector<unsigned char>& pixels)
+{
+	if (!BlockCompression::IsCompressed(cooked->format))
+		return INFINITY;
+
+	vector<unsigned char> decoded(pixels.size());
+	BlockCompression::Decode(cooked->format, &cooked->levels[0][0], cooked->width, cooked->height, &decoded[0]);
+
+	double squaredError = 0.0;
+	for (size_t i = 0; i < pixels.size(); i++)
+	{
+		double difference = (double)pixels[i] - decoded[i];
+		squaredError += difference * difference;
+	}
+
+	if (squaredError == 0.0)
+		return INFINITY;
+
+	return 10.0 * log10(255.0 * 255.0 * pixels.size() / squaredError);
+}
+
+int main(int argc, char** argv)
+{
+	CookOptions options;
+	if (!ParseOptions(argc, argv, &options))
+	{
+		fprintf(stderr, "Usage: %s [--force] [--format auto|rgba|bc1|bc3|bc7] [--dir folder] [file.png ...]\n", argv[0]);
+		return 1;
+	}
+
+	if (options.files.empty() && !FindPngFiles(options.folder, &options.files))
+	{
+		fprintf(stderr, "Could not read %s\n", options.folder);
+		return 1;
+	}
+
+	int cookedCount = 0;
+	int skippedCount = 0;
+	int failedCount = 0;
+
+	for (unsigned int i = 0; i < options.files.size(); i++)
+	{
+		const char* source = options.files[i].c_str();
+		string target = CookedTexture::GetCookedFilename(source);
+
+		if (!options.force && CookedTexture::IsUpToDate(source, target.c_str()))
+		{
+			printf("  %-40s up to date\n", target.c_str());
+			skippedCount++;
+			continue;
+		}
+
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+
+		vector<unsigned char> pixels;
+		unsigned int width;
+		unsigned int height;
+
+		if (!ReadPng(source, &pixels, &width, &height))
+		{
+			fprintf(stderr, "  %-40s could not be read\n", source);
+			failedCount++;
+			continue;
+		}
+
+		double decodeSeconds = SecondsSince(start);
+
+		DXGI_FORMAT format = ChooseFormat(options.format, pixels, width, height);
+		if (format == DXGI_FORMAT_R8G8B8A8_UNORM && options.format != DXGI_FORMAT_R8G8B8A8_UNORM)
+			printf("  %-40s %ux%u isn't whole 4x4 blocks, stored as %s instead\n", source, width, height, GetFormatName(format));
+
+		CookedTexture cooked;
+		double loadSeconds = 0.0;
+
+		if (!CookedTexture::Cook(&pixels[0], width, height, format, &cooked) || !cooked.Save(target.c_str()) ||
+			!CheckCookedFile(target.c_str(), &cooked, &loadSeconds))
+		{
+			fprintf(stderr, "  %-40s could not be written\n", target.c_str());
+			remove(target.c_str());
+			failedCount++;
+			continue;
+		}
+
+		MappedFile sourceFile;
+		MappedFile targetFile;
+		sourceFile.Open(source);
+		targetFile.Open(target.c_str());
+
+		// What the GPU holds for the top level, against the RGBA8 WIC would have made
+		size_t uncompressedSize = (size_t)width * height * 4;
+		double psnr = MeasurePsnr(&cooked, pixels);
+
+		char psnrText[32];
+		if (std::isinf(psnr))
+			snprintf(psnrText, sizeof(psnrText), "exact");
+		else
+			snprintf(psnrText, sizeof(psnrText), "%.1f dB", psnr);
+
+		printf("  %-40s %4ux%-4u %-5s %2d mips, %7.1f KB -> %6.1f KB (top level %5.1f%% of RGBA8), PSNR %s, load %7.3f ms -> %6.3f ms\n",
+			target.c_str(), width, height, GetFormatName(format), (int)cooked.levels.size(), sourceFile.GetSize() / 1024.0,
+			targetFile.GetSize() / 1024.0, 100.0 * cooked.levels[0].size() / uncompressedSize,
+			psnrText, decodeSeconds * 1000.0, loadSeconds * 1000.0);
+		cookedCount++;
+	}
+
+	printf("%d cooked, %d up to date, %d failed\n", cookedCount, skippedCount, failedCount);
+	return failedCount > 0 ? 1 : 0;
+}
@@ -43,7 +43,7 @@ void HealthPack::Update(float timestep)
 
 void HealthPack::Respawn()
 {
-	m_position = m_spawnPoint;
+	SetPosition(m_spawnPoint);
 }
 
 // Collisions
@@ -54,7 +54,7 @@ void HealthPack::OnPlayerCollisionEnter()
 	m_isUsed = true;
 	// Move to other places
 	
-	m_position = Vector3(-10.0f, -10.0f, 0.0f);  // Sink it to the ground
+	SetPosition(Vector3(-10.0f, -10.0f, 0.0f));  // Sink it to the ground
 }
 
 void HealthPack::OnPlayerCollisionStay()
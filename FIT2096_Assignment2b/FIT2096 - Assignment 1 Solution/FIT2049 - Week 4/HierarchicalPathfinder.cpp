@@ -0,0 +1,804 @@
+/*	FIT2096 - Assignment 2b
+*	HierarchicalPathfinder.cpp
+*	Implementation of HierarchicalPathfinder.h
+*/
+
+#include "HierarchicalPathfinder.h"
+#include <algorithm>
+#include <cmath>
+#include <functional>
+
+// Same steps as the flow field, 10 straight and 14 diagonally, no cutting corners
+static const int NEIGHBOUR_COUNT = 8;
+static const int NEIGHBOUR_X[NEIGHBOUR_COUNT] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int NEIGHBOUR_Z[NEIGHBOUR_COUNT] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+static const int NEIGHBOUR_COST[NEIGHBOUR_COUNT] = { 10, 10, 10, 10, 14, 14, 14, 14 };
+
+// The two straight neighbours a diagonal step squeezes between
+static const int DIAGONAL_SIDE_X[NEIGHBOUR_COUNT] = { -1, -1, -1, -1, 0, 0, 1, 1 };
+static const int DIAGONAL_SIDE_Z[NEIGHBOUR_COUNT] = { -1, -1, -1, -1, 2, 3, 2, 3 };
+
+// Width of a row in the local arrays, which have a blocked cell at each end
+#define LOCAL_STRIDE (PATHFINDER_SECTOR_SIZE + 2)
+
+// Stepping across an entrance is always a straight step
+#define ENTRANCE_COST 10
+
+// Crossing a 4096 x 4096 board takes a few hundred, stops a search for somewhere unreachable running for ages
+#define DEFAULT_SEARCH_LIMIT 20000
+
+// Marks the goal in the open list
+#define GOAL_ENTRY -1
+
+// Never overestimates when steps cost 10 straight and 14 diagonally
+static int EstimateCost(int fromX, int fromZ, int toX, int toZ)
+{
+	int dx = abs(toX - fromX);
+	int dz = abs(toZ - fromZ);
+	int diagonal = dx < dz ? dx : dz;
+
+	return 10 * (dx + dz) - 6 * diagonal;
+}
+
+// Between entrances we overestimate a little. Scattered obstacles make real routes a few percent
+// longer than the estimate, and an exact estimate then has A* trying every entrance in a wide band
+// either side of the route. Routes come out at most this much longer than the best one.
+#define ROUTE_ESTIMATE_PERCENT 120
+
+static int EstimateRouteCost(int fromX, int fromZ, int toX, int toZ)
+{
+	return EstimateCost(fromX, fromZ, toX, toZ) * ROUTE_ESTIMATE_PERCENT / 100;
+}
+
+// Open list ordering for searching between entrances. Lowest estimated total first, and when
+// those are equal (which happens a lot on open ground) whoever has come furthest, so the search
+// runs straight at the goal instead of fanning out across every equally good route.
+static long long MakeKey(int estimate, int cost)
+{
+	return ((long long)estimate << 32) | (unsigned int)(0x7fffffff - cost);
+}
+
+static int GetKeyEstimate(long long key)
+{
+	return (int)(key >> 32);
+}
+
+HierarchicalPathfinder::HierarchicalPathfinder()
+{
+	m_tiles = NULL;
+	m_width = 0;
+	m_height = 0;
+	m_sectorsX = 0;
+	m_sectorsZ = 0;
+	m_localSector = -1;
+	m_localMinX = 0;
+	m_localMinZ = 0;
+	m_localSearch = 0;
+	m_localTargetsLeft = 0;
+	m_nodeSearch = 0;
+	m_searchLimit = DEFAULT_SEARCH_LIMIT;
+	m_queryCount = 0;
+	m_cacheHits = 0;
+	m_sectorRebuilds = 0;
+	m_sectorConnects = 0;
+	m_expansions = 0;
+
+	for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+	{
+		m_localNeighbourOffsets[n] = NEIGHBOUR_Z[n] * LOCAL_STRIDE + NEIGHBOUR_X[n];
+	}
+}
+
+void HierarchicalPathfinder::Build(TileGrid* tiles)
+{
+	m_tiles = tiles;
+	m_width = tiles->GetWidth();
+	m_height = tiles->GetHeight();
+	m_sectorsX = (m_width + PATHFINDER_SECTOR_SIZE - 1) / PATHFINDER_SECTOR_SIZE;
+	m_sectorsZ = (m_height + PATHFINDER_SECTOR_SIZE - 1) / PATHFINDER_SECTOR_SIZE;
+
+	int sectorCount = m_sectorsX * m_sectorsZ;
+
+	m_nodes.clear();
+	m_freeNodes.clear();
+	m_dirtySectors.clear();
+	m_cache.clear();
+
+	m_sectors.clear();
+	m_sectors.resize(sectorCount);
+	m_eastEntrances.assign(sectorCount, std::vector<int>());
+	m_northEntrances.assign(sectorCount, std::vector<int>());
+
+	for (int i = 0; i < sectorCount; i++)
+	{
+		m_sectors[i].dirty = false;
+		m_sectors[i].connected = false;
+	}
+
+	int localCells = LOCAL_STRIDE * LOCAL_STRIDE;
+	m_localPassable.assign(localCells, 0);
+	m_localSector = -1;
+	m_localCost.assign(localCells, 0);
+	m_localParent.assign(localCells, -1);
+	m_localStamp.assign(localCells, 0);
+	m_localTargetStamp.assign(localCells, 0);
+	m_localSearch = 0;
+
+	m_nodeCost.clear();
+	m_nodeParent.clear();
+	m_nodeStamp.clear();
+	m_goalCost.clear();
+	m_nodeSearch = 0;
+
+	// Finding entrances is a quick walk along each edge. Connecting them up is the slow part,
+	// so that waits until a search actually comes through the sector.
+	for (int sector = 0; sector < sectorCount; sector++)
+	{
+		if (sector % m_sectorsX < m_sectorsX - 1)
+			FindEntrances(sector, true);
+
+		if (sector / m_sectorsX < m_sectorsZ - 1)
+			FindEntrances(sector, false);
+	}
+}
+
+void HierarchicalPathfinder::GetSectorBounds(int sector, int* minX, int* minZ, int* maxX, int* maxZ)
+{
+	*minX = (sector % m_sectorsX) * PATHFINDER_SECTOR_SIZE;
+	*minZ = (sector / m_sectorsX) * PATHFINDER_SECTOR_SIZE;
+
+	// The last row and column of sectors can be cut short by the edge of the board
+	*maxX = *minX + PATHFINDER_SECTOR_SIZE - 1;
+	*maxZ = *minZ + PATHFINDER_SECTOR_SIZE - 1;
+
+	if (*maxX > m_width - 1)
+		*maxX = m_width - 1;
+
+	if (*maxZ > m_height - 1)
+		*maxZ = m_height - 1;
+}
+
+int HierarchicalPathfinder::AddNode(int x, int z, int partner)
+{
+	int id;
+
+	if (m_freeNodes.size() > 0)
+	{
+		id = m_freeNodes.back();
+		m_freeNodes.pop_back();
+	}
+	else
+	{
+		id = (int)m_nodes.size();
+		m_nodes.push_back(PathNode());
+	}
+
+	m_nodes[id].x = x;
+	m_nodes[id].z = z;
+	m_nodes[id].sector = GetSector(x, z);
+	m_nodes[id].partner = partner;
+	m_nodes[id].edges.clear();
+
+	m_sectors[m_nodes[id].sector].nodes.push_back(id);
+
+	return id;
+}
+
+void HierarchicalPathfinder::RemoveEntrances(std::vector<int>* entrances)
+{
+	for (unsigned int i = 0; i < entrances->size(); i++)
+	{
+		int id = (*entrances)[i];
+		std::vector<int>& sectorNodes = m_sectors[m_nodes[id].sector].nodes;
+
+		for (unsigned int j = 0; j < sectorNodes.size(); j++)
+		{
+			if (sectorNodes[j] == id)
+			{
+				sectorNodes[j] = sectorNodes.back();
+				sectorNodes.pop_back();
+				break;
+			}
+		}
+
+		m_nodes[id].sector = -1;
+		m_nodes[id].partner = -1;
+		m_nodes[id].edges.clear();
+		m_freeNodes.push_back(id);
+	}
+
+	entrances->clear();
+}
+
+void HierarchicalPathfinder::FindEntrances(int sector, bool east)
+{
+	int minX, minZ, maxX, maxZ;
+	GetSectorBounds(sector, &minX, &minZ, &maxX, &maxZ);
+
+	std::vector<int>& entrances = east ? m_eastEntrances[sector] : m_northEntrances[sector];
+
+	// Walk along the edge looking for stretches where both sides can be walked on
+	int first = east ? minZ : minX;
+	int last = east ? maxZ : maxX;
+	int runStart = -1;
+
+	for (int i = first; i <= last + 1; i++)
+	{
+		bool open = false;
+
+		if (i <= last)
+		{
+			open = east ? m_tiles->IsWalkable(maxX, i) && m_tiles->IsWalkable(maxX + 1, i)
+				: m_tiles->IsWalkable(i, maxZ) && m_tiles->IsWalkable(i, maxZ + 1);
+		}
+
+		if (open && runStart == -1)
+		{
+			runStart = i;
+		}
+		else if (!open && runStart != -1)
+		{
+			// Wide openings get an entrance at each end so routes don't all funnel through the middle
+			int runEnd = i - 1;
+			int positions[2] = { (runStart + runEnd) / 2, -1 };
+
+			if (runEnd - runStart + 1 >= PATHFINDER_WIDE_ENTRANCE)
+			{
+				positions[0] = runStart;
+				positions[1] = runEnd;
+			}
+
+			for (int p = 0; p < 2 && positions[p] != -1; p++)
+			{
+				int ours = east ? AddNode(maxX, positions[p], -1) : AddNode(positions[p], maxZ, -1);
+				int theirs = east ? AddNode(maxX + 1, positions[p], ours) : AddNode(positions[p], maxZ + 1, ours);
+				m_nodes[ours].partner = theirs;
+
+				entrances.push_back(ours);
+				entrances.push_back(theirs);
+			}
+
+			runStart = -1;
+		}
+	}
+}
+
+void HierarchicalPathfinder::ConnectSector(int sector)
+{
+	std::vector<int>& nodes = m_sectors[sector].nodes;
+
+	for (unsigned int i = 0; i < nodes.size(); i++)
+	{
+		m_nodes[nodes[i]].edges.clear();
+	}
+
+	LoadSector(sector);
+
+	// Paths are the same both ways, so each pair only needs finding once
+	for (unsigned int i = 0; i + 1 < nodes.size(); i++)
+	{
+		PathNode& from = m_nodes[nodes[i]];
+
+		// The search can stop once it has reached every node we still need a distance to
+		m_localTargetsLeft = 0;
+
+		for (unsigned int j = i + 1; j < nodes.size(); j++)
+		{
+			int target = GetLocalIndex(m_nodes[nodes[j]].x, m_nodes[nodes[j]].z);
+
+			if (m_localTargetStamp[target] != m_localSearch + 1)
+			{
+				m_localTargetStamp[target] = m_localSearch + 1;
+				m_localTargetsLeft++;
+			}
+		}
+
+		SearchSector(sector, from.x, from.z, -1, -1);
+
+		for (unsigned int j = i + 1; j < nodes.size(); j++)
+		{
+			PathNode& to = m_nodes[nodes[j]];
+			int cost = GetLocalCost(sector, to.x, to.z);
+
+			if (cost >= 0)
+			{
+				from.edges.push_back(std::make_pair(nodes[j], cost));
+				to.edges.push_back(std::make_pair(nodes[i], cost));
+			}
+		}
+	}
+
+	m_sectors[sector].connected = true;
+	m_sectorConnects++;
+}
+
+void HierarchicalPathfinder::RebuildSector(int sector)
+{
+	int sectorX = sector % m_sectorsX;
+	int sectorZ = sector / m_sectorsX;
+
+	// Our four edges, two of which belong to the sectors to the left and below
+	if (sectorX < m_sectorsX - 1)
+	{
+		RemoveEntrances(&m_eastEntrances[sector]);
+		FindEntrances(sector, true);
+		m_sectors[sector + 1].connected = false;
+	}
+	if (sectorZ < m_sectorsZ - 1)
+	{
+		RemoveEntrances(&m_northEntrances[sector]);
+		FindEntrances(sector, false);
+		m_sectors[sector + m_sectorsX].connected = false;
+	}
+	if (sectorX > 0)
+	{
+		RemoveEntrances(&m_eastEntrances[sector - 1]);
+		FindEntrances(sector - 1, true);
+		m_sectors[sector - 1].connected = false;
+	}
+	if (sectorZ > 0)
+	{
+		RemoveEntrances(&m_northEntrances[sector - m_sectorsX]);
+		FindEntrances(sector - m_sectorsX, false);
+		m_sectors[sector - m_sectorsX].connected = false;
+	}
+
+	m_sectors[sector].connected = false;
+	m_sectors[sector].dirty = false;
+	m_sectorRebuilds++;
+}
+
+void HierarchicalPathfinder::OnTileChanged(int x, int z)
+{
+	if (!m_tiles || !m_tiles->IsInside(x, z))
+		return;
+
+	int sector = GetSector(x, z);
+
+	if (!m_sectors[sector].dirty)
+	{
+		m_sectors[sector].dirty = true;
+		m_dirtySectors.push_back(sector);
+	}
+}
+
+void HierarchicalPathfinder::UpdateDirtySectors()
+{
+	if (m_dirtySectors.size() == 0)
+		return;
+
+	for (unsigned int i = 0; i < m_dirtySectors.size(); i++)
+	{
+		RebuildSector(m_dirtySectors[i]);
+	}
+
+	m_dirtySectors.clear();
+	m_localSector = -1;
+
+	// Nodes have been thrown away and reused, none of the remembered routes can be trusted
+	m_cache.clear();
+}
+
+void HierarchicalPathfinder::LoadSector(int sector)
+{
+	if (sector == m_localSector)
+		return;
+
+	int minX, minZ, maxX, maxZ;
+	GetSectorBounds(sector, &minX, &minZ, &maxX, &maxZ);
+
+	m_localSector = sector;
+	m_localMinX = minX;
+	m_localMinZ = minZ;
+
+	// Everything outside the sector (including the part of a short sector past the edge of the board) stays blocked
+	m_localPassable.assign(m_localPassable.size(), 0);
+
+	for (int z = minZ; z <= maxZ; z++)
+	{
+		for (int x = minX; x <= maxX; x++)
+		{
+			m_localPassable[GetLocalIndex(x, z)] = m_tiles->IsWalkable(x, z) ? 1 : 0;
+		}
+	}
+}
+
+int HierarchicalPathfinder::SearchSector(int sector, int startX, int startZ, int goalX, int goalZ)
+{
+	LoadSector(sector);
+
+	// New search, anything stamped with an older number is unvisited
+	m_localSearch++;
+	if (m_localSearch == 0)
+	{
+		m_localStamp.assign(m_localStamp.size(), 0);
+		m_localSearch = 1;
+	}
+
+	bool hasGoal = goalX >= 0;
+	int start = GetLocalIndex(startX, startZ);
+	int goal = hasGoal ? GetLocalIndex(goalX, goalZ) : -1;
+	int goalLocalX = goal % LOCAL_STRIDE;
+	int goalLocalZ = goal / LOCAL_STRIDE;
+
+	m_localCost[start] = 0;
+	m_localParent[start] = -1;
+	m_localStamp[start] = m_localSearch;
+
+	// Cells are expanded in order of estimated total cost, which never goes down along a path
+	int current = hasGoal ? EstimateCost(start % LOCAL_STRIDE, start / LOCAL_STRIDE, goalLocalX, goalLocalZ) : 0;
+	int pending = 1;
+	int result = -1;
+	bool finished = false;
+
+	m_buckets[current % PATHFINDER_BUCKET_COUNT].push_back(start);
+
+	while (pending > 0 && !finished)
+	{
+		// A straight step towards the goal doesn't change the estimate, so this bucket can grow while we walk it
+		std::vector<int>& bucket = m_buckets[current % PATHFINDER_BUCKET_COUNT];
+
+		for (unsigned int i = 0; i < bucket.size(); i++)
+		{
+			int cell = bucket[i];
+			int cost = m_localCost[cell];
+			pending--;
+
+			// Found a cheaper way here since this was added
+			if (cost + (hasGoal ? EstimateCost(cell % LOCAL_STRIDE, cell / LOCAL_STRIDE, goalLocalX, goalLocalZ) : 0) != current)
+				continue;
+
+			if (cell == goal)
+			{
+				result = cost;
+				finished = true;
+				break;
+			}
+
+			if (m_localTargetsLeft > 0 && m_localTargetStamp[cell] == m_localSearch && --m_localTargetsLeft == 0)
+			{
+				finished = true;
+				break;
+			}
+
+			bool steps[NEIGHBOUR_COUNT];
+
+			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+			{
+				steps[n] = m_localPassable[cell + m_localNeighbourOffsets[n]] != 0;
+			}
+
+			for (int n = 0; n < NEIGHBOUR_COUNT; n++)
+			{
+				// Squeezing diagonally past the corner of a blocked cell isn't allowed
+				if (!steps[n] || (n >= 4 && (!steps[DIAGONAL_SIDE_X[n]] || !steps[DIAGONAL_SIDE_Z[n]])))
+					continue;
+
+				int next = cell + m_localNeighbourOffsets[n];
+				int nextCost = cost + NEIGHBOUR_COST[n];
+
+				if (m_localStamp[next] != m_localSearch || nextCost < m_localCost[next])
+				{
+					m_localCost[next] = nextCost;
+					m_localParent[next] = cell;
+					m_localStamp[next] = m_localSearch;
+
+					int estimate = nextCost + (hasGoal ? EstimateCost(next % LOCAL_STRIDE, next / LOCAL_STRIDE, goalLocalX, goalLocalZ) : 0);
+					m_buckets[estimate % PATHFINDER_BUCKET_COUNT].push_back(next);
+					pending++;
+				}
+			}
+		}
+
+		bucket.clear();
+		current++;
+	}
+
+	// Stopping early can leave cells waiting in other buckets
+	m_localTargetsLeft = 0;
+
+	if (pending > 0)
+	{
+		for (int i = 0; i < PATHFINDER_BUCKET_COUNT; i++)
+		{
+			m_buckets[i].clear();
+		}
+	}
+
+	return result;
+}
+
+int HierarchicalPathfinder::GetLocalCost(int sector, int x, int z)
+{
+	LoadSector(sector);
+
+	int cell = GetLocalIndex(x, z);
+
+	return m_localStamp[cell] == m_localSearch ? m_localCost[cell] : -1;
+}
+
+bool HierarchicalPathfinder::AppendLocalPath(int sector, int goalX, int goalZ)
+{
+	LoadSector(sector);
+
+	int cell = GetLocalIndex(goalX, goalZ);
+
+	if (m_localStamp[cell] != m_localSearch)
+		return false;
+
+	// Parents lead back to the start, add them backwards then flip them around (leaving the start off)
+	unsigned int first = m_cells.size();
+
+	while (m_localParent[cell] != -1)
+	{
+		int x = m_localMinX + cell % LOCAL_STRIDE - 1;
+		int z = m_localMinZ + cell / LOCAL_STRIDE - 1;
+		m_cells.push_back(m_tiles->GetIndex(x, z));
+		cell = m_localParent[cell];
+	}
+
+	std::reverse(m_cells.begin() + first, m_cells.end());
+
+	return true;
+}
+
+bool HierarchicalPathfinder::SearchRoute(int startX, int startZ, int goalX, int goalZ)
+{
+	int startSector = GetSector(startX, startZ);
+	int goalSector = GetSector(goalX, goalZ);
+
+	m_route.clear();
+
+	// New search, anything stamped with an older number is unvisited
+	m_nodeSearch++;
+	if (m_nodeSearch == 0)
+	{
+		m_nodeStamp.assign(m_nodeStamp.size(), 0);
+		m_nodeSearch = 1;
+	}
+
+	if (m_nodeCost.size() < m_nodes.size())
+	{
+		m_nodeCost.resize(m_nodes.size());
+		m_nodeParent.resize(m_nodes.size());
+		m_nodeStamp.resize(m_nodes.size(), 0);
+		m_goalCost.resize(m_nodes.size());
+	}
+
+	// How far each node in the goal sector is from the goal (paths are the same both ways)
+	std::vector<int>& goalNodes = m_sectors[goalSector].nodes;
+	SearchSector(goalSector, goalX, goalZ, -1, -1);
+
+	bool goalHasWayOut = false;
+
+	for (unsigned int i = 0; i < goalNodes.size(); i++)
+	{
+		m_goalCost[goalNodes[i]] = GetLocalCost(goalSector, m_nodes[goalNodes[i]].x, m_nodes[goalNodes[i]].z);
+
+		if (m_goalCost[goalNodes[i]] >= 0)
+			goalHasWayOut = true;
+	}
+
+	// Walled in, no point searching the whole board to find that out
+	if (!goalHasWayOut)
+		return false;
+
+	// Start from every node we can reach in the start sector
+	std::vector<int>& startNodes = m_sectors[startSector].nodes;
+	SearchSector(startSector, startX, startZ, -1, -1);
+
+	m_heap.clear();
+
+	for (unsigned int i = 0; i < startNodes.size(); i++)
+	{
+		int id = startNodes[i];
+		int cost = GetLocalCost(startSector, m_nodes[id].x, m_nodes[id].z);
+
+		if (cost >= 0)
+		{
+			m_nodeCost[id] = cost;
+			m_nodeParent[id] = -1;
+			m_nodeStamp[id] = m_nodeSearch;
+
+			m_heap.push_back(std::make_pair(MakeKey(cost + EstimateRouteCost(m_nodes[id].x, m_nodes[id].z, goalX, goalZ), cost), id));
+			std::push_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<long long, int> >());
+		}
+	}
+
+	int bestGoalCost = -1;
+	int bestGoalNode = -1;
+	int expansions = 0;
+
+	while (m_heap.size() > 0)
+	{
+		std::pop_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<long long, int> >());
+		int id = m_heap.back().second;
+		int estimate = GetKeyEstimate(m_heap.back().first);
+		m_heap.pop_back();
+
+		// Nothing left in the open list can beat the way we've found to the goal
+		if (id == GOAL_ENTRY)
+		{
+			if (estimate == bestGoalCost)
+				break;
+
+			continue;
+		}
+
+		int cost = m_nodeCost[id];
+
+		// Already found a cheaper way here since this was added
+		if (estimate != cost + EstimateRouteCost(m_nodes[id].x, m_nodes[id].z, goalX, goalZ))
+			continue;
+
+		expansions++;
+		if (m_searchLimit > 0 && expansions > m_searchLimit)
+		{
+			m_expansions += expansions;
+			return false;
+		}
+
+		// Can we finish from here?
+		if (m_nodes[id].sector == goalSector && m_goalCost[id] >= 0)
+		{
+			int total = cost + m_goalCost[id];
+
+			if (bestGoalCost == -1 || total < bestGoalCost)
+			{
+				bestGoalCost = total;
+				bestGoalNode = id;
+
+				// Sorts ahead of any node with the same estimate
+				m_heap.push_back(std::make_pair((long long)total << 32, GOAL_ENTRY));
+				std::push_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<long long, int> >());
+			}
+		}
+
+		if (!m_sectors[m_nodes[id].sector].connected)
+		{
+			ConnectSector(m_nodes[id].sector);
+		}
+
+		// Across the entrance, then to every other node in this sector
+		PathNode& node = m_nodes[id];
+
+		for (int e = -1; e < (int)node.edges.size(); e++)
+		{
+			int next = e == -1 ? node.partner : node.edges[e].first;
+			int nextCost = cost + (e == -1 ? ENTRANCE_COST : node.edges[e].second);
+
+			if (m_nodeStamp[next] != m_nodeSearch || nextCost < m_nodeCost[next])
+			{
+				m_nodeCost[next] = nextCost;
+				m_nodeParent[next] = id;
+				m_nodeStamp[next] = m_nodeSearch;
+
+				m_heap.push_back(std::make_pair(MakeKey(nextCost + EstimateRouteCost(m_nodes[next].x, m_nodes[next].z, goalX, goalZ), nextCost), next));
+				std::push_heap(m_heap.begin(), m_heap.end(), std::greater<std::pair<long long, int> >());
+			}
+		}
+	}
+
+	m_expansions += expansions;
+
+	if (bestGoalNode == -1)
+		return false;
+
+	for (int id = bestGoalNode; id != -1; id = m_nodeParent[id])
+	{
+		m_route.push_back(id);
+	}
+
+	std::reverse(m_route.begin(), m_route.end());
+
+	return true;
+}
+
+bool HierarchicalPathfinder::RefineRoute(int startX, int startZ, int goalX, int goalZ)
+{
+	m_cells.clear();
+	m_cells.push_back(m_tiles->GetIndex(startX, startZ));
+
+	int x = startX;
+	int z = startZ;
+	int previous = -1;
+
+	// Each hop is either straight across an entrance or a walk within one sector
+	for (unsigned int i = 0; i < m_route.size(); i++)
+	{
+		PathNode& node = m_nodes[m_route[i]];
+
+		if (previous != -1 && m_nodes[previous].partner == m_route[i])
+		{
+			m_cells.push_back(m_tiles->GetIndex(node.x, node.z));
+		}
+		else if (SearchSector(node.sector, x, z, node.x, node.z) < 0 || !AppendLocalPath(node.sector, node.x, node.z))
+		{
+			return false;
+		}
+
+		x = node.x;
+		z = node.z;
+		previous = m_route[i];
+	}
+
+	int goalSector = GetSector(goalX, goalZ);
+
+	if (SearchSector(goalSector, x, z, goalX, goalZ) < 0)
+		return false;
+
+	return AppendLocalPath(goalSector, goalX, goalZ);
+}
+
+bool HierarchicalPathfinder::FindPath(Vector3 start, Vector3 goal, std::vector<Vector3>* waypoints)
+{
+	if (!m_tiles)
+		return false;
+
+	// Cells are centred on whole numbers
+	int startX = (int)floorf(start.x + 0.5f);
+	int startZ = (int)floorf(start.z + 0.5f);
+	int goalX = (int)floorf(goal.x + 0.5f);
+	int goalZ = (int)floorf(goal.z + 0.5f);
+
+	if (!m_tiles->IsWalkable(startX, startZ) || !m_tiles->IsWalkable(goalX, goalZ))
+		return false;
+
+	UpdateDirtySectors();
+	m_queryCount++;
+
+	int startSector = GetSector(startX, startZ);
+	int goalSector = GetSector(goalX, goalZ);
+	bool found = false;
+
+	if (startSector == goalSector)
+	{
+		// Try staying inside the sector first, it's nearly always possible
+		m_route.clear();
+		found = RefineRoute(startX, startZ, goalX, goalZ);
+	}
+	else
+	{
+		// Someone has been between these sectors before, see if their route works for us too
+		unsigned long long key = ((unsigned long long)startSector << 32) | (unsigned int)goalSector;
+		std::map<unsigned long long, std::vector<int> >::iterator cached = m_cache.find(key);
+
+		if (cached != m_cache.end())
+		{
+			m_route = cached->second;
+			found = RefineRoute(startX, startZ, goalX, goalZ);
+
+			if (found)
+				m_cacheHits++;
+		}
+	}
+
+	if (!found)
+	{
+		if (!SearchRoute(startX, startZ, goalX, goalZ) || !RefineRoute(startX, startZ, goalX, goalZ))
+			return false;
+
+		if (startSector != goalSector)
+		{
+			if (m_cache.size() >= PATHFINDER_CACHE_SIZE)
+				m_cache.clear();
+
+			m_cache[((unsigned long long)startSector << 32) | (unsigned int)goalSector] = m_route;
+		}
+	}
+
+	// Walk through the middle of each cell after the one we're in, finishing exactly where we were asked to go
+	waypoints->clear();
+
+	for (unsigned int i = 1; i < m_cells.size(); i++)
+	{
+		waypoints->push_back(Vector3((float)(m_cells[i] % m_width), 0.0f, (float)(m_cells[i] / m_width)));
+	}
+
+	if (waypoints->size() > 0)
+		waypoints->back() = goal;
+	else
+		waypoints->push_back(goal);
+
+	return true;
+}
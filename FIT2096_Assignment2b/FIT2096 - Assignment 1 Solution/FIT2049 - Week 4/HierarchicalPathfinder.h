@@ -0,0 +1,160 @@
+/*	FIT2096 - Assignment 2b
+*	HierarchicalPathfinder.h
+*	Finds routes between any two cells of the board quickly, even on very large boards.
+*	The board is cut into square sectors. Wherever you can walk from one sector into the next we
+*	place an entrance, and for every sector we work out how far each of its entrances is from
+*	the others (once, the first time a search passes through it). A search then only has to hop
+*	from entrance to entrance (A* over a small graph) instead of visiting every cell, and the
+*	hops are turned back into cells one sector at a time.
+*	When a tile changes type only its sector (and the entrances it shares with its neighbours)
+*	is worked out again. Routes between sectors are remembered, so enemies wandering between
+*	the same parts of the board don't repeat the search.
+*/
+
+#ifndef HIERARCHICAL_PATHFINDER_H
+#define HIERARCHICAL_PATHFINDER_H
+
+#include "TileGrid.h"
+#include <map>
+#include <vector>
+
+// Width and height of a sector in cells
+#define PATHFINDER_SECTOR_SIZE 32
+
+// Openings between sectors at least this wide get an entrance at each end instead of one in the middle
+#define PATHFINDER_WIDE_ENTRANCE 6
+
+// How many routes between sectors we remember before starting again
+#define PATHFINDER_CACHE_SIZE 4096
+
+// Searches within a sector use a ring of buckets instead of a priority queue, as in the FlowField.
+// An A* step can raise the estimated total by at most 28, so this many buckets is always enough.
+#define PATHFINDER_BUCKET_COUNT 32
+
+class HierarchicalPathfinder
+{
+private:
+	// A cell just inside a sector where you can step across into the next one
+	struct PathNode
+	{
+		int x;
+		int z;
+		int sector;
+		int partner;	// The node on the other side of the entrance
+		std::vector<std::pair<int, int> > edges;	// Other nodes in this sector we can walk to, and how far
+	};
+
+	struct Sector
+	{
+		std::vector<int> nodes;
+		bool dirty;		// A tile changed, find its entrances again before the next search
+		bool connected;	// Distances between its nodes are worked out the first time a search passes through
+	};
+
+	TileGrid* m_tiles;
+	int m_width;
+	int m_height;
+	int m_sectorsX;
+	int m_sectorsZ;
+
+	std::vector<PathNode> m_nodes;
+	std::vector<int> m_freeNodes;	// Node slots thrown away by a rebuild, ready to reuse
+	std::vector<Sector> m_sectors;
+	std::vector<int> m_dirtySectors;
+
+	// Entrances (pairs of nodes, ours then theirs) across the right and top edge of each sector
+	std::vector<std::vector<int> > m_eastEntrances;
+	std::vector<std::vector<int> > m_northEntrances;
+
+	// Routes between sectors (entrance nodes only) keyed by start and goal sector
+	std::map<unsigned long long, std::vector<int> > m_cache;
+
+	// Open list for searching between entrances, (estimated total cost and tie breaker, node)
+	std::vector<std::pair<long long, int> > m_heap;
+
+	// Copy of which cells of one sector can be walked on, with a blocked ring around the outside
+	// so the search never has to check it's still inside the sector. Only redone when the sector changes.
+	std::vector<unsigned char> m_localPassable;
+	int m_localSector;	// -1 when nothing is loaded
+	int m_localMinX;
+	int m_localMinZ;
+	int m_localNeighbourOffsets[8];
+
+	// Scratch space for searching within a sector, stamped so it never needs clearing
+	std::vector<int> m_buckets[PATHFINDER_BUCKET_COUNT];
+	std::vector<int> m_localCost;
+	std::vector<int> m_localParent;
+	std::vector<unsigned int> m_localStamp;
+	unsigned int m_localSearch;
+
+	// Cells a search without a goal can stop after reaching, stamped with the search they belong to
+	std::vector<unsigned int> m_localTargetStamp;
+	int m_localTargetsLeft;	// 0 searches the whole sector
+
+	// Scratch space for searching between entrances
+	std::vector<int> m_nodeCost;
+	std::vector<int> m_nodeParent;
+	std::vector<unsigned int> m_nodeStamp;
+	std::vector<int> m_goalCost;	// Cost from each node in the goal sector to the goal, only valid for those nodes
+	unsigned int m_nodeSearch;
+
+	std::vector<int> m_route;	// Nodes from the start to the goal, filled in by a search
+	std::vector<int> m_cells;	// Cells from the start to the goal
+
+	int m_searchLimit;
+
+	// For checking it's all behaving
+	int m_queryCount;
+	int m_cacheHits;
+	int m_sectorRebuilds;
+	int m_sectorConnects;
+	long long m_expansions;
+
+	int GetSector(int x, int z) { return (z / PATHFINDER_SECTOR_SIZE) * m_sectorsX + x / PATHFINDER_SECTOR_SIZE; }
+	void GetSectorBounds(int sector, int* minX, int* minZ, int* maxX, int* maxZ);
+
+	// Index into the local arrays of a cell in the loaded sector
+	int GetLocalIndex(int x, int z) { return (z - m_localMinZ + 1) * (PATHFINDER_SECTOR_SIZE + 2) + x - m_localMinX + 1; }
+	void LoadSector(int sector);
+
+	int AddNode(int x, int z, int partner);
+	void RemoveEntrances(std::vector<int>* entrances);
+	void FindEntrances(int sector, bool east);
+	void ConnectSector(int sector);
+	void RebuildSector(int sector);
+	void UpdateDirtySectors();
+
+	// A* (or Dijkstra when there's no goal) restricted to a single sector. Costs land in the local scratch arrays.
+	int SearchSector(int sector, int startX, int startZ, int goalX, int goalZ);
+	int GetLocalCost(int sector, int x, int z);
+	bool AppendLocalPath(int sector, int goalX, int goalZ);
+
+	bool SearchRoute(int startX, int startZ, int goalX, int goalZ);
+	bool RefineRoute(int startX, int startZ, int goalX, int goalZ);
+
+public:
+	HierarchicalPathfinder();
+
+	// Cuts the board into sectors and finds every entrance. Call again if the board is regenerated.
+	void Build(TileGrid* tiles);
+
+	// Call after changing a tile's type in the TileGrid
+	void OnTileChanged(int x, int z);
+
+	// Fills waypoints with the middle of each cell to walk through, ending exactly at the goal
+	// Returns false if there's no way there (or the search ran out of steps)
+	bool FindPath(Vector3 start, Vector3 goal, std::vector<Vector3>* waypoints);
+
+	// Caps how many entrances a single search can look at, so a search can't take too long
+	void SetSearchLimit(int limit) { m_searchLimit = limit; }
+
+	int GetSectorCount() { return (int)m_sectors.size(); }
+	int GetNodeCount() { return (int)m_nodes.size() - (int)m_freeNodes.size(); }
+	int GetQueryCount() { return m_queryCount; }
+	int GetCacheHits() { return m_cacheHits; }
+	int GetSectorRebuilds() { return m_sectorRebuilds; }
+	int GetSectorConnects() { return m_sectorConnects; }
+	long long GetExpansions() { return m_expansions; }
+};
+
+#endif
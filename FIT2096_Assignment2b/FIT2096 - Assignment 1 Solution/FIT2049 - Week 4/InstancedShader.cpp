@@ -0,0 +1,108 @@
+/*	FIT2096 - Assignment 2b
+*	InstancedShader.cpp
+*	Implementation of InstancedShader.h
+*/
+
+#include "InstancedShader.h"
+
+#include <cstring>
+
+InstancedShader::InstancedShader() : TexturedShader()
+{
+	m_instanceBuffer = NULL;
+}
+
+InstancedShader::~InstancedShader()
+{
+
+}
+
+bool InstancedShader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename, VertexFormatType vertexFormat)
+{
+	if (!TexturedShader::Initialise(device, vertexFilename, pixelFilename, vertexFormat))
+	{
+		return false;
+	}
+
+	// Rewritten every frame, so it lives where the CPU can write it
+	D3D11_BUFFER_DESC instanceBufferDescription;
+	instanceBufferDescription.Usage = D3D11_USAGE_DYNAMIC;
+	instanceBufferDescription.ByteWidth = sizeof(Vector4) * INSTANCED_SHADER_MAX_INSTANCES;
+	instanceBufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	instanceBufferDescription.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	instanceBufferDescription.MiscFlags = 0;
+	instanceBufferDescription.StructureByteStride = 0;
+
+	if (FAILED(device->CreateBuffer(&instanceBufferDescription, NULL, &m_instanceBuffer)))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+int InstancedShader::GetInputLayout(VertexFormatType vertexFormat, D3D11_INPUT_ELEMENT_DESC* layout)
+{
+	int count = TexturedShader::GetInputLayout(vertexFormat, layout);
+
+	// The instance comes from the second vertex buffer and moves on once per copy of the mesh rather than once per vertex
+	layout[count].SemanticName = "INSTANCE";
+	layout[count].SemanticIndex = 0;
+	layout[count].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	layout[count].InputSlot = 1;
+	layout[count].AlignedByteOffset = 0;
+	layout[count].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	layout[count].InstanceDataStepRate = 1;
+
+	return count + 1;
+}
+
+void InstancedShader::GetShaderDefines(VertexFormatType vertexFormat, D3D_SHADER_MACRO* defines)
+{
+	TexturedShader::GetShaderDefines(vertexFormat, defines);
+
+	int count = 0;
+	while (defines[count].Name != NULL)
+	{
+		count++;
+	}
+
+	defines[count].Name = "INSTANCED";
+	defines[count].Definition = "1";
+	defines[count + 1].Name = NULL;
+	defines[count + 1].Definition = NULL;
+}
+
+bool InstancedShader::SetInstances(ID3D11DeviceContext* context, const Vector4* instances, int count)
+{
+	if (count > INSTANCED_SHADER_MAX_INSTANCES)
+	{
+		return false;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+
+	if (FAILED(context->Map(m_instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource)))
+	{
+		return false;
+	}
+
+	memcpy(mappedResource.pData, instances, sizeof(Vector4) * count);
+	context->Unmap(m_instanceBuffer, 0);
+
+	unsigned int stride = sizeof(Vector4);
+	unsigned int offset = 0;
+	context->IASetVertexBuffers(1, 1, &m_instanceBuffer, &stride, &offset);
+
+	return true;
+}
+
+void InstancedShader::Release()
+{
+	TexturedShader::Release();
+	if (m_instanceBuffer)
+	{
+		m_instanceBuffer->Release();
+		m_instanceBuffer = NULL;
+	}
+}
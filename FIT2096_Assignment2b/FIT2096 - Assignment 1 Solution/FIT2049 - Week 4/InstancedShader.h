@@ -0,0 +1,40 @@
+/*	FIT2096 - Assignment 2b
+*	InstancedShader.h
+*	A TexturedShader that draws many copies of the same mesh in one call. Each copy (an instance)
+*	comes from a second vertex buffer that's filled in every frame: how far to move it on from the
+*	world matrix, and which layer of a texture array it samples. The same VertexShader.vs and
+*	TexturedPixelShader.ps are used, compiled with INSTANCED defined so they read the extra input.
+*	The board draws all of its floor tiles (and then all its walls) this way, one draw each with
+*	no texture changes in between.
+*/
+
+#ifndef INSTANCEDSHADER_H
+#define INSTANCEDSHADER_H
+
+#include "TexturedShader.h"
+
+#define INSTANCED_SHADER_MAX_INSTANCES 4096		// In one draw, bigger batches take more than one
+
+class InstancedShader : public TexturedShader
+{
+private:
+	ID3D11Buffer* m_instanceBuffer;		// One Vector4 per instance: the offset in xyz, the texture array layer in w
+
+protected:
+	int GetInputLayout(VertexFormatType vertexFormat, D3D11_INPUT_ELEMENT_DESC* layout);
+	void GetShaderDefines(VertexFormatType vertexFormat, D3D_SHADER_MACRO* defines);
+
+public:
+	InstancedShader();
+	~InstancedShader();
+
+	bool Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename, VertexFormatType vertexFormat);
+
+	// Copies count instances (at most INSTANCED_SHADER_MAX_INSTANCES) into the instance buffer and sets it as the second
+	// vertex buffer, ready for Mesh::RenderInstanced
+	bool SetInstances(ID3D11DeviceContext* context, const Vector4* instances, int count);
+
+	void Release();
+};
+
+#endif
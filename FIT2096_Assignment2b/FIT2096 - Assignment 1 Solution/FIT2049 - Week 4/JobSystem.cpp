@@ -0,0 +1,270 @@
+/*	FIT2096 - Assignment 2b
+*	JobSystem.cpp
+*	Implementation of JobSystem.h
+*/
+
+#include "JobSystem.h"
+#include <Windows.h>
+#include <cassert>
+
+// Which worker the current thread is. Anyone we didn't start is treated as worker 0.
+static thread_local int t_workerIndex = 0;
+
+JobSystem::JobSystem(int threadCount)
+{
+	if (threadCount < 1)
+		threadCount = 1;
+
+	m_queuedCount = 0;
+	m_quit = false;
+
+	for (int i = 0; i < threadCount; i++)
+	{
+		Worker* worker = new Worker();
+		worker->nextJob = 0;
+		m_workers.push_back(worker);
+	}
+
+	// Worker 0 is whoever made us, everyone else gets a thread
+	for (int i = 1; i < threadCount; i++)
+	{
+		m_threads.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_sleepLock);
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for (unsigned int i = 0; i < m_threads.size(); i++)
+	{
+		m_threads[i].join();
+	}
+
+	for (unsigned int i = 0; i < m_workers.size(); i++)
+	{
+		delete m_workers[i];
+		m_workers[i] = NULL;
+	}
+}
+
+int JobSystem::GetWorkerIndex()
+{
+	return t_workerIndex < (int)m_workers.size() ? t_workerIndex : 0;
+}
+
+Job* JobSystem::CreateJob(std::function<void()> work, JobCounter* counter)
+{
+	Worker* worker = m_workers[GetWorkerIndex()];
+	Job* job = &worker->ring[worker->nextJob++ & (JOB_RING_SIZE - 1)];
+
+	// The ring has come all the way round to a job that hasn't finished, wait on jobs more often or make the ring bigger
+	assert(!job->busy && "JobSystem: more than JOB_RING_SIZE unfinished jobs on one thread");
+
+	job->busy = true;
+	job->work = work;
+	job->unfinished = 1;
+	job->counter = counter;
+	job->dependents.clear();
+
+	if (counter)
+	{
+		counter->count++;
+	}
+
+	return job;
+}
+
+void JobSystem::AddDependency(Job* job, Job* runsAfter)
+{
+	job->unfinished++;
+	runsAfter->dependents.push_back(job);
+}
+
+void JobSystem::Submit(Job* job)
+{
+	// Only goes in a queue once everything it was waiting on (and the submit itself) is done
+	if (--job->unfinished == 0)
+	{
+		Push(job);
+	}
+}
+
+void JobSystem::Push(Job* job)
+{
+	Worker* worker = m_workers[GetWorkerIndex()];
+
+	{
+		std::lock_guard<std::mutex> guard(worker->lock);
+		worker->queue.push_back(job);
+	}
+
+	m_queuedCount++;
+
+	// Taking the lock means a thread about to sleep either sees the new job or gets the wake up
+	{
+		std::lock_guard<std::mutex> guard(m_sleepLock);
+	}
+	m_wake.notify_one();
+}
+
+Job* JobSystem::Take(int workerIndex)
+{
+	if (m_queuedCount == 0)
+		return NULL;
+
+	// Newest first from our own queue, it's most likely to still be in the cache
+	{
+		Worker* worker = m_workers[workerIndex];
+		std::lock_guard<std::mutex> guard(worker->lock);
+
+		if (!worker->queue.empty())
+		{
+			Job* job = worker->queue.back();
+			worker->queue.pop_back();
+			m_queuedCount--;
+			return job;
+		}
+	}
+
+	// Oldest first from everyone else's, those tend to be the bigger pieces of work
+	int workerCount = (int)m_workers.size();
+
+	for (int i = 1; i < workerCount; i++)
+	{
+		Worker* victim = m_workers[(workerIndex + i) % workerCount];
+		std::lock_guard<std::mutex> guard(victim->lock);
+
+		if (!victim->queue.empty())
+		{
+			Job* job = victim->queue.front();
+			victim->queue.pop_front();
+			m_queuedCount--;
+			return job;
+		}
+	}
+
+	return NULL;
+}
+
+void JobSystem::Execute(Job* job)
+{
+	job->work();
+
+	for (unsigned int i = 0; i < job->dependents.size(); i++)
+	{
+		Submit(job->dependents[i]);
+	}
+
+	// Once the counter goes down whoever made us can move on and hand this slot out again
+	JobCounter* counter = job->counter;
+	job->busy = false;
+
+	if (counter)
+	{
+		counter->count--;
+	}
+}
+
+void JobSystem::WorkerLoop(int workerIndex)
+{
+	t_workerIndex = workerIndex;
+
+	// Jobs decode textures through WIC, which needs COM on whichever thread calls it. The main thread
+	// set itself up in WinMain but ours start with nothing. WIC's factory works from any apartment.
+	HRESULT comResult = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+
+	while (true)
+	{
+		Job* job = Take(workerIndex);
+
+		if (job)
+		{
+			Execute(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> guard(m_sleepLock);
+		m_wake.wait(guard, [this] { return m_quit || m_queuedCount > 0; });
+
+		if (m_quit)
+			break;
+	}
+
+	if (SUCCEEDED(comResult))
+	{
+		CoUninitialize();
+	}
+}
+
+void JobSystem::Wait(JobCounter* counter)
+{
+	int workerIndex = GetWorkerIndex();
+
+	while (counter->count > 0)
+	{
+		Job* job = Take(workerIndex);
+
+		if (job)
+		{
+			Execute(job);
+		}
+		else
+		{
+			// Whatever we're waiting on is running on another thread
+			std::this_thread::yield();
+		}
+	}
+}
+
+bool JobSystem::TryRunOne()
+{
+	Job* job = Take(GetWorkerIndex());
+
+	if (!job)
+		return false;
+
+	Execute(job);
+	return true;
+}
+
+void JobSystem::ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& work)
+{
+	if (grain < 1)
+		grain = 1;
+
+	// Not worth handing out
+	if (count <= grain || m_workers.size() == 1)
+	{
+		if (count > 0)
+			work(0, count);
+
+		return;
+	}
+
+	JobCounter counter;
+
+	for (int begin = 0; begin < count; begin += grain)
+	{
+		int end = count - begin < grain ? count : begin + grain;
+		Submit(CreateJob([&work, begin, end] { work(begin, end); }, &counter));
+	}
+
+	Wait(&counter);
+}
+
+void ParallelFor(JobSystem* jobs, int count, int grain, const std::function<void(int begin, int end)>& work)
+{
+	if (jobs)
+	{
+		jobs->ParallelFor(count, grain, work);
+	}
+	else if (count > 0)
+	{
+		work(0, count);
+	}
+}
@@ -0,0 +1,102 @@
+/*	FIT2096 - Assignment 2b
+*	JobSystem.h
+*	Spreads work over a fixed set of threads. A job is a function to call, and a job can be told
+*	to wait for others to finish before it's allowed to start.
+*	Every thread has its own queue of jobs ready to run. It adds to and takes from the back of
+*	its own queue, and when that's empty it steals from the front of someone else's, so the
+*	threads stay busy without fighting over one shared list.
+*	Whoever is waiting on jobs helps run them instead of sitting idle, which is what lets a job
+*	split itself up with ParallelFor and wait for the pieces.
+*	Jobs can only be created from the thread that made the JobSystem, or from inside a job.
+*/
+
+#ifndef JOB_SYSTEM_H
+#define JOB_SYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Each thread hands out jobs from a ring of this many, so no more than this many of one
+// thread's jobs can be unfinished at once (must be a power of two). Going over is caught
+// by an assert rather than quietly reusing a job that hasn't run yet.
+#define JOB_RING_SIZE 4096
+
+// Counts down as jobs finish, Wait on it to know they're all done
+struct JobCounter
+{
+	std::atomic<int> count;
+
+	JobCounter() : count(0) {}
+};
+
+struct Job
+{
+	std::function<void()> work;
+	std::atomic<int> unfinished;	// Jobs we're waiting on, plus one until we're submitted
+	JobCounter* counter;			// Counted down when we're done, can be NULL
+	std::vector<Job*> dependents;	// Cleared each time the job is reused, so it only allocates while it's growing
+	std::atomic<bool> busy;			// From being created until it has finished running
+
+	Job() : unfinished(0), counter(NULL), busy(false) {}
+};
+
+class JobSystem
+{
+private:
+	struct Worker
+	{
+		std::mutex lock;
+		std::deque<Job*> queue;		// Ready to run
+		Job ring[JOB_RING_SIZE];
+		unsigned int nextJob;
+	};
+
+	std::vector<Worker*> m_workers;		// The thread that made us is worker 0
+	std::vector<std::thread> m_threads;
+
+	// Threads with nothing to do sleep until a job is queued
+	std::atomic<int> m_queuedCount;
+	std::mutex m_sleepLock;
+	std::condition_variable m_wake;
+	bool m_quit;
+
+	int GetWorkerIndex();
+	void Push(Job* job);
+	Job* Take(int workerIndex);
+	void Execute(Job* job);
+	void WorkerLoop(int workerIndex);
+
+public:
+	// threadCount includes the calling thread, so 1 runs everything on it
+	JobSystem(int threadCount);
+	~JobSystem();
+
+	// The job won't run until Submit is called. Counts up the counter now and down when the job finishes.
+	Job* CreateJob(std::function<void()> work, JobCounter* counter);
+
+	// job won't start until runsAfter has finished. Only call this before runsAfter is submitted.
+	void AddDependency(Job* job, Job* runsAfter);
+
+	void Submit(Job* job);
+
+	// Runs jobs until the counter reaches zero
+	void Wait(JobCounter* counter);
+
+	// Runs one job that's ready, if there is one, without waiting for any. Returns whether it ran something.
+	bool TryRunOne();
+
+	// Splits [0, count) into ranges of about grain items, runs them all and waits for them to finish
+	void ParallelFor(int count, int grain, const std::function<void(int begin, int end)>& work);
+
+	int GetThreadCount() { return (int)m_workers.size(); }
+};
+
+// Same as JobSystem::ParallelFor, or the whole range in one go on this thread if jobs is NULL
+void ParallelFor(JobSystem* jobs, int count, int grain, const std::function<void(int begin, int end)>& work);
+
+#endif
@@ -0,0 +1,233 @@
+/*	FIT2096 - Assignment 2b
+*	Lz4.cpp
+*	Implementation of Lz4.h
+*/
+
+#include "Lz4.h"
+
+#include <cstring>
+
+// Matches are at least this long, shorter ones aren't worth the token and offset
+#define LZ4_MIN_MATCH 4
+
+// The format wants the last five bytes to be literals and the last match to start
+// at least twelve from the end, so the decoder can copy in big steps near the end
+#define LZ4_LAST_LITERALS 5
+#define LZ4_MATCH_FIND_LIMIT 12
+
+#define LZ4_MAX_OFFSET 65535
+
+// 4096 entries is what the lz4 library uses for its fast mode, small enough to stay in the L1 cache
+#define LZ4_HASH_BITS 12
+
+static unsigned int Read32(const unsigned char* p)
+{
+	unsigned int value;
+	memcpy(&value, p, 4);
+	return value;
+}
+
+static unsigned int Hash(unsigned int sequence)
+{
+	return (sequence * 2654435761u) >> (32 - LZ4_HASH_BITS);
+}
+
+// 15 in the token, then 255s, then whatever is left
+static unsigned char* WriteLength(unsigned char* out, size_t length)
+{
+	for (length -= 15; length >= 255; length -= 255)
+	{
+		*out++ = 255;
+	}
+
+	*out++ = (unsigned char)length;
+	return out;
+}
+
+// Worst case room a sequence needs, so the bounds are checked once per sequence instead of once per byte
+static size_t GetSequenceSize(size_t literalLength, size_t matchLength)
+{
+	return 1 + literalLength / 255 + 1 + literalLength + 2 + matchLength / 255 + 1;
+}
+
+size_t Lz4::GetMaxCompressedSize(size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+size_t Lz4::Compress(const char* source, size_t sourceSize, char* destination, size_t capacity)
+{
+	const unsigned char* in = (const unsigned char*)source;
+	const unsigned char* end = in + sourceSize;
+	unsigned char* out = (unsigned char*)destination;
+	unsigned char* outEnd = out + capacity;
+
+	const unsigned char* anchor = in;	// Start of the literals not written yet
+	const unsigned char* p = in;
+
+	if (sourceSize > LZ4_MATCH_FIND_LIMIT)
+	{
+		const unsigned char* matchFindLimit = end - LZ4_MATCH_FIND_LIMIT;
+		const unsigned char* matchEndLimit = end - LZ4_LAST_LITERALS;
+
+		// Positions plus one, so zero can mean nothing has landed in that entry yet
+		unsigned int table[1 << LZ4_HASH_BITS];
+		memset(table, 0, sizeof(table));
+
+		while (p < matchFindLimit)
+		{
+			unsigned int sequence = Read32(p);
+			unsigned int hash = Hash(sequence);
+			unsigned int candidate = table[hash];
+			table[hash] = (unsigned int)(p - in) + 1;
+
+			if (candidate == 0 || (size_t)(p - in) + 1 - candidate > LZ4_MAX_OFFSET || Read32(in + candidate - 1) != sequence)
+			{
+				p++;
+				continue;
+			}
+
+			const unsigned char* match = in + candidate - 1;
+
+			// The bytes just before might match too, they'd otherwise go out as literals
+			while (p > anchor && match > in && p[-1] == match[-1])
+			{
+				p--;
+				match--;
+			}
+
+			const unsigned char* matchEnd = p + LZ4_MIN_MATCH;
+			const unsigned char* from = match + LZ4_MIN_MATCH;
+
+			while (matchEnd < matchEndLimit && *matchEnd == *from)
+			{
+				matchEnd++;
+				from++;
+			}
+
+			size_t literalLength = p - anchor;
+			size_t matchLength = matchEnd - p - LZ4_MIN_MATCH;
+
+			if ((size_t)(outEnd - out) < GetSequenceSize(literalLength, matchLength))
+				return 0;
+
+			unsigned char* token = out++;
+			*token = (unsigned char)((literalLength < 15 ? literalLength : 15) << 4);
+			if (literalLength >= 15)
+				out = WriteLength(out, literalLength);
+
+			memcpy(out, anchor, literalLength);
+			out += literalLength;
+
+			unsigned int offset = (unsigned int)(p - match);
+			*out++ = (unsigned char)(offset & 0xff);
+			*out++ = (unsigned char)(offset >> 8);
+
+			*token |= (unsigned char)(matchLength < 15 ? matchLength : 15);
+			if (matchLength >= 15)
+				out = WriteLength(out, matchLength);
+
+			p = matchEnd;
+			anchor = p;
+		}
+	}
+
+	// Whatever is left goes out as the literals of the last sequence, which has no match
+	size_t literalLength = end - anchor;
+
+	if ((size_t)(outEnd - out) < 1 + literalLength / 255 + 1 + literalLength)
+		return 0;
+
+	*out++ = (unsigned char)((literalLength < 15 ? literalLength : 15) << 4);
+	if (literalLength >= 15)
+		out = WriteLength(out, literalLength);
+
+	memcpy(out, anchor, literalLength);
+	out += literalLength;
+
+	return out - (unsigned char*)destination;
+}
+
+bool Lz4::Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize)
+{
+	const unsigned char* in = (const unsigned char*)source;
+	const unsigned char* inEnd = in + sourceSize;
+	unsigned char* out = (unsigned char*)destination;
+	unsigned char* outEnd = out + destinationSize;
+
+	while (in < inEnd)
+	{
+		unsigned char token = *in++;
+
+		size_t literalLength = token >> 4;
+		if (literalLength == 15)
+		{
+			unsigned char extra;
+			do
+			{
+				if (in >= inEnd)
+					return false;
+
+				extra = *in++;
+				literalLength += extra;
+			} while (extra == 255);
+		}
+
+		if (literalLength > (size_t)(inEnd - in) || literalLength > (size_t)(outEnd - out))
+			return false;
+
+		memcpy(out, in, literalLength);
+		in += literalLength;
+		out += literalLength;
+
+		// The last sequence stops after its literals
+		if (in == inEnd)
+			break;
+
+		if (inEnd - in < 2)
+			return false;
+
+		size_t offset = in[0] | (in[1] << 8);
+		in += 2;
+
+		if (offset == 0 || offset > (size_t)(out - (unsigned char*)destination))
+			return false;
+
+		size_t matchLength = token & 15;
+		if (matchLength == 15)
+		{
+			unsigned char extra;
+			do
+			{
+				if (in >= inEnd)
+					return false;
+
+				extra = *in++;
+				matchLength += extra;
+			} while (extra == 255);
+		}
+
+		matchLength += LZ4_MIN_MATCH;
+
+		if (matchLength > (size_t)(outEnd - out))
+			return false;
+
+		// A match can overlap what it's writing (a short offset repeats a pattern), that has to go a byte at a time
+		const unsigned char* match = out - offset;
+
+		if (offset >= matchLength)
+		{
+			memcpy(out, match, matchLength);
+			out += matchLength;
+		}
+		else
+		{
+			for (size_t i = 0; i < matchLength; i++)
+			{
+				*out++ = *match++;
+			}
+		}
+	}
+
+	return out == outEnd;
+}
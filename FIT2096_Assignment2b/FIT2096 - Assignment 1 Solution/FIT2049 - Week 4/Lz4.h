@@ -0,0 +1,34 @@
+/*	FIT2096 - Assignment 2b
+*	Lz4.h
+*	Compresses and decompresses single blocks in the LZ4 block format, the one the lz4 library's
+*	LZ4_compress_default and LZ4_decompress_safe use, so anything written here can be read by it
+*	and the other way around. Decompressing is little more than copying, which is why the asset
+*	pack uses it: it's quick enough that reading less from the disk is nearly always a win.
+*
+*	A block is a run of sequences. Each one is a token byte (literal count in the top four bits,
+*	match length minus four in the bottom four, 15 meaning more bytes follow), the literals, then a
+*	two byte offset back into what's already been written and copied from. The last sequence is
+*	only literals. The compressor is the plain greedy one, a hash of the next four bytes says where
+*	they were last seen and we take any match found there.
+*/
+
+#ifndef LZ4_H
+#define LZ4_H
+
+#include <cstddef>
+
+class Lz4
+{
+public:
+	// Compressing into a buffer this big can never run out of room
+	static size_t GetMaxCompressedSize(size_t size);
+
+	// Returns how many bytes were written, or 0 if they didn't fit in capacity
+	static size_t Compress(const char* source, size_t sourceSize, char* destination, size_t capacity);
+
+	// The block has to decompress to exactly destinationSize bytes. False if it's corrupt,
+	// in which case destination may have been partly written. Never reads or writes out of bounds.
+	static bool Decompress(const char* source, size_t sourceSize, char* destination, size_t destinationSize);
+};
+
+#endif
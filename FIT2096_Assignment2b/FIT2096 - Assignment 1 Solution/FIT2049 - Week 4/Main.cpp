@@ -5,6 +5,8 @@
  */
 
 #include "Window.h"
+#include <stdlib.h>
+#include <string.h>
 #include <time.h>
 
 void CreateConsole()
@@ -15,6 +17,23 @@ void CreateConsole()
 }
 
 
+//Reads --tick-rate ticksPerSecond and --max-ticks-per-frame N, anything missing or nonsense keeps the defaults from Window.h
+void ReadTickRate(float* ticksPerSecond, int* maxTicksPerFrame)
+{
+	//WinMain only gets the command line as one string, the runtime has already split it up for us here
+	for (int i = 1; i < __argc - 1; i++)
+	{
+		if (strcmp(__argv[i], "--tick-rate") == 0 && atof(__argv[i + 1]) > 0.0)
+		{
+			*ticksPerSecond = (float)atof(__argv[++i]);
+		}
+		else if (strcmp(__argv[i], "--max-ticks-per-frame") == 0 && atoi(__argv[i + 1]) > 0)
+		{
+			*maxTicksPerFrame = atoi(__argv[++i]);
+		}
+	}
+}
+
 //Windows API programs have a special Main method, WinMain!
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline, int iCmdshow)
 {
@@ -26,6 +45,11 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pScmdline,
 
 	Window* win = new Window("FIT2096: Assignment 1 Sample Solution", 1280, 720, false);	//We'll create our window object, set a size and if we want it fullscreen
 
+	float ticksPerSecond = SIMULATION_TICKS_PER_SECOND;
+	int maxTicksPerFrame = MAX_SIMULATION_TICKS_PER_FRAME;
+	ReadTickRate(&ticksPerSecond, &maxTicksPerFrame);
+	win->SetTickRate(ticksPerSecond, maxTicksPerFrame);
+
 	if(win->Initialise())	//If the window initialises...
 	{
 		win->Start();		//...then we start the message pump running!
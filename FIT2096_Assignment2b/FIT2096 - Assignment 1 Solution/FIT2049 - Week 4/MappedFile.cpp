@@ -0,0 +1,79 @@
+/*	FIT2096 - Assignment 2b
+*	MappedFile.cpp
+*	Implementation of MappedFile.h
+*/
+
+#include "MappedFile.h"
+
+MappedFile::MappedFile()
+{
+	m_file = INVALID_HANDLE_VALUE;
+	m_mapping = NULL;
+	m_data = NULL;
+	m_size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* filename)
+{
+	Close();
+
+	m_file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER size;
+	if (!GetFileSizeEx(m_file, &size))
+	{
+		Close();
+		return false;
+	}
+
+	// Windows won't map an empty file, but there's nothing to read anyway
+	if (size.QuadPart == 0)
+		return true;
+
+	m_mapping = CreateFileMappingA(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (!m_mapping)
+	{
+		Close();
+		return false;
+	}
+
+	m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if (!m_data)
+	{
+		Close();
+		return false;
+	}
+
+	m_size = (size_t)size.QuadPart;
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (m_data)
+	{
+		UnmapViewOfFile(m_data);
+		m_data = NULL;
+	}
+
+	if (m_mapping)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = NULL;
+	}
+
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+
+	m_size = 0;
+}
@@ -0,0 +1,39 @@
+/*	FIT2096 - Assignment 2b
+*	MappedFile.h
+*	Opens a file read only and maps the whole thing into memory, so it can be read like one
+*	big array without copying it into a buffer first. The operating system pages it in as
+*	it's read and throws it away again when we close it.
+*	The contents are not null terminated, always go by GetSize.
+*/
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <Windows.h>
+#include <cstddef>
+
+class MappedFile
+{
+private:
+	HANDLE m_file;
+	HANDLE m_mapping;
+	const char* m_data;
+	size_t m_size;
+
+	// Not copyable, there's only one mapping to close
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+public:
+	MappedFile();
+	~MappedFile();
+
+	// False if the file doesn't exist or can't be mapped. An empty file opens fine with no data.
+	bool Open(const char* filename);
+	void Close();
+
+	const char* GetData() { return m_data; }
+	size_t GetSize() { return m_size; }
+};
+
+#endif
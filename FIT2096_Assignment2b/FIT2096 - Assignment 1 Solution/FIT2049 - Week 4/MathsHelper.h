@@ -1,7 +1,9 @@
 #ifndef MATHS_HELPER_H
 #define MATHS_HELPER_H
 
+#include <cmath>
 #include <cstdlib>
+#include <random>
 
 #define PI 3.14159
 #define ToRadians(degree) ((degree) * (PI / 180.0f))
@@ -21,6 +23,19 @@ public:
 		return rand() % (max - min + 1) + min;
 	}
 
+	// Same as above but from a generator of our own. rand keeps a separate sequence for each thread on
+	// Windows, so anything that might run on the job system's threads has to use one of these instead.
+	static float RandomRange(std::mt19937& random, float min, float max)
+	{
+		return min + (max - min) * ((float)random() / (float)std::mt19937::max());
+	}
+
+	static int RandomRange(std::mt19937& random, int min, int max)
+	{
+		// Includes min and max
+		return (int)(random() % (unsigned int)(max - min + 1)) + min;
+	}
+
 	static float RemapRange(float value, float fromMin, float fromMax, float toMin, float toMax)
 	{
 		// Example - remap 10 from range 0-20 to range 0-100. Result is 50
@@ -33,6 +48,21 @@ public:
 		return value1 + (value2 - value1) * amount;
 	}
 
+	// LerpFloat for angles in radians, going round whichever way is shorter. Headings from atan2 jump
+	// from pi to -pi, and lerping straight across that would spin the long way round the circle.
+	static float LerpAngle(float value1, float value2, float amount)
+	{
+		const float fullTurn = 2.0f * (float)PI;
+		float difference = fmodf(value2 - value1, fullTurn);
+
+		if (difference > (float)PI)
+			difference -= fullTurn;
+		else if (difference < -(float)PI)
+			difference += fullTurn;
+
+		return value1 + difference * amount;
+	}
+
 	static float Clamp(float value, float min, float max)
 	{
 		if (value > max)
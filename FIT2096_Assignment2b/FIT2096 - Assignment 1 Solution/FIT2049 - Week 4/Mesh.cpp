@@ -1,6 +1,6 @@
 #include "Mesh.h"
 #include "MathsHelper.h"
-#include <fstream>
+#include <vector>
 
 using namespace std;
 
@@ -10,6 +10,8 @@ Mesh::Mesh()
 	m_filename = "";
 	m_vertexBuffer = NULL;
 	m_indexBuffer = NULL;
+	m_indexFormat = DXGI_FORMAT_R32_UINT;
+	m_vertexStride = VertexFormat::GetStride(MESH_VERTEX_FORMAT);
 	m_vertexCount = 0;
 	m_indexCount = 0;
 
@@ -165,16 +167,33 @@ bool Mesh::CreateAbstractArt3D(Direct3D* renderer, const char* identifier)
 	return true;
 }
 
-void Mesh::Render(Direct3D* renderer, Shader* shader, Matrix world, Camera* cam, Texture* texture)
+void Mesh::Render(Direct3D* renderer, Shader* shader, Matrix world, Matrix view, Matrix projection, Texture* texture)
+{
+	Bind(renderer, shader, world, view, projection, texture);
+
+	// Once the buffers, shaders and matrices are set then we are ready to render.
+	// We tell renderer how many indices we want to render
+	renderer->GetDeviceContext()->DrawIndexed(m_indexCount, 0, 0);
+}
+
+void Mesh::RenderInstanced(Direct3D* renderer, Shader* shader, Matrix world, Matrix view, Matrix projection, Texture* texture, int instanceCount)
+{
+	Bind(renderer, shader, world, view, projection, texture);
+
+	// Same indices, just run through once for every instance
+	renderer->GetDeviceContext()->DrawIndexedInstanced(m_indexCount, instanceCount, 0, 0, 0);
+}
+
+void Mesh::Bind(Direct3D* renderer, Shader* shader, Matrix world, Matrix view, Matrix projection, Texture* texture)
 {
 	unsigned int stride;
 	unsigned int offset;
 
-	stride = sizeof(Vertex);
+	stride = m_vertexStride;
 	offset = 0;
 
 	renderer->GetDeviceContext()->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-	renderer->GetDeviceContext()->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	renderer->GetDeviceContext()->IASetIndexBuffer(m_indexBuffer, m_indexFormat, 0);
 	renderer->GetDeviceContext()->IASetPrimitiveTopology(m_topology);
 
 	if (renderer->GetCurrentShader() != shader)
@@ -189,14 +208,32 @@ void Mesh::Render(Direct3D* renderer, Shader* shader, Matrix world, Camera* cam,
 		shader->SetTexture(renderer->GetDeviceContext(), texture->GetShaderResourceView());
 	}
 
-	shader->SetMatrices(renderer->GetDeviceContext(), world, cam->GetView(), cam->GetProjection());
-
-	// Once the buffers, shaders and matrices are set then we are ready to render.
-	// We tell renderer how many indices we want to render
-	renderer->GetDeviceContext()->DrawIndexed(m_indexCount, 0, 0);
+	shader->SetMatrices(renderer->GetDeviceContext(), world, view, projection);
 }
 
 bool Mesh::InitialiseBuffers(Direct3D* renderer, Vertex* vertexData, unsigned long* indexData)
+{
+	//The buffer doesn't hold our Vertex structs as they are, they're packed down into the mesh vertex format first
+	std::vector<unsigned char> packedVertices(m_vertexStride * m_vertexCount);
+	VertexFormat::Pack(MESH_VERTEX_FORMAT, vertexData, m_vertexCount, &packedVertices[0]);
+
+	//If every index fits in 16 bits we can halve the size of the index buffer. 0xffff is left out because
+	//strips use it to mean "start a new strip".
+	if (m_vertexCount <= 0xffff)
+	{
+		std::vector<unsigned short> shortIndices(m_indexCount);
+		for (int i = 0; i < m_indexCount; i++)
+		{
+			shortIndices[i] = (unsigned short)indexData[i];
+		}
+
+		return CreateBuffers(renderer, &packedVertices[0], &shortIndices[0], DXGI_FORMAT_R16_UINT);
+	}
+
+	return CreateBuffers(renderer, &packedVertices[0], indexData, DXGI_FORMAT_R32_UINT);
+}
+
+bool Mesh::CreateBuffers(Direct3D* renderer, const void* vertexData, const void* indexData, DXGI_FORMAT indexFormat)
 {
 	//Here we need to create and initialise a Direct3D buffer to hold and vertices and one to hold our indices
 
@@ -206,7 +243,7 @@ bool Mesh::InitialiseBuffers(Direct3D* renderer, Vertex* vertexData, unsigned lo
 	D3D11_SUBRESOURCE_DATA indexDataDescription;	//...these structs are then passed to the Create buffer method so that Direct3D can allocate things correctly
 
 	vertexBufferDescription.Usage = D3D11_USAGE_DEFAULT;					//The buffer description struct needs to know what the buffer will be used for...
-	vertexBufferDescription.ByteWidth = sizeof(Vertex) * m_vertexCount;		//...how big the buffer should be in bytes (for us it is the size of one vertex * number of verts)...
+	vertexBufferDescription.ByteWidth = m_vertexStride * m_vertexCount;		//...how big the buffer should be in bytes (for us it is the size of one vertex * number of verts)...
 	vertexBufferDescription.BindFlags = D3D11_BIND_VERTEX_BUFFER;			//...what the buffer is for (ours is a vertex buffer)...
 	vertexBufferDescription.CPUAccessFlags = 0;								//...the rest a misc setting for various things that we won't need to worry about.
 	vertexBufferDescription.MiscFlags = 0;									//If you want more info look up D3D11_BUFFER_DESC on the MSDN
@@ -223,9 +260,11 @@ bool Mesh::InitialiseBuffers(Direct3D* renderer, Vertex* vertexData, unsigned lo
 		return false;
 	}
 
+	m_indexFormat = indexFormat;
+
 	//Creating the index buffer is pretty much the same as the vertex buffer
 	indexBufferDescription.Usage = D3D11_USAGE_DEFAULT;
-	indexBufferDescription.ByteWidth = sizeof(unsigned long) * m_indexCount;
+	indexBufferDescription.ByteWidth = (indexFormat == DXGI_FORMAT_R16_UINT ? 2 : 4) * m_indexCount;
 	indexBufferDescription.BindFlags = D3D11_BIND_INDEX_BUFFER;
 	indexBufferDescription.CPUAccessFlags = 0;
 	indexBufferDescription.MiscFlags = 0;
@@ -237,269 +276,95 @@ bool Mesh::InitialiseBuffers(Direct3D* renderer, Vertex* vertexData, unsigned lo
 
 	if (FAILED(renderer->GetDevice()->CreateBuffer(&indexBufferDescription, &indexDataDescription, &m_indexBuffer)))
 	{
+		//Don't keep half a mesh, whoever called us might try again another way
+		m_vertexBuffer->Release();
+		m_vertexBuffer = NULL;
 		return false;
 	}
 
 	return true;
 }
 
-bool Mesh::Load(Direct3D* renderer, const char* filename)
+bool Mesh::Load(Direct3D* renderer, const char* filename, AssetPack* pack)
 {
-	// Parsing the OBJ format to load meshes modelled in external tools
-
-	m_topology = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
-
-	//A face is made of three points, each one containing a position, normal and texture coord (uv)
-	//This struct is used during the load to store this data
-	struct Face
-	{
-		int vert1, uv1, normal1;
-		int vert2, uv2, normal2;
-		int vert3, uv3, normal3;
-	};
-
-	Vector3* verts;		//This array stores raw positional data from the OBJ file. 
-	Vector3* normals;	//This array stores the raw normals from the OBJ file
-	Vector2* uvs;		//This array stores the raw texture coords from the OBJ file
-	Face* faces;		//This is an array of Face structs that collects the different 
-	//vert, normal and uv indices into a single place
-
-	int vertexCount = 0;	//We will work out the total number of verts in the file
-	int normalCount = 0;	//The total number of normals	
-	int textureCount = 0;	//The total number of texture coords
-	int faceCount = 0;		//The total number of faces
-
-	int vertIndex = 0;		//These are used to keep track of where we are upto in our data arrays
-	int normalIndex = 0;
-	int uvIndex = 0;
-	int faceIndex = 0;
-
-	ifstream fileIn;		//OBJ files are just text files so we use a simple input file stream
-
-	//The first read of the file is just to determine the number of verts, normals and uvs in the file
-	fileIn.open(filename);		//Open our OBJ file for reading
-
-	if (!fileIn.good())			//If we can't open it return false
+	MeshSource source;
+	if (!Read(filename, &source, pack))
 		return false;
 
-	char input;					//We're going to read through char by char, each char we read will go in here
-	while (!fileIn.eof())		//Keep reading until the end of the file
-	{
-		fileIn.get(input);		//Read the first char on the line
-
-		if (input == 'v')		//If the line starts with v then we...
-		{
-			fileIn.get(input);	//...want to chack the next char after it...
-			if (input == ' ') { vertexCount++; }	//...if it's a blank space then we have a vertex position!
-			if (input == 't') { textureCount++; }	//...if it's a 't' then we have a texture coord!
-			if (input == 'n') { normalCount++; }	//...if it's an 'n' then we have a normal!
-		}
-
-		if (input == 'f')		//If the first char of the line is 'f' then it's a face
-		{
-			fileIn.get(input);
-			if (input == ' ') { faceCount++; }
-		}
-
-		while (input != '\n')	//Now that we have checked this line, we'll skip to the end of it.
-		{
-			fileIn.get(input);
-		}
-	}
-	fileIn.close();		//After reading the counts we then close the file to reset it
+	return Create(renderer, &source, filename);
+}
 
-	//Now that we know how much memory to allocate we can read the Data from the OBJ file
-	fileIn.open(filename);
-	if (!fileIn.good())
-		return false;
+bool Mesh::Read(const char* filename, MeshSource* source, AssetPack* pack)
+{
+	string cookedFilename = CookedMesh::GetCookedFilename(filename);
 
-	//Allocate our arrys
-	verts = new Vector3[vertexCount];
-	normals = new Vector3[normalCount];
-	uvs = new Vector2[textureCount];
-	faces = new Face[faceCount];
+	//assetpack only packs cooked files that were up to date, so in a pack being there is enough
+	bool fromPack = pack && pack->IsOpen();
+	bool useCooked = fromPack ? pack->Contains(cookedFilename.c_str()) : CookedMesh::IsUpToDate(filename, cookedFilename.c_str());
 
-	while (!fileIn.eof())		//We will read the whole file again
+	//Nothing to parse in a cooked file, it already holds the buffers exactly as Direct3D wants them.
+	//It's mapped into memory (on its own or as part of the pack) and Create copies the buffers straight out of it.
+	if (useCooked && AssetPack::ReadAsset(pack, cookedFilename.c_str(), &source->cookedData))
 	{
-		fileIn.get(input);		//Char by Char
-		if (input == 'v')		//If it is starts with v...
-		{
-			fileIn.get(input);
-
-			if (input == ' ')	//...and is a vert position...
-			{
-				//...then read from the file in to the vert array at vertIndex...
-				fileIn >> verts[vertIndex].x >> verts[vertIndex].y >> verts[vertIndex].z;
-				vertIndex++;	//...and increase the vertIndex
-			}
-			if (input == 't')	//...and is a tex coord...
-			{
-				//...then read from the file in to the uv array at uvIndex...
-				fileIn >> uvs[uvIndex].x >> uvs[uvIndex].y;
-				uvs[uvIndex].y = -uvs[uvIndex].y;
-				uvIndex++;	//...and increase the uvIndex
-			}
-			if (input == 'n')	//...and is a normal...
-			{
-				//...then read from the file in to the normal array at normalIndex...
-				fileIn >> normals[normalIndex].x >> normals[normalIndex].y >> normals[normalIndex].z;
-				normalIndex++;	//...and increase the normalIndex
-			}
-		}
-		if (input == 'f')	//If we're reading a line describing a face then we need to fill out one of the Face structs
-		{
-			char junk;		//The face lines are in the format of "index/index/index" which means that the / chars are junk
-
-			//Here you can see us reading three verts worth of information for each face. When we expect a / char we put it into "junk"
-			//(NOTE: OBJ can support faces with more then 3 points, we only read for 3. This means that our models must be made up of
-			//		 only triangles (i.e. they must be "triangulated"))
-			fileIn >> faces[faceIndex].vert1 >> junk >> faces[faceIndex].uv1 >> junk >> faces[faceIndex].normal1
-				>> faces[faceIndex].vert2 >> junk >> faces[faceIndex].uv2 >> junk >> faces[faceIndex].normal2
-				>> faces[faceIndex].vert3 >> junk >> faces[faceIndex].uv3 >> junk >> faces[faceIndex].normal3;
-			faceIndex++;	//After we read a face we increase the face index
-		}
+		source->cookedHeader = CookedMesh::Validate(source->cookedData.GetData(), source->cookedData.GetSize());
+		if (source->cookedHeader)
+			return true;
 
-		while (input != '\n')	//Now that we have checked this line, we'll skip to the end of it.
-		{
-			fileIn.get(input);
-		}
+		source->cookedData.Clear();
 	}
-	fileIn.close();		//Close the file, we are done with our file IO now
 
-	//Each face is made up of three verts so the total number of indices is 3 * the number of faces
-	int indexCount = faceCount * 3;
-	//We will also allocate the same number of vertices
-	int finalVertexCount = faceCount * 3;
-
-	m_indexCount = indexCount;
-	m_vertexCount = finalVertexCount;
-
-	//(NOTE: There is a bit of an inefficiency in this loading code, the number of vertices is the same as the number of indices
-	//		 this means that there is a lot of repeated vertex data. It's difficult because some position have different normals which
-	//		 means you need to duplicate some vertices but not others.
-	//		 This could be optimised by working out the final list of unique verts and creating an index buffer drawing them in the right order.)
-
-	Vertex* vertexData = new Vertex[finalVertexCount];		//We'll allocate our vertex memory
-	if (!vertexData)									//Big models could run out memory, we check for that
+	// Parsing the OBJ format to load meshes modelled in external tools.
+	// This does everything meshcook does, just every time we run, so the cooked file is the faster way in.
+	AssetData obj;
+	if (!AssetPack::ReadAsset(pack, filename, &obj))
 		return false;
 
-	int vertexCounter = 0;
-	for (int i = 0; i < faceCount; i++)					//For each face
-	{
-		int vertIndex = faces[i].vert1 - 1;				//Look up the vertex index,
-		int normIndex = faces[i].normal1 - 1;			//normal index
-		int uvIndex = faces[i].uv1 - 1;					//and uv index for the first point in the face
-
-		vertexData[vertexCounter].position = verts[vertIndex];		//Fill out our vertex with the correct vert,
-		vertexData[vertexCounter].colour = Color(1.0f, 1.0f, 1.0f);			//colour (this was a method parameter),
-		vertexData[vertexCounter].texCoord = uvs[uvIndex];			//uv,
-		vertexData[vertexCounter].normal = normals[normIndex];		//and normal data
-		vertexCounter++;
-
-		vertIndex = faces[i].vert2 - 1;		//Move to the next point
-		normIndex = faces[i].normal2 - 1;
-		uvIndex = faces[i].uv2 - 1;
-
-		vertexData[vertexCounter].position = verts[vertIndex];	//and read the data for that point
-		vertexData[vertexCounter].colour = Color(1.0f, 1.0f, 1.0f);
-		vertexData[vertexCounter].texCoord = uvs[uvIndex];
-		vertexData[vertexCounter].normal = normals[normIndex];
-		vertexCounter++;
-
-		vertIndex = faces[i].vert3 - 1;		//Move to the last point
-		normIndex = faces[i].normal3 - 1;
-		uvIndex = faces[i].uv3 - 1;
-
-		vertexData[vertexCounter].position = verts[vertIndex];	//and read the last point for the face
-		vertexData[vertexCounter].colour = Color(1.0f, 1.0f, 1.0f);
-		vertexData[vertexCounter].texCoord = uvs[uvIndex];
-		vertexData[vertexCounter].normal = normals[normIndex];
-		vertexCounter++;
-	}
-
-	unsigned long* indexData = new unsigned long[indexCount];		//Allocate our index buffer
-	if (!indexData)													//Big models could run out of memory, we check for that
-		return false;
-
-	for (int i = 0; i < indexCount; i++)		//Fill it out as just a linear array of numbers (NOTE: as mentioned above this could be optimised!)
-	{
-		indexData[i] = i;
-	}
-
-	if (!InitialiseBuffers(renderer, vertexData, indexData))	//Now that we have our vertex and index data, we need to copy it into buffers
-	{
-		return false;
-	}
+	return CookedMesh::CookObj(filename, obj.GetData(), obj.GetSize(), &source->cooked);
+}
 
-	// For Bounding Box
-	float minX = 0, minY = 0, minZ = 0;
-	float maxX = 0, maxY = 0, maxZ = 0;
+bool Mesh::Create(Direct3D* renderer, MeshSource* source, const char* identifier)
+{
+	const CookedMeshHeader* header = source->cookedHeader;
 
-	for (int i = 0; i < finalVertexCount; i++)
+	if (header)
 	{
-		Vector3 currentPos = vertexData[i].position;
-
-		if (currentPos.x > maxX)
-			maxX = currentPos.x;
-		else if (currentPos.x < minX)
-			minX = currentPos.x;
-
-		if (currentPos.y > maxY)
-			maxY = currentPos.y;
-		else if (currentPos.y < minY)
-			minY = currentPos.y;
-
-		if (currentPos.z > maxZ)
-			maxZ = currentPos.z;
-		else if (currentPos.z < minZ)
-			minZ = currentPos.z;
-	}
+		m_topology = (D3D11_PRIMITIVE_TOPOLOGY)header->topology;
+		m_vertexCount = header->vertexCount;
+		m_indexCount = header->indexCount;
 
-	m_minVector = Vector3(minX, minY, minZ);
-	m_maxVector = Vector3(maxX, maxY, maxZ);
+		const char* vertexData = source->cookedData.GetData() + header->vertexOffset;
+		const char* indexData = source->cookedData.GetData() + header->indexOffset;
 
-	m_radius = (m_maxVector - m_minVector).Length() / 2.0f; // Radius is half the distance between min and max
-	m_centre = (m_maxVector - m_minVector) / 2;
-	// End Bounding Box
+		if (!CreateBuffers(renderer, vertexData, indexData, header->indexSize == 2 ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT))
+		{
+			return false;
+		}
 
-	//Now that the buffers are created we can delete all of the data we loaded!
-	if (verts)
-	{
-		delete[] verts;
-		verts = NULL;
+		m_minVector = Vector3(header->minimum[0], header->minimum[1], header->minimum[2]);
+		m_maxVector = Vector3(header->maximum[0], header->maximum[1], header->maximum[2]);
+		m_centre = Vector3(header->centre[0], header->centre[1], header->centre[2]);
+		m_radius = header->radius;
 	}
-
-	if (normals)
+	else
 	{
-		delete[] normals;
-		normals = NULL;
-	}
+		CookedMesh* cooked = &source->cooked;
 
-	if (uvs)
-	{
-		delete[] uvs;
-		uvs = NULL;
-	}
-
-	if (faces)
-	{
-		delete[] faces;
-		faces = NULL;
-	}
+		m_topology = (D3D11_PRIMITIVE_TOPOLOGY)cooked->topology;
+		m_vertexCount = (int)cooked->vertices.size();
+		m_indexCount = (int)cooked->indices.size();
 
-	if (vertexData)
-	{
-		delete[] vertexData;
-		vertexData = NULL;
-	}
+		if (!InitialiseBuffers(renderer, &cooked->vertices[0], &cooked->indices[0]))	//Now that we have our vertex and index data, we need to copy it into buffers
+		{
+			return false;
+		}
 
-	if (indexData)
-	{
-		delete[] indexData;
-		indexData = NULL;
+		m_minVector = cooked->minimum;
+		m_maxVector = cooked->maximum;
+		m_centre = cooked->centre;
+		m_radius = cooked->radius;
 	}
 
-	m_filename = filename;
+	m_filename = identifier;
 
 	return true;
-}
\ No newline at end of file
+}
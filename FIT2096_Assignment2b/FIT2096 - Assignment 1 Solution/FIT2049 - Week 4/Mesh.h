@@ -6,17 +6,25 @@
 #include "DirectXTK/SimpleMath.h"
 #include "Camera.h"
 #include "Texture.h"
+#include "CookedMesh.h"
+#include "AssetPack.h"
+#include "VertexFormat.h"
+
+// A mesh file read into memory but not yet turned into buffers. Mesh::Read fills one in and can run on
+// any thread, Mesh::Create makes the buffers from it and has to happen where the device lives.
+struct MeshSource
+{
+	AssetData cookedData;					// The .mesh meshcook made, when there's one newer than the OBJ
+	const CookedMeshHeader* cookedHeader;	// Points into cookedData, NULL if we had to cook the OBJ ourselves
+	CookedMesh cooked;						// Otherwise the OBJ, cooked while loading
+
+	MeshSource() : cookedHeader(NULL) { }
+};
 
 class Mesh
 {
 private:
-	struct Vertex
-	{
-		Vector3 position;
-		Color colour;
-		Vector3 normal;
-		Vector2 texCoord;
-	};
+	typedef MeshVertex Vertex;	//We build vertices like this, then they're packed into MESH_VERTEX_FORMAT for the buffer
 
 	D3D11_PRIMITIVE_TOPOLOGY m_topology;
 	int m_referenceCount;
@@ -26,6 +34,8 @@ private:
 	int m_indexCount;
 	ID3D11Buffer* m_vertexBuffer;
 	ID3D11Buffer* m_indexBuffer;
+	DXGI_FORMAT m_indexFormat;	//16 bit indices when there are few enough vertices, otherwise 32 bit
+	unsigned int m_vertexStride;	//Size of one vertex once it's packed into MESH_VERTEX_FORMAT
 
 	Vector3 m_minVector;	//For our bounding boxes we need to know the min position of the mesh...
 	Vector3 m_maxVector;	//... and the max position
@@ -34,14 +44,21 @@ private:
 
 	Mesh();
 	~Mesh();
-	bool Load(Direct3D* renderer, const char* filename);
+	bool Load(Direct3D* renderer, const char* filename, AssetPack* pack);	//Read then Create, all on this thread
+
+	//Uses the file meshcook made if it's there and the OBJ hasn't changed since, otherwise cooks the OBJ. Doesn't touch the device.
+	//Both come out of the pack when it has them (pack can be NULL).
+	static bool Read(const char* filename, MeshSource* source, AssetPack* pack);
+	bool Create(Direct3D* renderer, MeshSource* source, const char* identifier);
 
 	void AddRef() { m_referenceCount++; }
 	void RemoveRef() { m_referenceCount--; }
 	int GetRefCount() { return m_referenceCount; }
 
-	//This method takes vertex and index data and creates the Direct3D buffers
+	//This method takes vertex and index data and creates the Direct3D buffers (the vertices are packed and the indices are squashed to 16 bits if they fit)
 	bool InitialiseBuffers(Direct3D* renderer, Vertex* vertexData, unsigned long* indexData);
+	//...which CreateBuffers does with data that's already in its final format (such as a mapped cooked mesh)
+	bool CreateBuffers(Direct3D* renderer, const void* vertexData, const void* indexData, DXGI_FORMAT indexFormat);
 
 	// Week four exercises
 	bool CreateTriangle(Direct3D* renderer, const char* identifier);
@@ -49,8 +66,15 @@ private:
 	bool CreateAbstractArt(Direct3D* renderer, const char* identifier);
 	bool CreateAbstractArt3D(Direct3D* renderer, const char* identifier);
 
+	//Sets everything a draw of this mesh needs, the two Render methods only differ in the draw call afterwards
+	void Bind(Direct3D* renderer, Shader* shader, Matrix world, Matrix view, Matrix projection, Texture* texture);
+
 public:
-	void Render(Direct3D* renderer, Shader* shader, Matrix world, Camera* cam, Texture* texture);
+	void Render(Direct3D* renderer, Shader* shader, Matrix world, Matrix view, Matrix projection, Texture* texture);
+
+	//Draws instanceCount copies in one go. The shader has to be one that reads instances (see InstancedShader)
+	//and they have to have been set on it first.
+	void RenderInstanced(Direct3D* renderer, Shader* shader, Matrix world, Matrix view, Matrix projection, Texture* texture, int instanceCount);
 
 	int GetVertexCount() { return m_vertexCount; }
 	int GetIndexCount() { return m_indexCount; }
@@ -1,10 +1,12 @@
 #include "MeshManager.h"
+#include <Windows.h>
+#include <sstream>
 
 using namespace std;
 
 MeshManager::MeshManager()
 {
-
+	m_assetPack = NULL;
 }
 
 MeshManager::~MeshManager()
@@ -17,22 +19,47 @@ bool MeshManager::Load(Direct3D* renderer, const char* filename)
 	if (filename == NULL)
 		return false;
 
-	if (GetMesh(filename) != NULL)
+	if (GetHandle(filename).IsValid())
 		return true;
 
 	Mesh* tempMesh = new Mesh();
 
-	if (tempMesh->Load(renderer, filename))
-	{
-		string filenameStr = filename;
-		m_meshMap[filenameStr] = tempMesh;
-		return true;
-	}
-	else
-	{
-		delete tempMesh;
-		return false;
-	}
+	if (tempMesh->Load(renderer, filename, m_assetPack))
+		return Add(tempMesh, filename);
+
+	delete tempMesh;
+	return false;
+}
+
+AssetFuture MeshManager::LoadAsync(AssetLoader* loader, Direct3D* renderer, const char* filename)
+{
+	if (filename == NULL)
+		return AssetLoader::Ready(false);
+
+	if (GetHandle(filename).IsValid())
+		return AssetLoader::Ready(true);
+
+	// Read on one of the loader's threads, then the buffers are made on this one
+	MeshSource* source = new MeshSource();
+	AssetPack* pack = m_assetPack;
+
+	return loader->Load(filename,
+		[source, filename, pack]()
+		{
+			return Mesh::Read(filename, source, pack);
+		},
+		[this, source, renderer, filename](bool decoded)
+		{
+			Mesh* mesh = new Mesh();
+			bool created = decoded && mesh->Create(renderer, source, filename);
+			delete source;
+
+			if (created)
+				return Add(mesh, filename);
+
+			delete mesh;
+			return false;
+		});
 }
 
 bool MeshManager::LoadTriangle(Direct3D* renderer, const char* identifier)
@@ -40,22 +67,16 @@ bool MeshManager::LoadTriangle(Direct3D* renderer, const char* identifier)
 	if (identifier == NULL)
 		return false;
 
-	if (GetMesh(identifier) != NULL)
+	if (GetHandle(identifier).IsValid())
 		return true;
 
 	Mesh* tempMesh = new Mesh();
 
 	if (tempMesh->CreateTriangle(renderer, identifier))
-	{
-		string identifierStr = identifier;
-		m_meshMap[identifierStr] = tempMesh;
-		return true;
-	}
-	else
-	{
-		delete tempMesh;
-		return false;
-	}
+		return Add(tempMesh, identifier);
+
+	delete tempMesh;
+	return false;
 }
 
 bool MeshManager::LoadSquare(Direct3D* renderer, const char* identifier)
@@ -63,22 +84,16 @@ bool MeshManager::LoadSquare(Direct3D* renderer, const char* identifier)
 	if (identifier == NULL)
 		return false;
 
-	if (GetMesh(identifier) != NULL)
+	if (GetHandle(identifier).IsValid())
 		return true;
 
 	Mesh* tempMesh = new Mesh();
 
 	if (tempMesh->CreateSquare(renderer, identifier))
-	{
-		string identifierStr = identifier;
-		m_meshMap[identifierStr] = tempMesh;
-		return true;
-	}
-	else
-	{
-		delete tempMesh;
-		return false;
-	}
+		return Add(tempMesh, identifier);
+
+	delete tempMesh;
+	return false;
 }
 
 bool MeshManager::LoadAbstractArt(Direct3D* renderer, const char* identifier)
@@ -86,22 +101,16 @@ bool MeshManager::LoadAbstractArt(Direct3D* renderer, const char* identifier)
 	if (identifier == NULL)
 		return false;
 
-	if (GetMesh(identifier) != NULL)
+	if (GetHandle(identifier).IsValid())
 		return true;
 
 	Mesh* tempMesh = new Mesh();
 
 	if (tempMesh->CreateAbstractArt(renderer, identifier))
-	{
-		string identifierStr = identifier;
-		m_meshMap[identifierStr] = tempMesh;
-		return true;
-	}
-	else
-	{
-		delete tempMesh;
-		return false;
-	}
+		return Add(tempMesh, identifier);
+
+	delete tempMesh;
+	return false;
 }
 
 bool MeshManager::LoadAbstractArt3D(Direct3D* renderer, const char* identifier)
@@ -109,38 +118,47 @@ bool MeshManager::LoadAbstractArt3D(Direct3D* renderer, const char* identifier)
 	if (identifier == NULL)
 		return false;
 
-	if (GetMesh(identifier) != NULL)
+	if (GetHandle(identifier).IsValid())
 		return true;
 
 	Mesh* tempMesh = new Mesh();
 
 	if (tempMesh->CreateAbstractArt3D(renderer, identifier))
-	{
-		string identifierStr = identifier;
-		m_meshMap[identifierStr] = tempMesh;
-		return true;
-	}
-	else
-	{
-		delete tempMesh;
-		return false;
-	}
+		return Add(tempMesh, identifier);
+
+	delete tempMesh;
+	return false;
 }
 
-Mesh* MeshManager::GetMesh(const char* filename)
+bool MeshManager::Add(Mesh* mesh, const char* filename)
 {
-	string filenameStr = filename;
+	if (m_meshes.Add(HashPath(filename), mesh).IsValid())
+		return true;
 
-	MeshMap::const_iterator searchResult = m_meshMap.find(filenameStr);
-	if (searchResult != m_meshMap.end())
+	// Loaded twice at once (asked for again before the first one finished), keep the first
+	if (GetHandle(filename).IsValid())
 	{
-		searchResult->second->AddRef();
-		return searchResult->second;
+		delete mesh;
+		return true;
 	}
 
-	return NULL;
+	stringstream message;
+	message << "MeshManager: " << filename << " has the same hash as a mesh that's already loaded, rename one of them\n";
+	OutputDebugString(message.str().c_str());
+
+	delete mesh;
+	return false;
 }
 
+Mesh* MeshManager::GetMesh(MeshHandle handle)
+{
+	Mesh* mesh = m_meshes.Get(handle);
+
+	if (mesh)
+		mesh->AddRef();
+
+	return mesh;
+}
 
 void MeshManager::ReleaseMesh(Mesh* mesh)
 {
@@ -149,12 +167,7 @@ void MeshManager::ReleaseMesh(Mesh* mesh)
 		mesh->RemoveRef();
 		if (mesh->GetRefCount() <= 0)
 		{
-			string filename = mesh->GetFilename();
-			MeshMap::const_iterator searchResult = m_meshMap.find(filename);
-			if (searchResult != m_meshMap.end())
-			{
-				m_meshMap.erase(searchResult);
-			}
+			m_meshes.Remove(mesh);
 			delete mesh;
 		}
 	}
@@ -162,14 +175,10 @@ void MeshManager::ReleaseMesh(Mesh* mesh)
 
 void MeshManager::Release()
 {
-	if (!m_meshMap.empty())
+	for (int i = 0; i < m_meshes.GetSlotCount(); i++)
 	{
-		MeshMap::iterator mapIterator;
-		for (mapIterator = m_meshMap.begin(); mapIterator != m_meshMap.end(); mapIterator++)
-		{
-			delete mapIterator->second;
-			mapIterator->second = NULL;
-		}
-		m_meshMap.clear();
+		delete m_meshes.GetResource(i);
 	}
+
+	m_meshes.Clear();
 }
\ No newline at end of file
@@ -2,22 +2,43 @@
 #define MESHMANAGER_H
 
 #include <d3d11.h>
-#include <map>
-#include <string>
 
+#include "AssetLoader.h"
 #include "Mesh.h"
+#include "ResourceHandle.h"
+
+typedef ResourceHandle<Mesh> MeshHandle;
 
 class MeshManager
 {
 private:
-	typedef std::map<std::string, Mesh*> MeshMap;
-	MeshMap m_meshMap;
+	ResourceTable<Mesh> m_meshes;
+	AssetPack* m_assetPack;
+
+	// Puts a freshly loaded mesh in the table, or deletes it if the name is taken by a different file with the same hash
+	bool Add(Mesh* mesh, const char* filename);
 
 public:
 	MeshManager();
 	~MeshManager();
 	bool Load(Direct3D* renderer, const char* filename);
-	Mesh* GetMesh(const char* filename);
+
+	// Files are read out of the pack from now on (the ones it has, anything else still comes off the disk)
+	void SetAssetPack(AssetPack* pack) { m_assetPack = pack; }
+
+	// Queues the mesh on the loader and returns straight away, it's in here once the future is ready.
+	// filename has to stay around until then.
+	AssetFuture LoadAsync(AssetLoader* loader, Direct3D* renderer, const char* filename);
+
+	// Look the handle up once (PATH_HASH the filename) and keep it, GetMesh with a handle is just an array index
+	MeshHandle GetHandle(unsigned int pathHash) { return m_meshes.Find(pathHash); }
+	MeshHandle GetHandle(const char* filename) { return m_meshes.Find(HashPath(filename), filename); }
+
+	// These add a reference, NULL if the mesh isn't loaded (or has been released since the handle was made)
+	Mesh* GetMesh(MeshHandle handle);
+	Mesh* GetMesh(unsigned int pathHash) { return GetMesh(GetHandle(pathHash)); }
+	Mesh* GetMesh(const char* filename) { return GetMesh(GetHandle(filename)); }
+
 	void ReleaseMesh(Mesh* mesh);
 	void Release();
 
@@ -0,0 +1,301 @@
+/*	FIT2096 - Assignment 2b
+*	MeshOptimiser.cpp
+*	Implementation of MeshOptimiser.h
+*/
+
+#include "MeshOptimiser.h"
+
+#include <cmath>
+#include <cstring>
+
+using namespace std;
+
+// Forsyth's tuning values, see "Linear-Speed Vertex Cache Optimisation"
+#define FORSYTH_CACHE_DECAY_POWER 1.5f
+#define FORSYTH_LAST_TRIANGLE_SCORE 0.75f
+#define FORSYTH_VALENCE_BOOST_SCALE 2.0f
+#define FORSYTH_VALENCE_BOOST_POWER 0.5f
+
+// FNV-1a, quick and good enough to spread vertices around the table
+static unsigned int HashBytes(const unsigned char* bytes, int count)
+{
+	unsigned int hash = 2166136261u;
+
+	for (int i = 0; i < count; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 16777619u;
+	}
+
+	return hash;
+}
+
+// How much we'd like to draw a triangle using this vertex next. Vertices that were just used score
+// highest, and vertices with only a few triangles left get a boost so they're finished off rather
+// than left lying around to be transformed again later.
+static float ScoreVertex(int cachePosition, int trianglesLeft)
+{
+	if (trianglesLeft == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+
+	if (cachePosition >= 0)
+	{
+		// The last triangle's vertices get a fixed score, otherwise it would pay to draw the same
+		// three again in a different order
+		if (cachePosition < 3)
+		{
+			score = FORSYTH_LAST_TRIANGLE_SCORE;
+		}
+		else
+		{
+			float scaler = 1.0f / (MESH_OPTIMISER_CACHE_SIZE - 3);
+			score = powf(1.0f - (cachePosition - 3) * scaler, FORSYTH_CACHE_DECAY_POWER);
+		}
+	}
+
+	score += FORSYTH_VALENCE_BOOST_SCALE * powf((float)trianglesLeft, -FORSYTH_VALENCE_BOOST_POWER);
+	return score;
+}
+
+int MeshOptimiser::Weld(const void* vertices, int vertexCount, int stride, vector<unsigned long>* remap)
+{
+	const unsigned char* bytes = (const unsigned char*)vertices;
+	remap->resize(vertexCount);
+
+	// Open addressing with at least twice as many slots as vertices keeps the probes short.
+	// Each slot holds the first vertex that had that value, or -1 when empty.
+	unsigned int tableSize = 16;
+	while (tableSize < (unsigned int)vertexCount * 2)
+	{
+		tableSize *= 2;
+	}
+
+	vector<int> table(tableSize, -1);
+	int uniqueCount = 0;
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		const unsigned char* vertex = bytes + (size_t)i * stride;
+		unsigned int slot = HashBytes(vertex, stride) & (tableSize - 1);
+
+		while (true)
+		{
+			int existing = table[slot];
+
+			if (existing < 0)
+			{
+				table[slot] = i;
+				(*remap)[i] = uniqueCount++;
+				break;
+			}
+
+			if (memcmp(bytes + (size_t)existing * stride, vertex, stride) == 0)
+			{
+				(*remap)[i] = (*remap)[existing];
+				break;
+			}
+
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+
+	return uniqueCount;
+}
+
+void MeshOptimiser::OptimiseVertexCache(unsigned long* indices, int indexCount, int vertexCount)
+{
+	int triangleCount = indexCount / 3;
+	if (triangleCount == 0 || vertexCount == 0)
+		return;
+
+	// Every vertex keeps a list of the triangles using it that haven't been drawn yet.
+	// They all live in one array, each vertex gets trianglesLeft of them starting at its offset.
+	vector<int> trianglesLeft(vertexCount, 0);
+	vector<int> adjacencyOffset(vertexCount, 0);
+	vector<int> adjacency(triangleCount * 3);
+
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		trianglesLeft[indices[i]]++;
+	}
+
+	int offset = 0;
+	for (int i = 0; i < vertexCount; i++)
+	{
+		adjacencyOffset[i] = offset;
+		offset += trianglesLeft[i];
+		trianglesLeft[i] = 0;
+	}
+
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		unsigned long vertex = indices[i];
+		adjacency[adjacencyOffset[vertex] + trianglesLeft[vertex]++] = i / 3;
+	}
+
+	vector<int> cachePosition(vertexCount, -1);
+	vector<float> vertexScore(vertexCount);
+	for (int i = 0; i < vertexCount; i++)
+	{
+		vertexScore[i] = ScoreVertex(-1, trianglesLeft[i]);
+	}
+
+	vector<bool> triangleDrawn(triangleCount, false);
+
+	// Room for the whole cache plus the three new vertices pushing the oldest out
+	int cache[MESH_OPTIMISER_CACHE_SIZE + 3];
+	int newCache[MESH_OPTIMISER_CACHE_SIZE + 3];
+	int cacheCount = 0;
+
+	vector<unsigned long> output(triangleCount * 3);
+	int outputTriangles = 0;
+	int nextUndrawn = 0;
+	int bestTriangle = -1;
+
+	while (outputTriangles < triangleCount)
+	{
+		// Nothing in the cache leads anywhere (first triangle, or we finished off a piece of the mesh),
+		// so just start again from the first triangle that hasn't been drawn
+		if (bestTriangle < 0)
+		{
+			while (triangleDrawn[nextUndrawn])
+			{
+				nextUndrawn++;
+			}
+
+			bestTriangle = nextUndrawn;
+		}
+
+		const unsigned long* triangle = indices + bestTriangle * 3;
+		output[outputTriangles * 3] = triangle[0];
+		output[outputTriangles * 3 + 1] = triangle[1];
+		output[outputTriangles * 3 + 2] = triangle[2];
+		triangleDrawn[bestTriangle] = true;
+		outputTriangles++;
+
+		// This triangle is done so take it off its vertices' lists
+		for (int corner = 0; corner < 3; corner++)
+		{
+			unsigned long vertex = triangle[corner];
+			int* list = &adjacency[adjacencyOffset[vertex]];
+			int count = trianglesLeft[vertex];
+
+			for (int i = 0; i < count; i++)
+			{
+				if (list[i] == bestTriangle)
+				{
+					list[i] = list[count - 1];
+					break;
+				}
+			}
+
+			trianglesLeft[vertex]--;
+		}
+
+		// Its vertices go to the front of the cache, everything else shuffles back.
+		// A squashed triangle can use the same vertex twice, it only needs one spot.
+		int newCacheCount = 0;
+		for (int corner = 0; corner < 3; corner++)
+		{
+			if (corner == 0 || triangle[corner] != triangle[0])
+			{
+				if (corner < 2 || triangle[corner] != triangle[1])
+				{
+					newCache[newCacheCount++] = triangle[corner];
+				}
+			}
+		}
+
+		for (int i = 0; i < cacheCount; i++)
+		{
+			int vertex = cache[i];
+			if (vertex != (int)triangle[0] && vertex != (int)triangle[1] && vertex != (int)triangle[2])
+			{
+				newCache[newCacheCount++] = vertex;
+			}
+		}
+
+		// Rescore what's in the cache. Anything that fell off the end is forgotten.
+		for (int i = 0; i < newCacheCount; i++)
+		{
+			int vertex = newCache[i];
+			cachePosition[vertex] = i < MESH_OPTIMISER_CACHE_SIZE ? i : -1;
+			vertexScore[vertex] = ScoreVertex(cachePosition[vertex], trianglesLeft[vertex]);
+		}
+
+		// Then the triangles around it, keeping an eye out for the best one to draw next
+		bestTriangle = -1;
+		float bestScore = -1.0f;
+
+		for (int i = 0; i < newCacheCount; i++)
+		{
+			int vertex = newCache[i];
+			const int* list = &adjacency[adjacencyOffset[vertex]];
+
+			for (int j = 0; j < trianglesLeft[vertex]; j++)
+			{
+				int candidate = list[j];
+				const unsigned long* corners = indices + candidate * 3;
+				float score = vertexScore[corners[0]] + vertexScore[corners[1]] + vertexScore[corners[2]];
+
+				if (score > bestScore)
+				{
+					bestScore = score;
+					bestTriangle = candidate;
+				}
+			}
+		}
+
+		cacheCount = newCacheCount < MESH_OPTIMISER_CACHE_SIZE ? newCacheCount : MESH_OPTIMISER_CACHE_SIZE;
+		memcpy(cache, newCache, cacheCount * sizeof(int));
+	}
+
+	memcpy(indices, &output[0], triangleCount * 3 * sizeof(unsigned long));
+}
+
+int MeshOptimiser::OptimiseVertexFetch(unsigned long* indices, int indexCount, int vertexCount, vector<unsigned long>* remap)
+{
+	remap->assign(vertexCount, MESH_OPTIMISER_UNUSED);
+	int usedCount = 0;
+
+	for (int i = 0; i < indexCount; i++)
+	{
+		unsigned long& newIndex = (*remap)[indices[i]];
+
+		if (newIndex == MESH_OPTIMISER_UNUSED)
+		{
+			newIndex = usedCount++;
+		}
+
+		indices[i] = newIndex;
+	}
+
+	return usedCount;
+}
+
+float MeshOptimiser::GetACMR(const unsigned long* indices, int indexCount, int vertexCount)
+{
+	int triangleCount = indexCount / 3;
+	if (triangleCount == 0)
+		return 0.0f;
+
+	// Rather than moving everything along, each vertex remembers when it went in.
+	// It's still in the cache if fewer than FIFO_SIZE misses have happened since.
+	vector<int> insertedAt(vertexCount, -MESH_OPTIMISER_FIFO_SIZE - 1);
+	int misses = 0;
+
+	for (int i = 0; i < triangleCount * 3; i++)
+	{
+		unsigned long vertex = indices[i];
+
+		if (misses - insertedAt[vertex] > MESH_OPTIMISER_FIFO_SIZE)
+		{
+			insertedAt[vertex] = misses;
+			misses++;
+		}
+	}
+
+	return (float)misses / triangleCount;
+}
@@ -0,0 +1,43 @@
+/*	FIT2096 - Assignment 2b
+*	MeshOptimiser.h
+*	Tidies up triangle lists after they've been loaded so the GPU does less work drawing them.
+*	Weld merges corners that ended up exactly the same so they share one vertex, OptimiseVertexCache
+*	reorders the triangles so recently transformed vertices get reused (Tom Forsyth's linear speed
+*	vertex cache optimisation) and OptimiseVertexFetch renumbers the vertices in the order they're
+*	first drawn so they're read from memory front to back.
+*	Everything works on plain index arrays so it doesn't care what a vertex looks like.
+*/
+
+#ifndef MESH_OPTIMISER_H
+#define MESH_OPTIMISER_H
+
+#include <vector>
+
+// How many transformed vertices the GPU is assumed to keep around. Forsyth's scoring is tuned for this many.
+#define MESH_OPTIMISER_CACHE_SIZE 32
+
+// GetACMR pretends the cache is a simple FIFO this big, which is closer to what real hardware does
+#define MESH_OPTIMISER_FIFO_SIZE 16
+
+// What OptimiseVertexFetch puts in the remap for a vertex no triangle uses
+#define MESH_OPTIMISER_UNUSED 0xffffffffUL
+
+class MeshOptimiser
+{
+public:
+	// Finds vertices that are byte for byte the same. remap gets one entry per vertex saying which unique
+	// vertex it became, numbered in the order they first appear. Returns how many unique vertices there are.
+	static int Weld(const void* vertices, int vertexCount, int stride, std::vector<unsigned long>* remap);
+
+	// Reorders the triangles in place. Every index must be below vertexCount.
+	static void OptimiseVertexCache(unsigned long* indices, int indexCount, int vertexCount);
+
+	// Renumbers the indices in place so vertex 0 is the first one drawn, 1 the next new one and so on.
+	// remap says where each old vertex went (or MESH_OPTIMISER_UNUSED). Returns how many are used.
+	static int OptimiseVertexFetch(unsigned long* indices, int indexCount, int vertexCount, std::vector<unsigned long>* remap);
+
+	// Average cache misses per triangle, 3 is as bad as it gets and 0.5 is about as good
+	static float GetACMR(const unsigned long* indices, int indexCount, int vertexCount);
+};
+
+#endif
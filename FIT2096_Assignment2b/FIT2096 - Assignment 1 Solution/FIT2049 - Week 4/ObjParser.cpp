@@ -0,0 +1,352 @@
+/*	FIT2096 - Assignment 2b
+*	ObjParser.cpp
+*	Implementation of ObjParser.h
+*/
+
+#include "ObjParser.h"
+#include "MappedFile.h"
+
+#include <cmath>
+#include <cstring>
+
+// Every power of ten up to here is exact in a double, so scaling by one only rounds once
+#define OBJ_EXACT_POWERS 22
+
+static const double s_powersOfTen[OBJ_EXACT_POWERS + 1] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+// Newlines aren't spaces, they end the line
+static bool IsSpace(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+static bool IsDigit(char c)
+{
+	return c >= '0' && c <= '9';
+}
+
+static const char* SkipSpaces(const char* text, const char* end)
+{
+	while (text < end && IsSpace(*text))
+	{
+		text++;
+	}
+
+	return text;
+}
+
+static const char* SkipLine(const char* text, const char* end)
+{
+	const char* newline = (const char*)memchr(text, '\n', end - text);
+	return newline ? newline + 1 : end;
+}
+
+static const char* ParseInt(const char* text, const char* end, int* value)
+{
+	const char* p = text;
+	bool negative = false;
+
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+
+	if (p >= end || !IsDigit(*p))
+		return text;
+
+	int result = 0;
+	while (p < end && IsDigit(*p))
+	{
+		result = result * 10 + (*p - '0');
+		p++;
+	}
+
+	*value = negative ? -result : result;
+	return p;
+}
+
+// Reads up to count numbers off the line, anything missing is left as zero
+static const char* ParseFloats(const char* text, const char* end, float* values, int count)
+{
+	for (int i = 0; i < count; i++)
+	{
+		values[i] = 0.0f;
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		text = SkipSpaces(text, end);
+		const char* next = ObjParser::ParseFloat(text, end, &values[i]);
+
+		if (next == text)
+			break;
+
+		text = next;
+	}
+
+	return text;
+}
+
+// Positive indices count from 1 and are checked once the whole file has been read, since they can
+// point at something further down. Negative ones count back from what we've read so far.
+static bool ResolveIndex(int index, int countSoFar, int* resolved)
+{
+	if (index > 0)
+	{
+		*resolved = index - 1;
+		return true;
+	}
+
+	if (index < 0 && countSoFar + index >= 0)
+	{
+		*resolved = countSoFar + index;
+		return true;
+	}
+
+	return false;
+}
+
+void ObjMeshData::Clear()
+{
+	positions.clear();
+	uvs.clear();
+	normals.clear();
+	corners.clear();
+}
+
+const char* ObjParser::ParseFloat(const char* text, const char* end, float* value)
+{
+	const char* p = text;
+	bool negative = false;
+
+	if (p < end && (*p == '-' || *p == '+'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+
+	// Collect the digits into one big integer and remember where the decimal point goes.
+	// Past 19 digits there's no more precision to be had, the rest only move the point.
+	unsigned long long mantissa = 0;
+	int significantDigits = 0;
+	int exponent = 0;
+	bool anyDigits = false;
+
+	while (p < end && IsDigit(*p))
+	{
+		if (significantDigits < 19)
+		{
+			mantissa = mantissa * 10 + (*p - '0');
+			significantDigits += mantissa > 0 ? 1 : 0;
+		}
+		else
+		{
+			exponent++;
+		}
+
+		anyDigits = true;
+		p++;
+	}
+
+	if (p < end && *p == '.')
+	{
+		p++;
+
+		while (p < end && IsDigit(*p))
+		{
+			if (significantDigits < 19)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				significantDigits += mantissa > 0 ? 1 : 0;
+				exponent--;
+			}
+
+			anyDigits = true;
+			p++;
+		}
+	}
+
+	if (!anyDigits)
+		return text;
+
+	// Only take the exponent if there's actually a number after the e
+	if (p < end && (*p == 'e' || *p == 'E'))
+	{
+		const char* q = p + 1;
+		bool negativeExponent = false;
+
+		if (q < end && (*q == '-' || *q == '+'))
+		{
+			negativeExponent = *q == '-';
+			q++;
+		}
+
+		if (q < end && IsDigit(*q))
+		{
+			int written = 0;
+			while (q < end && IsDigit(*q))
+			{
+				// Anything this big is zero or infinity as a float anyway
+				if (written < 10000)
+					written = written * 10 + (*q - '0');
+
+				q++;
+			}
+
+			exponent += negativeExponent ? -written : written;
+			p = q;
+		}
+	}
+
+	double result = (double)mantissa;
+
+	if (exponent < 0)
+	{
+		result /= exponent >= -OBJ_EXACT_POWERS ? s_powersOfTen[-exponent] : pow(10.0, -exponent);
+	}
+	else if (exponent > 0)
+	{
+		result *= exponent <= OBJ_EXACT_POWERS ? s_powersOfTen[exponent] : pow(10.0, exponent);
+	}
+
+	*value = (float)(negative ? -result : result);
+	return p;
+}
+
+bool ObjParser::ParseFile(const char* filename, ObjMeshData* data)
+{
+	MappedFile file;
+
+	if (!file.Open(filename))
+		return false;
+
+	return Parse(file.GetData(), file.GetSize(), data);
+}
+
+bool ObjParser::Parse(const char* text, size_t length, ObjMeshData* data)
+{
+	data->Clear();
+
+	const char* p = text;
+	const char* end = text + length;
+
+	float values[3];
+
+	while (p < end)
+	{
+		p = SkipSpaces(p, end);
+
+		if (p + 1 >= end)
+			break;
+
+		if (p[0] == 'v' && IsSpace(p[1]))
+		{
+			p = ParseFloats(p + 2, end, values, 3);
+			data->positions.push_back(Vector3(values[0], values[1], values[2]));
+		}
+		else if (p[0] == 'v' && p[1] == 't' && p + 2 < end && IsSpace(p[2]))
+		{
+			// OBJ puts v = 0 at the bottom of the texture, Direct3D puts it at the top
+			p = ParseFloats(p + 3, end, values, 2);
+			data->uvs.push_back(Vector2(values[0], -values[1]));
+		}
+		else if (p[0] == 'v' && p[1] == 'n' && p + 2 < end && IsSpace(p[2]))
+		{
+			p = ParseFloats(p + 3, end, values, 3);
+			data->normals.push_back(Vector3(values[0], values[1], values[2]));
+		}
+		else if (p[0] == 'f' && IsSpace(p[1]))
+		{
+			// Each point is position/uv/normal, where uv and normal (and their slashes) can be left out.
+			// A fan from the first point covers any convex polygon, so from the third point on each
+			// new one makes a triangle with the first and the one before it. Less than three makes nothing.
+			ObjCorner first;
+			ObjCorner previous;
+			int pointCount = 0;
+			p += 2;
+
+			while (true)
+			{
+				p = SkipSpaces(p, end);
+
+				int index;
+				const char* next = ParseInt(p, end, &index);
+				if (next == p)
+					break;
+
+				ObjCorner corner;
+				corner.uv = -1;
+				corner.normal = -1;
+
+				if (!ResolveIndex(index, (int)data->positions.size(), &corner.position))
+					return false;
+
+				p = next;
+
+				if (p < end && *p == '/')
+				{
+					p++;
+					next = ParseInt(p, end, &index);
+
+					if (next != p)
+					{
+						if (!ResolveIndex(index, (int)data->uvs.size(), &corner.uv))
+							return false;
+
+						p = next;
+					}
+
+					if (p < end && *p == '/')
+					{
+						p++;
+						next = ParseInt(p, end, &index);
+
+						if (next != p)
+						{
+							if (!ResolveIndex(index, (int)data->normals.size(), &corner.normal))
+								return false;
+
+							p = next;
+						}
+					}
+				}
+
+				if (pointCount == 0)
+				{
+					first = corner;
+				}
+				else if (pointCount >= 2)
+				{
+					data->corners.push_back(first);
+					data->corners.push_back(previous);
+					data->corners.push_back(corner);
+				}
+
+				previous = corner;
+				pointCount++;
+			}
+		}
+
+		p = SkipLine(p, end);
+	}
+
+	// Now everything has been read, make sure the faces only use what's there
+	int positionCount = (int)data->positions.size();
+	int uvCount = (int)data->uvs.size();
+	int normalCount = (int)data->normals.size();
+
+	for (unsigned int i = 0; i < data->corners.size(); i++)
+	{
+		const ObjCorner& corner = data->corners[i];
+
+		if (corner.position >= positionCount || corner.uv >= uvCount || corner.normal >= normalCount)
+			return false;
+	}
+
+	return true;
+}
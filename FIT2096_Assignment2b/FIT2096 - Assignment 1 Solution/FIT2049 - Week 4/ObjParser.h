@@ -0,0 +1,51 @@
+/*	FIT2096 - Assignment 2b
+*	ObjParser.h
+*	Reads Wavefront OBJ meshes. The file is mapped into memory and read once from start to
+*	end, with the numbers parsed straight out of the text (no streams, so the locale doesn't
+*	matter and nothing is copied). Arrays grow as lines are found rather than being counted
+*	up front.
+*	Faces with more than three points are cut into a fan of triangles. Indices can be
+*	negative, which counts back from the last position, uv or normal read so far.
+*	Only positions, uvs, normals and faces are read, every other kind of line is skipped.
+*/
+
+#ifndef OBJ_PARSER_H
+#define OBJ_PARSER_H
+
+#include "DirectXTK/SimpleMath.h"
+#include <cstddef>
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+// One corner of a triangle. Indices start at zero and are -1 when the face didn't give one.
+struct ObjCorner
+{
+	int position;
+	int uv;
+	int normal;
+};
+
+struct ObjMeshData
+{
+	std::vector<Vector3> positions;
+	std::vector<Vector2> uvs;		// Already flipped upside down for Direct3D
+	std::vector<Vector3> normals;
+	std::vector<ObjCorner> corners;	// Three per triangle
+
+	void Clear();
+};
+
+class ObjParser
+{
+public:
+	// False if the file can't be read or a face uses something that isn't there
+	static bool ParseFile(const char* filename, ObjMeshData* data);
+	static bool Parse(const char* text, size_t length, ObjMeshData* data);
+
+	// Reads a decimal number such as -1.5e-3 starting at text. Returns where the number ends,
+	// or text itself if there wasn't one. Never reads past end.
+	static const char* ParseFloat(const char* text, const char* end, float* value);
+};
+
+#endif
@@ -27,7 +27,6 @@ Player::Player(Mesh* mesh, Shader* shader, Texture* texture, InputController* in
 	TeleportToTileOfType(TileType::NORMAL);
 
 	shootCounter = 0.0f;
-	m_bullets = m_currentBoard->getBulletVector();
 
 	m_boundingBox = CBoundingBox(m_position + m_mesh->GetMin(), m_position + m_mesh->GetMax());
 }
@@ -111,18 +110,15 @@ void Player::FinishTurn()
 
 void Player::TeleportToTileOfType(TileType type)
 {
-	Tile* destinationTile = m_currentBoard->GetRandomTileOfType(type);
+	int x, z;
 
-	if (destinationTile)
+	if (m_currentBoard->GetRandomTileOfType(type, &x, &z))
 	{
 		// We need to set both the current position and the target
 		// The only time the player remains still is when these two positions match
-		m_targetPosition = destinationTile->GetPosition();
-		m_position = destinationTile->GetPosition();
-
 		// Tiles start up in the sky and fall down. Ensure player starts on the ground.
-		m_targetPosition.y = 0.0f;
-		m_position.y = 0.0f;
+		m_targetPosition = Vector3((float)x, 0.0f, (float)z);
+		m_position = m_targetPosition;
 	}
 }
 
@@ -140,42 +136,24 @@ void Player::CheckWinCondition()
 // The shoot function of a player
 void Player::Shoot()
 {
-	Bullet* the_bullet = NULL;
-
-	for (int i = 0; i < m_bullets.size(); i++)
-	{
-		if (m_bullets[i]->GetBeingUsed() == false)
-		{
-			the_bullet = m_bullets[i];
-			break;
-		}
-	}
-
-	if (the_bullet)
-	{
-		Vector3 m_offset = Vector3(0.0f, 0.0f, 1.0f);    // The offset for player bullet
-		
-		Vector3 m_view = m_position + Vector3(0, 1, 0);  // This is the position of the camera
-
-		Matrix heading = Matrix::CreateRotationY(m_rotY);
-
-		Matrix lookAtRotation = heading;
+	Vector3 m_offset = Vector3(0.0f, 0.0f, 1.0f);    // The offset for player bullet
+	
+	Vector3 m_view = m_position + Vector3(0, 1, 0);  // This is the position of the camera
 
-		// The offset is still based on the world local, transform it into player's local
-		Vector3 spawnAt = Vector3::TransformNormal(m_offset, lookAtRotation);
+	Matrix heading = Matrix::CreateRotationY(m_rotY);
 
-		spawnAt += m_view;                               // Now it is a point slightly in front of the player
+	Matrix lookAtRotation = heading;
 
-		Vector3 flyTowards = Vector3::TransformNormal(Vector3(0, 0, 10), heading);  // This is the direction player is facing
+	// The offset is still based on the world local, transform it into player's local
+	Vector3 spawnAt = Vector3::TransformNormal(m_offset, lookAtRotation);
 
-		the_bullet->SetPosition(spawnAt);                // Need to add some offset so the bullet appear in front of player and will not trigger hitbox
-		                                                 
-		the_bullet->SetFlyTowards(flyTowards);           // Fly towards the direction player is facing
+	spawnAt += m_view;                               // Now it is a point slightly in front of the player
 
-		the_bullet->SetYRotation(m_rotY);                // Rotate the bullet to the correct direction
+	Vector3 flyTowards = Vector3::TransformNormal(Vector3(0, 0, 10), heading);  // This is the direction player is facing
 
-		the_bullet->SetBeingUsed(true);  // So the bullet will start updating
-	}
+	// Spawn slightly in front of the player so it doesn't trigger our own hitbox, facing and flying the way we face
+	// Nothing happens if the pool is out of bullets
+	m_currentBoard->GetBulletPool()->Fire(spawnAt, flyTowards, m_rotY, this);
 }
 
 // Collisions
@@ -27,8 +27,7 @@ private:
 	float m_moveSpeed;
 	
 	// Which board is the player currently on
-	GameBoard* m_currentBoard;
-	std::vector<Bullet*> m_bullets;
+	GameBoard* m_currentBoard;  // Also where we get our bullets from
 
 	// Game variables
 	float m_health;
@@ -0,0 +1,21 @@
+/*	FIT2096 - Assignment 2b
+*	RenderBackend.h
+*	Something that can draw a RenderSnapshot. The game draws with a Direct3DRenderBackend,
+*	the headless build swaps in one that writes down what it was asked to draw instead.
+*/
+
+#ifndef RENDER_BACKEND_H
+#define RENDER_BACKEND_H
+
+#include "RenderSnapshot.h"
+
+class RenderBackend
+{
+public:
+	virtual ~RenderBackend() {}
+
+	// Draws one frame, amount of the way from the snapshot's previous tick to its current one
+	virtual void Draw(const RenderSnapshot* snapshot, float amount) = 0;
+};
+
+#endif
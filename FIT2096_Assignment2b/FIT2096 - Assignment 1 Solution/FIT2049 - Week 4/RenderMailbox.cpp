@@ -0,0 +1,73 @@
+/*	FIT2096 - Assignment 2b
+*	RenderMailbox.cpp
+*	Implementation of RenderMailbox.h
+*/
+
+#include "RenderMailbox.h"
+
+RenderMailbox::RenderMailbox()
+{
+	m_writing = 0;
+	m_waiting = 1;
+	m_reading = 2;
+	m_hasRead = false;
+	m_woken = false;
+
+	m_publishedCount = 0;
+	m_acquiredCount = 0;
+	m_droppedCount = 0;
+}
+
+void RenderMailbox::Publish()
+{
+	QueryPerformanceCounter(&m_snapshots[m_writing].publishedAt);
+
+	// The exchange is what hands the snapshot over, everything written to it before here is visible to the render thread
+	int previous = m_waiting.exchange(m_writing | RENDER_MAILBOX_FRESH);
+
+	if (previous & RENDER_MAILBOX_FRESH)
+	{
+		m_droppedCount++;
+	}
+
+	m_writing = previous & RENDER_MAILBOX_INDEX_MASK;
+	m_publishedCount++;
+
+	// Taking the lock means a render thread about to sleep either sees the new snapshot or gets the wake up
+	{
+		std::lock_guard<std::mutex> guard(m_signalLock);
+	}
+	m_signal.notify_one();
+}
+
+const RenderSnapshot* RenderMailbox::Acquire(bool* isNew)
+{
+	*isNew = false;
+
+	if (m_waiting & RENDER_MAILBOX_FRESH)
+	{
+		// Ours goes back in the middle, not fresh, so the simulation will only ever write over it
+		m_reading = m_waiting.exchange(m_reading) & RENDER_MAILBOX_INDEX_MASK;
+		m_hasRead = true;
+		m_acquiredCount++;
+		*isNew = true;
+	}
+
+	return m_hasRead ? &m_snapshots[m_reading] : NULL;
+}
+
+void RenderMailbox::WaitForPublish()
+{
+	std::unique_lock<std::mutex> guard(m_signalLock);
+	m_signal.wait(guard, [this] { return m_woken || (m_waiting & RENDER_MAILBOX_FRESH) != 0; });
+	m_woken = false;
+}
+
+void RenderMailbox::Wake()
+{
+	{
+		std::lock_guard<std::mutex> guard(m_signalLock);
+		m_woken = true;
+	}
+	m_signal.notify_one();
+}
@@ -0,0 +1,67 @@
+/*	FIT2096 - Assignment 2b
+*	RenderMailbox.h
+*	Passes render snapshots from the simulation to the render thread without either one
+*	waiting on the other. There are three snapshots: the one the simulation is filling in,
+*	the one the render thread is drawing, and the newest finished one waiting in between.
+*	Publishing swaps the one just filled in for the waiting one, and the render thread swaps
+*	the one it's finished with for the waiting one, so each side always has one to itself.
+*	If the simulation publishes twice before the render thread comes back, the older of the
+*	two is dropped. The render thread only ever wants the newest.
+*	Publish is only called from one thread and Acquire from one (possibly different) thread.
+*	The render thread can sleep in WaitForPublish when it has nothing new to draw.
+*/
+
+#ifndef RENDER_MAILBOX_H
+#define RENDER_MAILBOX_H
+
+#include "RenderSnapshot.h"
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+// Added to the waiting index while the snapshot there hasn't been picked up yet
+#define RENDER_MAILBOX_FRESH 4
+#define RENDER_MAILBOX_INDEX_MASK 3
+
+class RenderMailbox
+{
+private:
+	RenderSnapshot m_snapshots[3];
+
+	int m_writing;				// Only the simulation touches this
+	int m_reading;				// Only the render thread touches this...
+	bool m_hasRead;				// ...and this, which stays false until the first snapshot arrives
+	std::atomic<int> m_waiting;	// Index of the newest published snapshot, plus RENDER_MAILBOX_FRESH
+
+	// Publish wakes the render thread if it's waiting for a snapshot
+	std::mutex m_signalLock;
+	std::condition_variable m_signal;
+	bool m_woken;
+
+	std::atomic<int> m_publishedCount;
+	std::atomic<int> m_acquiredCount;
+	std::atomic<int> m_droppedCount;
+
+public:
+	RenderMailbox();
+
+	// Simulation side. Fill this in (it still holds whatever was in it three publishes ago) and then Publish it.
+	RenderSnapshot* GetWriteSnapshot() { return &m_snapshots[m_writing]; }
+	void Publish();
+
+	// Render thread side. The newest published snapshot, which is ours until the next Acquire.
+	// NULL until something has been published. isNew is set if it's one we haven't seen before.
+	const RenderSnapshot* Acquire(bool* isNew);
+
+	// Render thread side. Sleeps until there's a snapshot it hasn't picked up yet, or until Wake is called.
+	void WaitForPublish();
+
+	// Lets whoever is in WaitForPublish go without a new snapshot (or the next one to call it, if nobody is)
+	void Wake();
+
+	int GetPublishedCount() { return m_publishedCount; }
+	int GetAcquiredCount() { return m_acquiredCount; }	// Different snapshots the render thread has picked up
+	int GetDroppedCount() { return m_droppedCount; }	// Replaced by a newer one before anyone picked them up
+};
+
+#endif
@@ -0,0 +1,132 @@
+/*	FIT2096 - Assignment 2b
+*	RenderSnapshot.cpp
+*	Implementation of RenderSnapshot.h
+*/
+
+#include "RenderSnapshot.h"
+#include "MathsHelper.h"
+
+Matrix MeshDraw::GetWorld(float amount) const
+{
+	Vector3 blendedPosition = Vector3::Lerp(previousPosition, position, amount);
+	float rotX = MathsHelper::LerpAngle(previousRotation.x, rotation.x, amount);
+	float rotY = MathsHelper::LerpAngle(previousRotation.y, rotation.y, amount);
+	float rotZ = MathsHelper::LerpAngle(previousRotation.z, rotation.z, amount);
+
+	return Matrix::CreateScale(scale.x, scale.y, scale.z) * Matrix::CreateFromYawPitchRoll(rotY, rotX, rotZ) * Matrix::CreateTranslation(blendedPosition);
+}
+
+RenderSnapshot::RenderSnapshot()
+{
+	tick = 0;
+	interpolation = 0.0f;
+	publishedAt.QuadPart = 0;
+	clearColour = Color(0.0f, 0.0f, 0.0f, 1.0f);
+	cameraUp = Vector3::Up;
+	projection = Matrix::Identity;
+}
+
+void RenderSnapshot::Clear()
+{
+	meshes.clear();
+	instancedMeshes.clear();
+	instances.clear();
+	ui.clear();
+}
+
+void RenderSnapshot::AddMesh(Mesh* mesh, Shader* shader, Texture* texture, Vector3 previousPosition, Vector3 position,
+	Vector3 previousRotation, Vector3 rotation, Vector3 scale)
+{
+	MeshDraw draw;
+	draw.mesh = mesh;
+	draw.shader = shader;
+	draw.texture = texture;
+	draw.previousPosition = previousPosition;
+	draw.position = position;
+	draw.previousRotation = previousRotation;
+	draw.rotation = rotation;
+	draw.scale = scale;
+
+	meshes.push_back(draw);
+}
+
+void RenderSnapshot::AddInstancedMesh(Mesh* mesh, InstancedShader* shader, Texture* textureArray)
+{
+	InstancedMeshDraw draw;
+	draw.mesh = mesh;
+	draw.shader = shader;
+	draw.textureArray = textureArray;
+	draw.firstInstance = (unsigned int)instances.size();
+	draw.instanceCount = 0;
+
+	instancedMeshes.push_back(draw);
+}
+
+void RenderSnapshot::AddInstance(Vector3 previousPosition, Vector3 position, int layer)
+{
+	MeshInstance instance;
+	instance.previousPosition = previousPosition;
+	instance.position = position;
+	instance.layer = (float)layer;
+
+	instances.push_back(instance);
+	instancedMeshes.back().instanceCount++;
+}
+
+void RenderSnapshot::AddSprite(Texture* texture, Vector2 position, const RECT* source, Color colour, Vector2 origin)
+{
+	UIDraw draw;
+	draw.type = UIDrawType::SPRITE;
+	draw.texture = texture;
+	draw.font = NULL;
+	draw.position = position;
+	draw.origin = origin;
+	draw.colour = colour;
+	draw.useDestination = false;
+	draw.useSource = source != NULL;
+
+	if (source)
+	{
+		draw.source = *source;
+	}
+
+	ui.push_back(draw);
+}
+
+void RenderSnapshot::AddSprite(Texture* texture, RECT destination, Color colour)
+{
+	UIDraw draw;
+	draw.type = UIDrawType::SPRITE;
+	draw.texture = texture;
+	draw.font = NULL;
+	draw.colour = colour;
+	draw.destination = destination;
+	draw.useDestination = true;
+	draw.useSource = false;
+
+	ui.push_back(draw);
+}
+
+void RenderSnapshot::AddText(SpriteFont* font, const std::wstring& text, Vector2 position, Color colour, Vector2 origin)
+{
+	UIDraw draw;
+	draw.type = UIDrawType::TEXT;
+	draw.texture = NULL;
+	draw.font = font;
+	draw.text = text;
+	draw.position = position;
+	draw.origin = origin;
+	draw.colour = colour;
+	draw.useDestination = false;
+	draw.useSource = false;
+
+	ui.push_back(draw);
+}
+
+Matrix RenderSnapshot::GetView(float amount) const
+{
+	Vector3 position = Vector3::Lerp(previousCameraPosition, cameraPosition, amount);
+	Vector3 lookAt = Vector3::Lerp(previousCameraLookAt, cameraLookAt, amount);
+
+	return DirectX::XMMatrixLookAtLH(position, lookAt, cameraUp);
+}
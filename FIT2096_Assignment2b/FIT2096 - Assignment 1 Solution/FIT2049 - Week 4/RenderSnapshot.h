@@ -0,0 +1,130 @@
+/*	FIT2096 - Assignment 2b
+*	RenderSnapshot.h
+*	Everything needed to draw one frame, copied out of the game after a tick. Anything that
+*	moves is stored as where it was on the tick before and where it is now, so whoever draws
+*	it can blend between the two without asking the game anything.
+*	Once a snapshot has been published nothing in it changes, which is what lets the render
+*	thread draw it while the simulation gets on with the next tick.
+*	Meshes, shaders, textures and fonts are pointed to rather than copied. They're all loaded
+*	before the first tick and aren't released until everything has stopped drawing.
+*/
+
+#ifndef RENDER_SNAPSHOT_H
+#define RENDER_SNAPSHOT_H
+
+#include "InstancedShader.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "Texture.h"
+
+#include "DirectXTK/SimpleMath.h"
+#include "DirectXTK/SpriteFont.h"
+
+#include <Windows.h>
+#include <string>
+#include <vector>
+
+using namespace DirectX;
+using namespace DirectX::SimpleMath;
+
+struct MeshDraw
+{
+	Mesh* mesh;
+	Shader* shader;
+	Texture* texture;
+
+	Vector3 previousPosition;
+	Vector3 position;
+	Vector3 previousRotation;	// Pitch, yaw and roll in x, y and z
+	Vector3 rotation;
+	Vector3 scale;
+
+	// The world matrix for amount of the way from the previous tick to the current one
+	Matrix GetWorld(float amount) const;
+};
+
+// One copy of an instanced mesh. Instances only move, they keep the rotation and scale of the mesh.
+struct MeshInstance
+{
+	Vector3 previousPosition;
+	Vector3 position;
+	float layer;				// Which layer of the texture array it samples
+};
+
+// A run of instances that all use the same mesh, shader and texture array, drawn together
+struct InstancedMeshDraw
+{
+	Mesh* mesh;
+	InstancedShader* shader;
+	Texture* textureArray;
+
+	unsigned int firstInstance;	// Where its instances start in the snapshot's list
+	unsigned int instanceCount;
+};
+
+enum class UIDrawType
+{
+	SPRITE,
+	TEXT,
+};
+
+struct UIDraw
+{
+	UIDrawType type;
+	Texture* texture;		// Sprites only
+	SpriteFont* font;		// Text only
+	std::wstring text;
+
+	Vector2 position;
+	Vector2 origin;
+	Color colour;
+
+	RECT destination;		// Sprites are stretched over this when useDestination is set, otherwise drawn at position
+	bool useDestination;
+	RECT source;			// The part of the texture to draw when useSource is set, otherwise all of it
+	bool useSource;
+};
+
+class RenderSnapshot
+{
+public:
+	unsigned int tick;			// The tick the game was up to when it built this
+	float interpolation;		// How far past that tick the clock already was
+	LARGE_INTEGER publishedAt;	// Performance counter when it was published, set by the mailbox
+
+	Color clearColour;
+
+	// The camera, blended between the same two ticks as everything else
+	Vector3 previousCameraPosition;
+	Vector3 cameraPosition;
+	Vector3 previousCameraLookAt;
+	Vector3 cameraLookAt;
+	Vector3 cameraUp;
+	Matrix projection;
+
+	std::vector<MeshDraw> meshes;
+	std::vector<InstancedMeshDraw> instancedMeshes;	// Drawn before meshes
+	std::vector<MeshInstance> instances;			// For all of the instanced meshes, each takes a run of them
+	std::vector<UIDraw> ui;		// Drawn in order, over the top of the meshes
+
+	RenderSnapshot();
+
+	// Empties the lists but keeps their memory, so the next frame doesn't have to allocate it again
+	void Clear();
+
+	void AddMesh(Mesh* mesh, Shader* shader, Texture* texture, Vector3 previousPosition, Vector3 position,
+		Vector3 previousRotation = Vector3::Zero, Vector3 rotation = Vector3::Zero, Vector3 scale = Vector3::One);
+
+	// Starts a new instanced mesh, every AddInstance after this (until the next one) is a copy of it
+	void AddInstancedMesh(Mesh* mesh, InstancedShader* shader, Texture* textureArray);
+	void AddInstance(Vector3 previousPosition, Vector3 position, int layer);
+
+	// source can be NULL to draw the whole texture
+	void AddSprite(Texture* texture, Vector2 position, const RECT* source, Color colour, Vector2 origin);
+	void AddSprite(Texture* texture, RECT destination, Color colour);
+	void AddText(SpriteFont* font, const std::wstring& text, Vector2 position, Color colour, Vector2 origin);
+
+	Matrix GetView(float amount) const;
+};
+
+#endif
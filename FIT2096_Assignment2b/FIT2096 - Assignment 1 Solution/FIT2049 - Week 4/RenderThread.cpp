@@ -0,0 +1,83 @@
+/*	FIT2096 - Assignment 2b
+*	RenderThread.cpp
+*	Implementation of RenderThread.h
+*/
+
+#include "RenderThread.h"
+
+RenderThread::RenderThread(RenderMailbox* mailbox, RenderBackend* backend, float stepSize)
+{
+	m_mailbox = mailbox;
+	m_backend = backend;
+	m_stepSize = stepSize;
+	m_quit = false;
+	m_frameCount = 0;
+
+	QueryPerformanceFrequency(&m_counterFrequency);
+}
+
+RenderThread::~RenderThread()
+{
+	Stop();
+}
+
+void RenderThread::Start()
+{
+	if (m_thread.joinable())
+		return;
+
+	m_quit = false;
+	m_thread = std::thread(&RenderThread::Loop, this);
+}
+
+void RenderThread::Stop()
+{
+	if (!m_thread.joinable())
+		return;
+
+	m_quit = true;
+	m_mailbox->Wake();
+	m_thread.join();
+}
+
+float RenderThread::GetInterpolation(const RenderSnapshot* snapshot)
+{
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+
+	// Carry on from where the simulation was when it published, but never past the current tick
+	float sincePublished = (now.QuadPart - snapshot->publishedAt.QuadPart) / (float)m_counterFrequency.QuadPart;
+	float amount = snapshot->interpolation + sincePublished / m_stepSize;
+
+	if (amount < 0.0f)
+		amount = 0.0f;
+
+	if (amount > 1.0f)
+		amount = 1.0f;
+
+	return amount;
+}
+
+void RenderThread::Loop()
+{
+	bool caughtUp = false;
+
+	while (!m_quit)
+	{
+		bool isNew;
+		const RenderSnapshot* snapshot = m_mailbox->Acquire(&isNew);
+
+		// Nothing to draw yet, or nothing that would look any different to last time
+		if (!snapshot || (caughtUp && !isNew))
+		{
+			m_mailbox->WaitForPublish();
+			continue;
+		}
+
+		float amount = GetInterpolation(snapshot);
+		m_backend->Draw(snapshot, amount);
+		m_frameCount++;
+
+		caughtUp = amount >= 1.0f;
+	}
+}
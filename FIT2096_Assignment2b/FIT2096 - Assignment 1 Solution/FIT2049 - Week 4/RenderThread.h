@@ -0,0 +1,48 @@
+/*	FIT2096 - Assignment 2b
+*	RenderThread.h
+*	Draws whatever the newest snapshot in a RenderMailbox is, over and over, on its own thread.
+*	A slow tick no longer holds up Present and a slow Present no longer holds up the next tick.
+*	Between snapshots it keeps blending further towards the snapshot's current tick as real
+*	time passes, the same as drawing between ticks did when everything was on one thread.
+*	Once it's caught up with a snapshot it sleeps until the next one is published rather than
+*	drawing the same picture again.
+*/
+
+#ifndef RENDER_THREAD_H
+#define RENDER_THREAD_H
+
+#include "RenderBackend.h"
+#include "RenderMailbox.h"
+
+#include <atomic>
+#include <thread>
+
+class RenderThread
+{
+private:
+	RenderMailbox* m_mailbox;
+	RenderBackend* m_backend;
+	float m_stepSize;			// Seconds between ticks, so we know how fast to blend
+
+	std::thread m_thread;
+	std::atomic<bool> m_quit;
+	std::atomic<int> m_frameCount;
+
+	LARGE_INTEGER m_counterFrequency;
+
+	float GetInterpolation(const RenderSnapshot* snapshot);
+	void Loop();
+
+public:
+	RenderThread(RenderMailbox* mailbox, RenderBackend* backend, float stepSize);
+	~RenderThread();
+
+	void Start();
+
+	// Waits for the frame being drawn to finish. Call before releasing anything a snapshot points to.
+	void Stop();
+
+	int GetFrameCount() { return m_frameCount; }
+};
+
+#endif
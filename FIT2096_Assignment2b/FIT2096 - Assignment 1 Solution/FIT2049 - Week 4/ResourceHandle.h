@@ -0,0 +1,163 @@
+/*	FIT2096 - Assignment 2b
+*	ResourceHandle.h
+*	Handles the MeshManager and TextureManager give out instead of making everyone look things up
+*	by filename. A handle is a slot number in the manager's array plus the generation of that slot,
+*	32 bits altogether. Resolving one is an array index and a compare, and a handle to something
+*	that has since been released just resolves to NULL instead of to whatever took its slot.
+*
+*	Filenames are turned into handles by their hash. PATH_HASH works it out while compiling, so
+*	code asking for "Assets/Meshes/enemy.obj" never builds a string or walks a tree to find it.
+*/
+
+#ifndef RESOURCE_HANDLE_H
+#define RESOURCE_HANDLE_H
+
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// FNV-1a over the path. Worked out in 64 bits and cut back down because some compilers warn about
+// unsigned overflow in a constant expression, even though it's exactly what we want.
+constexpr unsigned int HashPath(const char* path)
+{
+	unsigned int hash = 2166136261u;
+
+	for (; *path != '\0'; path++)
+	{
+		hash = (unsigned int)(((unsigned long long)(hash ^ (unsigned char)*path) * 16777619ull) & 0xffffffffull);
+	}
+
+	return hash;
+}
+
+// Same as HashPath, but only for literals and guaranteed to happen at compile time
+#define PATH_HASH(path) (std::integral_constant<unsigned int, HashPath(path)>::value)
+
+// Slot 0 generation 0 is never handed out, so a default handle is an empty one
+template <class T>
+struct ResourceHandle
+{
+	unsigned short index;
+	unsigned short generation;
+
+	ResourceHandle() : index(0), generation(0) { }
+	ResourceHandle(unsigned short slot, unsigned short slotGeneration) : index(slot), generation(slotGeneration) { }
+
+	bool IsValid() const { return generation != 0; }
+};
+
+#define RESOURCE_TABLE_MAX_SLOTS 0xffff
+
+// The dense array behind a manager. Resources are found by the hash of their filename with a straight
+// run through the array, with a few dozen of them that's quicker than any tree and never allocates.
+// T needs a GetFilename so two files with the same hash can be told apart.
+template <class T>
+class ResourceTable
+{
+private:
+	struct Slot
+	{
+		unsigned int pathHash;
+		unsigned short generation;	// Goes up every time the slot is emptied
+		T* resource;				// NULL while the slot is free
+	};
+
+	std::vector<Slot> m_slots;
+	std::vector<unsigned short> m_freeSlots;
+
+public:
+	// The handle for whatever was added with this hash, or an empty one
+	ResourceHandle<T> Find(unsigned int pathHash) const
+	{
+		for (unsigned int i = 0; i < m_slots.size(); i++)
+		{
+			if (m_slots[i].pathHash == pathHash && m_slots[i].resource)
+				return ResourceHandle<T>((unsigned short)i, m_slots[i].generation);
+		}
+
+		return ResourceHandle<T>();
+	}
+
+	// As above but also checks the name, for when we have one and a collision would matter
+	ResourceHandle<T> Find(unsigned int pathHash, const char* filename) const
+	{
+		ResourceHandle<T> handle = Find(pathHash);
+
+		if (handle.IsValid() && strcmp(m_slots[handle.index].resource->GetFilename(), filename) != 0)
+			return ResourceHandle<T>();
+
+		return handle;
+	}
+
+	// NULL if the handle is empty or what it pointed at has been removed
+	T* Get(ResourceHandle<T> handle) const
+	{
+		if (handle.index >= m_slots.size() || m_slots[handle.index].generation != handle.generation)
+			return NULL;
+
+		return m_slots[handle.index].resource;
+	}
+
+	// Fails (returns an empty handle) if something else already has this hash
+	ResourceHandle<T> Add(unsigned int pathHash, T* resource)
+	{
+		if (Find(pathHash).IsValid())
+			return ResourceHandle<T>();
+
+		unsigned short index;
+
+		if (!m_freeSlots.empty())
+		{
+			index = m_freeSlots.back();
+			m_freeSlots.pop_back();
+		}
+		else
+		{
+			if (m_slots.size() >= RESOURCE_TABLE_MAX_SLOTS)
+				return ResourceHandle<T>();
+
+			Slot slot;
+			slot.generation = 1;
+			m_slots.push_back(slot);
+			index = (unsigned short)(m_slots.size() - 1);
+		}
+
+		m_slots[index].pathHash = pathHash;
+		m_slots[index].resource = resource;
+
+		return ResourceHandle<T>(index, m_slots[index].generation);
+	}
+
+	// Empties the resource's slot so every handle to it goes stale. Doesn't delete it.
+	void Remove(T* resource)
+	{
+		for (unsigned int i = 0; i < m_slots.size(); i++)
+		{
+			if (m_slots[i].resource == resource)
+			{
+				m_slots[i].resource = NULL;
+
+				// Generation 0 means empty, so skip it when wrapping around
+				m_slots[i].generation++;
+				if (m_slots[i].generation == 0)
+					m_slots[i].generation = 1;
+
+				m_freeSlots.push_back((unsigned short)i);
+				return;
+			}
+		}
+	}
+
+	// For going through everything, free slots come back as NULL
+	int GetSlotCount() const { return (int)m_slots.size(); }
+	T* GetResource(int slot) const { return m_slots[slot].resource; }
+
+	// Forgets everything. Resources are deleted by their manager first, only it can.
+	void Clear()
+	{
+		m_slots.clear();
+		m_freeSlots.clear();
+	}
+};
+
+#endif
@@ -12,6 +12,7 @@ Shader::Shader()
 	m_pixelShader = NULL;
 	m_layout = NULL;
 	m_matrixBuffer = NULL;
+	m_vertexFormat = MESH_VERTEX_FORMAT;
 }
 
 Shader::~Shader()
@@ -19,7 +20,7 @@ Shader::~Shader()
 
 }
 
-bool Shader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename)
+bool Shader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename, VertexFormatType vertexFormat)
 {
 	//This method loads and compiles the Vertex and Pixel shader code, sets up the vertex layout and creates a CPU accessable buffer to hold the matrices
 	
@@ -27,13 +28,15 @@ bool Shader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pi
 	ID3DBlob* pixelShaderBlob = NULL;		//and this one is for the pixel shader
 	ID3DBlob* errorBlob = NULL;				//Any compiler errors are stored in this blob, they will be a string which we can output if needed
 
-	const unsigned int numberOfVertexElements = 4;					//The input layout needs to know how many elements make up our vertices
-	D3D11_INPUT_ELEMENT_DESC vertexLayout[numberOfVertexElements];	//Each element will have a Description struct which tells us how they should be layed out
+	D3D11_INPUT_ELEMENT_DESC vertexLayout[SHADER_MAX_INPUT_ELEMENTS];	//Each element will have a Description struct which tells us how they should be layed out
+	D3D_SHADER_MACRO shaderDefines[SHADER_MAX_DEFINES + 1];			//The shaders need to be told how the vertices are packed
 	D3D11_BUFFER_DESC matrixBufferDescription;						//We will also need to create a Description struct for the buffer we are creating for the matrices
 
+	GetShaderDefines(vertexFormat, shaderDefines);
+
 	//We use D3DCompileFromFile to compile the HLSL code for our shaders
 	if (FAILED(D3DCompileFromFile(vertexFilename,	//The filename of the source code file
-		NULL,										//Any marco defines we want to include
+		shaderDefines,								//Any marco defines we want to include (here they describe the vertex format)
 		D3D_COMPILE_STANDARD_FILE_INCLUDE,			//Here we can specify include files
 		"main",										//This is the name of the entry point method
 		"vs_4_0",									//What Shader Model (version) do we want to target, shader model 4 is old but works almost everywhere
@@ -55,7 +58,7 @@ bool Shader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pi
 
 	//Compiling the pixel shader is the same process but we use "ps_4_0" as the shader model
 	if (FAILED(D3DCompileFromFile(pixelFilename,
-		NULL,
+		shaderDefines,								//The same macros, so a pixel shader with more than one version knows which it is
 		D3D_COMPILE_STANDARD_FILE_INCLUDE,
 		"main",
 		"ps_4_0",
@@ -102,44 +105,11 @@ bool Shader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pi
 		return false;
 	}
 
-	//Here we start filling out the Descriptions of each Vertex Element
-	//The Input Layout uses a concept known as "Semantics". Each element has a semantic name, these names match semantics that are defined in the shader code
-	//The order of these descriptions must match the order of the elements on our Vertex struct, see Mesh.h
-
-	vertexLayout[0].SemanticName = "POSITION";				//The first element is the position vector so we use the "POSITION" semantic
-	vertexLayout[0].SemanticIndex = 0;						//Semantics can be indexed (like an array) so that you can pass more then one in. We only have one position though
-	vertexLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;	//This specifies how the element is interpreted, our vector is made up of 3 32-bit floats so the format needs to 
-															//support that much data
-	vertexLayout[0].InputSlot = 0;							//Shader input can come from lots of different places, we only use one input slot so 0 is fine for us			
-	vertexLayout[0].AlignedByteOffset = 0;					//This specifies the offset from the start of the Vertex where this element begins, 
-															//this is the first element so there is no offset. 
-	vertexLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;	//This specifies that this element is present for each vertex
-	vertexLayout[0].InstanceDataStepRate = 0;				//This is for a technique called instancing, we won't be covering it this semester
-
-	vertexLayout[1].SemanticName = "COLOR";					//The next input element is our colour
-	vertexLayout[1].SemanticIndex = 0;
-	vertexLayout[1].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;//It is 4 32-bit floats so our format matches that
-	vertexLayout[1].InputSlot = 0;
-	vertexLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;	//Here we would calculate the byte offset by factoring in the size of the last element
-																		//however this value here tells Direct3D to calculate it for us, which is nice!
-	vertexLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	vertexLayout[1].InstanceDataStepRate = 0;
-
-	vertexLayout[2].SemanticName = "NORMAL";				//The next element is the normal
-	vertexLayout[2].SemanticIndex = 0;
-	vertexLayout[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;	//A normal is 3 32-bit floats
-	vertexLayout[2].InputSlot = 0;
-	vertexLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	vertexLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	vertexLayout[2].InstanceDataStepRate = 0;
-
-	vertexLayout[3].SemanticName = "TEXCOORD";				//The final element is the texture coordinate
-	vertexLayout[3].SemanticIndex = 0;
-	vertexLayout[3].Format = DXGI_FORMAT_R32G32_FLOAT;		//A texture coord is 2 32-bit floats
-	vertexLayout[3].InputSlot = 0;
-	vertexLayout[3].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
-	vertexLayout[3].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
-	vertexLayout[3].InstanceDataStepRate = 0;
+	//Next we describe each Vertex Element in an input layout.
+	//The Input Layout uses a concept known as "Semantics". Each element has a semantic name, these names match semantics that are defined in the shader code.
+	//The descriptions come from the same table that packs the mesh data (see VertexFormat.cpp), so they always match the vertices in our buffers
+	int numberOfVertexElements = GetInputLayout(vertexFormat, vertexLayout);
+	m_vertexFormat = vertexFormat;
 
 	//After we have described our input elements we can create our input layout, this method needs the descriptions we created 
 	//and the vertex shader with the semantics that match the ones in the descriptions
@@ -181,6 +151,16 @@ bool Shader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pi
 	return true;
 }
 
+int Shader::GetInputLayout(VertexFormatType vertexFormat, D3D11_INPUT_ELEMENT_DESC* layout)
+{
+	return VertexFormat::GetInputLayout(vertexFormat, layout);
+}
+
+void Shader::GetShaderDefines(VertexFormatType vertexFormat, D3D_SHADER_MACRO* defines)
+{
+	VertexFormat::GetShaderDefines(vertexFormat, defines);
+}
+
 void Shader::Release()
 {
 	if (m_matrixBuffer)
@@ -13,11 +13,16 @@
 #include <d3d11.h>
 #include <d3dcompiler.h>
 #include "DirectXTK/SimpleMath.h"
+#include "VertexFormat.h"
 
 #pragma comment(lib, "d3dcompiler.lib")
 
 using namespace DirectX::SimpleMath;
 
+//Room for everything a vertex format needs plus whatever a subclass adds on the end (see InstancedShader)
+#define SHADER_MAX_INPUT_ELEMENTS (VERTEX_FORMAT_MAX_ELEMENTS + 1)
+#define SHADER_MAX_DEFINES (VERTEX_FORMAT_MAX_DEFINES + 1)
+
 class Shader
 {
 protected:
@@ -32,15 +37,23 @@ protected:
 	ID3D11PixelShader* m_pixelShader;		//This is a pointer to the compiled and initialised Pixel Shader
 	ID3D11InputLayout* m_layout;			//This is the Vertex layout, it defines the mapping between the vertex data and the input variables in the shader code
 	ID3D11Buffer* m_matrixBuffer;			//This buffer stores that matrix data so it can be easly passed into the Vertex shader
+	VertexFormatType m_vertexFormat;		//How the vertices this shader draws are laid out
+
+	//These describe the vertex format by default. Subclasses that need more going into the shaders override them, call
+	//the parent version and add theirs on the end (at most SHADER_MAX_INPUT_ELEMENTS and SHADER_MAX_DEFINES altogether)
+	virtual int GetInputLayout(VertexFormatType vertexFormat, D3D11_INPUT_ELEMENT_DESC* layout);
+	virtual void GetShaderDefines(VertexFormatType vertexFormat, D3D_SHADER_MACRO* defines);	//Ends with a NULL entry
 
 public:
 	Shader();			//Constructor
 	virtual ~Shader();	//Destructor
 
-	virtual bool Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename);	//Initialises the shader, here we specify the file name of the 
-																									//vertex and pixel shader source code files
+	virtual bool Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename, VertexFormatType vertexFormat);	//Initialises the shader, here we specify the file name of the 
+																									//vertex and pixel shader source code files and the vertex format it will draw
 	virtual void Release();		//Cleanup
 	
+	VertexFormatType GetVertexFormat() { return m_vertexFormat; }
+
 	virtual void Begin(ID3D11DeviceContext* context);	//The begin method tells the device context to use the Shaders as the current rendering shaders
 
 	virtual bool SetMatrices(ID3D11DeviceContext* context, Matrix world, Matrix view, Matrix projection);	//This method copies the world, view, proj matrices 
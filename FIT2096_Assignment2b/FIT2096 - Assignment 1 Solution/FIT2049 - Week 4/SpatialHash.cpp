@@ -0,0 +1,137 @@
+/*	FIT2096 - Assignment 2b
+*	SpatialHash.cpp
+*	Implementation of SpatialHash.h
+*/
+
+#include "SpatialHash.h"
+#include <algorithm>
+
+// Scratch for nearest queries, distance squared and object. One per thread so enemies updating
+// in jobs can all ask at once.
+static thread_local std::vector<std::pair<float, int> > t_candidates;
+
+SpatialHash::SpatialHash()
+{
+	m_cellSize = 1.0f;
+	m_inverseCellSize = 1.0f;
+	m_bucketMask = 0;
+}
+
+void SpatialHash::SetCellSize(float cellSize)
+{
+	m_cellSize = cellSize;
+	m_inverseCellSize = 1.0f / cellSize;
+}
+
+unsigned int SpatialHash::GetBucket(int cellX, int cellZ)
+{
+	// Large primes so neighbouring cells scatter across the buckets
+	return ((unsigned int)cellX * 73856093u ^ (unsigned int)cellZ * 19349663u) & m_bucketMask;
+}
+
+void SpatialHash::Clear()
+{
+	m_pendingObjects.clear();
+	m_pendingX.clear();
+	m_pendingZ.clear();
+}
+
+void SpatialHash::Add(int object, Vector3 position)
+{
+	m_pendingObjects.push_back(object);
+	m_pendingX.push_back(position.x);
+	m_pendingZ.push_back(position.z);
+}
+
+void SpatialHash::Build()
+{
+	int count = (int)m_pendingObjects.size();
+
+	// Roughly twice as many buckets as objects keeps most buckets to one cell
+	unsigned int bucketCount = SPATIAL_HASH_MIN_BUCKETS;
+
+	while (bucketCount < (unsigned int)count * 2)
+	{
+		bucketCount *= 2;
+	}
+
+	m_bucketMask = bucketCount - 1;
+
+	// Count how many land in each bucket
+	m_bucketStarts.assign(bucketCount + 1, 0);
+	m_pendingBuckets.resize(count);
+
+	for (int i = 0; i < count; i++)
+	{
+		m_pendingBuckets[i] = GetBucket(GetCell(m_pendingX[i]), GetCell(m_pendingZ[i]));
+		m_bucketStarts[m_pendingBuckets[i] + 1]++;
+	}
+
+	// Running total turns the counts into where each bucket starts
+	for (unsigned int b = 0; b < bucketCount; b++)
+	{
+		m_bucketStarts[b + 1] += m_bucketStarts[b];
+	}
+
+	m_objects.resize(count);
+	m_x.resize(count);
+	m_z.resize(count);
+
+	// Drop everyone into their bucket's next free slot, using the start of the next bucket as a cursor
+	for (int i = 0; i < count; i++)
+	{
+		int slot = m_bucketStarts[m_pendingBuckets[i]]++;
+
+		m_objects[slot] = m_pendingObjects[i];
+		m_x[slot] = m_pendingX[i];
+		m_z[slot] = m_pendingZ[i];
+	}
+
+	// The cursors have all moved along one bucket, shift them back
+	for (unsigned int b = bucketCount; b > 0; b--)
+	{
+		m_bucketStarts[b] = m_bucketStarts[b - 1];
+	}
+
+	m_bucketStarts[0] = 0;
+}
+
+void SpatialHash::QueryRadius(Vector3 centre, float radius, std::vector<int>* results)
+{
+	ForEachWithin(centre, radius, [results](int object, float x, float z, float distanceSquared)
+	{
+		results->push_back(object);
+	});
+}
+
+void SpatialHash::QueryNearest(Vector3 centre, int count, float maxRadius, std::vector<int>* results)
+{
+	if (count <= 0)
+		return;
+
+	t_candidates.clear();
+
+	std::vector<std::pair<float, int> >* candidates = &t_candidates;
+	ForEachWithin(centre, maxRadius, [candidates](int object, float x, float z, float distanceSquared)
+	{
+		candidates->push_back(std::make_pair(distanceSquared, object));
+	});
+
+	// Only the closest few need to be in order
+	int found = (int)t_candidates.size();
+
+	if (found > count)
+	{
+		std::partial_sort(t_candidates.begin(), t_candidates.begin() + count, t_candidates.end());
+		found = count;
+	}
+	else
+	{
+		std::sort(t_candidates.begin(), t_candidates.end());
+	}
+
+	for (int i = 0; i < found; i++)
+	{
+		results->push_back(t_candidates[i].second);
+	}
+}
@@ -0,0 +1,143 @@
+/*	FIT2096 - Assignment 2b
+*	SpatialHash.h
+*	Finds which objects are near a point without checking every one of them. The ground is cut
+*	into square cells and each cell is hashed into one of a fixed number of buckets, so the
+*	memory used depends on how many objects there are rather than how big the board is.
+*	Objects are sorted by bucket into one flat array each time it's built (count them up, then
+*	drop each into place), so building is cheap enough to redo every tick and a query only
+*	reads the buckets under its radius.
+*	Nothing in the hash is written during a query, so any number of threads can query at once.
+*/
+
+#ifndef SPATIAL_HASH_H
+#define SPATIAL_HASH_H
+
+#include "DirectXTK/SimpleMath.h"
+#include <cmath>
+#include <utility>
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+// Never fewer buckets than this, however few objects there are
+#define SPATIAL_HASH_MIN_BUCKETS 64
+
+// Queries covering more cells than this read every object instead of going cell by cell
+#define SPATIAL_HASH_QUERY_CELLS 64
+
+class SpatialHash
+{
+private:
+	float m_cellSize;
+	float m_inverseCellSize;
+	unsigned int m_bucketMask;	// Bucket count is a power of two so this picks the bucket
+
+	// Objects added since the last Build, in the order they came in
+	std::vector<int> m_pendingObjects;
+	std::vector<float> m_pendingX;
+	std::vector<float> m_pendingZ;
+	std::vector<unsigned int> m_pendingBuckets;
+
+	// After Build, bucket b holds entries m_bucketStarts[b] up to (not including) m_bucketStarts[b + 1]
+	std::vector<int> m_bucketStarts;
+	std::vector<int> m_objects;
+	std::vector<float> m_x;
+	std::vector<float> m_z;
+
+	int GetCell(float position) { return (int)floorf(position * m_inverseCellSize); }
+	unsigned int GetBucket(int cellX, int cellZ);
+
+public:
+	SpatialHash();
+
+	// Cells should be about as big as the radius most queries use
+	void SetCellSize(float cellSize);
+
+	// Empties the hash, then Add everyone and Build before querying
+	void Clear();
+	void Add(int object, Vector3 position);
+	void Build();
+
+	// Every object within radius of the centre on the ground (height is ignored), in no particular order.
+	// Results are appended to the vector.
+	void QueryRadius(Vector3 centre, float radius, std::vector<int>* results);
+
+	// Up to count of the closest objects no further than maxRadius away, closest first.
+	// Results are appended to the vector.
+	void QueryNearest(Vector3 centre, int count, float maxRadius, std::vector<int>* results);
+
+	// Calls visit(object, x, z, distanceSquared) for everything within radius, without building a list
+	template <typename Visitor>
+	void ForEachWithin(Vector3 centre, float radius, Visitor visit);
+
+	int GetCount() { return (int)m_objects.size(); }
+};
+
+template <typename Visitor>
+void SpatialHash::ForEachWithin(Vector3 centre, float radius, Visitor visit)
+{
+	if (m_objects.size() == 0)
+		return;
+
+	float radiusSquared = radius * radius;
+	int minX = GetCell(centre.x - radius);
+	int maxX = GetCell(centre.x + radius);
+	int minZ = GetCell(centre.z - radius);
+	int maxZ = GetCell(centre.z + radius);
+
+	if (maxX - minX >= SPATIAL_HASH_QUERY_CELLS || maxZ - minZ >= SPATIAL_HASH_QUERY_CELLS ||
+		(maxX - minX + 1) * (maxZ - minZ + 1) > SPATIAL_HASH_QUERY_CELLS)
+	{
+		for (int entry = 0; entry < (int)m_objects.size(); entry++)
+		{
+			float dx = m_x[entry] - centre.x;
+			float dz = m_z[entry] - centre.z;
+			float distanceSquared = dx * dx + dz * dz;
+
+			if (distanceSquared <= radiusSquared)
+			{
+				visit(m_objects[entry], m_x[entry], m_z[entry], distanceSquared);
+			}
+		}
+
+		return;
+	}
+
+	// Two cells in one query can land in the same bucket, this stops us reading it twice
+	unsigned int visited[SPATIAL_HASH_QUERY_CELLS];
+	int visitedCount = 0;
+
+	for (int cellZ = minZ; cellZ <= maxZ; cellZ++)
+	{
+		for (int cellX = minX; cellX <= maxX; cellX++)
+		{
+			unsigned int bucket = GetBucket(cellX, cellZ);
+			bool seen = false;
+
+			for (int v = 0; v < visitedCount; v++)
+			{
+				seen = seen || visited[v] == bucket;
+			}
+
+			if (seen)
+				continue;
+
+			visited[visitedCount++] = bucket;
+
+			// Other cells share this bucket too, the distance check throws them out
+			for (int entry = m_bucketStarts[bucket]; entry < m_bucketStarts[bucket + 1]; entry++)
+			{
+				float dx = m_x[entry] - centre.x;
+				float dz = m_z[entry] - centre.z;
+				float distanceSquared = dx * dx + dz * dz;
+
+				if (distanceSquared <= radiusSquared)
+				{
+					visit(m_objects[entry], m_x[entry], m_z[entry], distanceSquared);
+				}
+			}
+		}
+	}
+}
+
+#endif
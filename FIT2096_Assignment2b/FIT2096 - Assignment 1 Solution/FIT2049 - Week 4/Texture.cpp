@@ -5,10 +5,15 @@
 */
 
 #include "Texture.h"
+#include "AssetPack.h"
+#include "CookedTexture.h"
 #include "DirectXTK/WICTextureLoader.h"
+#include <cstring>
 #include <sstream>
+#include <vector>
 
 using namespace DirectX;
+using namespace std;
 
 Texture::Texture()
 {
@@ -33,13 +38,34 @@ Texture::~Texture()
 	}
 }
 
-bool Texture::Load(Direct3D* direct3D, const char* filename)
+bool Texture::Load(Direct3D* direct3D, const char* filename, AssetPack* pack)
 {
-	//This method uses the CreateWICTextureFromFile function. This function comes from the DirectXToolKit library
+	string cookedFilename = CookedTexture::GetCookedFilename(filename);
 
-	wchar_t* wideFilename = ConvertString(filename);
+	if (IsCooked(filename, pack) && LoadCooked(direct3D, cookedFilename.c_str(), pack))
+	{
+		m_filename = filename;
+		return true;
+	}
 
-	HRESULT result = CreateWICTextureFromFile(direct3D->GetDevice(), wideFilename, &m_texture, &m_textureView);
+	HRESULT result;
+	AssetData data;
+
+	if (pack && pack->IsOpen() && pack->Read(filename, &data))
+	{
+		//The image is decoded straight out of the pack's mapping, no file to open
+		result = CreateWICTextureFromMemory(direct3D->GetDevice(), (const uint8_t*)data.GetData(), data.GetSize(), &m_texture, &m_textureView);
+	}
+	else
+	{
+		//This method uses the CreateWICTextureFromFile function. This function comes from the DirectXToolKit library
+
+		wchar_t* wideFilename = ConvertString(filename);
+
+		result = CreateWICTextureFromFile(direct3D->GetDevice(), wideFilename, &m_texture, &m_textureView);
+
+		delete[] wideFilename;
+	}
 
 	if (FAILED(result))
 	{
@@ -51,9 +77,130 @@ bool Texture::Load(Direct3D* direct3D, const char* filename)
 	return true;
 }
 
+bool Texture::LoadCooked(Direct3D* direct3D, const char* filename, AssetPack* pack)
+{
+	AssetData data;
+	if (!AssetPack::ReadAsset(pack, filename, &data))
+	{
+		return false;
+	}
+
+	//Nothing to decode, every mip level is already in the format the GPU samples and goes up straight out of the mapping
+	D3D11_TEXTURE2D_DESC description;
+	vector<D3D11_SUBRESOURCE_DATA> levels;
+
+	if (!CookedTexture::Validate(data.GetData(), data.GetSize(), &description, &levels))
+	{
+		return false;
+	}
+
+	ID3D11Texture2D* texture = NULL;
+
+	if (FAILED(direct3D->GetDevice()->CreateTexture2D(&description, &levels[0], &texture)))
+	{
+		return false;
+	}
+
+	//No description needed, the view covers the whole texture and every mip level
+	if (FAILED(direct3D->GetDevice()->CreateShaderResourceView(texture, NULL, &m_textureView)))
+	{
+		texture->Release();
+		return false;
+	}
+
+	m_texture = texture;
+
+	return true;
+}
+
+bool Texture::LoadArray(Direct3D* direct3D, const char* name, const char* const* filenames, int count, AssetPack* pack)
+{
+	if (count <= 0)
+	{
+		return false;
+	}
+
+	//Every layer stays mapped until the array has been made from them
+	vector<AssetData> files(count);
+	vector<D3D11_SUBRESOURCE_DATA> levels;
+	D3D11_TEXTURE2D_DESC description;
+
+	for (int i = 0; i < count; i++)
+	{
+		string cookedFilename = CookedTexture::GetCookedFilename(filenames[i]);
+		D3D11_TEXTURE2D_DESC layerDescription;
+		vector<D3D11_SUBRESOURCE_DATA> layerLevels;
+
+		if (!AssetPack::ReadAsset(pack, cookedFilename.c_str(), &files[i]) ||
+			!CookedTexture::Validate(files[i].GetData(), files[i].GetSize(), &layerDescription, &layerLevels))
+		{
+			return false;
+		}
+
+		if (i == 0)
+		{
+			description = layerDescription;
+		}
+		else if (layerDescription.Width != description.Width || layerDescription.Height != description.Height ||
+			layerDescription.Format != description.Format || layerDescription.MipLevels != description.MipLevels)
+		{
+			stringstream message;
+			message << "Texture: " << filenames[i] << " doesn't match " << filenames[0] << " so it can't go in " << name << "\n";
+			OutputDebugString(message.str().c_str());
+			return false;
+		}
+
+		//Direct3D wants every mip level of the first layer, then every level of the second and so on
+		levels.insert(levels.end(), layerLevels.begin(), layerLevels.end());
+	}
+
+	description.ArraySize = count;
+
+	ID3D11Texture2D* texture = NULL;
+
+	if (FAILED(direct3D->GetDevice()->CreateTexture2D(&description, &levels[0], &texture)))
+	{
+		return false;
+	}
+
+	//Without a description the view would still work, but spell out that shaders see it as an array
+	D3D11_SHADER_RESOURCE_VIEW_DESC viewDescription;
+	memset(&viewDescription, 0, sizeof(viewDescription));
+	viewDescription.Format = description.Format;
+	viewDescription.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	viewDescription.Texture2DArray.MostDetailedMip = 0;
+	viewDescription.Texture2DArray.MipLevels = description.MipLevels;
+	viewDescription.Texture2DArray.FirstArraySlice = 0;
+	viewDescription.Texture2DArray.ArraySize = count;
+
+	if (FAILED(direct3D->GetDevice()->CreateShaderResourceView(texture, &viewDescription, &m_textureView)))
+	{
+		texture->Release();
+		return false;
+	}
+
+	m_texture = texture;
+	m_filename = name;
+
+	return true;
+}
+
+bool Texture::IsCooked(const char* filename, AssetPack* pack)
+{
+	string cookedFilename = CookedTexture::GetCookedFilename(filename);
+
+	//Same as meshes, assetpack only packs cooked textures that were up to date so in a pack being there is enough
+	if (pack && pack->IsOpen())
+	{
+		return pack->Contains(cookedFilename.c_str());
+	}
+
+	return CookedTexture::IsUpToDate(filename, cookedFilename.c_str());
+}
+
 wchar_t* Texture::ConvertString(const char * str)
 {
-	// Convert C string (which we like using) into a wchar_t* (which the texture loader likes) 
+	// Convert C string (which we like using) into a wchar_t* (which the texture loader likes). The caller deletes it with delete[]
 	// https://msdn.microsoft.com/en-us/library/ms235631.aspx
 	size_t newsize = strlen(str) + 1;
 	wchar_t* wcstring = new wchar_t[newsize];
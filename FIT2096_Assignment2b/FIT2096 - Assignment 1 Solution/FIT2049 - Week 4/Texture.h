@@ -11,6 +11,8 @@
 #include <d3d11.h>
 #include "Direct3D.h"
 
+class AssetPack;
+
 class Texture
 {
 private:
@@ -22,7 +24,14 @@ private:
 
 	Texture();
 	~Texture();
-	bool Load(Direct3D* renderer, const char* filename);
+	bool Load(Direct3D* renderer, const char* filename, AssetPack* pack);	//pack can be NULL
+	bool LoadCooked(Direct3D* renderer, const char* filename, AssetPack* pack);	//The .dds texturecook made, see CookedTexture.h
+
+	//Stacks the cooked versions of count textures into one texture array, layer i is filenames[i]. They all have to be cooked
+	//and the same size, format and mip count. name is what the array goes by in the TextureManager, it isn't a file.
+	bool LoadArray(Direct3D* renderer, const char* name, const char* const* filenames, int count, AssetPack* pack);
+
+	static bool IsCooked(const char* filename, AssetPack* pack);	//Whether Load would use the .dds
 
 	void AddRef() { m_referenceCount++; }
 	void RemoveRef() { m_referenceCount--; }
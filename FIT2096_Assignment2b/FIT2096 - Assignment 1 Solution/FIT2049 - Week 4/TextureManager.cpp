@@ -1,10 +1,12 @@
 #include "TextureManager.h"
+#include <Windows.h>
+#include <sstream>
 
 using namespace std;
 
 TextureManager::TextureManager()
 {
-
+	m_assetPack = NULL;
 }
 
 TextureManager::~TextureManager()
@@ -17,36 +19,108 @@ bool TextureManager::Load(Direct3D* renderer, const char* filename)
 	if (filename == NULL)
 		return false;
 
-	if (GetTexture(filename) != NULL)
+	if (GetHandle(filename).IsValid())
 		return true;
 
 	Texture* tempTexture = new Texture();
 
-	if (tempTexture->Load(renderer, filename))
-	{
-		string filenameStr = filename;
-		m_textureMap[filenameStr] = tempTexture;
-		return true;
-	}
-	else
+	if (tempTexture->Load(renderer, filename, m_assetPack))
+		return Add(tempTexture, filename);
+
+	delete tempTexture;
+	return false;
+}
+
+AssetFuture TextureManager::LoadAsync(AssetLoader* loader, Direct3D* renderer, const char* filename)
+{
+	if (filename == NULL)
+		return AssetLoader::Ready(false);
+
+	if (GetHandle(filename).IsValid())
+		return AssetLoader::Ready(true);
+
+	Texture* texture = new Texture();
+	AssetPack* pack = m_assetPack;
+
+	// The WIC loader decodes the image and makes the texture in one go. It doesn't touch the device context and the
+	// device is free threaded, so all of it happens on the loader's threads and we just take it in here. WIC needs COM
+	// on the thread that calls it, the JobSystem sets that up for its threads and WinMain did for the main one.
+	return loader->Load(filename,
+		[texture, renderer, filename, pack]()
+		{
+			return texture->Load(renderer, filename, pack);
+		},
+		[this, texture, filename](bool decoded)
+		{
+			if (decoded)
+				return Add(texture, filename);
+
+			delete texture;
+			return false;
+		});
+}
+
+AssetFuture TextureManager::LoadArrayAsync(AssetLoader* loader, Direct3D* renderer, const char* name, const char* const* filenames, int count)
+{
+	if (name == NULL || filenames == NULL)
+		return AssetLoader::Ready(false);
+
+	if (GetHandle(name).IsValid())
+		return AssetLoader::Ready(true);
+
+	// Only cooked layers can be stacked, and it's cheaper to find out now than after queuing
+	for (int i = 0; i < count; i++)
 	{
-		delete tempTexture;
-		return false;
+		if (!Texture::IsCooked(filenames[i], m_assetPack))
+			return AssetLoader::Ready(false);
 	}
+
+	Texture* texture = new Texture();
+	AssetPack* pack = m_assetPack;
+
+	return loader->Load(name,
+		[texture, renderer, name, filenames, count, pack]()
+		{
+			return texture->LoadArray(renderer, name, filenames, count, pack);
+		},
+		[this, texture, name](bool decoded)
+		{
+			if (decoded)
+				return Add(texture, name);
+
+			delete texture;
+			return false;
+		});
 }
 
-Texture* TextureManager::GetTexture(const char* filename)
+bool TextureManager::Add(Texture* texture, const char* filename)
 {
-	string filenameStr = filename;
+	if (m_textures.Add(HashPath(filename), texture).IsValid())
+		return true;
 
-	TextureMap::const_iterator searchResult = m_textureMap.find(filenameStr);
-	if (searchResult != m_textureMap.end())
+	// Loaded twice at once (asked for again before the first one finished), keep the first
+	if (GetHandle(filename).IsValid())
 	{
-		searchResult->second->AddRef();
-		return searchResult->second;
+		delete texture;
+		return true;
 	}
 
-	return NULL;
+	stringstream message;
+	message << "TextureManager: " << filename << " has the same hash as a texture that's already loaded, rename one of them\n";
+	OutputDebugString(message.str().c_str());
+
+	delete texture;
+	return false;
+}
+
+Texture* TextureManager::GetTexture(TextureHandle handle)
+{
+	Texture* texture = m_textures.Get(handle);
+
+	if (texture)
+		texture->AddRef();
+
+	return texture;
 }
 
 void TextureManager::ReleaseTexture(Texture* texture)
@@ -56,12 +130,7 @@ void TextureManager::ReleaseTexture(Texture* texture)
 		texture->RemoveRef();
 		if (texture->GetRefCount() <= 0)
 		{
-			string filename = texture->GetFilename();
-			TextureMap::const_iterator searchResult = m_textureMap.find(filename);
-			if (searchResult != m_textureMap.end())
-			{
-				m_textureMap.erase(searchResult);
-			}
+			m_textures.Remove(texture);
 			delete texture;
 		}
 	}
@@ -69,14 +138,10 @@ void TextureManager::ReleaseTexture(Texture* texture)
 
 void TextureManager::Release()
 {
-	if (!m_textureMap.empty())
+	for (int i = 0; i < m_textures.GetSlotCount(); i++)
 	{
-		TextureMap::iterator mapIterator;
-		for (mapIterator = m_textureMap.begin(); mapIterator != m_textureMap.end(); mapIterator++)
-		{
-			delete mapIterator->second;
-			mapIterator->second = NULL;
-		}
-		m_textureMap.clear();
+		delete m_textures.GetResource(i);
 	}
+
+	m_textures.Clear();
 }
\ No newline at end of file
@@ -2,22 +2,47 @@
 #define TEXTUREMANAGER_H
 
 #include <d3d11.h>
-#include <map>
-#include <string>
 
+#include "AssetLoader.h"
+#include "AssetPack.h"
 #include "Texture.h"
+#include "ResourceHandle.h"
+
+typedef ResourceHandle<Texture> TextureHandle;
 
 class TextureManager
 {
 private:
-	typedef std::map<std::string, Texture*> TextureMap;
-	TextureMap m_textureMap;
+	ResourceTable<Texture> m_textures;
+	AssetPack* m_assetPack;
+
+	// Puts a freshly loaded texture in the table, or deletes it if the name is taken by a different file with the same hash
+	bool Add(Texture* texture, const char* filename);
 
 public:
 	TextureManager();
 	~TextureManager();
 	bool Load(Direct3D* renderer, const char* filename);
-	Texture* GetTexture(const char* identifier);
+
+	// Files are read out of the pack from now on (the ones it has, anything else still comes off the disk)
+	void SetAssetPack(AssetPack* pack) { m_assetPack = pack; }
+
+	// Queues the texture on the loader and returns straight away, it's in here once the future is ready.
+	// filename has to stay around until then.
+	AssetFuture LoadAsync(AssetLoader* loader, Direct3D* renderer, const char* filename);
+
+	// Queues a texture array made from the cooked versions of count textures (see Texture::LoadArray), found afterwards
+	// by name. The future is false straight away when any of them hasn't been cooked. name and filenames have to stay around.
+	AssetFuture LoadArrayAsync(AssetLoader* loader, Direct3D* renderer, const char* name, const char* const* filenames, int count);
+
+	// Same as the MeshManager, find the handle once and keep it
+	TextureHandle GetHandle(unsigned int pathHash) { return m_textures.Find(pathHash); }
+	TextureHandle GetHandle(const char* filename) { return m_textures.Find(HashPath(filename), filename); }
+
+	// These add a reference, NULL if the texture isn't loaded (or has been released since the handle was made)
+	Texture* GetTexture(TextureHandle handle);
+	Texture* GetTexture(unsigned int pathHash) { return GetTexture(GetHandle(pathHash)); }
+	Texture* GetTexture(const char* filename) { return GetTexture(GetHandle(filename)); }
 	void ReleaseTexture(Texture* texture);
 	void Release();
 };
@@ -16,11 +16,11 @@ TexturedShader::~TexturedShader()
 
 }
 
-bool TexturedShader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename)
+bool TexturedShader::Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename, VertexFormatType vertexFormat)
 {
 	D3D11_SAMPLER_DESC textureSamplerDescription;	//When we create a sampler we need a Description struct to describe how we want to create the sampler
 
-	if (!Shader::Initialise(device, vertexFilename, pixelFilename))		//We'll use the parent method to create most of the shader
+	if (!Shader::Initialise(device, vertexFilename, pixelFilename, vertexFormat))		//We'll use the parent method to create most of the shader
 	{
 		return false;
 	}
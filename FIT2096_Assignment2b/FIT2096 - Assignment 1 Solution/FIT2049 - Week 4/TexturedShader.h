@@ -22,7 +22,7 @@ public:
 	~TexturedShader();	//Destructor
 
 	void Begin(ID3D11DeviceContext* context);
-	bool Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename);
+	bool Initialise(ID3D11Device* device, LPCWSTR vertexFilename, LPCWSTR pixelFilename, VertexFormatType vertexFormat);
 	bool SetTexture(ID3D11DeviceContext* context, ID3D11ShaderResourceView* textureView);
 	void Release();
 };
@@ -0,0 +1,115 @@
+/*	FIT2096 - Assignment 2b
+*	TileGrid.cpp
+*	Implementation of TileGrid.h
+*/
+
+#include "TileGrid.h"
+
+// Close enough to the ground that nobody can tell the difference
+#define TILE_REST_THRESHOLD 0.001f
+
+TileGrid::TileGrid()
+{
+	m_width = 0;
+	m_height = 0;
+	m_dropSpeed = 3.0f;
+	m_fallingCount = 0;
+	m_previousHeightsSettled = true;
+}
+
+void TileGrid::Resize(int width, int height)
+{
+	m_width = width;
+	m_height = height;
+
+	int cellCount = width * height;
+
+	// assign rather than resize so any old board is completely replaced
+	m_types.assign(cellCount, TileType::NORMAL);
+	m_hasEnemy.assign(cellCount, 0);
+	m_heights.assign(cellCount, 0.0f);
+	m_previousHeights.assign(cellCount, 0.0f);
+	m_dropDelays.assign(cellCount, 0.0f);
+
+	m_fallingCount = 0;
+	m_previousHeightsSettled = true;
+}
+
+void TileGrid::Update(float timestep, JobSystem* jobs)
+{
+	// Tiles only animate while they're dropping in. After that the whole board is static.
+	if (m_fallingCount == 0)
+		return;
+
+	float amount = timestep * m_dropSpeed;
+	std::atomic<int> landedCount(0);
+
+	// Every cell only looks at itself, so any split of the board gives the same result
+	ParallelFor(jobs, GetCellCount(), TILE_UPDATE_GRAIN, [this, timestep, amount, &landedCount](int begin, int end)
+	{
+		int landed = 0;
+
+		for (int i = begin; i < end; i++)
+		{
+			if (m_heights[i] == 0.0f)
+				continue;
+
+			if (m_dropDelays[i] > 0.0f)
+			{
+				// Not ready to fall yet
+				m_dropDelays[i] -= timestep;
+			}
+			else
+			{
+				// We're falling! Same LERP towards the ground the tiles have always done
+				m_heights[i] -= m_heights[i] * amount;
+
+				if (m_heights[i] < TILE_REST_THRESHOLD)
+				{
+					m_heights[i] = 0.0f;
+					landed++;
+				}
+			}
+		}
+
+		landedCount += landed;
+	});
+
+	m_fallingCount -= landedCount;
+}
+
+void TileGrid::StorePreviousHeights()
+{
+	// Once the board has settled and we've copied the final heights there's nothing left to remember
+	if (m_fallingCount == 0 && m_previousHeightsSettled)
+		return;
+
+	m_previousHeights = m_heights;
+	m_previousHeightsSettled = (m_fallingCount == 0);
+}
+
+bool TileGrid::IsWalkable(int x, int z)
+{
+	TileType type = GetType(x, z);
+	return type != TileType::WALL && type != TileType::DISABLED && type != TileType::INVALID;
+}
+
+void TileGrid::DropFromHeight(int x, int z, float dropHeight, float delay)
+{
+	int index = GetIndex(x, z);
+
+	if (m_heights[index] == 0.0f && dropHeight != 0.0f)
+	{
+		m_fallingCount++;
+	}
+	else if (m_heights[index] != 0.0f && dropHeight == 0.0f)
+	{
+		m_fallingCount--;
+	}
+
+	// Snap to drop height, it's a teleport so the previous height snaps too
+	m_heights[index] = dropHeight;
+	m_previousHeights[index] = dropHeight;
+	m_dropDelays[index] = delay;
+	m_previousHeightsSettled = false;
+}
@@ -0,0 +1,74 @@
+/*	FIT2096 - Assignment 2b
+*	TileGrid.h
+*	Stores every cell of the board in a handful of flat arrays (one entry per cell, row by row)
+*	instead of one heap allocated GameObject per tile. A cell only needs to know its type,
+*	whether an enemy is standing on it and how far it still has to fall, so that's all we keep.
+*	Walking the board is now a walk through contiguous memory which scales to very large boards.
+*/
+
+#ifndef TILE_GRID_H
+#define TILE_GRID_H
+
+#include "Tile.h"
+#include "JobSystem.h"
+#include "DirectXTK/SimpleMath.h"
+#include <vector>
+
+using namespace DirectX::SimpleMath;
+
+// Cells per job when the board is updated on several threads
+#define TILE_UPDATE_GRAIN 4096
+
+class TileGrid
+{
+private:
+	int m_width;
+	int m_height;
+
+	// Structure of arrays, index with GetIndex(x, z)
+	std::vector<TileType> m_types;
+	std::vector<unsigned char> m_hasEnemy;
+	std::vector<float> m_heights;			// Tiles drop in from the sky and come to rest at 0
+	std::vector<float> m_previousHeights;	// Height at the end of the last tick (for render interpolation)
+	std::vector<float> m_dropDelays;		// How long until each tile starts falling
+
+	float m_dropSpeed;
+	int m_fallingCount;						// Once nothing is falling, Update has nothing to do
+	bool m_previousHeightsSettled;			// and the previous heights don't need copying either
+
+public:
+	TileGrid();
+
+	// Throws away the current board and creates a new one full of NORMAL tiles resting on the ground
+	void Resize(int width, int height);
+
+	void Update(float timestep, JobSystem* jobs = NULL);  // Cells are split between threads if there's a job system
+	void StorePreviousHeights();
+
+	// Instruct a tile to start falling from a specified height
+	void DropFromHeight(int x, int z, float dropHeight, float delay);
+
+	int GetWidth() { return m_width; }
+	int GetHeight() { return m_height; }
+	int GetCellCount() { return m_width * m_height; }
+	int GetIndex(int x, int z) { return z * m_width + x; }
+	bool IsInside(int x, int z) { return x >= 0 && x < m_width && z >= 0 && z < m_height; }
+
+	// Returns INVALID if the cell isn't on the board
+	TileType GetType(int x, int z) { return IsInside(x, z) ? m_types[GetIndex(x, z)] : TileType::INVALID; }
+	TileType GetTypeAt(int index) { return m_types[index]; }
+	bool IsWalkable(int x, int z);  // Enemies can't walk through walls or disabled tiles (or off the board)
+	void SetType(int x, int z, TileType type) { m_types[GetIndex(x, z)] = type; }
+
+	bool GetHasEnemy(int x, int z) { return m_hasEnemy[GetIndex(x, z)] != 0; }
+	void SetHasEnemy(int x, int z, bool value) { m_hasEnemy[GetIndex(x, z)] = value ? 1 : 0; }
+
+	float GetHeightAt(int index) { return m_heights[index]; }
+	float GetPreviousHeightAt(int index) { return m_previousHeights[index]; }
+
+	Vector3 GetPosition(int x, int z) { return Vector3((float)x, m_heights[GetIndex(x, z)], (float)z); }
+
+	void SetDropSpeed(float speed) { m_dropSpeed = speed; }
+};
+
+#endif
@@ -0,0 +1,393 @@
+/*	FIT2096 - Assignment 2b
+*	VertexFormat.cpp
+*	Implementation of VertexFormat.h
+*/
+
+#include "VertexFormat.h"
+
+#include <cmath>
+#include <cstring>
+
+struct VertexFormatDescription
+{
+	const char* name;
+	int elementCount;
+	VertexElement elements[VERTEX_FORMAT_MAX_ELEMENTS];
+};
+
+// Attributes are stored in the order listed here, one after another with no gaps
+static const VertexFormatDescription s_formats[VERTEX_FORMAT_COUNT] =
+{
+	{ "standard", 4, {
+		{ VERTEX_ATTRIBUTE_POSITION, VERTEX_ENCODING_FLOAT3 },
+		{ VERTEX_ATTRIBUTE_COLOUR, VERTEX_ENCODING_FLOAT4 },
+		{ VERTEX_ATTRIBUTE_NORMAL, VERTEX_ENCODING_FLOAT3 },
+		{ VERTEX_ATTRIBUTE_TEXCOORD, VERTEX_ENCODING_FLOAT2 } } },
+
+	{ "compact", 3, {
+		{ VERTEX_ATTRIBUTE_POSITION, VERTEX_ENCODING_FLOAT3 },
+		{ VERTEX_ATTRIBUTE_NORMAL, VERTEX_ENCODING_UNORM_1010102 },
+		{ VERTEX_ATTRIBUTE_TEXCOORD, VERTEX_ENCODING_HALF2 } } },
+
+	{ "octahedral", 3, {
+		{ VERTEX_ATTRIBUTE_POSITION, VERTEX_ENCODING_FLOAT3 },
+		{ VERTEX_ATTRIBUTE_NORMAL, VERTEX_ENCODING_OCTAHEDRAL_SNORM16 },
+		{ VERTEX_ATTRIBUTE_TEXCOORD, VERTEX_ENCODING_HALF2 } } }
+};
+
+static const char* s_semantics[] = { "POSITION", "COLOR", "NORMAL", "TEXCOORD" };
+
+static unsigned int GetEncodingSize(VertexEncoding encoding)
+{
+	switch (encoding)
+	{
+	case VERTEX_ENCODING_FLOAT2: return 8;
+	case VERTEX_ENCODING_FLOAT3: return 12;
+	case VERTEX_ENCODING_FLOAT4: return 16;
+	default: return 4;	// The packed ones all fit in 32 bits
+	}
+}
+
+static DXGI_FORMAT GetEncodingFormat(VertexEncoding encoding)
+{
+	switch (encoding)
+	{
+	case VERTEX_ENCODING_FLOAT2: return DXGI_FORMAT_R32G32_FLOAT;
+	case VERTEX_ENCODING_FLOAT3: return DXGI_FORMAT_R32G32B32_FLOAT;
+	case VERTEX_ENCODING_FLOAT4: return DXGI_FORMAT_R32G32B32A32_FLOAT;
+	case VERTEX_ENCODING_HALF2: return DXGI_FORMAT_R16G16_FLOAT;
+	case VERTEX_ENCODING_UNORM_1010102: return DXGI_FORMAT_R10G10B10A2_UNORM;
+	case VERTEX_ENCODING_OCTAHEDRAL_SNORM16: return DXGI_FORMAT_R16G16_SNORM;
+	default: return DXGI_FORMAT_UNKNOWN;
+	}
+}
+
+// Rounds to the nearest half, anything too big becomes infinity and anything too small becomes zero
+static unsigned short FloatToHalf(float value)
+{
+	unsigned int bits;
+	memcpy(&bits, &value, 4);
+
+	unsigned short sign = (unsigned short)((bits >> 16) & 0x8000);
+	int exponent = (int)((bits >> 23) & 0xff) - 127 + 15;
+	unsigned int mantissa = bits & 0x7fffff;
+
+	if (((bits >> 23) & 0xff) == 0xff)
+		return sign | 0x7c00 | (mantissa ? 0x200 : 0);	// Infinity or NaN
+
+	if (exponent >= 31)
+		return sign | 0x7c00;
+
+	if (exponent <= 0)
+	{
+		// Too small for a normal half, it might still fit as a denormal
+		if (exponent < -10)
+			return sign;
+
+		mantissa |= 0x800000;
+		int shift = 14 - exponent;
+		unsigned short half = (unsigned short)(mantissa >> shift);
+
+		if ((mantissa >> (shift - 1)) & 1)
+			half++;
+
+		return sign | half;
+	}
+
+	unsigned short half = (unsigned short)(sign | (exponent << 10) | (mantissa >> 13));
+
+	// Rounding up can carry into the exponent, which is still the right answer
+	if (mantissa & 0x1000)
+		half++;
+
+	return half;
+}
+
+static float HalfToFloat(unsigned short half)
+{
+	unsigned int sign = (unsigned int)(half & 0x8000) << 16;
+	unsigned int exponent = (half >> 10) & 0x1f;
+	unsigned int mantissa = half & 0x3ff;
+	unsigned int bits;
+
+	if (exponent == 0)
+	{
+		// Zero or a denormal, which is just the mantissa scaled down
+		float value = mantissa / 16777216.0f;
+		return sign ? -value : value;
+	}
+
+	if (exponent == 31)
+		bits = sign | 0x7f800000 | (mantissa << 13);
+	else
+		bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+	float value;
+	memcpy(&value, &bits, 4);
+	return value;
+}
+
+static unsigned int ToUnorm10(float value)
+{
+	float unorm = value * 0.5f + 0.5f;
+	if (unorm < 0.0f) unorm = 0.0f;
+	if (unorm > 1.0f) unorm = 1.0f;
+	return (unsigned int)(unorm * 1023.0f + 0.5f);
+}
+
+static short ToSnorm16(float value)
+{
+	if (value < -1.0f) value = -1.0f;
+	if (value > 1.0f) value = 1.0f;
+	return (short)floorf(value * 32767.0f + 0.5f);
+}
+
+static float FromSnorm16(short value)
+{
+	float result = value / 32767.0f;
+	return result < -1.0f ? -1.0f : result;
+}
+
+static float SignNotZero(float value)
+{
+	return value >= 0.0f ? 1.0f : -1.0f;
+}
+
+// Project onto the octahedron |x| + |y| + |z| = 1, then fold the bottom half out over the corners
+// of the top half so the whole thing flattens into a square
+static void EncodeOctahedral(Vector3 normal, short* encoded)
+{
+	float sum = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+	float x = 0.0f;
+	float y = 0.0f;
+
+	// A missing normal has nowhere to go, it comes back pointing along z
+	if (sum > 0.0f)
+	{
+		x = normal.x / sum;
+		y = normal.y / sum;
+
+		if (normal.z < 0.0f)
+		{
+			float foldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+			float foldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+			x = foldedX;
+			y = foldedY;
+		}
+	}
+
+	encoded[0] = ToSnorm16(x);
+	encoded[1] = ToSnorm16(y);
+}
+
+// The same as the shader does it
+static Vector3 DecodeOctahedral(const short* encoded)
+{
+	Vector3 normal(FromSnorm16(encoded[0]), FromSnorm16(encoded[1]), 0.0f);
+	normal.z = 1.0f - fabsf(normal.x) - fabsf(normal.y);
+
+	float fold = normal.z < 0.0f ? -normal.z : 0.0f;
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+
+	normal.Normalize();
+	return normal;
+}
+
+const char* VertexFormat::GetName(VertexFormatType format)
+{
+	return s_formats[format].name;
+}
+
+unsigned int VertexFormat::GetStride(VertexFormatType format)
+{
+	unsigned int stride = 0;
+
+	for (int i = 0; i < s_formats[format].elementCount; i++)
+	{
+		stride += GetEncodingSize(s_formats[format].elements[i].encoding);
+	}
+
+	return stride;
+}
+
+int VertexFormat::GetInputLayout(VertexFormatType format, D3D11_INPUT_ELEMENT_DESC* layout)
+{
+	const VertexFormatDescription& description = s_formats[format];
+	unsigned int offset = 0;
+
+	for (int i = 0; i < description.elementCount; i++)
+	{
+		const VertexElement& element = description.elements[i];
+
+		layout[i].SemanticName = s_semantics[element.attribute];	//Matches the semantic on the same input in VertexShader.vs
+		layout[i].SemanticIndex = 0;
+		layout[i].Format = GetEncodingFormat(element.encoding);		//How the GPU should read it, packed ones get unpacked for free
+		layout[i].InputSlot = 0;
+		layout[i].AlignedByteOffset = offset;
+		layout[i].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+		layout[i].InstanceDataStepRate = 0;
+
+		offset += GetEncodingSize(element.encoding);
+	}
+
+	return description.elementCount;
+}
+
+void VertexFormat::GetShaderDefines(VertexFormatType format, D3D_SHADER_MACRO* defines)
+{
+	const VertexFormatDescription& description = s_formats[format];
+	int defineCount = 0;
+	bool hasColour = false;
+
+	for (int i = 0; i < description.elementCount; i++)
+	{
+		const VertexElement& element = description.elements[i];
+
+		if (element.attribute == VERTEX_ATTRIBUTE_COLOUR)
+			hasColour = true;
+
+		if (element.encoding == VERTEX_ENCODING_UNORM_1010102)
+		{
+			defines[defineCount].Name = "VERTEX_NORMAL_UNORM";
+			defines[defineCount++].Definition = "1";
+		}
+		else if (element.encoding == VERTEX_ENCODING_OCTAHEDRAL_SNORM16)
+		{
+			defines[defineCount].Name = "VERTEX_NORMAL_OCTAHEDRAL";
+			defines[defineCount++].Definition = "1";
+		}
+	}
+
+	if (!hasColour)
+	{
+		defines[defineCount].Name = "VERTEX_NO_COLOUR";
+		defines[defineCount++].Definition = "1";
+	}
+
+	defines[defineCount].Name = NULL;
+	defines[defineCount].Definition = NULL;
+}
+
+void VertexFormat::Pack(VertexFormatType format, const MeshVertex* vertices, int count, void* output)
+{
+	const VertexFormatDescription& description = s_formats[format];
+	unsigned char* bytes = (unsigned char*)output;
+
+	for (int v = 0; v < count; v++)
+	{
+		const MeshVertex& vertex = vertices[v];
+
+		for (int i = 0; i < description.elementCount; i++)
+		{
+			const VertexElement& element = description.elements[i];
+			float values[4];
+
+			switch (element.attribute)
+			{
+			case VERTEX_ATTRIBUTE_POSITION: values[0] = vertex.position.x; values[1] = vertex.position.y; values[2] = vertex.position.z; values[3] = 1.0f; break;
+			case VERTEX_ATTRIBUTE_COLOUR: values[0] = vertex.colour.x; values[1] = vertex.colour.y; values[2] = vertex.colour.z; values[3] = vertex.colour.w; break;
+			case VERTEX_ATTRIBUTE_NORMAL: values[0] = vertex.normal.x; values[1] = vertex.normal.y; values[2] = vertex.normal.z; values[3] = 0.0f; break;
+			case VERTEX_ATTRIBUTE_TEXCOORD: values[0] = vertex.texCoord.x; values[1] = vertex.texCoord.y; values[2] = 0.0f; values[3] = 0.0f; break;
+			}
+
+			switch (element.encoding)
+			{
+			case VERTEX_ENCODING_FLOAT2:
+			case VERTEX_ENCODING_FLOAT3:
+			case VERTEX_ENCODING_FLOAT4:
+				memcpy(bytes, values, GetEncodingSize(element.encoding));
+				break;
+
+			case VERTEX_ENCODING_HALF2:
+			{
+				unsigned short halves[2] = { FloatToHalf(values[0]), FloatToHalf(values[1]) };
+				memcpy(bytes, halves, 4);
+				break;
+			}
+
+			case VERTEX_ENCODING_UNORM_1010102:
+			{
+				// Red in the lowest bits, the two bit alpha is unused
+				unsigned int packed = ToUnorm10(values[0]) | (ToUnorm10(values[1]) << 10) | (ToUnorm10(values[2]) << 20);
+				memcpy(bytes, &packed, 4);
+				break;
+			}
+
+			case VERTEX_ENCODING_OCTAHEDRAL_SNORM16:
+			{
+				short encoded[2];
+				EncodeOctahedral(Vector3(values[0], values[1], values[2]), encoded);
+				memcpy(bytes, encoded, 4);
+				break;
+			}
+			}
+
+			bytes += GetEncodingSize(element.encoding);
+		}
+	}
+}
+
+void VertexFormat::Unpack(VertexFormatType format, const void* data, int index, MeshVertex* vertex)
+{
+	const VertexFormatDescription& description = s_formats[format];
+	const unsigned char* bytes = (const unsigned char*)data + (size_t)index * GetStride(format);
+
+	// The shader makes up a white colour when there isn't one
+	vertex->colour = Color(1.0f, 1.0f, 1.0f, 1.0f);
+
+	for (int i = 0; i < description.elementCount; i++)
+	{
+		const VertexElement& element = description.elements[i];
+		float values[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+		switch (element.encoding)
+		{
+		case VERTEX_ENCODING_FLOAT2:
+		case VERTEX_ENCODING_FLOAT3:
+		case VERTEX_ENCODING_FLOAT4:
+			memcpy(values, bytes, GetEncodingSize(element.encoding));
+			break;
+
+		case VERTEX_ENCODING_HALF2:
+		{
+			unsigned short halves[2];
+			memcpy(halves, bytes, 4);
+			values[0] = HalfToFloat(halves[0]);
+			values[1] = HalfToFloat(halves[1]);
+			break;
+		}
+
+		case VERTEX_ENCODING_UNORM_1010102:
+		{
+			unsigned int packed;
+			memcpy(&packed, bytes, 4);
+			values[0] = (packed & 0x3ff) / 1023.0f * 2.0f - 1.0f;
+			values[1] = ((packed >> 10) & 0x3ff) / 1023.0f * 2.0f - 1.0f;
+			values[2] = ((packed >> 20) & 0x3ff) / 1023.0f * 2.0f - 1.0f;
+			break;
+		}
+
+		case VERTEX_ENCODING_OCTAHEDRAL_SNORM16:
+		{
+			short encoded[2];
+			memcpy(encoded, bytes, 4);
+			Vector3 normal = DecodeOctahedral(encoded);
+			values[0] = normal.x;
+			values[1] = normal.y;
+			values[2] = normal.z;
+			break;
+		}
+		}
+
+		switch (element.attribute)
+		{
+		case VERTEX_ATTRIBUTE_POSITION: vertex->position = Vector3(values[0], values[1], values[2]); break;
+		case VERTEX_ATTRIBUTE_COLOUR: vertex->colour = Color(values[0], values[1], values[2], values[3]); break;
+		case VERTEX_ATTRIBUTE_NORMAL: vertex->normal = Vector3(values[0], values[1], values[2]); break;
+		case VERTEX_ATTRIBUTE_TEXCOORD: vertex->texCoord = Vector2(values[0], values[1]); break;
+		}
+
+		bytes += GetEncodingSize(element.encoding);
+	}
+}
@@ -0,0 +1,87 @@
+/*	FIT2096 - Assignment 2b
+*	VertexFormat.h
+*	The ways a mesh's vertices can be laid out in a vertex buffer. Each format is one row in a
+*	table (see VertexFormat.cpp) listing its attributes and how each one is stored. The same row
+*	packs MeshVertex data into the buffer, builds the shader's input layout and picks the macros
+*	the vertex shader is compiled with, so the CPU and GPU sides can't disagree.
+*
+*	STANDARD is the original 48 byte vertex. COMPACT and OCTAHEDRAL drop the colour (it was
+*	always white) and store the normal in 4 bytes and the uv as two halves, for 20 bytes a vertex.
+*	MESH_VERTEX_FORMAT is the one every mesh and the game's shader use.
+*/
+
+#ifndef VERTEX_FORMAT_H
+#define VERTEX_FORMAT_H
+
+#include <d3d11.h>
+#include "DirectXTK/SimpleMath.h"
+
+using namespace DirectX::SimpleMath;
+
+// Every vertex as we build it on the CPU, before it's packed into whichever format is in use
+struct MeshVertex
+{
+	Vector3 position;
+	Color colour;
+	Vector3 normal;
+	Vector2 texCoord;
+};
+
+enum VertexFormatType
+{
+	VERTEX_FORMAT_STANDARD,		// float3 position, float4 colour, float3 normal, float2 uv
+	VERTEX_FORMAT_COMPACT,		// float3 position, 10:10:10:2 normal, half2 uv
+	VERTEX_FORMAT_OCTAHEDRAL,	// float3 position, octahedral snorm16x2 normal, half2 uv
+	VERTEX_FORMAT_COUNT
+};
+
+#define MESH_VERTEX_FORMAT VERTEX_FORMAT_COMPACT
+
+// The most attributes a format can have, and the most shader macros one needs (plus the NULL on the end)
+#define VERTEX_FORMAT_MAX_ELEMENTS 4
+#define VERTEX_FORMAT_MAX_DEFINES 3
+
+enum VertexAttribute
+{
+	VERTEX_ATTRIBUTE_POSITION,
+	VERTEX_ATTRIBUTE_COLOUR,
+	VERTEX_ATTRIBUTE_NORMAL,
+	VERTEX_ATTRIBUTE_TEXCOORD
+};
+
+enum VertexEncoding
+{
+	VERTEX_ENCODING_FLOAT2,
+	VERTEX_ENCODING_FLOAT3,
+	VERTEX_ENCODING_FLOAT4,
+	VERTEX_ENCODING_HALF2,				// Plenty for uvs between -2 and 2
+	VERTEX_ENCODING_UNORM_1010102,		// A unit vector squeezed into 0..1, the shader undoes it
+	VERTEX_ENCODING_OCTAHEDRAL_SNORM16	// A unit vector folded onto a square, the shader unfolds it
+};
+
+struct VertexElement
+{
+	VertexAttribute attribute;
+	VertexEncoding encoding;
+};
+
+class VertexFormat
+{
+public:
+	static const char* GetName(VertexFormatType format);
+	static unsigned int GetStride(VertexFormatType format);
+
+	// Fills in one description per attribute (at most VERTEX_FORMAT_MAX_ELEMENTS) and returns how many
+	static int GetInputLayout(VertexFormatType format, D3D11_INPUT_ELEMENT_DESC* layout);
+
+	// The macros VertexShader.vs needs to read this format, ending with a NULL entry
+	static void GetShaderDefines(VertexFormatType format, D3D_SHADER_MACRO* defines);
+
+	// Writes count vertices of GetStride bytes each to output
+	static void Pack(VertexFormatType format, const MeshVertex* vertices, int count, void* output);
+
+	// Reads one vertex back, anything the format doesn't store comes back as it would look in the shader
+	static void Unpack(VertexFormatType format, const void* data, int index, MeshVertex* vertex);
+};
+
+#endif
@@ -17,6 +17,10 @@ Window::Window(const char* windowName, int width, int height, bool fullscreen)
 	m_fullscreen = fullscreen;
 	m_renderer = NULL;
 	m_input = NULL;
+	m_renderMailbox = NULL;
+	m_renderThread = NULL;
+
+	m_fixedTimestep = new FixedTimestep(SIMULATION_TICKS_PER_SECOND, MAX_SIMULATION_TICKS_PER_FRAME);
 
 	QueryPerformanceFrequency(&m_counterFrequency);
 	QueryPerformanceCounter(&m_lastCount);
@@ -131,9 +135,18 @@ bool Window::Initialise()
 		return false;
 	}
 
+	//The render thread draws with whatever backend the game made, it doesn't start until Start is called
+	m_renderMailbox = new RenderMailbox();
+	m_renderThread = new RenderThread(m_renderMailbox, m_game->GetRenderBackend(), m_fixedTimestep->GetStepSize());
+
 	return true;
 }
 
+void Window::SetTickRate(float ticksPerSecond, int maxTicksPerFrame)
+{
+	m_fixedTimestep->SetTickRate(ticksPerSecond, maxTicksPerFrame);
+}
+
 void Window::Start()
 {
 	//This method runs the message pump which looks out for new message sent by the OS
@@ -143,6 +156,15 @@ void Window::Start()
 	
 	bool running = true;	
 
+	//Show the game as it is before the first tick, then let the render thread take it from there
+	m_game->BuildSnapshot(m_renderMailbox->GetWriteSnapshot(), 0.0f);
+	m_renderMailbox->Publish();
+	m_renderThread->Start();
+
+	//Sleep is only as accurate as the system timer, which can be as coarse as 15ms. We sleep between ticks
+	//that are 16ms apart, so ask for 1ms while we're running.
+	timeBeginPeriod(1);
+
 	while(running)
 	{
 		//If is a message, store it in msg and remove it from the message queue
@@ -167,14 +189,39 @@ void Window::Start()
 			//This value is now the number of seconds that have passed since the last frame to this frame, hopefully it is a fractional number, otherwise we are running very slow!
 			float timestep = (currentCount.QuadPart - m_lastCount.QuadPart) / (float)m_counterFrequency.QuadPart;
 
-			m_game->Update(timestep);	//We tell the game to update, and give it the timestep so it can move things around correctly
-			m_game->Render();			//After everything is updated we can then render a frame
+			//The game isn't updated with this timestep directly. Instead we run as many fixed size ticks as fit into it,
+			//any time left over carries into the next frame. This way the game behaves the same at 30fps and at 300fps.
+			int ticks = m_fixedTimestep->Advance(timestep);
+			for (int i = 0; i < ticks; i++)
+			{
+				m_game->Update(m_fixedTimestep->GetStepSize());
+			}
+
+			//After everything is updated we hand a snapshot of it to the render thread. We're usually part way
+			//between two ticks, the snapshot remembers how far so objects can be drawn in between
+			if (ticks > 0)
+			{
+				m_game->BuildSnapshot(m_renderMailbox->GetWriteSnapshot(), m_fixedTimestep->GetInterpolation());
+				m_renderMailbox->Publish();
+			}
+			else
+			{
+				//Nothing changed and nothing will until the next tick is due, so sleep until then rather than
+				//spinning. A message arriving wakes us early so input isn't held up.
+				DWORD waitTime = (DWORD)(m_fixedTimestep->GetTimeUntilNextTick() * 1000.0f);
+				MsgWaitForMultipleObjectsEx(0, NULL, waitTime, QS_ALLINPUT, MWMO_INPUTAVAILABLE);
+			}
 
 			//We set the last count value to the current count so that next frame we still have the count from this frame
 			m_lastCount = currentCount;
 
 		}
 	}
+
+	timeEndPeriod(1);
+
+	//Everything a snapshot points to is about to be released
+	m_renderThread->Stop();
 }
 
 void Window::Shutdown()
@@ -186,6 +233,20 @@ void Window::Shutdown()
 		ChangeDisplaySettings(NULL, 0);	//If we were fullscreen we need to go back to the default display settings
 	}
 
+	//Should have already stopped at the end of Start, but we might never have got that far
+	if (m_renderThread)
+	{
+		m_renderThread->Stop();
+		delete m_renderThread;
+		m_renderThread = NULL;
+	}
+
+	if (m_renderMailbox)
+	{
+		delete m_renderMailbox;
+		m_renderMailbox = NULL;
+	}
+
 	if (m_game)
 	{
 		m_game->Shutdown();
@@ -206,6 +267,12 @@ void Window::Shutdown()
 		m_input = NULL;
 	}
 
+	if (m_fixedTimestep)
+	{
+		delete m_fixedTimestep;
+		m_fixedTimestep = NULL;
+	}
+
 	DestroyWindow(m_windowHandle);		
 	m_windowHandle = NULL;
 
@@ -11,7 +11,16 @@
 
 #include <Windows.h>
 #include "Direct3D.h"
+#include "FixedTimestep.h"
 #include "Game.h"
+#include "RenderMailbox.h"
+#include "RenderThread.h"
+
+#pragma comment(lib, "winmm.lib")	//For timeBeginPeriod, so the main loop can sleep for a millisecond at a time
+
+//Defaults for SetTickRate, the command line can change them (see Main.cpp)
+#define SIMULATION_TICKS_PER_SECOND 60.0f	//How many times a second the game is updated, regardless of how fast we can render
+#define MAX_SIMULATION_TICKS_PER_FRAME 5	//If we fall further behind than this in one frame we give up on catching up
 
 class Window
 {
@@ -34,6 +43,15 @@ private:
 	LARGE_INTEGER m_counterFrequency;	//The performance counter has a frequency which is basically the number counts per second
 	LARGE_INTEGER m_lastCount;			//This value will store where the counter was upto on the last frame
 
+	//The game is updated in fixed size ticks so it behaves the same no matter the frame rate
+	//The timestep above is fed into this and it tells us how many ticks to run each frame
+	FixedTimestep* m_fixedTimestep;
+
+	//Drawing happens on its own thread so a slow tick doesn't hold up the screen and a slow screen doesn't hold up the game
+	//After each frame's ticks the game publishes a snapshot of itself into the mailbox and the render thread draws the newest one
+	RenderMailbox* m_renderMailbox;
+	RenderThread* m_renderThread;
+
 public:
 	Window(const char* windowName, int width, int height, bool fullscreen);	//A simple constructor used to set some initial values
 	~Window();	//Destructor
@@ -42,6 +60,10 @@ public:
 	void Start();		//The Start method starts the message pump running, while there are messages to process, the program will remain running.
 	void Shutdown();	//The Shutdown method cleans up the window when it is about to be deleted.
 
+	//How often the game is updated and how far it can catch up in one frame. Call before Initialise, the render thread
+	//is told the tick length when it's made.
+	void SetTickRate(float ticksPerSecond, int maxTicksPerFrame);
+
 	LRESULT CALLBACK MessageProc(HWND, UINT, WPARAM, LPARAM);	//This method is an internal message procedure.
 																//It is declared within the scope of the Window class which means it is able to
 																//modify variables inside the Window (for example an Input class which we will be